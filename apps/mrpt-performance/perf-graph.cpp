@@ -104,7 +104,8 @@ double graphs_dijkstra(int nNodes, int _N)
 	for (long i = 0; i < N; i++)
 	{
 		tims.enter("op");
-		mrpt::graphs::CDijkstra<graph_t> dij(gs, TNodeID(0));
+		mrpt::graphs::CDijkstra<graph_t, MAPS_IMPLEMENTATION> dij(
+			gs, TNodeID(0));
 		tims.leave("op");
 		// Don't count the time of the destructor.
 	}
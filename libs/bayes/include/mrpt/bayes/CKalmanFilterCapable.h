@@ -23,6 +23,7 @@
 #include <mrpt/typemeta/TEnumType.h>
 
 #include <cstring>	// memcpy
+#include <map>
 #include <vector>
 
 #if defined(_DEBUG)
@@ -44,7 +45,10 @@ enum TKFMethod
 	kfEKFNaive = 0,
 	kfEKFAlaDavison,
 	kfIKFFull,
-	kfIKF
+	kfIKF,
+	/** Sparse extended information filter (SEIF), only for SLAM problems
+	 * (FEAT_SIZE>0). See CKalmanFilterCapable. (New in MRPT 2.7.1) */
+	kfSEIF
 };
 
 // Forward declaration:
@@ -81,6 +85,11 @@ struct TKF_options : public mrpt::config::CLoadableOptions
 		MRPT_LOAD_CONFIG_VAR(
 			debug_verify_analytic_jacobians_threshold, double, iniFile,
 			section);
+		MRPT_LOAD_CONFIG_VAR(SEIF_max_active_landmarks, int, iniFile, section);
+		MRPT_LOAD_CONFIG_VAR(
+			SEIF_mean_recovery_landmarks, int, iniFile, section);
+		MRPT_LOAD_CONFIG_VAR(
+			SEIF_mean_recovery_iterations, int, iniFile, section);
 	}
 
 	/** This method must display clearly all the contents of the structure in
@@ -101,6 +110,15 @@ struct TKF_options : public mrpt::config::CLoadableOptions
 		out << mrpt::format(
 			"enable_profiler                         = %c\n",
 			enable_profiler ? 'Y' : 'N');
+		out << mrpt::format(
+			"SEIF_max_active_landmarks               = %u\n",
+			SEIF_max_active_landmarks);
+		out << mrpt::format(
+			"SEIF_mean_recovery_landmarks            = %u\n",
+			SEIF_mean_recovery_landmarks);
+		out << mrpt::format(
+			"SEIF_mean_recovery_iterations           = %u\n",
+			SEIF_mean_recovery_iterations);
 		out << "\n";
 	}
 
@@ -127,6 +145,19 @@ struct TKF_options : public mrpt::config::CLoadableOptions
 	/** (default-1e-2) Sets the threshold for the difference between the
 	 * analytic and the numerical jacobians */
 	double debug_verify_analytic_jacobians_threshold{1e-2};
+	/** (default=20) Only for kfSEIF: maximum number of "active" landmarks,
+	 * i.e. those directly linked to the vehicle in the information matrix.
+	 * Landmarks beyond this number are deactivated by sparsification on each
+	 * iteration, which bounds the cost of the prediction and update steps. */
+	unsigned int SEIF_max_active_landmarks{20};
+	/** (default=50) Only for kfSEIF: number of non-active landmarks whose
+	 * means are recovered in each iteration, taken in round-robin order. The
+	 * vehicle and the active landmarks are always updated. Set to 0 to update
+	 * all the landmarks in each iteration. */
+	unsigned int SEIF_mean_recovery_landmarks{50};
+	/** (default=2) Only for kfSEIF: number of Gauss-Seidel sweeps in each
+	 * iteration to recover the mean from the information form. */
+	unsigned int SEIF_mean_recovery_iterations{2};
 };
 
 /** Auxiliary functions, for internal usage of MRPT classes */
@@ -209,6 +240,25 @@ void addNewLandmarks(
  *	- ACT_SIZE: The dimension of each "action" u_k (or 0 if not applicable).
  *	- KFTYPE: The numeric type of the matrices (default: double)
  *
+ * The kfSEIF method keeps a sparse information matrix instead of the dense
+ *covariance, so the memory grows linearly with the number of landmarks and
+ *the cost of each iteration is bounded by TKF_options::SEIF_max_active_landmarks
+ *(plus the landmarks predicted by OnPreComputingPredictions(), which should
+ *then be overridden). It relies on the same virtual methods as the EKF
+ *methods, with these differences:
+ *	- The mean in the state vector is recovered incrementally (see
+ *TKF_options::SEIF_mean_recovery_landmarks), hence it is an approximation.
+ *	- \a m_pkk only holds the covariance of the vehicle state. Use
+ *getLandmarkCov() and getFullCov() to query the rest.
+ *	- The innovation matrix passed to OnGetObservationsAndDataAssociation()
+ *is block diagonal, and its blocks (as the covariances returned by
+ *getLandmarkCov()) are computed from the Markov blanket of each landmark.
+ *	- The transition Jacobian must be invertible.
+ *
+ *  Calling reset() in the derived classes (or setting a full covariance in
+ *\a m_pkk and clearing \a m_SEIF_active by any other means) re-initializes
+ *the information form.
+ *
  * Revisions:
  *	- 2007: Antonio J. Ortiz de Galisteo (AJOGD)
  *	- 2008/FEB: All KF classes corrected, reorganized, and rewritten (JLBC).
@@ -282,9 +332,33 @@ class CKalmanFilterCapable : public mrpt::system::COutputLogger
 	 */
 	inline void getLandmarkCov(size_t idx, KFMatrix_FxF& feat_cov) const
 	{
+		if (SEIF_inUse())
+		{
+			ASSERT_(idx < getNumberOfLandmarksInTheMap());
+			KFMatrix cov;
+			SEIF_getLocalCov(std::vector<size_t>(1, idx), cov);
+			feat_cov = cov.template blockCopy<FEAT_SIZE, FEAT_SIZE>(
+				VEH_SIZE, VEH_SIZE);
+			return;
+		}
 		feat_cov = m_pkk.template blockCopy<FEAT_SIZE, FEAT_SIZE>(
 			VEH_SIZE + idx * FEAT_SIZE, VEH_SIZE + idx * FEAT_SIZE);
 	}
+	/** Returns the full covariance matrix of the state vector. With the
+	 * kfSEIF method, it is computed by inverting the whole information
+	 * matrix, which is expensive for large maps.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void getFullCov(KFMatrix& cov) const;
+	/** Only for kfSEIF: returns the number of landmarks directly linked to
+	 * the vehicle in the information matrix (see
+	 * TKF_options::SEIF_max_active_landmarks).
+	 * \note (New in MRPT 2.7.1)
+	 */
+	size_t getNumberOfActiveLandmarks() const
+	{
+		return SEIF_inUse() ? m_SEIF.Ovm.size() : 0;
+	}
 
    protected:
 	/** @name Kalman filter state
@@ -292,8 +366,14 @@ class CKalmanFilterCapable : public mrpt::system::COutputLogger
 
 	/** The system state vector. */
 	KFVector m_xkk;
-	/** The system full covariance matrix. */
+	/** The system full covariance matrix (or only the vehicle covariance,
+	 * with the kfSEIF method). */
 	KFMatrix m_pkk;
+	/** Whether the state is kept in information form, with only the vehicle
+	 * covariance in \a m_pkk (kfSEIF method). Derived classes that reset
+	 * \a m_xkk and \a m_pkk to a full covariance must set it to false.
+	 * \note (New in MRPT 2.7.1) */
+	bool m_SEIF_active = false;
 
 	/** @} */
 
@@ -623,6 +703,67 @@ class CKalmanFilterCapable : public mrpt::system::COutputLogger
 	KFMatrix m_dh_dx_full_obs;
 	KFMatrix m_aux_K_dh_dx;
 
+	/** @name Information form, for the kfSEIF method
+		@{ */
+
+	/** Sparse information matrix and vector of the state, in blocks of the
+	 * vehicle and each landmark. Only the non-zero blocks are stored. */
+	struct TInformationForm
+	{
+		/** Vehicle-vehicle block */
+		KFMatrix_VxV Ovv;
+		/** Vehicle-landmark blocks, only for the active landmarks */
+		std::map<size_t, KFMatrix_VxF> Ovm;
+		/** Diagonal landmark blocks */
+		std::vector<KFMatrix_FxF> Omm;
+		/** Off-diagonal landmark blocks: Omm_links[i][j] is the block of
+		 * landmarks i,j (each link is stored for both landmarks) */
+		std::vector<std::map<size_t, KFMatrix_FxF>> Omm_links;
+		/** The information vector */
+		KFVector xi;
+	};
+	TInformationForm m_SEIF;
+	/** Next landmark for the round-robin mean recovery */
+	size_t m_SEIF_next_mean_recovery = 0;
+
+	/** Whether the state is kept in information form */
+	bool SEIF_inUse() const { return m_SEIF_active; }
+	void SEIF_initFromCovariance();
+	/** Dense information matrix over the vehicle and the given landmarks, in
+	 * this order. */
+	void SEIF_getLocalInformation(
+		const std::vector<size_t>& lms, KFMatrix& O) const;
+	/** Stores back the blocks of a matrix from SEIF_getLocalInformation().
+	 * Blocks which are exactly zero are removed. */
+	void SEIF_setLocalInformation(
+		const std::vector<size_t>& lms, const KFMatrix& O);
+	void SEIF_getLocalMean(const std::vector<size_t>& lms, KFVector& mu) const;
+	/** Adds a vector in the order of SEIF_getLocalInformation() to the
+	 * information vector */
+	void SEIF_addLocalInformationVector(
+		const std::vector<size_t>& lms, const KFVector& d);
+	/** Covariance of the vehicle and the given landmarks (in this order),
+	 * approximated by the inverse of the information matrix over them and
+	 * their Markov blanket, i.e. conditioned on the mean of the rest of
+	 * landmarks. */
+	void SEIF_getLocalCov(const std::vector<size_t>& lms, KFMatrix& cov) const;
+	void SEIF_activeLandmarks(std::vector<size_t>& lms) const;
+	void SEIF_predict(
+		const KFMatrix_VxV& dfv_dxv, const KFMatrix_VxV& Q,
+		const KFArray_VEH& xv);
+	void SEIF_update(
+		const std::vector<int>& data_association, const KFMatrix_OxO& R);
+	void SEIF_addNewLandmark(
+		const KFMatrix_FxV& dyn_dxv, const KFMatrix_FxF& yn_cov);
+	void SEIF_sparsify(const std::vector<size_t>& observed_lms);
+	void SEIF_recoverMean();
+	/** Calls OnNormalizeStateVector() and updates the information vector
+	 * for any change in the mean. */
+	void SEIF_normalizeStateVector();
+	void SEIF_updateVehicleCov();
+
+	/** @} */
+
    protected:
 	/** The main entry point, executes one complete step: prediction + update.
 	 *  It is protected since derived classes must provide a problem-specific
@@ -670,6 +811,7 @@ MRPT_FILL_ENUM(kfEKFNaive);
 MRPT_FILL_ENUM(kfEKFAlaDavison);
 MRPT_FILL_ENUM(kfIKFFull);
 MRPT_FILL_ENUM(kfIKF);
+MRPT_FILL_ENUM(kfSEIF);
 MRPT_ENUM_TYPE_END()
 
 // Template implementation:
@@ -33,7 +33,28 @@ void CKalmanFilterCapable<
 	m_timLogger.enable(KF_options.enable_profiler);
 	m_timLogger.enter("KF:complete_step");
 
-	ASSERT_(int(m_xkk.size()) == m_pkk.cols());
+	const bool useSEIF = (KF_options.method == kfSEIF);
+	ASSERTMSG_(
+		!useSEIF || FEAT_SIZE != 0,
+		"kfSEIF is only applicable to SLAM problems (FEAT_SIZE>0)");
+
+	if (useSEIF)
+	{
+		// (Re)load the information form from the full covariance, after a
+		// reset or a switch from another method:
+		if (!SEIF_inUse()) SEIF_initFromCovariance();
+		ASSERT_(size_t(m_SEIF.xi.size()) == size_t(m_xkk.size()));
+	}
+	else if (SEIF_inUse())
+	{
+		// Switching from kfSEIF to a covariance-based method:
+		KFMatrix P;
+		getFullCov(P);
+		m_pkk = std::move(P);
+		m_SEIF_active = false;
+	}
+
+	ASSERT_(useSEIF || int(m_xkk.size()) == m_pkk.cols());
 	ASSERT_(size_t(m_xkk.size()) >= VEH_SIZE);
 	// =============================================================
 	//  1. CREATE ACTION MATRIX u FROM ODOMETRY
@@ -131,29 +152,40 @@ void CKalmanFilterCapable<
 		KFMatrix_VxV Q;
 		OnTransitionNoise(Q);
 
-		// ====================================
-		//  3.1:  Pxx submatrix
-		// ====================================
-		// Replace old covariance:
-		m_pkk.asEigen().template block<VEH_SIZE, VEH_SIZE>(0, 0) = Q.asEigen() +
-			dfv_dxv.asEigen() * m_pkk.template block<VEH_SIZE, VEH_SIZE>(0, 0) *
-				dfv_dxv.asEigen().transpose();
-
-		// ====================================
-		//  3.2:  All Pxy_i
-		// ====================================
-		// Now, update the cov. of landmarks, if any:
-		KFMatrix_VxF aux;
-		for (size_t i = 0; i < N_map; i++)
+		if (useSEIF)
 		{
-			aux = dfv_dxv.asEigen() *
-				m_pkk.template block<VEH_SIZE, FEAT_SIZE>(
-					0, VEH_SIZE + i * FEAT_SIZE);
-
-			m_pkk.asEigen().template block<VEH_SIZE, FEAT_SIZE>(
-				0, VEH_SIZE + i * FEAT_SIZE) = aux.asEigen();
-			m_pkk.asEigen().template block<FEAT_SIZE, VEH_SIZE>(
-				VEH_SIZE + i * FEAT_SIZE, 0) = aux.asEigen().transpose();
+			// Update the vehicle and active landmarks blocks of the
+			// information matrix and vector:
+			SEIF_predict(dfv_dxv, Q, xv);
+		}
+		else
+		{
+			// ====================================
+			//  3.1:  Pxx submatrix
+			// ====================================
+			// Replace old covariance:
+			m_pkk.asEigen().template block<VEH_SIZE, VEH_SIZE>(0, 0) =
+				Q.asEigen() +
+				dfv_dxv.asEigen() *
+					m_pkk.template block<VEH_SIZE, VEH_SIZE>(0, 0) *
+					dfv_dxv.asEigen().transpose();
+
+			// ====================================
+			//  3.2:  All Pxy_i
+			// ====================================
+			// Now, update the cov. of landmarks, if any:
+			KFMatrix_VxF aux;
+			for (size_t i = 0; i < N_map; i++)
+			{
+				aux = dfv_dxv.asEigen() *
+					m_pkk.template block<VEH_SIZE, FEAT_SIZE>(
+						0, VEH_SIZE + i * FEAT_SIZE);
+
+				m_pkk.asEigen().template block<VEH_SIZE, FEAT_SIZE>(
+					0, VEH_SIZE + i * FEAT_SIZE) = aux.asEigen();
+				m_pkk.asEigen().template block<FEAT_SIZE, VEH_SIZE>(
+					VEH_SIZE + i * FEAT_SIZE, 0) = aux.asEigen().transpose();
+			}
 		}
 
 		// =============================================================
@@ -163,10 +195,15 @@ void CKalmanFilterCapable<
 			m_xkk[i] = xv[i];
 
 		// Normalize, if neccesary.
-		OnNormalizeStateVector();
+		if (useSEIF) SEIF_normalizeStateVector();
+		else
+			OnNormalizeStateVector();
 
 	}  // end if (!skipPrediction)
 
+	// Keep the vehicle covariance up to date for the user callbacks:
+	if (useSEIF) SEIF_updateVehicleCov();
+
 	const double tim_pred = m_timLogger.leave("KF:2.prediction stage");
 
 	// =============================================================
@@ -365,7 +402,28 @@ void CKalmanFilterCapable<
 		// ------------------------------------------
 		m_S.setSize(N_pred * OBS_SIZE, N_pred * OBS_SIZE);
 
-		if (FEAT_SIZE > 0)
+		if (FEAT_SIZE > 0 && useSEIF)
+		{  // Information form: block-diagonal m_S from the covariance of the
+			// vehicle and each landmark, over their Markov blanket:
+			m_S.setZero();
+			KFMatrix cov;
+			mrpt::math::CMatrixFixed<KFTYPE, OBS_SIZE, VEH_SIZE + FEAT_SIZE> H;
+			for (size_t i = 0; i < N_pred; ++i)
+			{
+				SEIF_getLocalCov(
+					std::vector<size_t>(1, m_predictLMidxs[i]), cov);
+				H.asEigen().template leftCols<VEH_SIZE>() = m_Hxs[i].asEigen();
+				H.asEigen().template rightCols<FEAT_SIZE>() =
+					m_Hys[i].asEigen();
+
+				const size_t obs_idx_off = i * OBS_SIZE;
+				m_S.asEigen().template block<OBS_SIZE, OBS_SIZE>(
+					obs_idx_off, obs_idx_off) =
+					H.asEigen() * cov.asEigen() * H.asEigen().transpose() +
+					R.asEigen();
+			}
+		}
+		else if (FEAT_SIZE > 0)
 		{  // SLAM-like problem:
 			// Covariance of the vehicle pose
 			const auto Px = m_pkk.template block<VEH_SIZE, VEH_SIZE>(0, 0);
@@ -893,14 +951,32 @@ void CKalmanFilterCapable<
 			}
 			break;
 
+			// --------------------------------------------------------------------
+			// - SEIF: add the observations to the information form
+			// --------------------------------------------------------------------
+			case kfSEIF:
+			{
+				SEIF_update(data_association, R);
+			}
+			break;
+
 			default: THROW_EXCEPTION("Invalid value of options.KF_method");
 		}  // end switch method
 	}
 
 	const double tim_update = m_timLogger.leave("KF:8.update stage");
 
+	if (useSEIF)
+	{
+		m_timLogger.enter("KF:9.SEIF recover mean");
+		SEIF_recoverMean();
+		m_timLogger.leave("KF:9.SEIF recover mean");
+	}
+
 	m_timLogger.enter("KF:9.OnNormalizeStateVector");
-	OnNormalizeStateVector();
+	if (useSEIF) SEIF_normalizeStateVector();
+	else
+		OnNormalizeStateVector();
 	m_timLogger.leave("KF:9.OnNormalizeStateVector");
 
 	// =============================================================
@@ -913,6 +989,21 @@ void CKalmanFilterCapable<
 		m_timLogger.leave("KF:A.add new landmarks");
 	}  // end if data_association!=empty
 
+	if (useSEIF)
+	{
+		m_timLogger.enter("KF:A.SEIF sparsification");
+		// Landmarks observed now, known or new, are kept active if possible:
+		std::vector<size_t> observed_lms;
+		for (int i : data_association)
+			if (i >= 0) observed_lms.push_back(static_cast<size_t>(i));
+		for (size_t i = N_map; i < getNumberOfLandmarksInTheMap(); i++)
+			observed_lms.push_back(i);
+
+		SEIF_sparsify(observed_lms);
+		SEIF_updateVehicleCov();
+		m_timLogger.leave("KF:A.SEIF sparsification");
+	}
+
 	// Post iteration user code:
 	m_timLogger.enter("KF:B.OnPostIteration");
 	OnPostIteration();
@@ -979,6 +1070,547 @@ void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
 	out_x = prediction[0];
 }
 
+namespace detail
+{
+/** Marginalizes out the variables [first,first+count) of a dense information
+ * matrix, leaving zeros in their rows and columns. */
+template <class MATRIX>
+MATRIX marginalizeInformation(
+	const MATRIX& O, const size_t first, const size_t count)
+{
+	MATRIX R = O -
+		O.middleCols(first, count) *
+			O.block(first, first, count, count)
+				.llt()
+				.solve(O.middleRows(first, count));
+	R.middleRows(first, count).setZero();
+	R.middleCols(first, count).setZero();
+	return R;
+}
+}  // namespace detail
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	getFullCov(KFMatrix& cov) const
+{
+	MRPT_START
+	if (!SEIF_inUse())
+	{
+		cov = m_pkk;
+		return;
+	}
+	KFMatrix O;
+	SEIF_getLocalInformation(
+		mrpt::math::sequenceStdVec<size_t, 1>(
+			0, getNumberOfLandmarksInTheMap()),
+		O);
+	cov = O.inverse_LLt();
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<
+	VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::SEIF_initFromCovariance()
+{
+	MRPT_START
+	ASSERT_EQUAL_(size_t(m_pkk.rows()), size_t(m_xkk.size()));
+	const size_t N = getNumberOfLandmarksInTheMap();
+
+	// The covariance may be singular, e.g. for a perfectly known initial
+	// vehicle pose:
+	KFMatrix P = m_pkk;
+	if (P.asEigen().llt().info() != Eigen::Success)
+		for (int i = 0; i < P.rows(); i++)
+			P(i, i) += 1e-9;
+	const KFMatrix O = P.inverse_LLt();
+
+	m_SEIF.Ovm.clear();
+	m_SEIF.Omm.assign(N, KFMatrix_FxF());
+	m_SEIF.Omm_links.assign(N, {});
+	SEIF_setLocalInformation(mrpt::math::sequenceStdVec<size_t, 1>(0, N), O);
+	m_SEIF.xi.resize(m_xkk.size());
+	m_SEIF.xi.asEigen() = O.asEigen() * m_xkk.asEigen();
+
+	// From now on, only keep the vehicle covariance:
+	const KFMatrix_VxV Pvv =
+		m_pkk.template blockCopy<VEH_SIZE, VEH_SIZE>(0, 0);
+	m_pkk.setSize(VEH_SIZE, VEH_SIZE);
+	m_pkk.asEigen() = Pvv.asEigen();
+	m_SEIF_active = true;
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_getLocalInformation(const std::vector<size_t>& lms, KFMatrix& O) const
+{
+	const size_t n = VEH_SIZE + FEAT_SIZE * lms.size();
+	O.setZero(n, n);
+
+	std::map<size_t, size_t> offsets;  // landmark index -> offset in O
+	for (size_t k = 0; k < lms.size(); k++)
+		offsets[lms[k]] = VEH_SIZE + FEAT_SIZE * k;
+
+	auto Oe = O.asEigen();
+	Oe.template block<VEH_SIZE, VEH_SIZE>(0, 0) = m_SEIF.Ovv.asEigen();
+	for (const auto& lm_off : offsets)
+	{
+		const size_t lm = lm_off.first, off = lm_off.second;
+		Oe.template block<FEAT_SIZE, FEAT_SIZE>(off, off) =
+			m_SEIF.Omm[lm].asEigen();
+
+		if (const auto it = m_SEIF.Ovm.find(lm); it != m_SEIF.Ovm.end())
+		{
+			Oe.template block<VEH_SIZE, FEAT_SIZE>(0, off) =
+				it->second.asEigen();
+			Oe.template block<FEAT_SIZE, VEH_SIZE>(off, 0) =
+				it->second.asEigen().transpose();
+		}
+		for (const auto& link : m_SEIF.Omm_links[lm])
+		{
+			const auto it = offsets.find(link.first);
+			if (it == offsets.end()) continue;
+			Oe.template block<FEAT_SIZE, FEAT_SIZE>(off, it->second) =
+				link.second.asEigen();
+		}
+	}
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_setLocalInformation(const std::vector<size_t>& lms, const KFMatrix& O)
+{
+	const auto Oe = O.asEigen();
+	m_SEIF.Ovv.asEigen() = Oe.template block<VEH_SIZE, VEH_SIZE>(0, 0);
+	for (size_t a = 0; a < lms.size(); a++)
+	{
+		const size_t lm = lms[a], off = VEH_SIZE + FEAT_SIZE * a;
+
+		const auto Ovm = Oe.template block<VEH_SIZE, FEAT_SIZE>(0, off);
+		if (Ovm.isZero(0)) m_SEIF.Ovm.erase(lm);
+		else
+			m_SEIF.Ovm[lm].asEigen() = Ovm;
+
+		m_SEIF.Omm[lm].asEigen() =
+			Oe.template block<FEAT_SIZE, FEAT_SIZE>(off, off);
+
+		for (size_t b = 0; b < lms.size(); b++)
+		{
+			if (a == b) continue;
+			const auto Oab = Oe.template block<FEAT_SIZE, FEAT_SIZE>(
+				off, VEH_SIZE + FEAT_SIZE * b);
+			if (Oab.isZero(0)) m_SEIF.Omm_links[lm].erase(lms[b]);
+			else
+				m_SEIF.Omm_links[lm][lms[b]].asEigen() = Oab;
+		}
+	}
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_getLocalMean(const std::vector<size_t>& lms, KFVector& mu) const
+{
+	mu.resize(VEH_SIZE + FEAT_SIZE * lms.size());
+	for (size_t i = 0; i < VEH_SIZE; i++)
+		mu[i] = m_xkk[i];
+	for (size_t k = 0; k < lms.size(); k++)
+		for (size_t i = 0; i < FEAT_SIZE; i++)
+			mu[VEH_SIZE + FEAT_SIZE * k + i] =
+				m_xkk[VEH_SIZE + FEAT_SIZE * lms[k] + i];
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_addLocalInformationVector(
+		const std::vector<size_t>& lms, const KFVector& d)
+{
+	auto xi = m_SEIF.xi.asEigen();
+	xi.template head<VEH_SIZE>() += d.asEigen().template head<VEH_SIZE>();
+	for (size_t k = 0; k < lms.size(); k++)
+		xi.template segment<FEAT_SIZE>(VEH_SIZE + FEAT_SIZE * lms[k]) +=
+			d.asEigen().template segment<FEAT_SIZE>(VEH_SIZE + FEAT_SIZE * k);
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_getLocalCov(const std::vector<size_t>& lms, KFMatrix& cov) const
+{
+	MRPT_START
+	// The Markov blanket: the active landmarks (linked to the vehicle) and
+	// those linked to "lms":
+	std::vector<size_t> L = lms;
+	const auto addIfNew = [&L](const size_t lm) {
+		if (std::find(L.begin(), L.end(), lm) == L.end()) L.push_back(lm);
+	};
+	for (const auto& e : m_SEIF.Ovm)
+		addIfNew(e.first);
+	for (const size_t lm : lms)
+		for (const auto& e : m_SEIF.Omm_links[lm])
+			addIfNew(e.first);
+
+	KFMatrix O;
+	SEIF_getLocalInformation(L, O);
+
+	using dense_t = Eigen::Matrix<KFTYPE, Eigen::Dynamic, Eigen::Dynamic>;
+	const Eigen::LLT<dense_t> llt(O.asEigen());
+	ASSERTMSG_(
+		llt.info() == Eigen::Success,
+		"kfSEIF: the information matrix is not positive definite");
+
+	const size_t n = VEH_SIZE + FEAT_SIZE * lms.size();
+	const dense_t X = llt.solve(dense_t::Identity(O.rows(), n));
+	cov.setSize(n, n);
+	cov.asEigen() = X.topRows(n);
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_activeLandmarks(std::vector<size_t>& lms) const
+{
+	lms.clear();
+	lms.reserve(m_SEIF.Ovm.size());
+	for (const auto& e : m_SEIF.Ovm)
+		lms.push_back(e.first);
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_predict(
+		const KFMatrix_VxV& dfv_dxv, const KFMatrix_VxV& Q,
+		const KFArray_VEH& xv)
+{
+	MRPT_START
+	using vxv_t = Eigen::Matrix<KFTYPE, VEH_SIZE, VEH_SIZE>;
+
+	// Only the vehicle and the active landmarks blocks change:
+	std::vector<size_t> lms;
+	SEIF_activeLandmarks(lms);
+	KFMatrix O;
+	SEIF_getLocalInformation(lms, O);
+	KFVector mu;
+	SEIF_getLocalMean(lms, mu);
+
+	auto Oe = O.asEigen();
+	const size_t nm = O.rows() - VEH_SIZE;
+	const KFVector O_mu_old(KFVector(Oe * mu.asEigen()));
+
+	// Phi = A^-T * Omega * A^-1, with A=diag(dfv_dxv,I):
+	const Eigen::FullPivLU<vxv_t> luF(dfv_dxv.asEigen());
+	ASSERTMSG_(
+		luF.isInvertible(),
+		"kfSEIF requires an invertible transition Jacobian");
+	const vxv_t Finv = luF.inverse();
+	Oe.topRows(VEH_SIZE) = (Finv.transpose() * Oe.topRows(VEH_SIZE)).eval();
+	Oe.leftCols(VEH_SIZE) = (Oe.leftCols(VEH_SIZE) * Finv).eval();
+
+	// Add the noise (Woodbury identity), without inverting Q:
+	//  Omega' = Phi - Phi_{:,v} * M * Phi_{v,:},  M = Q*(I + Phi_vv*Q)^-1
+	// For the vehicle rows, this is Omega'_{v,:} = (I + Phi_vv*Q)^-1 Phi_{v,:}
+	const vxv_t T = (vxv_t::Identity() +
+					 Oe.template topLeftCorner<VEH_SIZE, VEH_SIZE>() *
+						 Q.asEigen())
+						.fullPivLu()
+						.inverse();
+	vxv_t M = Q.asEigen() * T;
+	M = (0.5 * (M + M.transpose())).eval();
+
+	if (nm > 0)
+		Oe.bottomRightCorner(nm, nm) -= Oe.bottomLeftCorner(nm, VEH_SIZE) * M *
+			Oe.topRightCorner(VEH_SIZE, nm);
+	Oe.topRows(VEH_SIZE) = (T * Oe.topRows(VEH_SIZE)).eval();
+	Oe.bottomLeftCorner(nm, VEH_SIZE) =
+		Oe.topRightCorner(VEH_SIZE, nm).transpose();
+	Oe.template topLeftCorner<VEH_SIZE, VEH_SIZE>() =
+		(0.5 *
+		 (Oe.template topLeftCorner<VEH_SIZE, VEH_SIZE>() +
+		  Oe.template topLeftCorner<VEH_SIZE, VEH_SIZE>().transpose()))
+			.eval();
+
+	// Keep "xi - Omega*mu" for the new mean:
+	for (size_t i = 0; i < VEH_SIZE; i++)
+		mu[i] = xv[i];
+	KFVector dxi(KFVector(Oe * mu.asEigen()));
+	dxi.asEigen() -= O_mu_old.asEigen();
+
+	SEIF_addLocalInformationVector(lms, dxi);
+	SEIF_setLocalInformation(lms, O);
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_update(const std::vector<int>& data_association, const KFMatrix_OxO& R)
+{
+	MRPT_START
+	const KFMatrix_OxO R_inv = R.inverse_LLt();
+	const KFArray_VEH xv(&m_xkk[0]);
+
+	for (size_t i = 0; i < data_association.size(); ++i)
+	{
+		if (data_association[i] < 0) continue;
+
+		const auto lm = static_cast<size_t>(data_association[i]);
+		const size_t idx_in_pred =
+			mrpt::containers::find_in_vector(lm, m_predictLMidxs);
+		ASSERTMSG_(
+			idx_in_pred != std::string::npos,
+			"OnPreComputingPredictions() didn't recommend the prediction of a "
+			"landmark which has been actually observed!");
+
+		const auto& Hx = m_Hxs[idx_in_pred].asEigen();
+		const auto& Hy = m_Hys[idx_in_pred].asEigen();
+		const size_t lm_off = VEH_SIZE + lm * FEAT_SIZE;
+		const KFArray_FEAT xy(&m_xkk[lm_off]);
+
+		// ytilde = observation - prediction
+		KFArray_OBS ytilde = m_Z[i];
+		OnSubstractObservationVectors(ytilde, m_all_predictions[lm]);
+
+		// Omega += H^t R^-1 H,  xi += H^t R^-1 (ytilde + H*mu)
+		const Eigen::Matrix<KFTYPE, VEH_SIZE, OBS_SIZE> HxtRi =
+			Hx.transpose() * R_inv.asEigen();
+		const Eigen::Matrix<KFTYPE, FEAT_SIZE, OBS_SIZE> HytRi =
+			Hy.transpose() * R_inv.asEigen();
+		const Eigen::Matrix<KFTYPE, OBS_SIZE, 1> r =
+			ytilde.asEigen() + Hx * xv.asEigen() + Hy * xy.asEigen();
+
+		m_SEIF.Ovv.asEigen() += HxtRi * Hx;
+		m_SEIF.Ovm[lm].asEigen() += HxtRi * Hy;
+		m_SEIF.Omm[lm].asEigen() += HytRi * Hy;
+
+		auto xi = m_SEIF.xi.asEigen();
+		xi.template head<VEH_SIZE>() += HxtRi * r;
+		xi.template segment<FEAT_SIZE>(lm_off) += HytRi * r;
+	}
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_addNewLandmark(const KFMatrix_FxV& dyn_dxv, const KFMatrix_FxF& yn_cov)
+{
+	MRPT_START
+	const size_t lm = m_SEIF.Omm.size();
+	const size_t lm_off = VEH_SIZE + lm * FEAT_SIZE;
+	ASSERT_EQUAL_(size_t(m_xkk.size()), lm_off + FEAT_SIZE);
+
+	// The new landmark "y" (already in m_xkk) is linked to the vehicle by the
+	// linearized inverse sensor model: y = yn + G*(xv-mu_v) + noise(yn_cov)
+	const KFMatrix_FxF W = yn_cov.inverse_LLt();
+	const auto& G = dyn_dxv.asEigen();
+	const Eigen::Matrix<KFTYPE, FEAT_SIZE, VEH_SIZE> WG = W.asEigen() * G;
+	const KFArray_VEH xv(&m_xkk[0]);
+	const KFArray_FEAT yn(&m_xkk[lm_off]);
+	const Eigen::Matrix<KFTYPE, FEAT_SIZE, 1> c =
+		yn.asEigen() - G * xv.asEigen();
+
+	m_SEIF.Omm.push_back(W);
+	m_SEIF.Omm_links.emplace_back();
+	m_SEIF.Ovm[lm].asEigen() = -WG.transpose();
+	m_SEIF.Ovv.asEigen() += G.transpose() * WG;
+
+	m_SEIF.xi.resize(lm_off + FEAT_SIZE);
+	auto xi = m_SEIF.xi.asEigen();
+	xi.template segment<FEAT_SIZE>(lm_off) = W.asEigen() * c;
+	xi.template head<VEH_SIZE>() -= WG.transpose() * c;
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_sparsify(const std::vector<size_t>& observed_lms)
+{
+	MRPT_START
+	const size_t maxActive = KF_options.SEIF_max_active_landmarks;
+	if (m_SEIF.Ovm.size() <= maxActive) return;
+
+	// Keep active the landmarks observed now, then those with the strongest
+	// links to the vehicle:
+	struct TCandidate
+	{
+		bool observed;
+		KFTYPE strength;
+		size_t lm;
+	};
+	std::vector<TCandidate> candidates;
+	for (const auto& e : m_SEIF.Ovm)
+		candidates.push_back(
+			{std::find(observed_lms.begin(), observed_lms.end(), e.first) !=
+				 observed_lms.end(),
+			 e.second.asEigen().norm(), e.first});
+	std::sort(
+		candidates.begin(), candidates.end(),
+		[](const TCandidate& a, const TCandidate& b) {
+			if (a.observed != b.observed) return a.observed;
+			if (a.strength != b.strength) return a.strength > b.strength;
+			return a.lm < b.lm;
+		});
+
+	// Local order: vehicle, landmarks to deactivate ("m0"), and the rest of
+	// active landmarks ("m+"):
+	std::vector<size_t> lms;
+	for (size_t k = maxActive; k < candidates.size(); k++)
+		lms.push_back(candidates[k].lm);
+	const size_t n0 = FEAT_SIZE * lms.size();
+	for (size_t k = 0; k < maxActive; k++)
+		lms.push_back(candidates[k].lm);
+
+	KFMatrix O;
+	SEIF_getLocalInformation(lms, O);
+	KFVector mu;
+	SEIF_getLocalMean(lms, mu);
+
+	// Approximate p(x,m+,m0) by removing the links between x and m0, as in
+	// Thrun et al., "Simultaneous localization and mapping with sparse
+	// extended information filters", IJRR 2004:
+	//  Omega~ = Omega1 - Omega2 + Omega3, with Omega over {x,m+,m0} with
+	//  m0 (Omega1) and x,m0 (Omega2) marginalized out, and Omega with x
+	//  marginalized out (Omega3, which only differs in the rows of m+,m0).
+	using dense_t = Eigen::Matrix<KFTYPE, Eigen::Dynamic, Eigen::Dynamic>;
+	const dense_t O_old = O.asEigen();
+	dense_t O_new = detail::marginalizeInformation(O_old, VEH_SIZE, n0) -
+		detail::marginalizeInformation(O_old, 0, VEH_SIZE + n0) +
+		detail::marginalizeInformation(O_old, 0, VEH_SIZE);
+	O_new.block(0, VEH_SIZE, VEH_SIZE, n0).setZero();
+	O_new.block(VEH_SIZE, 0, n0, VEH_SIZE).setZero();
+
+	// xi~ = xi + (Omega~ - Omega)*mu
+	KFVector dxi(KFVector((O_new - O_old) * mu.asEigen()));
+	SEIF_addLocalInformationVector(lms, dxi);
+
+	O.asEigen() = O_new;
+	SEIF_setLocalInformation(lms, O);
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<
+	VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::SEIF_recoverMean()
+{
+	MRPT_START
+	// Update the vehicle, the active landmarks, and some more landmarks in
+	// round-robin order:
+	std::vector<size_t> lms;
+	SEIF_activeLandmarks(lms);
+
+	const size_t N = m_SEIF.Omm.size();
+	const size_t nPassive = KF_options.SEIF_mean_recovery_landmarks == 0
+		? N
+		: std::min<size_t>(N, KF_options.SEIF_mean_recovery_landmarks);
+	for (size_t k = 0; k < nPassive; k++)
+	{
+		lms.push_back(m_SEIF_next_mean_recovery % N);
+		m_SEIF_next_mean_recovery = (m_SEIF_next_mean_recovery + 1) % N;
+	}
+
+	// Gauss-Seidel iterations on "Omega*mu = xi":
+	auto mu = m_xkk.asEigen();
+	const auto xi = m_SEIF.xi.asEigen();
+	for (unsigned int it = 0; it < KF_options.SEIF_mean_recovery_iterations;
+		 it++)
+	{
+		Eigen::Matrix<KFTYPE, VEH_SIZE, 1> bv = xi.template head<VEH_SIZE>();
+		for (const auto& e : m_SEIF.Ovm)
+			bv -= e.second.asEigen() *
+				mu.template segment<FEAT_SIZE>(VEH_SIZE + FEAT_SIZE * e.first);
+		mu.template head<VEH_SIZE>() = m_SEIF.Ovv.asEigen().llt().solve(bv);
+
+		if constexpr (FEAT_SIZE > 0)  // (Always true, if kfSEIF is used)
+		{
+			for (const size_t lm : lms)
+			{
+				const size_t off = VEH_SIZE + FEAT_SIZE * lm;
+				Eigen::Matrix<KFTYPE, FEAT_SIZE, 1> b =
+					xi.template segment<FEAT_SIZE>(off);
+				for (const auto& e : m_SEIF.Omm_links[lm])
+					b -= e.second.asEigen() *
+						mu.template segment<FEAT_SIZE>(
+							VEH_SIZE + FEAT_SIZE * e.first);
+				if (const auto itV = m_SEIF.Ovm.find(lm);
+					itV != m_SEIF.Ovm.end())
+					b -= itV->second.asEigen().transpose() *
+						mu.template head<VEH_SIZE>();
+				mu.template segment<FEAT_SIZE>(off) =
+					m_SEIF.Omm[lm].asEigen().llt().solve(b);
+			}
+		}
+	}
+	MRPT_END
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::
+	SEIF_normalizeStateVector()
+{
+	const KFVector old_mu = m_xkk;
+	OnNormalizeStateVector();
+
+	// Keep "xi - Omega*mu" for the changed parts of the mean:
+	const auto d = (m_xkk.asEigen() - old_mu.asEigen()).eval();
+	auto xi = m_SEIF.xi.asEigen();
+
+	const Eigen::Matrix<KFTYPE, VEH_SIZE, 1> dv = d.template head<VEH_SIZE>();
+	if (!dv.isZero(0))
+	{
+		xi.template head<VEH_SIZE>() += m_SEIF.Ovv.asEigen() * dv;
+		for (const auto& e : m_SEIF.Ovm)
+			xi.template segment<FEAT_SIZE>(VEH_SIZE + FEAT_SIZE * e.first) +=
+				e.second.asEigen().transpose() * dv;
+	}
+	for (size_t lm = 0; lm < m_SEIF.Omm.size(); lm++)
+	{
+		const size_t off = VEH_SIZE + FEAT_SIZE * lm;
+		const Eigen::Matrix<KFTYPE, FEAT_SIZE, 1> dl =
+			d.template segment<FEAT_SIZE>(off);
+		if (dl.isZero(0)) continue;
+
+		xi.template segment<FEAT_SIZE>(off) += m_SEIF.Omm[lm].asEigen() * dl;
+		for (const auto& e : m_SEIF.Omm_links[lm])
+			xi.template segment<FEAT_SIZE>(VEH_SIZE + FEAT_SIZE * e.first) +=
+				e.second.asEigen().transpose() * dl;
+		if (const auto itV = m_SEIF.Ovm.find(lm); itV != m_SEIF.Ovm.end())
+			xi.template head<VEH_SIZE>() += itV->second.asEigen() * dl;
+	}
+}
+
+template <
+	size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE,
+	typename KFTYPE>
+void CKalmanFilterCapable<
+	VEH_SIZE, OBS_SIZE, FEAT_SIZE, ACT_SIZE, KFTYPE>::SEIF_updateVehicleCov()
+{
+	SEIF_getLocalCov({}, m_pkk);
+}
+
 namespace detail
 {
 // generic version for SLAM. There is a speciation below for NON-SLAM problems.
@@ -1041,6 +1673,20 @@ void addNewLandmarks(
 			for (q = 0; q < FEAT_SIZE; q++)
 				obj.internal_getXkk()[idx + q] = yn[q];
 
+			if (obj.KF_options.method == kfSEIF)
+			{
+				// Information form: add the landmark, linked to the vehicle
+				// by the inverse sensor model.
+				obj.SEIF_addNewLandmark(
+					dyn_dxv,
+					use_dyn_dhn_jacobian
+						? typename KF::KFMatrix_FxF(
+							  mrpt::math::multiply_HCHt(dyn_dhn, R))
+						: dyn_dhn_R_dyn_dhnT);
+				obj.getProfiler().leave("KF:9.create new LMs");
+				continue;
+			}
+
 			// --------------------
 			// Append to Pkk:
 			// --------------------
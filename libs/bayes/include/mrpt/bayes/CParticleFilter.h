@@ -163,6 +163,39 @@ class CParticleFilter : public mrpt::system::COutputLogger
 		 * perform rejection sampling, but just the most-likely (ML) particle
 		 * found in the preliminary weight-determination stage. */
 		bool pfAuxFilterOptimal_MLE{false};
+
+		/** Number of worker threads used to evaluate the per-particle
+		 * observation likelihoods and to draw samples from the motion model
+		 * (default=1: everything runs serially in the calling thread).
+		 * Set to 0 to use as many threads as CPU cores.
+		 *
+		 * Only honored by the PF algorithms implemented in
+		 * mrpt::slam::PF_implementation (e.g.
+		 * mrpt::slam::CMonteCarloLocalization2D), and only for the steps
+		 * that do not depend on previous samples: the KLD adaptive sample
+		 * size drawing loop always runs serially.
+		 * Particles are split into chunks of #parallelChunkSize and each chunk
+		 * draws its random numbers from its own generator, seeded from
+		 * mrpt::random::getRandomGenerator(), so for a fixed seed results are
+		 * the same for any parallelThreads!=1. With parallelThreads==1 the
+		 * global generator is used directly, so results differ from those of
+		 * the multi-threaded runs.
+		 * \note The metric map observation likelihood must be safe to be
+		 * evaluated concurrently from several threads. For
+		 * mrpt::maps::COccupancyGridMap2D, the methods writing into shared
+		 * state (`lmConsensusOWA`, and `lmLikelihoodField_Thrun` with
+		 * `enableLikelihoodCache=true`) take an internal lock, so they are
+		 * safe but evaluated one particle at a time.
+		 * \note (New in MRPT 2.7.1)
+		 */
+		unsigned int parallelThreads{1};
+
+		/** Number of particles in each work unit when parallelThreads!=1.
+		 * Changing it changes the random streams used for each particle, so
+		 * keep it fixed for reproducible results (default=64).
+		 * \note (New in MRPT 2.7.1)
+		 */
+		unsigned int parallelChunkSize{64};
 	};
 
 	/** Statistics for being returned from the "execute" method. */
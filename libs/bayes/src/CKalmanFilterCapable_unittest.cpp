@@ -0,0 +1,289 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/bayes/CKalmanFilterCapable.h>
+#include <mrpt/math/TPoint2D.h>
+#include <mrpt/random.h>
+
+#include <map>
+
+using namespace mrpt;
+using namespace mrpt::bayes;
+using namespace std;
+
+namespace
+{
+// A linear 2D SLAM problem: the vehicle state is its (x,y) position, and
+// each observation is the position of one landmark relative to the vehicle.
+class LinearSLAM2D : public CKalmanFilterCapable<2, 2, 2, 2>
+{
+   public:
+	struct TStep
+	{
+		KFArray_ACT u;
+		std::vector<std::pair<size_t, KFArray_OBS>> obs;  // (Landmark ID,z)
+	};
+
+	static constexpr double STD_ODO = 0.05, STD_OBS = 0.1;
+
+	explicit LinearSLAM2D(TKFMethod method)
+	{
+		KF_options.method = method;
+		m_xkk.resize(2);
+		m_xkk.fill(0);
+		m_pkk.setZero(2, 2);
+	}
+
+	void processStep(const TStep& s)
+	{
+		m_step = &s;
+		runOneKalmanIteration();
+	}
+
+	void getState(KFVector& x, KFMatrix& cov) const
+	{
+		x = m_xkk;
+		getFullCov(cov);
+	}
+
+	bool informationFormInUse() const { return m_SEIF_active; }
+
+	std::map<size_t, size_t> m_IDs;	 // Landmark ID -> index in the map
+
+   protected:
+	const TStep* m_step = nullptr;
+	std::vector<size_t> m_obsIDs;
+
+	void OnGetAction(KFArray_ACT& out_u) const override { out_u = m_step->u; }
+	void OnTransitionModel(
+		const KFArray_ACT& in_u, KFArray_VEH& inout_x,
+		bool& out_skipPrediction) const override
+	{
+		inout_x += in_u;
+		out_skipPrediction = false;
+	}
+	void OnTransitionJacobian(KFMatrix_VxV& F) const override
+	{
+		F.setIdentity();
+	}
+	void OnTransitionNoise(KFMatrix_VxV& Q) const override
+	{
+		Q.setDiagonal(2, square(STD_ODO));
+	}
+	void OnGetObservationNoise(KFMatrix_OxO& R) const override
+	{
+		R.setDiagonal(2, square(STD_OBS));
+	}
+	void OnGetObservationsAndDataAssociation(
+		vector_KFArray_OBS& out_z, std::vector<int>& out_data_association,
+		const vector_KFArray_OBS&, const KFMatrix&, const std::vector<size_t>&,
+		const KFMatrix_OxO&) override
+	{
+		out_z.clear();
+		out_data_association.clear();
+		m_obsIDs.clear();
+		for (const auto& o : m_step->obs)
+		{
+			out_z.push_back(o.second);
+			const auto it = m_IDs.find(o.first);
+			out_data_association.push_back(
+				it == m_IDs.end() ? -1 : static_cast<int>(it->second));
+			m_obsIDs.push_back(o.first);
+		}
+	}
+	void OnObservationModel(
+		const std::vector<size_t>& idx_landmarks_to_predict,
+		vector_KFArray_OBS& out_predictions) const override
+	{
+		out_predictions.clear();
+		for (const size_t i : idx_landmarks_to_predict)
+		{
+			KFArray_OBS z;
+			for (int k = 0; k < 2; k++)
+				z[k] = m_xkk[2 + 2 * i + k] - m_xkk[k];
+			out_predictions.push_back(z);
+		}
+	}
+	void OnObservationJacobians(
+		size_t, KFMatrix_OxV& Hx, KFMatrix_OxF& Hy) const override
+	{
+		Hx.setDiagonal(2, -1.0);
+		Hy.setIdentity();
+	}
+	void OnInverseObservationModel(
+		const KFArray_OBS& in_z, KFArray_FEAT& out_yn,
+		KFMatrix_FxV& out_dyn_dxv, KFMatrix_FxO& out_dyn_dhn) const override
+	{
+		for (int k = 0; k < 2; k++)
+			out_yn[k] = m_xkk[k] + in_z[k];
+		out_dyn_dxv.setIdentity();
+		out_dyn_dhn.setIdentity();
+	}
+	void OnNewLandmarkAddedToMap(
+		const size_t in_obsIdx, const size_t in_idxNewFeat) override
+	{
+		m_IDs[m_obsIDs.at(in_obsIdx)] = in_idxNewFeat;
+	}
+};
+
+// A vehicle moving along a row of landmarks, and back:
+std::vector<LinearSLAM2D::TStep> generateDataset(
+	std::vector<mrpt::math::TPoint2D>& landmarks)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(1234);
+
+	landmarks.clear();
+	for (int i = 0; i < 20; i++)
+		landmarks.emplace_back(i, (i % 2) ? 1.5 : -1.5);
+
+	std::vector<LinearSLAM2D::TStep> steps;
+	mrpt::math::TPoint2D veh(0, 0);
+	for (int t = 0; t < 60; t++)
+	{
+		LinearSLAM2D::TStep s;
+		const double dx = t < 30 ? 0.6 : -0.6;
+		veh.x += dx + rng.drawGaussian1D(0, LinearSLAM2D::STD_ODO);
+		veh.y += rng.drawGaussian1D(0, LinearSLAM2D::STD_ODO);
+		s.u[0] = dx;
+		s.u[1] = 0;
+
+		for (size_t i = 0; i < landmarks.size(); i++)
+		{
+			if ((landmarks[i] - veh).norm() > 4.0) continue;
+			LinearSLAM2D::KFArray_OBS z;
+			z[0] = landmarks[i].x - veh.x +
+				rng.drawGaussian1D(0, LinearSLAM2D::STD_OBS);
+			z[1] = landmarks[i].y - veh.y +
+				rng.drawGaussian1D(0, LinearSLAM2D::STD_OBS);
+			s.obs.emplace_back(i, z);
+		}
+		steps.push_back(s);
+	}
+	return steps;
+}
+}  // namespace
+
+TEST(CKalmanFilterCapable, SEIF_vs_EKF)
+{
+	std::vector<mrpt::math::TPoint2D> landmarks;
+	const auto steps = generateDataset(landmarks);
+
+	LinearSLAM2D ekf(kfEKFNaive), seif(kfSEIF);
+	// Without sparsification and with a full mean recovery, the information
+	// form must give the same estimate than the EKF:
+	seif.KF_options.SEIF_max_active_landmarks = 1000;
+	seif.KF_options.SEIF_mean_recovery_landmarks = 0;
+	seif.KF_options.SEIF_mean_recovery_iterations = 200;
+
+	for (const auto& s : steps)
+	{
+		ekf.processStep(s);
+		seif.processStep(s);
+	}
+
+	LinearSLAM2D::KFVector x_ekf, x_seif;
+	LinearSLAM2D::KFMatrix cov_ekf, cov_seif;
+	ekf.getState(x_ekf, cov_ekf);
+	seif.getState(x_seif, cov_seif);
+
+	ASSERT_EQ(ekf.getNumberOfLandmarksInTheMap(), landmarks.size());
+	ASSERT_EQ(x_ekf.size(), x_seif.size());
+	EXPECT_EQ(ekf.m_IDs, seif.m_IDs);
+	for (int i = 0; i < x_ekf.size(); i++)
+		EXPECT_NEAR(x_ekf[i], x_seif[i], 1e-4) << "i=" << i;
+	for (int i = 0; i < cov_ekf.rows(); i++)
+		for (int j = 0; j < cov_ekf.cols(); j++)
+			EXPECT_NEAR(cov_ekf(i, j), cov_seif(i, j), 1e-6)
+				<< "i=" << i << " j=" << j;
+
+	LinearSLAM2D::KFMatrix_FxF lmCov;
+	seif.getLandmarkCov(5, lmCov);
+	for (int i = 0; i < 2; i++)
+		for (int j = 0; j < 2; j++)
+			EXPECT_NEAR(lmCov(i, j), cov_ekf(2 + 10 + i, 2 + 10 + j), 1e-6);
+}
+
+TEST(CKalmanFilterCapable, SEIF_sparsification)
+{
+	std::vector<mrpt::math::TPoint2D> landmarks;
+	const auto steps = generateDataset(landmarks);
+
+	LinearSLAM2D seif(kfSEIF);
+	seif.KF_options.SEIF_max_active_landmarks = 4;
+	seif.KF_options.SEIF_mean_recovery_landmarks = 5;
+
+	for (const auto& s : steps)
+	{
+		seif.processStep(s);
+		EXPECT_LE(seif.getNumberOfActiveLandmarks(), 4U);
+	}
+
+	// Sparsification is an approximation, but the map must be still close to
+	// the ground truth, with the first landmark as reference:
+	ASSERT_EQ(seif.getNumberOfLandmarksInTheMap(), landmarks.size());
+	LinearSLAM2D::KFArray_FEAT lm0;
+	LinearSLAM2D::KFMatrix_FxF lm0_cov;
+	seif.getLandmarkMean(seif.m_IDs.at(0), lm0);
+	seif.getLandmarkCov(seif.m_IDs.at(0), lm0_cov);
+	EXPECT_GT(lm0_cov(0, 0), 0);
+	for (size_t i = 0; i < landmarks.size(); i++)
+	{
+		LinearSLAM2D::KFArray_FEAT lm;
+		seif.getLandmarkMean(seif.m_IDs.at(i), lm);
+		const auto gt = landmarks[i] - landmarks[0];
+		EXPECT_NEAR(lm[0] - lm0[0], gt.x, 0.5) << "landmark: " << i;
+		EXPECT_NEAR(lm[1] - lm0[1], gt.y, 0.5) << "landmark: " << i;
+	}
+}
+
+TEST(CKalmanFilterCapable, SEIF_emptyMap)
+{
+	std::vector<mrpt::math::TPoint2D> landmarks;
+	auto steps = generateDataset(landmarks);
+	// No landmark seen in the first steps:
+	for (size_t t = 0; t < 5; t++)
+		steps[t].obs.clear();
+
+	LinearSLAM2D ekf(kfEKFNaive), seif(kfSEIF);
+	EXPECT_FALSE(seif.informationFormInUse());
+
+	for (size_t t = 0; t < 5; t++)
+	{
+		ekf.processStep(steps[t]);
+		seif.processStep(steps[t]);
+		// The information form must be kept, even without landmarks:
+		EXPECT_TRUE(seif.informationFormInUse());
+		EXPECT_EQ(seif.getNumberOfLandmarksInTheMap(), 0U);
+
+		LinearSLAM2D::KFVector x_ekf, x_seif;
+		LinearSLAM2D::KFMatrix cov_ekf, cov_seif;
+		ekf.getState(x_ekf, cov_ekf);
+		seif.getState(x_seif, cov_seif);
+		ASSERT_EQ(cov_seif.rows(), 2);
+		// (Up to the regularization of the initial, singular, covariance)
+		for (int i = 0; i < 2; i++)
+		{
+			EXPECT_NEAR(x_ekf[i], x_seif[i], 1e-9);
+			for (int j = 0; j < 2; j++)
+				EXPECT_NEAR(cov_ekf(i, j), cov_seif(i, j), 1e-8);
+		}
+	}
+
+	// Switching to the EKF brings back the full covariance:
+	seif.KF_options.method = kfEKFNaive;
+	seif.processStep(steps[5]);
+	EXPECT_FALSE(seif.informationFormInUse());
+	LinearSLAM2D::KFVector x;
+	LinearSLAM2D::KFMatrix cov;
+	seif.getState(x, cov);
+	EXPECT_EQ(cov.rows(), x.size());
+	EXPECT_GT(seif.getNumberOfLandmarksInTheMap(), 0U);
+}
@@ -136,6 +136,12 @@ void CParticleFilter::TParticleFilterOptions::saveToConfigFile(
 		pfAuxFilterStandard_FirstStageWeightsMonteCarlo,
 		"Only for PF_algorithm==pfAuxiliaryPFStandard");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(pfAuxFilterOptimal_MLE, "See doxygen docs.");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		parallelThreads,
+		"Number of threads for likelihood evaluation and motion sampling "
+		"(1=serial, 0=all CPU cores)");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		parallelChunkSize, "Particles per work unit in parallel mode");
 }
 
 /*---------------------------------------------------------------
@@ -178,6 +184,9 @@ void CParticleFilter::TParticleFilterOptions::loadFromConfigFile(
 		section.c_str());
 	MRPT_LOAD_CONFIG_VAR(
 		pfAuxFilterOptimal_MLE, bool, iniFile, section.c_str());
+	MRPT_LOAD_CONFIG_VAR(parallelThreads, int, iniFile, section.c_str());
+	MRPT_LOAD_CONFIG_VAR(parallelChunkSize, int, iniFile, section.c_str());
+	ASSERT_GT_(parallelChunkSize, 0U);
 
 	MRPT_END
 }
@@ -12,12 +12,18 @@
 #include <mrpt/typemeta/TTypeName_stl.h>
 
 #include <any>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <iostream>
-#include <list>
 #include <memory>  // shared_ptr
 #include <mutex>
+#include <thread>
+#include <typeindex>
 #include <unordered_map>
+#include <vector>
 
 namespace mrpt::comms
 {
@@ -28,8 +34,9 @@ class Subscriber
 {
    private:
 	Subscriber(
-		std::function<void(const std::any&)>&& func,
-		std::function<void()>&& cleanup);
+		std::type_index type, std::function<void(const std::any&)>&& func,
+		std::function<void(const void*)>&& typedFunc,
+		std::function<void()>&& cleanup, std::size_t asyncQueueLength);
 
    public:
 	using Ptr = std::shared_ptr<Subscriber>;
@@ -39,11 +46,53 @@ class Subscriber
 		std::function<void(const std::any&)>&& func,
 		std::function<void()>&& cleanup);
 
+	/** Creates a subscriber for messages of the given type, which can be
+	 * received either as std::any (via `func`) or as a pointer to the shared
+	 * message object (via `typedFunc`). If `asyncQueueLength>0`, messages are
+	 * delivered from a dedicated thread, see Topic::createSubscriber().
+	 * \note (New in MRPT 2.7.1) */
+	static Ptr create(
+		std::type_index type, std::function<void(const std::any&)>&& func,
+		std::function<void(const void*)>&& typedFunc,
+		std::function<void()>&& cleanup, std::size_t asyncQueueLength = 0);
+
 	void pub(const std::any& a);
 
+	/** Delivers a shared message whose type is `type`. Subscribers created
+	 * without a type (the std::any-only create() overload) ignore it.
+	 * \note (New in MRPT 2.7.1) */
+	void pubShared(
+		std::type_index type, const std::shared_ptr<const void>& msg);
+
+	/** Number of messages discarded so far because the asynchronous queue
+	 * was full.
+	 * \note (New in MRPT 2.7.1) */
+	std::size_t droppedMessages() const { return m_dropped; }
+
    private:
+	std::type_index m_type;
 	std::function<void(const std::any&)> m_func;
+	std::function<void(const void*)> m_typedFunc;
 	std::function<void()> m_cleanup;
+
+	/** Pending messages, for asynchronous delivery only */
+	struct QueuedMsg
+	{
+		std::shared_ptr<const void> msg;
+		bool isAny = false;	 //!< msg is a std::any, for m_func
+	};
+	std::size_t m_queueLength = 0;
+	std::deque<QueuedMsg> m_queue;
+	std::mutex m_queueMtx;
+	std::condition_variable m_queueCv;
+	bool m_stop = false;
+	std::atomic_size_t m_dropped{0};
+	std::thread m_thread;
+
+	void enqueue(QueuedMsg&& m);
+	void deliver(const QueuedMsg& m);
+	void asyncThread();
+	void wrongType() const;
 };
 
 class Topic : public std::enable_shared_from_this<Topic>
@@ -56,39 +105,76 @@ class Topic : public std::enable_shared_from_this<Topic>
 
 	~Topic();
 
+	/** Creates a new subscriber to messages of type `ARG`, which will be
+	 * passed to `func` as `const ARG&`.
+	 *
+	 * By default, messages are delivered synchronously from the publisher
+	 * thread. If `asyncQueueLength>0`, the subscriber owns a thread and a
+	 * queue of up to that number of pending messages: publishers only append
+	 * to it, and the oldest messages are discarded when it is full, so a slow
+	 * subscriber never blocks publishers. Messages published with
+	 * publishShared() are queued without copies. Destroying an asynchronous
+	 * subscriber waits until all its queued messages are delivered, hence
+	 * it must not be destroyed from within its own callback.
+	 *
+	 * Publishers hold a temporary reference to each subscriber while
+	 * delivering a message to it. If the last user reference is released
+	 * meanwhile, the subscriber is destroyed by the publisher thread, which
+	 * then waits for the asynchronous queue (if any) to be drained.
+	 */
 	template <typename ARG, typename Callable>
-	Subscriber::Ptr createSubscriber(Callable&& func)
+	Subscriber::Ptr createSubscriber(
+		Callable&& func, std::size_t asyncQueueLength = 0)
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
-		m_subs.emplace_back();
-		auto it = m_subs.end();
-		it--;
 		auto capturedShared = shared_from_this();
+		const uint64_t id = m_nextSubscriberId++;
+		auto f = std::make_shared<std::decay_t<Callable>>(
+			std::forward<Callable>(func));
 		auto newNode = Subscriber::create(
-			[func{std::forward<Callable>(func)}](const std::any& anyArg) {
-				try
-				{
-					std::invoke(func, std::any_cast<const ARG&>(anyArg));
-				}
-				catch (std::bad_any_cast&)
-				{
+			std::type_index(typeid(ARG)),
+			[f](const std::any& anyArg) {
+				const auto* arg = std::any_cast<ARG>(&anyArg);
+				if (arg) std::invoke(*f, *arg);
+				else
 					std::cerr << "Subscriber has wrong type: "
 							  << mrpt::typemeta::TTypeName<ARG>::get()
 							  << std::endl;
-				}
+			},
+			[f](const void* msg) {
+				std::invoke(*f, *static_cast<const ARG*>(msg));
 			},
 			// cleanup function
-			[=] {
-				// list operations don't invalidate iterators
-				// This iterator capture will be valid
-				capturedShared->cleanupSubscriber(it);
-			});
-		*it = newNode;
+			[=] { capturedShared->cleanupSubscriber(id); }, asyncQueueLength);
+		addSubscriber(id, newNode);
 		return newNode;
 	}
 
+	/** Publishes a message to all subscribers, as a copy stored in std::any.
+	 */
 	void publish(const std::any& any);
-	void cleanupSubscriber(std::list<std::weak_ptr<Subscriber>>::iterator it);
+
+	/** Publishes a message shared by all subscribers, without copies.
+	 * The object must not be modified afterwards, since subscribers may
+	 * still be reading it from other threads. Subscribers are found without
+	 * locking the topic mutex, and their type is checked without
+	 * std::any_cast.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	template <typename T>
+	void publishShared(const std::shared_ptr<T>& msg)
+	{
+		publishShared(
+			std::type_index(typeid(std::remove_cv_t<T>)),
+			std::shared_ptr<const void>(msg));
+	}
+	/** \overload */
+	void publishShared(
+		std::type_index type, const std::shared_ptr<const void>& msg);
+
+	void cleanupSubscriber(uint64_t id);
+
+	/** Number of current subscribers. */
+	std::size_t subscriberCount() const;
 
 	template <typename CLEANUP>
 	static Ptr create(CLEANUP&& cleanup)
@@ -97,9 +183,27 @@ class Topic : public std::enable_shared_from_this<Topic>
 	}
 
    private:
+	struct SubscriberEntry
+	{
+		uint64_t id;
+		std::weak_ptr<Subscriber> sub;
+	};
+	using subscriber_list_t = std::vector<SubscriberEntry>;
+
+	/** Mutex for writers only (new or deleted subscribers) */
 	std::mutex m_mutex;
-	std::list<std::weak_ptr<Subscriber>> m_subs;
+	/** Immutable list of subscribers, replaced as a whole by writers and
+	 * read by publishers via std::atomic_load() (RCU-like). Publishers never
+	 * wait for writers, but note that standard libraries implement these
+	 * shared_ptr atomic accesses with a short internal lock. */
+	std::shared_ptr<const subscriber_list_t> m_subs =
+		std::make_shared<subscriber_list_t>();
+	std::atomic<uint64_t> m_nextSubscriberId{0};
 	std::function<void()> m_cleanup;
+
+	void addSubscriber(uint64_t id, const Subscriber::Ptr& s);
+	std::shared_ptr<const subscriber_list_t> subscribers() const;
+	void setSubscribers(std::shared_ptr<const subscriber_list_t>&& subs);
 };
 
 /** The central directory of existing topics for pub/sub */
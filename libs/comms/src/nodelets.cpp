@@ -15,39 +15,163 @@ using namespace mrpt::comms;
 
 // ------- Subscriber --------------
 Subscriber::Subscriber(
-	std::function<void(const std::any&)>&& func,
-	std::function<void()>&& cleanup)
-	: m_func(std::move(func)), m_cleanup(std::move(cleanup))
+	std::type_index type, std::function<void(const std::any&)>&& func,
+	std::function<void(const void*)>&& typedFunc,
+	std::function<void()>&& cleanup, std::size_t asyncQueueLength)
+	: m_type(type),
+	  m_func(std::move(func)),
+	  m_typedFunc(std::move(typedFunc)),
+	  m_cleanup(std::move(cleanup)),
+	  m_queueLength(asyncQueueLength)
 {
+	if (m_queueLength > 0) m_thread = std::thread([this]() { asyncThread(); });
+}
+
+Subscriber::~Subscriber()
+{
+	if (m_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lck(m_queueMtx);
+			m_stop = true;
+		}
+		m_queueCv.notify_one();
+		m_thread.join();
+	}
+	m_cleanup();
 }
 
-Subscriber::~Subscriber() { m_cleanup(); }
 Subscriber::Ptr Subscriber::create(
 	std::function<void(const std::any&)>&& func,
 	std::function<void()>&& cleanup)
 {
-	return Ptr(new Subscriber(std::move(func), std::move(cleanup)));
+	return Ptr(new Subscriber(
+		std::type_index(typeid(void)), std::move(func), {}, std::move(cleanup),
+		0));
+}
+
+Subscriber::Ptr Subscriber::create(
+	std::type_index type, std::function<void(const std::any&)>&& func,
+	std::function<void(const void*)>&& typedFunc,
+	std::function<void()>&& cleanup, std::size_t asyncQueueLength)
+{
+	return Ptr(new Subscriber(
+		type, std::move(func), std::move(typedFunc), std::move(cleanup),
+		asyncQueueLength));
+}
+
+void Subscriber::pub(const std::any& a)
+{
+	if (m_queueLength == 0) m_func(a);
+	else
+		enqueue({std::make_shared<const std::any>(a), true});
+}
+
+void Subscriber::pubShared(
+	std::type_index type, const std::shared_ptr<const void>& msg)
+{
+	// Subscribers created without a type only receive std::any messages:
+	if (!m_typedFunc) return;
+	if (type != m_type) return wrongType();
+
+	if (m_queueLength == 0) m_typedFunc(msg.get());
+	else
+		enqueue({msg, false});
+}
+
+void Subscriber::wrongType() const
+{
+	std::cerr << "Subscriber has wrong type: " << m_type.name() << std::endl;
+}
+
+void Subscriber::enqueue(QueuedMsg&& m)
+{
+	{
+		std::lock_guard<std::mutex> lck(m_queueMtx);
+		if (m_queue.size() >= m_queueLength)
+		{
+			m_queue.pop_front();
+			m_dropped++;
+		}
+		m_queue.emplace_back(std::move(m));
+	}
+	m_queueCv.notify_one();
+}
+
+void Subscriber::deliver(const QueuedMsg& m)
+{
+	if (m.isAny) m_func(*std::static_pointer_cast<const std::any>(m.msg));
+	else
+		m_typedFunc(m.msg.get());
+}
+
+void Subscriber::asyncThread()
+{
+	for (;;)
+	{
+		QueuedMsg m;
+		{
+			std::unique_lock<std::mutex> lck(m_queueMtx);
+			m_queueCv.wait(
+				lck, [this]() { return m_stop || !m_queue.empty(); });
+			// Deliver all pending messages before quitting:
+			if (m_queue.empty()) return;
+			m = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+		deliver(m);
+	}
 }
 
-void Subscriber::pub(const std::any& a) { m_func(a); }
 // ------- Topic --------------
 Topic::Topic(std::function<void()>&& cleanup) : m_cleanup(std::move(cleanup)) {}
 Topic::~Topic() { m_cleanup(); }
 void Topic::publish(const std::any& any)
+{
+	const auto subs = subscribers();
+	for (const auto& e : *subs)
+		if (auto sub = e.sub.lock(); sub) sub->pub(any);
+}
+
+void Topic::publishShared(
+	std::type_index type, const std::shared_ptr<const void>& msg)
+{
+	const auto subs = subscribers();
+	for (const auto& e : *subs)
+		if (auto sub = e.sub.lock(); sub) sub->pubShared(type, msg);
+}
+
+// std::atomic<std::shared_ptr> would require C++20 in all the user code
+// including nodelets.h, since it changes the layout of Topic:
+std::shared_ptr<const Topic::subscriber_list_t> Topic::subscribers() const
+{
+	return std::atomic_load(&m_subs);
+}
+
+void Topic::setSubscribers(std::shared_ptr<const subscriber_list_t>&& subs)
+{
+	std::atomic_store(&m_subs, std::move(subs));
+}
+
+void Topic::addSubscriber(uint64_t id, const Subscriber::Ptr& s)
 {
 	std::lock_guard<std::mutex> lock(m_mutex);
-	for (auto& sub : m_subs)
-	{
-		sub.lock()->pub(any);
-	}
+	auto newList = std::make_shared<subscriber_list_t>(*subscribers());
+	newList->push_back({id, s});
+	setSubscribers(std::move(newList));
 }
 
-void Topic::cleanupSubscriber(std::list<std::weak_ptr<Subscriber>>::iterator it)
+void Topic::cleanupSubscriber(uint64_t id)
 {
 	std::lock_guard<std::mutex> lock(m_mutex);
-	m_subs.erase(it);
+	auto newList = std::make_shared<subscriber_list_t>();
+	for (const auto& e : *subscribers())
+		if (e.id != id) newList->push_back(e);
+	setSubscribers(std::move(newList));
 }
 
+std::size_t Topic::subscriberCount() const { return subscribers()->size(); }
+
 // -------------- TopicDirectory ---------------------
 TopicDirectory::TopicDirectory() = default;
 
@@ -18,3 +18,95 @@ TEST(NodeletsTests, pub_sub_multithread_test)
 	NodeletsTest();
 	EXPECT_TRUE(nodelets_test_passed_ok);
 }
+
+TEST(NodeletsTests, publishShared)
+{
+	auto topicDir = mrpt::comms::TopicDirectory::create();
+	auto topic = topicDir->getTopic("/test/shared");
+
+	const mrpt::math::TPose3D* rxAddr = nullptr;
+	int rxCount = 0;
+	auto sub = topic->createSubscriber<mrpt::math::TPose3D>(
+		[&](const mrpt::math::TPose3D& p) {
+			rxAddr = &p;
+			rxCount++;
+		});
+	EXPECT_EQ(topic->subscriberCount(), 1U);
+
+	// No copies: the subscriber gets the published object itself.
+	auto msg = std::make_shared<const mrpt::math::TPose3D>(p_tx);
+	topic->publishShared(msg);
+	EXPECT_EQ(rxCount, 1);
+	EXPECT_EQ(rxAddr, msg.get());
+
+	// Messages of another type are not delivered:
+	topic->publishShared(std::make_shared<int>(1));
+	EXPECT_EQ(rxCount, 1);
+
+	// std::any path still works:
+	topic->publish(p_tx);
+	EXPECT_EQ(rxCount, 2);
+
+	sub.reset();
+	EXPECT_EQ(topic->subscriberCount(), 0U);
+	topic->publishShared(msg);
+	EXPECT_EQ(rxCount, 2);
+}
+
+TEST(NodeletsTests, asyncSubscriber)
+{
+	using namespace std::chrono_literals;
+
+	auto topicDir = mrpt::comms::TopicDirectory::create();
+	auto topic = topicDir->getTopic("/test/async");
+
+	std::mutex mtx;
+	std::condition_variable cv;
+	bool release = false;
+	std::atomic_int rxCount{0};
+	std::atomic_bool entered{false};
+	auto slowSub = topic->createSubscriber<int>(
+		[&](const int&) {
+			entered = true;
+			std::unique_lock<std::mutex> lck(mtx);
+			cv.wait(lck, [&]() { return release; });
+			rxCount++;
+		},
+		2 /*queue length*/);
+
+	// A blocked subscriber must not block the publisher:
+	topic->publishShared(std::make_shared<int>(0));
+	for (int i = 0; i < 200 && !entered; i++)
+		std::this_thread::sleep_for(5ms);
+	ASSERT_TRUE(entered);
+	for (int i = 1; i < 10; i++)
+		topic->publishShared(std::make_shared<int>(i));
+
+	EXPECT_EQ(slowSub->droppedMessages(), 7U);
+
+	{
+		std::lock_guard<std::mutex> lck(mtx);
+		release = true;
+	}
+	cv.notify_all();
+
+	// Destroying the subscriber delivers the pending messages: the first one
+	// (being processed) plus the last two queued ones.
+	slowSub.reset();
+	EXPECT_EQ(rxCount, 3);
+}
+
+TEST(NodeletsTests, untypedSubscriberIgnoresShared)
+{
+	int rxCount = 0;
+	auto sub = mrpt::comms::Subscriber::create(
+		[&](const std::any&) { rxCount++; }, []() {});
+
+	testing::internal::CaptureStderr();
+	sub->pubShared(typeid(int), std::make_shared<int>(1));
+	EXPECT_TRUE(testing::internal::GetCapturedStderr().empty());
+	EXPECT_EQ(rxCount, 0);
+
+	sub->pub(std::any(1));
+	EXPECT_EQ(rxCount, 1);
+}
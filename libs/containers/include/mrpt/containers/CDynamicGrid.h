@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/containers/sparse_tiled_storage.h>
 #include <mrpt/core/round.h>
 
 #include <cmath>
@@ -32,6 +33,15 @@ struct dynamic_grid_txt_saver
 }  // namespace internal
 
 /** A 2D grid of dynamic size which stores any kind of data at each cell.
+ *
+ * Cells are stored in one contiguous std::vector by default. Alternatively,
+ * setStorageMode() can select grid_storage_t::SparseTiles, where tiles of
+ * 32x32 cells are only allocated when written to, so memory follows the
+ * actually-modified area and resize() does not copy any cell. In that mode,
+ * all cells must be read via cellByIndex() or cellByPos(), new cells are
+ * written via insertCellByIndex() or insertCellByPos(), and data(), begin()
+ * and end() are empty.
+ *
  * \tparam T The type of each cell in the 2D grid.
  * \ingroup mrpt_containers_grp
  */
@@ -42,6 +52,7 @@ class CDynamicGrid
 	using grid_data_t = std::vector<T>;
 	using iterator = typename grid_data_t::iterator;
 	using const_iterator = typename grid_data_t::const_iterator;
+	using sparse_storage_t = sparse_tiled_storage<T, 2, 5>;
 
 	/** Constructor */
 	CDynamicGrid(
@@ -83,14 +94,50 @@ class CDynamicGrid
 		m_size_y = round((m_y_max - m_y_min) / m_resolution);
 
 		// Cells memory:
-		if (fill_value) m_map.assign(m_size_x * m_size_y, *fill_value);
+		if (m_storage == grid_storage_t::SparseTiles)
+		{
+			m_sparse.reset(fill_value ? *fill_value : T());
+			m_sparse_offset_x = m_sparse_offset_y = 0;
+		}
+		else if (fill_value)
+			m_map.assign(m_size_x * m_size_y, *fill_value);
 		else
 			m_map.resize(m_size_x * m_size_y);
 	}
 
+	/** Selects the cell storage backend, keeping the grid limits.
+	 * All previous contents are erased, and all cells are set to `fillValue`.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	virtual void setStorageMode(grid_storage_t mode, const T& fillValue = T())
+	{
+		m_storage = mode;
+		if (mode == grid_storage_t::SparseTiles)
+		{
+			m_map = grid_data_t();
+			m_sparse.reset(fillValue);
+			m_sparse_offset_x = m_sparse_offset_y = 0;
+		}
+		else
+		{
+			m_sparse.reset();
+			m_map.assign(m_size_x * m_size_y, fillValue);
+		}
+	}
+	/** \sa setStorageMode() */
+	grid_storage_t getStorageMode() const { return m_storage; }
+
+	/** Read-only access to the tiles of grid_storage_t::SparseTiles mode */
+	const sparse_storage_t& sparseStorage() const { return m_sparse; }
+
 	/** Erase the contents of all the cells. */
 	void clear()
 	{
+		if (m_storage == grid_storage_t::SparseTiles)
+		{
+			m_sparse.reset();
+			return;
+		}
 		m_map.clear();
 		m_map.resize(m_size_x * m_size_y);
 	}
@@ -99,11 +146,19 @@ class CDynamicGrid
 	 */
 	inline void fill(const T& value)
 	{
+		if (m_storage == grid_storage_t::SparseTiles)
+		{
+			m_sparse.reset(value);
+			return;
+		}
 		for (auto it = m_map.begin(); it != m_map.end(); ++it)
 			*it = value;
 	}
 
 	/** Changes the size of the grid, maintaining previous contents.
+	 * In grid_storage_t::SparseTiles mode no cell is copied, and new cells
+	 * take the value given to setSize(), fill() or setStorageMode() instead
+	 * of `defaultValueNewCells`.
 	 * \sa setSize
 	 */
 	virtual void resize(
@@ -155,6 +210,21 @@ class CDynamicGrid
 		unsigned int new_size_x = round((new_x_max - new_x_min) / m_resolution);
 		unsigned int new_size_y = round((new_y_max - new_y_min) / m_resolution);
 
+		if (m_storage == grid_storage_t::SparseTiles)
+		{
+			// Just shift the indices of existing cells:
+			m_sparse_offset_x -= static_cast<int32_t>(extra_x_izq);
+			m_sparse_offset_y -= static_cast<int32_t>(extra_y_arr);
+
+			m_x_min = new_x_min;
+			m_x_max = new_x_max;
+			m_y_min = new_y_min;
+			m_y_max = new_y_max;
+			m_size_x = new_size_x;
+			m_size_y = new_size_y;
+			return;
+		}
+
 		// Reserve new memory:
 		grid_data_t new_map;
 		new_map.resize(new_size_x * new_size_y, defaultValueNewCells);
@@ -189,6 +259,8 @@ class CDynamicGrid
 
 	/** Returns a pointer to the contents of a cell given by its coordinates, or
 	 * nullptr if it is out of the map extensions.
+	 * In grid_storage_t::SparseTiles mode, it also returns nullptr for cells
+	 * in tiles not allocated yet: use insertCellByPos() to write new cells.
 	 */
 	inline T* cellByPos(double x, double y)
 	{
@@ -196,7 +268,7 @@ class CDynamicGrid
 		const int cy = y2idx(y);
 		if (cx < 0 || cx >= static_cast<int>(m_size_x)) return nullptr;
 		if (cy < 0 || cy >= static_cast<int>(m_size_y)) return nullptr;
-		return &m_map[cx + cy * m_size_x];
+		return cellByIndex(cx, cy);
 	}
 	/** \overload */
 	inline const T* cellByPos(double x, double y) const
@@ -205,25 +277,56 @@ class CDynamicGrid
 		const int cy = y2idx(y);
 		if (cx < 0 || cx >= static_cast<int>(m_size_x)) return nullptr;
 		if (cy < 0 || cy >= static_cast<int>(m_size_y)) return nullptr;
-		return &m_map[cx + cy * m_size_x];
+		return cellByIndex(cx, cy);
+	}
+	/** Like cellByPos(), but in grid_storage_t::SparseTiles mode it allocates
+	 * the tile of the cell if needed, so it only returns nullptr if the cell
+	 * is out of the map extensions. Use it to write new cells. */
+	inline T* insertCellByPos(double x, double y)
+	{
+		const int cx = x2idx(x);
+		const int cy = y2idx(y);
+		if (cx < 0 || cx >= static_cast<int>(m_size_x)) return nullptr;
+		if (cy < 0 || cy >= static_cast<int>(m_size_y)) return nullptr;
+		return insertCellByIndex(cx, cy);
 	}
 
 	/** Returns a pointer to the contents of a cell given by its cell indexes,
 	 * or nullptr if it is out of the map extensions.
+	 * In grid_storage_t::SparseTiles mode, it also returns nullptr for cells
+	 * in tiles not allocated yet: use insertCellByIndex() to write new cells.
 	 */
 	inline T* cellByIndex(unsigned int cx, unsigned int cy)
 	{
 		if (cx >= m_size_x || cy >= m_size_y) return nullptr;
+		else if (m_storage == grid_storage_t::SparseTiles)
+			return m_sparse.mutableCellIfAllocated(sparseIndex(cx, cy));
 		else
 			return &m_map[cx + cy * m_size_x];
 	}
 
 	/** Returns a pointer to the contents of a cell given by its cell indexes,
 	 * or nullptr if it is out of the map extensions.
+	 * In grid_storage_t::SparseTiles mode, cells in tiles not allocated yet
+	 * point to the default value.
 	 */
 	inline const T* cellByIndex(unsigned int cx, unsigned int cy) const
 	{
 		if (cx >= m_size_x || cy >= m_size_y) return nullptr;
+		else if (m_storage == grid_storage_t::SparseTiles)
+			return &m_sparse.cell(sparseIndex(cx, cy));
+		else
+			return &m_map[cx + cy * m_size_x];
+	}
+
+	/** Like cellByIndex(), but in grid_storage_t::SparseTiles mode it
+	 * allocates the tile of the cell if needed, so it only returns nullptr if
+	 * the cell is out of the map extensions. Use it to write new cells. */
+	inline T* insertCellByIndex(unsigned int cx, unsigned int cy)
+	{
+		if (cx >= m_size_x || cy >= m_size_y) return nullptr;
+		else if (m_storage == grid_storage_t::SparseTiles)
+			return &m_sparse.mutableCell(sparseIndex(cx, cy));
 		else
 			return &m_map[cx + cy * m_size_x];
 	}
@@ -289,11 +392,9 @@ class CDynamicGrid
 	void getAsMatrix(MAT& m) const
 	{
 		m.setSize(m_size_y, m_size_x);
-		if (m_map.empty()) return;
-		const T* c = &m_map[0];
 		for (size_t cy = 0; cy < m_size_y; cy++)
 			for (size_t cx = 0; cx < m_size_x; cx++)
-				m(cy, cx) = *c++;
+				m(cy, cx) = *cellByIndex(cx, cy);
 	}
 
 	/** The user must implement this in order to provide "saveToTextFile" a way
@@ -311,8 +412,7 @@ class CDynamicGrid
 			float getCellAsFloat(
 				unsigned int cx, unsigned int cy) const override
 			{
-				return m_obj.cell2float(
-					m_obj.m_map[cx + cy * m_obj.getSizeX()]);
+				return m_obj.cell2float(*m_obj.cellByIndex(cx, cy));
 			}
 			const CDynamicGrid<T>& m_obj;
 		};
@@ -321,6 +421,7 @@ class CDynamicGrid
 	}
 
 	/** @name Direct and range-based access to data
+	 * Only for grid_storage_t::Dense storage: empty otherwise.
 	 * @{ */
 	inline const grid_data_t& data() const { return m_map; }
 	inline iterator begin() { return m_map.begin(); }
@@ -358,6 +459,9 @@ class CDynamicGrid
 		}
 		m_size_x = in.template ReadAs<uint32_t>();
 		m_size_y = in.template ReadAs<uint32_t>();
+		// Cell contents are always deserialized into dense storage:
+		m_storage = grid_storage_t::Dense;
+		m_sparse.reset();
 		m_map.resize(m_size_x * m_size_y);
 	}
 
@@ -374,6 +478,19 @@ class CDynamicGrid
 	double m_x_min{0}, m_x_max{0}, m_y_min{0}, m_y_max{0}, m_resolution{0};
 	size_t m_size_x{0}, m_size_y{0};
 
+	grid_storage_t m_storage = grid_storage_t::Dense;
+	/** The cells, in grid_storage_t::SparseTiles mode */
+	sparse_storage_t m_sparse;
+	/** Index in m_sparse of cell (0,0). Changes with each resize(). */
+	int32_t m_sparse_offset_x = 0, m_sparse_offset_y = 0;
+
+	typename sparse_storage_t::index_t sparseIndex(
+		unsigned int cx, unsigned int cy) const
+	{
+		return {
+			static_cast<int32_t>(cx) + m_sparse_offset_x,
+			static_cast<int32_t>(cy) + m_sparse_offset_y};
+	}
 };	// end of CDynamicGrid<>
 
 }  // namespace containers
@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/containers/sparse_tiled_storage.h>
 #include <mrpt/core/round.h>
 
 #include <cmath>
@@ -20,6 +21,15 @@ namespace mrpt::containers
 {
 /** A 3D rectangular grid of dynamic size which stores any kind of data at each
  * voxel.
+ *
+ * Voxels are stored in one contiguous std::vector by default. Alternatively,
+ * setStorageMode() can select grid_storage_t::SparseTiles, where blocks of
+ * 16x16x16 voxels are only allocated when written to, so memory follows the
+ * actually-modified volume and resize() does not copy any voxel. In that
+ * mode, all voxels must be read via cellByIndex() or cellByPos(), new voxels
+ * are written via insertCellByIndex() or insertCellByPos(), and data(),
+ * begin() and end() are empty.
+ *
  * \tparam T The type of each voxel in the grid.
  * \ingroup mrpt_containers_grp
  */
@@ -30,6 +40,7 @@ class CDynamicGrid3D
 	using grid_data_t = std::vector<T>;
 	using iterator = typename grid_data_t::iterator;
 	using const_iterator = typename grid_data_t::const_iterator;
+	using sparse_storage_t = sparse_tiled_storage<T, 3, 4>;
 
 	/** Constructor */
 	CDynamicGrid3D(
@@ -44,6 +55,9 @@ class CDynamicGrid3D
 	}
 
 	/** Changes the size of the grid, maintaining previous contents.
+	 * In grid_storage_t::SparseTiles mode no voxel is copied, and new voxels
+	 * take the value given to setSize(), fill() or setStorageMode() instead
+	 * of `defaultValueNewCells`.
 	 * \sa setSize
 	 */
 	virtual void resize(
@@ -118,6 +132,26 @@ class CDynamicGrid3D
 		size_t new_size_z = round((new_z_max - new_z_min) / m_resolution_z);
 		size_t new_size_x_times_y = new_size_x * new_size_y;
 
+		if (m_storage == grid_storage_t::SparseTiles)
+		{
+			// Just shift the indices of existing voxels:
+			m_sparse_offset[0] -= static_cast<int32_t>(extra_x_izq);
+			m_sparse_offset[1] -= static_cast<int32_t>(extra_y_arr);
+			m_sparse_offset[2] -= static_cast<int32_t>(extra_z_top);
+
+			m_x_min = new_x_min;
+			m_x_max = new_x_max;
+			m_y_min = new_y_min;
+			m_y_max = new_y_max;
+			m_z_min = new_z_min;
+			m_z_max = new_z_max;
+			m_size_x = new_size_x;
+			m_size_y = new_size_y;
+			m_size_z = new_size_z;
+			m_size_x_times_y = new_size_x_times_y;
+			return;
+		}
+
 		// Reserve new memory:
 		grid_data_t new_map;
 		new_map.resize(
@@ -205,16 +239,52 @@ class CDynamicGrid3D
 		m_size_z = round((m_z_max - m_z_min) / m_resolution_z);
 
 		// Cells memory:
-		if (fill_value)
+		if (m_storage == grid_storage_t::SparseTiles)
+		{
+			m_sparse.reset(fill_value ? *fill_value : T());
+			m_sparse_offset = {0, 0, 0};
+		}
+		else if (fill_value)
 			m_map.assign(m_size_x * m_size_y * m_size_z, *fill_value);
 		else
 			m_map.resize(m_size_x * m_size_y * m_size_z);
 	}
 
+	/** Selects the voxel storage backend, keeping the grid limits.
+	 * All previous contents are erased, and all voxels are set to
+	 * `fillValue`.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	virtual void setStorageMode(grid_storage_t mode, const T& fillValue = T())
+	{
+		m_storage = mode;
+		if (mode == grid_storage_t::SparseTiles)
+		{
+			m_map = grid_data_t();
+			m_sparse.reset(fillValue);
+			m_sparse_offset = {0, 0, 0};
+		}
+		else
+		{
+			m_sparse.reset();
+			m_map.assign(m_size_x * m_size_y * m_size_z, fillValue);
+		}
+	}
+	/** \sa setStorageMode() */
+	grid_storage_t getStorageMode() const { return m_storage; }
+
+	/** Read-only access to the tiles of grid_storage_t::SparseTiles mode */
+	const sparse_storage_t& sparseStorage() const { return m_sparse; }
+
 	/** Erase the contents of all the cells, setting them to their default
 	 * values (default ctor). */
 	virtual void clear()
 	{
+		if (m_storage == grid_storage_t::SparseTiles)
+		{
+			m_sparse.reset();
+			return;
+		}
 		m_map.clear();
 		m_map.resize(m_size_x * m_size_y * m_size_z);
 	}
@@ -223,6 +293,11 @@ class CDynamicGrid3D
 	 */
 	inline void fill(const T& value)
 	{
+		if (m_storage == grid_storage_t::SparseTiles)
+		{
+			m_sparse.reset(value);
+			return;
+		}
 		for (auto it = m_map.begin(); it != m_map.end(); ++it)
 			*it = value;
 	}
@@ -248,32 +323,42 @@ class CDynamicGrid3D
 
 	/** Returns a pointer to the contents of a voxel given by its coordinates,
 	 * or nullptr if it is out of the map extensions.
+	 * In grid_storage_t::SparseTiles mode, it also returns nullptr for voxels
+	 * in tiles not allocated yet: use insertCellByPos() to write new voxels.
 	 */
 	inline T* cellByPos(coord_t x, coord_t y, coord_t z)
 	{
-		const size_t cidx =
-			cellAbsIndexFromCXCYCZ(x2idx(x), y2idx(y), z2idx(z));
-		if (cidx == INVALID_VOXEL_IDX) return nullptr;
-		return &m_map[cidx];
+		const int cx = x2idx(x), cy = y2idx(y), cz = z2idx(z);
+		if (isOutOfBounds(cx, cy, cz)) return nullptr;
+		return cellByIndex(cx, cy, cz);
 	}
 	/** \overload */
 	inline const T* cellByPos(coord_t x, coord_t y, coord_t z) const
 	{
-		const size_t cidx =
-			cellAbsIndexFromCXCYCZ(x2idx(x), y2idx(y), z2idx(z));
-		if (cidx == INVALID_VOXEL_IDX) return nullptr;
-		return &m_map[cidx];
+		const int cx = x2idx(x), cy = y2idx(y), cz = z2idx(z);
+		if (isOutOfBounds(cx, cy, cz)) return nullptr;
+		return cellByIndex(cx, cy, cz);
+	}
+	/** Like cellByPos(), but in grid_storage_t::SparseTiles mode it allocates
+	 * the tile of the voxel if needed, so it only returns nullptr if the voxel
+	 * is out of the map extensions. Use it to write new voxels. */
+	inline T* insertCellByPos(coord_t x, coord_t y, coord_t z)
+	{
+		const int cx = x2idx(x), cy = y2idx(y), cz = z2idx(z);
+		if (isOutOfBounds(cx, cy, cz)) return nullptr;
+		return insertCellByIndex(cx, cy, cz);
 	}
 
-	/** Like cellByPos() but returns a reference
+	/** Like insertCellByPos() but returns a reference
 	 * \exception std::out_of_range if out of grid limits. */
 	inline T& cellRefByPos(coord_t x, coord_t y, coord_t z)
 	{
-		T* c = cellByPos(x, y, z);
+		T* c = insertCellByPos(x, y, z);
 		if (!c) throw std::out_of_range("cellRefByPos: Out of grid limits");
 		return *c;
 	}
-	/** \overload */
+	/** Like cellByPos() but returns a reference
+	 * \exception std::out_of_range if out of grid limits. */
 	inline const T& cellRefByPos(coord_t x, coord_t y, coord_t z) const
 	{
 		const T* c = cellByPos(x, y, z);
@@ -283,11 +368,15 @@ class CDynamicGrid3D
 
 	/** Returns a pointer to the contents of a voxel given by its voxel indexes,
 	 * or nullptr if it is out of the map extensions.
+	 * In grid_storage_t::SparseTiles mode, it also returns nullptr for voxels
+	 * in tiles not allocated yet: use insertCellByIndex() to write new voxels.
 	 */
 	inline T* cellByIndex(unsigned int cx, unsigned int cy, unsigned int cz)
 	{
 		const size_t cidx = cellAbsIndexFromCXCYCZ(cx, cy, cz);
 		if (cidx == INVALID_VOXEL_IDX) return nullptr;
+		if (m_storage == grid_storage_t::SparseTiles)
+			return m_sparse.mutableCellIfAllocated(sparseIndex(cx, cy, cz));
 		return &m_map[cidx];
 	}
 	inline const T* cellByIndex(
@@ -295,6 +384,21 @@ class CDynamicGrid3D
 	{
 		const size_t cidx = cellAbsIndexFromCXCYCZ(cx, cy, cz);
 		if (cidx == INVALID_VOXEL_IDX) return nullptr;
+		if (m_storage == grid_storage_t::SparseTiles)
+			return &m_sparse.cell(sparseIndex(cx, cy, cz));
+		return &m_map[cidx];
+	}
+	/** Like cellByIndex(), but in grid_storage_t::SparseTiles mode it
+	 * allocates the tile of the voxel if needed, so it only returns nullptr
+	 * if the voxel is out of the map extensions. Use it to write new voxels.
+	 */
+	inline T* insertCellByIndex(
+		unsigned int cx, unsigned int cy, unsigned int cz)
+	{
+		const size_t cidx = cellAbsIndexFromCXCYCZ(cx, cy, cz);
+		if (cidx == INVALID_VOXEL_IDX) return nullptr;
+		if (m_storage == grid_storage_t::SparseTiles)
+			return &m_sparse.mutableCell(sparseIndex(cx, cy, cz));
 		return &m_map[cidx];
 	}
 
@@ -303,13 +407,26 @@ class CDynamicGrid3D
 	 */
 	inline const T* cellByIndex(size_t cidx) const
 	{
-		if (cidx > m_map.size()) return nullptr;
+		if (cidx >= getVoxelCount()) return nullptr;
+		if (m_storage == grid_storage_t::SparseTiles)
+			return &m_sparse.cell(sparseIndex(cidx));
 		return &m_map[cidx];
 	}
-	/// \overload
+	/// \overload (In grid_storage_t::SparseTiles mode, nullptr for voxels in
+	/// tiles not allocated yet; see insertCellByIndex())
 	inline T* cellByIndex(size_t cidx)
 	{
-		if (cidx > m_map.size()) return nullptr;
+		if (cidx >= getVoxelCount()) return nullptr;
+		if (m_storage == grid_storage_t::SparseTiles)
+			return m_sparse.mutableCellIfAllocated(sparseIndex(cidx));
+		return &m_map[cidx];
+	}
+	/// \overload
+	inline T* insertCellByIndex(size_t cidx)
+	{
+		if (cidx >= getVoxelCount()) return nullptr;
+		if (m_storage == grid_storage_t::SparseTiles)
+			return &m_sparse.mutableCell(sparseIndex(cidx));
 		return &m_map[cidx];
 	}
 
@@ -352,6 +469,7 @@ class CDynamicGrid3D
 	inline coord_t idx2z(int cz) const { return m_z_min + (cz)*m_resolution_z; }
 
 	/** @name Direct and range-based access to data
+	 * Only for grid_storage_t::Dense storage: empty otherwise.
 	 * @{ */
 	inline const grid_data_t& data() const { return m_map; }
 	inline iterator begin() { return m_map.begin(); }
@@ -370,6 +488,27 @@ class CDynamicGrid3D
 		m_resolution_xy, m_resolution_z;
 	size_t m_size_x, m_size_y, m_size_z, m_size_x_times_y;
 
+	grid_storage_t m_storage = grid_storage_t::Dense;
+	/** The voxels, in grid_storage_t::SparseTiles mode */
+	sparse_storage_t m_sparse;
+	/** Index in m_sparse of voxel (0,0,0). Changes with each resize(). */
+	typename sparse_storage_t::index_t m_sparse_offset{0, 0, 0};
+
+	typename sparse_storage_t::index_t sparseIndex(
+		unsigned int cx, unsigned int cy, unsigned int cz) const
+	{
+		return {
+			static_cast<int32_t>(cx) + m_sparse_offset[0],
+			static_cast<int32_t>(cy) + m_sparse_offset[1],
+			static_cast<int32_t>(cz) + m_sparse_offset[2]};
+	}
+	typename sparse_storage_t::index_t sparseIndex(size_t cidx) const
+	{
+		return sparseIndex(
+			cidx % m_size_x, (cidx / m_size_x) % m_size_y,
+			cidx / m_size_x_times_y);
+	}
+
    public:
 	/** Serialization of all parameters, except the contents of each voxel
 	 * (responsability of the derived class) */
@@ -393,6 +532,10 @@ class CDynamicGrid3D
 		m_size_x = in.template ReadAs<uint32_t>();
 		m_size_y = in.template ReadAs<uint32_t>();
 		m_size_z = in.template ReadAs<uint32_t>();
+		m_size_x_times_y = m_size_x * m_size_y;
+		// Voxel contents are always deserialized into dense storage:
+		m_storage = grid_storage_t::Dense;
+		m_sparse.reset();
 		m_map.resize(m_size_x * m_size_y * m_size_z);
 	}
 
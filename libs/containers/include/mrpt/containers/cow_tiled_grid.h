@@ -0,0 +1,210 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace mrpt::containers
+{
+/** A dense 2D array of cells stored in "tiles" of `2^TILE_ROWS_LOG2` complete
+ * rows, which are shared among copies of the container and only cloned when
+ * modified (copy-on-write).
+ *
+ * Copying a container is cheap (one reference count per tile), and memory is
+ * only duplicated for the tiles modified afterwards. This is intended for
+ * particle filters where many particles hold copies of the same grid map,
+ * which only differ in small areas. Right after assign() or fill(), all tiles
+ * share one single memory block.
+ *
+ * Each row is contiguous in memory, but the whole array is not. Read access
+ * is done via the const methods; any non-const accessor (mutableCell(),
+ * mutableRow()) first clones the affected tile if it is shared.
+ *
+ * Different copies sharing tiles can be modified from different threads.
+ * A single object must not be modified concurrently from several threads,
+ * unless makeRowsUnique() was called before for all the rows to be modified.
+ *
+ * \note Defined in #include <mrpt/containers/cow_tiled_grid.h>
+ * \ingroup mrpt_containers_grp
+ * \note (New in MRPT 2.7.1)
+ */
+template <typename T, unsigned TILE_ROWS_LOG2 = 5>
+class cow_tiled_grid
+{
+   public:
+	using value_type = T;
+	static constexpr std::size_t TILE_ROWS = std::size_t(1) << TILE_ROWS_LOG2;
+
+	cow_tiled_grid() = default;
+	cow_tiled_grid(std::size_t sizeX, std::size_t sizeY, const T& value = T())
+	{
+		assign(sizeX, sizeY, value);
+	}
+
+	/** Sets the grid size and sets all cells to the given value. */
+	void assign(std::size_t sizeX, std::size_t sizeY, const T& value = T())
+	{
+		m_sizeX = sizeX;
+		m_sizeY = sizeY;
+		const std::size_t nTiles = (sizeY + TILE_ROWS - 1) >> TILE_ROWS_LOG2;
+		m_tiles.assign(
+			nTiles,
+			nTiles != 0 && sizeX != 0
+				? std::make_shared<tile_t>(sizeX * TILE_ROWS, value)
+				: nullptr);
+		m_tileData.resize(nTiles);
+		for (std::size_t i = 0; i < nTiles; i++)
+			m_tileData[i] = m_tiles[i] ? m_tiles[i]->data() : nullptr;
+	}
+
+	/** Sets all cells to the given value, keeping the grid size. */
+	void fill(const T& value) { assign(m_sizeX, m_sizeY, value); }
+
+	/** Enlarges the grid to `newSizeX x newSizeY` cells, moving the current
+	 * contents so its first cell ends up at (offsetX, offsetY), and setting
+	 * all the new cells to the given value.
+	 *
+	 * If the row length does not change and `offsetY` is a multiple of
+	 * TILE_ROWS, the existing tiles are reused as they are, still shared with
+	 * other copies (only the last one is cloned if it is partially filled).
+	 * Otherwise, all cells are copied into new (unshared) tiles.
+	 *
+	 * \note The new size must hold the old grid: `newSizeX >= sizeX()+offsetX`
+	 * and `newSizeY >= sizeY()+offsetY`.
+	 */
+	void grow(
+		std::size_t newSizeX, std::size_t newSizeY, std::size_t offsetX,
+		std::size_t offsetY, const T& value = T())
+	{
+		cow_tiled_grid g(newSizeX, newSizeY, value);
+		if (newSizeX == m_sizeX && offsetX == 0 && m_sizeX != 0 &&
+			(offsetY & (TILE_ROWS - 1)) == 0)
+		{
+			// Rows past sizeY() in the last tile are now visible: reset them.
+			const std::size_t lastRows = m_sizeY & (TILE_ROWS - 1);
+			if (lastRows != 0 && newSizeY > offsetY + m_sizeY)
+			{
+				T* t = tileForWriting(m_tiles.size() - 1);
+				std::fill(t + lastRows * m_sizeX, t + TILE_ROWS * m_sizeX, value);
+			}
+			const std::size_t t0 = offsetY >> TILE_ROWS_LOG2;
+			for (std::size_t i = 0; i < m_tiles.size(); i++)
+			{
+				g.m_tiles[t0 + i] = std::move(m_tiles[i]);
+				g.m_tileData[t0 + i] = m_tileData[i];
+			}
+		}
+		else
+		{
+			for (std::size_t y = 0; y < m_sizeY; y++)
+				std::copy(
+					row(y), row(y) + m_sizeX, g.mutableRow(offsetY + y) + offsetX);
+		}
+		*this = std::move(g);
+	}
+
+	/** Releases all memory and leaves an empty grid */
+	void clear()
+	{
+		m_sizeX = m_sizeY = 0;
+		m_tiles.clear();
+		m_tileData.clear();
+	}
+
+	std::size_t sizeX() const { return m_sizeX; }
+	std::size_t sizeY() const { return m_sizeY; }
+	/** Total number of cells */
+	std::size_t size() const { return m_sizeX * m_sizeY; }
+	bool empty() const { return size() == 0; }
+
+	/** Read access to one cell, without bound checks */
+	const T& operator()(std::size_t x, std::size_t y) const
+	{
+		return row(y)[x];
+	}
+	/** Read access to one cell by its row-major index (`x+y*sizeX()`) */
+	const T& operator[](std::size_t idx) const
+	{
+		return (*this)(idx % m_sizeX, idx / m_sizeX);
+	}
+	/** Pointer to the `sizeX()` contiguous cells of row `y` (read-only) */
+	const T* row(std::size_t y) const
+	{
+		return m_tileData[y >> TILE_ROWS_LOG2] +
+			(y & (TILE_ROWS - 1)) * m_sizeX;
+	}
+
+	/** Write access to one cell, without bound checks. Clones its tile if it
+	 * is shared with other copies. */
+	T& mutableCell(std::size_t x, std::size_t y) { return mutableRow(y)[x]; }
+	/** Write access to one cell by its row-major index (`x+y*sizeX()`) */
+	T& mutableCell(std::size_t idx)
+	{
+		return mutableCell(idx % m_sizeX, idx / m_sizeX);
+	}
+	/** Pointer to the `sizeX()` contiguous cells of row `y`, for writing.
+	 * Clones its tile if it is shared with other copies. */
+	T* mutableRow(std::size_t y)
+	{
+		return tileForWriting(y >> TILE_ROWS_LOG2) +
+			(y & (TILE_ROWS - 1)) * m_sizeX;
+	}
+
+	/** Ensures the tiles of all rows in the range [y0,y1] are not shared,
+	 * so they can be modified afterwards from several threads. */
+	void makeRowsUnique(std::size_t y0, std::size_t y1)
+	{
+		for (std::size_t t = y0 >> TILE_ROWS_LOG2; t <= (y1 >> TILE_ROWS_LOG2);
+			 t++)
+			tileForWriting(t);
+	}
+
+	/** Number of tiles (bands of TILE_ROWS rows) */
+	std::size_t tileCount() const { return m_tiles.size(); }
+	/** Number of tiles currently shared with other copies, or among several
+	 * bands of this same grid. */
+	std::size_t sharedTileCount() const
+	{
+		std::size_t n = 0;
+		for (const auto& t : m_tiles)
+			if (t && t.use_count() > 1) n++;
+		return n;
+	}
+
+   private:
+	using tile_t = std::vector<T>;
+
+	std::size_t m_sizeX = 0, m_sizeY = 0;
+	std::vector<std::shared_ptr<tile_t>> m_tiles;
+	/** Cached data() pointers of m_tiles, for faster access */
+	std::vector<T*> m_tileData;
+
+	T* tileForWriting(std::size_t t)
+	{
+		auto& tile = m_tiles[t];
+		if (tile.use_count() != 1)
+		{
+			tile = std::make_shared<tile_t>(*tile);
+			m_tileData[t] = tile->data();
+		}
+		else
+		{
+			// We are the only owner: synchronize with the release of the
+			// references that other copies may have dropped in other threads.
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		return m_tileData[t];
+	}
+};
+
+}  // namespace mrpt::containers
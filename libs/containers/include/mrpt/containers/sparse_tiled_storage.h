@@ -0,0 +1,156 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mrpt::containers
+{
+/** Cell storage backends for CDynamicGrid and CDynamicGrid3D.
+ * \ingroup mrpt_containers_grp
+ * \note (New in MRPT 2.7.1)
+ */
+enum class grid_storage_t : uint8_t
+{
+	/** One contiguous std::vector with all cells (default) */
+	Dense = 0,
+	/** Fixed-size tiles, allocated on the first write access and stored in a
+	 * hash map (see sparse_tiled_storage) */
+	SparseTiles
+};
+
+/** Sparse storage of a 2D or 3D grid as square (cubic) tiles of
+ * `2^TILE_SIDE_LOG2` cells per side, stored in a hash map indexed by tile
+ * coordinates.
+ *
+ * Cell indices are signed integers, without any predefined bounds. Tiles are
+ * only allocated upon the first write access to any of its cells via
+ * mutableCell(); reading a cell in an unallocated tile returns the default
+ * value given in reset().
+ * Hence, memory follows the area actually modified, and shifting or growing
+ * the grid limits is free.
+ *
+ * Tiles are shared among copies of the object and cloned upon modification
+ * (copy-on-write), so copying a storage object is cheap.
+ *
+ * Const methods are thread-safe. Write access to different cells from
+ * different threads is not, since it may insert new tiles.
+ *
+ * \note Defined in #include <mrpt/containers/sparse_tiled_storage.h>
+ * \ingroup mrpt_containers_grp
+ * \note (New in MRPT 2.7.1)
+ */
+template <typename T, unsigned DIM, unsigned TILE_SIDE_LOG2>
+class sparse_tiled_storage
+{
+	static_assert(DIM == 2 || DIM == 3, "Only 2D and 3D grids supported");
+
+   public:
+	using index_t = std::array<int32_t, DIM>;
+	static constexpr int32_t TILE_SIDE = int32_t(1) << TILE_SIDE_LOG2;
+	static constexpr std::size_t TILE_CELLS = std::size_t(1)
+		<< (DIM * TILE_SIDE_LOG2);
+
+	/** Removes all tiles. Cells read as `defaultValue` afterwards. */
+	void reset(const T& defaultValue = T())
+	{
+		m_tiles.clear();
+		m_default = defaultValue;
+	}
+
+	/** The value of all cells in non-allocated tiles */
+	const T& defaultValue() const { return m_default; }
+
+	/** Read-only access to a cell. Does not allocate new tiles. */
+	const T& cell(const index_t& idx) const
+	{
+		const auto it = m_tiles.find(tileKey(idx));
+		if (it == m_tiles.end()) return m_default;
+		return (*it->second)[offsetInTile(idx)];
+	}
+
+	/** Write access to a cell. Allocates its tile (filled with the default
+	 * value) if it did not exist yet, or clones it if it is shared with other
+	 * copies of this object. */
+	T& mutableCell(const index_t& idx)
+	{
+		auto& tile = m_tiles[tileKey(idx)];
+		if (!tile) tile = std::make_shared<tile_t>(TILE_CELLS, m_default);
+		return ownedTile(tile)[offsetInTile(idx)];
+	}
+
+	/** Write access to a cell whose tile is already allocated (cloning it if
+	 * it is shared with other copies), or nullptr if its tile does not exist.
+	 * Never allocates new tiles. */
+	T* mutableCellIfAllocated(const index_t& idx)
+	{
+		const auto it = m_tiles.find(tileKey(idx));
+		if (it == m_tiles.end()) return nullptr;
+		return &ownedTile(it->second)[offsetInTile(idx)];
+	}
+
+	/** Number of allocated tiles */
+	std::size_t tileCount() const { return m_tiles.size(); }
+
+	/** Approximate memory used by cells in allocated tiles, in bytes */
+	std::size_t memoryUsage() const
+	{
+		return m_tiles.size() * (TILE_CELLS * sizeof(T) + sizeof(tile_t));
+	}
+
+   private:
+	using tile_t = std::vector<T>;
+
+	T m_default{};
+	std::unordered_map<uint64_t, std::shared_ptr<tile_t>> m_tiles;
+
+	/** Clones the tile if it is shared with other copies */
+	static tile_t& ownedTile(std::shared_ptr<tile_t>& tile)
+	{
+		if (tile.use_count() != 1) tile = std::make_shared<tile_t>(*tile);
+		else
+		{
+			// We are the only owner: synchronize with the release of the
+			// references that other copies may have dropped in other threads.
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		return *tile;
+	}
+
+	static uint64_t tileKey(const index_t& idx)
+	{
+		constexpr unsigned BITS = 64 / DIM;
+		constexpr uint64_t MASK = (uint64_t(1) << BITS) - 1;
+		uint64_t k = 0;
+		for (unsigned d = 0; d < DIM; d++)
+		{
+			// Arithmetic shift: floor division, also for negative indices.
+			const auto t = static_cast<uint32_t>(idx[d] >> TILE_SIDE_LOG2);
+			k = (k << BITS) | (t & MASK);
+		}
+		return k;
+	}
+
+	static std::size_t offsetInTile(const index_t& idx)
+	{
+		std::size_t o = 0;
+		for (unsigned d = DIM; d-- > 0;)
+			o = (o << TILE_SIDE_LOG2) |
+				static_cast<std::size_t>(idx[d] & (TILE_SIDE - 1));
+		return o;
+	}
+};
+
+}  // namespace mrpt::containers
@@ -46,3 +46,63 @@ TEST(CDynamicGrid, rangeForLoop)
 	EXPECT_EQ(counter.at(0), 20 * 20 * 10 * 10 - 1);
 	EXPECT_EQ(counter.at(8), 1);
 }
+
+TEST(CDynamicGrid, sparseTiles)
+{
+	using mrpt::containers::grid_storage_t;
+
+	CDynamicGrid<double> grid{-10.0, 10.0, -10.0, 10.0, 0.1};
+	grid.setStorageMode(grid_storage_t::SparseTiles, 1.0);
+	EXPECT_EQ(grid.getStorageMode(), grid_storage_t::SparseTiles);
+	EXPECT_TRUE(grid.data().empty());
+
+	// Reading does not allocate memory:
+	const auto& cgrid = grid;
+	EXPECT_NEAR(*cgrid.cellByPos(5.0, 5.0), 1.0, 1e-10);
+	EXPECT_TRUE(grid.cellByPos(5.0, 5.0) == nullptr);
+	EXPECT_EQ(grid.sparseStorage().tileCount(), 0U);
+
+	*grid.insertCellByPos(3.0, 4.0) = 8.0;
+	*grid.insertCellByPos(-2.0, -7.0) = 9.0;
+	EXPECT_EQ(grid.sparseStorage().tileCount(), 2U);
+	EXPECT_TRUE(grid.insertCellByPos(11.0, 0.0) == nullptr);
+	// Cells in allocated tiles can be also modified via cellByPos():
+	*grid.cellByPos(3.1, 4.0) = 7.0;
+	EXPECT_NEAR(*cgrid.cellByPos(3.1, 4.0), 7.0, 1e-10);
+	EXPECT_EQ(grid.sparseStorage().tileCount(), 2U);
+
+	// Growing does not copy any cell:
+	grid.resize(-100.0, 20.0, -20.0, 100.0, 0.0, 0.0);
+	EXPECT_EQ(grid.sparseStorage().tileCount(), 2U);
+	EXPECT_NEAR(*grid.cellByPos(3.0, 4.0), 8.0, 1e-10);
+	EXPECT_NEAR(*grid.cellByPos(-2.0, -7.0), 9.0, 1e-10);
+	EXPECT_NEAR(*cgrid.cellByPos(-90.0, 90.0), 1.0, 1e-10);
+
+	*grid.insertCellByPos(-90.0, 90.0) = 3.0;
+	EXPECT_NEAR(*grid.cellByPos(-90.0, 90.0), 3.0, 1e-10);
+	EXPECT_EQ(grid.sparseStorage().tileCount(), 3U);
+
+	// Same results than dense storage:
+	CDynamicGrid<double> dense{-10.0, 10.0, -10.0, 10.0, 0.1};
+	dense.fill(1.0);
+	*dense.cellByPos(3.0, 4.0) = 8.0;
+	*dense.cellByPos(-2.0, -7.0) = 9.0;
+	*dense.cellByPos(3.1, 4.0) = 7.0;
+	dense.resize(-100.0, 20.0, -20.0, 100.0, 1.0, 0.0);
+	*dense.cellByPos(-90.0, 90.0) = 3.0;
+	ASSERT_EQ(dense.getSizeX(), grid.getSizeX());
+	ASSERT_EQ(dense.getSizeY(), grid.getSizeY());
+	for (unsigned int cy = 0; cy < grid.getSizeY(); cy += 7)
+		for (unsigned int cx = 0; cx < grid.getSizeX(); cx += 7)
+			EXPECT_EQ(*cgrid.cellByIndex(cx, cy), *dense.cellByIndex(cx, cy));
+
+	// Copies share tiles until modified:
+	auto grid2 = grid;
+	*grid2.cellByPos(3.0, 4.0) = 5.0;
+	EXPECT_NEAR(*grid.cellByPos(3.0, 4.0), 8.0, 1e-10);
+	EXPECT_NEAR(*grid2.cellByPos(3.0, 4.0), 5.0, 1e-10);
+
+	grid.fill(2.0);
+	EXPECT_EQ(grid.sparseStorage().tileCount(), 0U);
+	EXPECT_NEAR(*cgrid.cellByPos(3.0, 4.0), 2.0, 1e-10);
+}
@@ -0,0 +1,114 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <CTraitsTest.h>
+#include <gtest/gtest.h>
+#include <mrpt/containers/cow_tiled_grid.h>
+
+#include <cstdint>
+
+template class mrpt::CTraitsTest<mrpt::containers::cow_tiled_grid<int8_t>>;
+
+using grid_t = mrpt::containers::cow_tiled_grid<int, 2>;  // 4 rows/tile
+
+TEST(cow_tiled_grid, assignAndAccess)
+{
+	grid_t g(7, 10, 3);
+	EXPECT_EQ(g.sizeX(), 7U);
+	EXPECT_EQ(g.sizeY(), 10U);
+	EXPECT_EQ(g.size(), 70U);
+	EXPECT_EQ(g.tileCount(), 3U);
+	// All tiles share the same block after assign():
+	EXPECT_EQ(g.sharedTileCount(), 3U);
+
+	for (size_t y = 0; y < g.sizeY(); y++)
+		for (size_t x = 0; x < g.sizeX(); x++)
+			EXPECT_EQ(g(x, y), 3);
+
+	for (size_t y = 0; y < g.sizeY(); y++)
+		for (size_t x = 0; x < g.sizeX(); x++)
+			g.mutableCell(x, y) = static_cast<int>(x + 100 * y);
+
+	EXPECT_EQ(g.sharedTileCount(), 0U);
+	for (size_t y = 0; y < g.sizeY(); y++)
+	{
+		const int* row = g.row(y);
+		for (size_t x = 0; x < g.sizeX(); x++)
+		{
+			EXPECT_EQ(row[x], static_cast<int>(x + 100 * y));
+			EXPECT_EQ(g[x + y * g.sizeX()], row[x]);
+		}
+	}
+
+	g.clear();
+	EXPECT_TRUE(g.empty());
+	EXPECT_EQ(g.tileCount(), 0U);
+}
+
+TEST(cow_tiled_grid, copyOnWrite)
+{
+	grid_t g1(5, 16, 0);
+	for (size_t y = 0; y < g1.sizeY(); y++)
+		g1.mutableRow(y)[0] = static_cast<int>(y);
+	EXPECT_EQ(g1.sharedTileCount(), 0U);
+
+	grid_t g2 = g1;
+	EXPECT_EQ(g1.sharedTileCount(), 4U);
+	EXPECT_EQ(g2.sharedTileCount(), 4U);
+	EXPECT_EQ(g1.row(0), g2.row(0));
+
+	// Modifying one cell only clones its tile:
+	g2.mutableCell(2, 9) = 42;
+	EXPECT_EQ(g2.sharedTileCount(), 3U);
+	EXPECT_EQ(g1.sharedTileCount(), 3U);
+	EXPECT_EQ(g2(2, 9), 42);
+	EXPECT_EQ(g1(2, 9), 0);
+	EXPECT_EQ(g2(0, 9), 9);
+	EXPECT_NE(g1.row(9), g2.row(9));
+	EXPECT_EQ(g1.row(0), g2.row(0));
+
+	g2.makeRowsUnique(0, 15);
+	EXPECT_EQ(g2.sharedTileCount(), 0U);
+	for (size_t y = 0; y < g1.sizeY(); y++)
+		EXPECT_EQ(g1(0, y), g2(0, y));
+}
+
+TEST(cow_tiled_grid, grow)
+{
+	grid_t g1(5, 6, 0);
+	for (size_t y = 0; y < g1.sizeY(); y++)
+		for (size_t x = 0; x < g1.sizeX(); x++)
+			g1.mutableCell(x, y) = static_cast<int>(1 + x + 10 * y);
+
+	// Only new rows, by whole tiles: tiles are kept shared.
+	grid_t g2 = g1;
+	g2.grow(5, 14, 0, 4, -1);
+	EXPECT_EQ(g2.sizeX(), 5U);
+	EXPECT_EQ(g2.sizeY(), 14U);
+	EXPECT_EQ(g2.row(4), g1.row(0));
+	for (size_t y = 0; y < g2.sizeY(); y++)
+		for (size_t x = 0; x < g2.sizeX(); x++)
+			EXPECT_EQ(
+				g2(x, y),
+				y >= 4 && y < 10 ? static_cast<int>(1 + x + 10 * (y - 4)) : -1)
+				<< "x=" << x << " y=" << y;
+
+	// New columns: all cells are copied.
+	grid_t g3 = g1;
+	g3.grow(8, 9, 2, 1, -1);
+	EXPECT_EQ(g3.sharedTileCount(), 0U);
+	for (size_t y = 0; y < g3.sizeY(); y++)
+		for (size_t x = 0; x < g3.sizeX(); x++)
+			EXPECT_EQ(
+				g3(x, y),
+				x >= 2 && x < 7 && y >= 1 && y < 7
+					? static_cast<int>(1 + (x - 2) + 10 * (y - 1))
+					: -1)
+				<< "x=" << x << " y=" << y;
+}
@@ -18,10 +18,13 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -139,5 +142,227 @@ auto WorkerThreadsPool::enqueue(F&& f, Args&&... args)
 	return res;
 }
 
+/** A thread pool specialized in data-parallel loops, with a work-stealing
+ * scheduler: parallel_for() and parallel_reduce().
+ *
+ * The index range of each loop is split into chunks, which are initially
+ * distributed evenly among the workers (the pool threads plus the calling
+ * thread, which also takes part in the computation). Each worker consumes
+ * chunks from the front of its own range; when it runs out of work, it steals
+ * the back half of the range of another worker. Ranges are kept in one
+ * lock-free atomic word per worker, hence there is no shared queue nor mutex
+ * contention while running, and no memory is allocated per chunk or per loop
+ * (except for the per-chunk partial results of parallel_reduce()).
+ *
+ * Compared to WorkerThreadsPool::enqueue(), this is the preferred tool for
+ * fine-grained loops (per particle, per ray, per point...).
+ *
+ * Notes:
+ * - Only one loop runs at a time in the pool: parallel calls from different
+ *   threads are serialized.
+ * - Nested calls from within a loop body run serially in the calling thread.
+ * - Exceptions thrown from loop bodies are rethrown in the calling thread
+ *   (only the first one, the rest of chunks are skipped).
+ *
+ * \code
+ * mrpt::WorkStealingThreadsPool pool(4);
+ * std::vector<double> v(N);
+ * pool.parallel_for(0, N, [&](std::size_t i) { v[i] = heavy(i); });
+ * const double sum = pool.parallel_reduce(
+ *     0, N, 0.0, [&](double& acc, std::size_t i) { acc += v[i]; },
+ *     [](double a, double b) { return a + b; });
+ * \endcode
+ *
+ * \note (New in MRPT 2.7.1)
+ */
+class WorkStealingThreadsPool
+{
+   public:
+	WorkStealingThreadsPool() = default;
+
+	/** Creates a pool with the given number of worker threads. Note that the
+	 * thread calling parallel_for() also works, so `num_threads=N-1` is the
+	 * natural choice for N cores, and `num_threads=0` runs all loops serially.
+	 */
+	explicit WorkStealingThreadsPool(
+		std::size_t num_threads,
+		const std::string& threadsName = "WorkStealingThreadsPool")
+	{
+		resize(num_threads);
+		name(threadsName);
+	}
+	~WorkStealingThreadsPool() { clear(); }
+
+	WorkStealingThreadsPool(const WorkStealingThreadsPool&) = delete;
+	WorkStealingThreadsPool& operator=(const WorkStealingThreadsPool&) =
+		delete;
+
+	/** Returns a process-wide pool to run loops with `nThreads` threads in
+	 * total (i.e. `nThreads-1` workers plus the calling thread). Pools are
+	 * created upon the first request of each (nThreads, name) pair, and kept
+	 * alive for reuse until the program exits. Different names give different
+	 * pools, so loops of unrelated modules do not serialize each other.
+	 */
+	static WorkStealingThreadsPool& shared(
+		std::size_t nThreads, const std::string& name);
+
+	/** Stops all existing threads and creates `num_threads` new ones */
+	void resize(std::size_t num_threads);
+
+	/** Get number of working threads (not counting the calling thread) */
+	std::size_t size() const { return threads_.size(); }
+
+	/** Stops and deletes all worker threads */
+	void clear();
+
+	/** Sets the private thread names of threads in this pool, with the format
+	 * `${name}[i]` */
+	void name(const std::string& name);
+
+	/** Returns the base name of threads in this pool */
+	std::string name() const { return name_; }
+
+	/** Runs `f(i)` for all `i` in the range [first,last), in parallel, and
+	 * returns once all of them are done.
+	 *
+	 * \param chunkSize Number of consecutive indices that are run as one task.
+	 * Use 0 (default) for an automatic value.
+	 */
+	template <class F>
+	void parallel_for(
+		std::size_t first, std::size_t last, F&& f, std::size_t chunkSize = 0);
+
+	/** Like parallel_for(), but the user function gets whole chunks:
+	 * `f(chunkFirst, chunkLast)`, with `chunkLast` one past the end. */
+	template <class F>
+	void parallel_for_chunked(
+		std::size_t first, std::size_t last, F&& f, std::size_t chunkSize = 0);
+
+	/** Parallel reduction: each chunk accumulates its indices into a copy of
+	 * `identity` via `accumulate(T& acc, std::size_t i)`, then partial results
+	 * are combined with `T combine(const T& a, const T& b)`.
+	 *
+	 * Partial results are always combined in chunk order, so for a fixed
+	 * `chunkSize` the result is deterministic (even for floating point types)
+	 * no matter the number of threads nor how chunks were stolen.
+	 */
+	template <class T, class Accumulate, class Combine>
+	T parallel_reduce(
+		std::size_t first, std::size_t last, const T& identity,
+		Accumulate&& accumulate, Combine&& combine, std::size_t chunkSize = 0);
+
+	/** Returns the chunk size that a loop over `count` indices will use for
+	 * a given user-provided `chunkSize` (which may be 0=auto). */
+	std::size_t effectiveChunkSize(
+		std::size_t count, std::size_t chunkSize) const;
+
+   private:
+	/** Type-erased loop body: (user context, chunk index, first, last) */
+	using chunk_runner_t =
+		void (*)(void*, std::size_t, std::size_t, std::size_t);
+
+	template <class Body>
+	static void invokeChunk(
+		void* ctx, std::size_t chunkIdx, std::size_t a, std::size_t b)
+	{
+		(*static_cast<Body*>(ctx))(chunkIdx, a, b);
+	}
+
+	void workerThreadMain(std::size_t workerIdx);
+
+	/** Runs one loop, with the calling thread taking part on it */
+	void runJob(
+		std::size_t first, std::size_t last, std::size_t chunkSize,
+		chunk_runner_t runner, void* ctx);
+
+	/** Executes chunks (own or stolen) until there is no work left */
+	void workOnCurrentJob(std::size_t workerIdx);
+
+	/** Pop one chunk index from the front of a worker range */
+	bool popChunk(std::size_t workerIdx, std::size_t& chunkIdx);
+
+	/** Moves the back half of another worker range into ours */
+	bool stealChunks(std::size_t thiefIdx);
+
+	void runChunk(std::size_t chunkIdx);
+
+	/** One range of chunk indices [lo,hi), packed into an atomic word */
+	struct alignas(64) WorkerRange
+	{
+		std::atomic<uint64_t> range{0};
+	};
+
+	std::vector<std::thread> threads_;
+	/** One entry per thread, plus one (the last one) for the caller */
+	std::unique_ptr<WorkerRange[]> ranges_;
+	std::size_t numRanges_ = 0;
+	std::string name_{"WorkStealingThreadsPool"};
+
+	/** Serializes loops from different user threads */
+	std::mutex job_mutex_;
+
+	/** Protects the fields below, and it is used for sleeping threads */
+	std::mutex state_mutex_;
+	std::condition_variable wakeup_;
+	std::condition_variable done_;
+	bool do_stop_ = false;
+	bool job_active_ = false;
+	uint64_t job_generation_ = 0;
+	std::size_t busy_workers_ = 0;
+
+	/** Current job: */
+	chunk_runner_t job_runner_ = nullptr;
+	void* job_ctx_ = nullptr;
+	std::size_t job_first_ = 0, job_last_ = 0, job_chunk_ = 1;
+	std::atomic_bool job_failed_{false};
+	std::exception_ptr job_exception_;
+};
+
+template <class F>
+void WorkStealingThreadsPool::parallel_for_chunked(
+	std::size_t first, std::size_t last, F&& f, std::size_t chunkSize)
+{
+	if (last <= first) return;
+	auto body = [&f](std::size_t, std::size_t a, std::size_t b) { f(a, b); };
+	runJob(first, last, chunkSize, &invokeChunk<decltype(body)>, &body);
+}
+
+template <class F>
+void WorkStealingThreadsPool::parallel_for(
+	std::size_t first, std::size_t last, F&& f, std::size_t chunkSize)
+{
+	parallel_for_chunked(
+		first, last,
+		[&f](std::size_t a, std::size_t b) {
+			for (std::size_t i = a; i < b; i++)
+				f(i);
+		},
+		chunkSize);
+}
+
+template <class T, class Accumulate, class Combine>
+T WorkStealingThreadsPool::parallel_reduce(
+	std::size_t first, std::size_t last, const T& identity,
+	Accumulate&& accumulate, Combine&& combine, std::size_t chunkSize)
+{
+	if (last <= first) return identity;
+
+	chunkSize = effectiveChunkSize(last - first, chunkSize);
+	const std::size_t nChunks = (last - first + chunkSize - 1) / chunkSize;
+
+	std::vector<T> partials(nChunks, identity);
+	auto body = [&](std::size_t chunkIdx, std::size_t a, std::size_t b) {
+		T& acc = partials[chunkIdx];
+		for (std::size_t i = a; i < b; i++)
+			accumulate(acc, i);
+	};
+	runJob(first, last, chunkSize, &invokeChunk<decltype(body)>, &body);
+
+	T ret = partials[0];
+	for (std::size_t i = 1; i < nChunks; i++)
+		ret = combine(ret, partials[i]);
+	return ret;
+}
+
 /** @} */
 }  // namespace mrpt
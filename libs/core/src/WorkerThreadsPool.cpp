@@ -19,7 +19,9 @@
 #include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/exceptions.h>
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 
 // for SetThreadDescription()
 #if defined(_WIN32)
@@ -109,3 +111,256 @@ void WorkerThreadsPool::name(const std::string& name)
 		mySetThreadName(str, threads_.at(i));
 	}
 }
+
+// ------------------------------------------------------------------------
+//  WorkStealingThreadsPool
+// ------------------------------------------------------------------------
+namespace
+{
+// Ranges of chunk indices [lo,hi) are packed into one 64bit word, so both
+// the owner (popping from the front) and thieves (taking from the back) can
+// update them with a single CAS.
+constexpr uint64_t packRange(uint64_t lo, uint64_t hi)
+{
+	return (hi << 32) | lo;
+}
+constexpr std::size_t rangeLo(uint64_t v)
+{
+	return static_cast<std::size_t>(v & 0xffffffffU);
+}
+constexpr std::size_t rangeHi(uint64_t v)
+{
+	return static_cast<std::size_t>(v >> 32);
+}
+
+// The pool whose loop body is being run by this thread, if any:
+thread_local const WorkStealingThreadsPool* tlRunningLoopOf = nullptr;
+}  // namespace
+
+WorkStealingThreadsPool& WorkStealingThreadsPool::shared(
+	std::size_t nThreads, const std::string& name)
+{
+	using key_t = std::pair<std::size_t, std::string>;
+
+	static std::mutex mtx;
+	static std::map<key_t, std::unique_ptr<WorkStealingThreadsPool>> pools;
+
+	std::lock_guard<std::mutex> lck(mtx);
+	auto& pool = pools[key_t(nThreads, name)];
+	if (!pool)
+		pool = std::make_unique<WorkStealingThreadsPool>(
+			nThreads > 0 ? nThreads - 1 : 0 /* the caller also works */, name);
+	return *pool;
+}
+
+void WorkStealingThreadsPool::clear()
+{
+	{
+		std::unique_lock<std::mutex> lock(state_mutex_);
+		do_stop_ = true;
+	}
+	wakeup_.notify_all();
+
+	for (auto& t : threads_)
+		if (t.joinable()) t.join();
+	threads_.clear();
+}
+
+void WorkStealingThreadsPool::resize(std::size_t num_threads)
+{
+	clear();
+
+	do_stop_ = false;
+	numRanges_ = num_threads + 1;
+	ranges_ = std::make_unique<WorkerRange[]>(numRanges_);
+
+	for (std::size_t i = 0; i < num_threads; ++i)
+		threads_.emplace_back([this, i] { workerThreadMain(i); });
+}
+
+void WorkStealingThreadsPool::name(const std::string& name)
+{
+	using namespace std::string_literals;
+
+	name_ = name;
+
+	for (std::size_t i = 0; i < threads_.size(); ++i)
+	{
+		const std::string str = name + "["s + std::to_string(i) + "]"s;
+		mySetThreadName(str, threads_.at(i));
+	}
+}
+
+std::size_t WorkStealingThreadsPool::effectiveChunkSize(
+	std::size_t count, std::size_t chunkSize) const
+{
+	// Auto: a few chunks per worker, to leave room for load balancing:
+	if (chunkSize == 0)
+		chunkSize = std::max<std::size_t>(1, count / (8 * (size() + 1)));
+
+	// Chunk indices are stored as 32bit numbers:
+	const std::size_t maxChunks = 0xffffffffU;
+	if (count / chunkSize >= maxChunks) chunkSize = count / maxChunks + 1;
+
+	return chunkSize;
+}
+
+void WorkStealingThreadsPool::workerThreadMain(std::size_t workerIdx)
+{
+	uint64_t lastGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(state_mutex_);
+			wakeup_.wait(lock, [&] {
+				return do_stop_ ||
+					(job_active_ && job_generation_ != lastGeneration);
+			});
+			if (do_stop_) return;
+			lastGeneration = job_generation_;
+			busy_workers_++;
+		}
+
+		workOnCurrentJob(workerIdx);
+
+		{
+			std::unique_lock<std::mutex> lock(state_mutex_);
+			busy_workers_--;
+		}
+		done_.notify_all();
+	}
+}
+
+void WorkStealingThreadsPool::runJob(
+	std::size_t first, std::size_t last, std::size_t chunkSize,
+	chunk_runner_t runner, void* ctx)
+{
+	chunkSize = effectiveChunkSize(last - first, chunkSize);
+	const std::size_t nChunks = (last - first + chunkSize - 1) / chunkSize;
+
+	// Serial execution: no threads, nested loops, or nothing to split:
+	if (threads_.empty() || nChunks == 1 || tlRunningLoopOf == this)
+	{
+		for (std::size_t c = 0; c < nChunks; c++)
+		{
+			const std::size_t a = first + c * chunkSize;
+			runner(ctx, c, a, std::min(a + chunkSize, last));
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> jobLock(job_mutex_);
+
+	job_runner_ = runner;
+	job_ctx_ = ctx;
+	job_first_ = first;
+	job_last_ = last;
+	job_chunk_ = chunkSize;
+	job_failed_ = false;
+	job_exception_ = nullptr;
+
+	// Initial even distribution of chunks among workers:
+	for (std::size_t w = 0; w < numRanges_; w++)
+	{
+		const uint64_t lo = nChunks * w / numRanges_;
+		const uint64_t hi = nChunks * (w + 1) / numRanges_;
+		ranges_[w].range.store(packRange(lo, hi));
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(state_mutex_);
+		job_active_ = true;
+		job_generation_++;
+	}
+	wakeup_.notify_all();
+
+	// The calling thread works too, using the last range:
+	workOnCurrentJob(numRanges_ - 1);
+
+	// At this point all chunks have been claimed. Wait for those being run
+	// by other threads:
+	{
+		std::unique_lock<std::mutex> lock(state_mutex_);
+		job_active_ = false;
+		done_.wait(lock, [this] { return busy_workers_ == 0; });
+	}
+
+	if (job_exception_) std::rethrow_exception(job_exception_);
+}
+
+void WorkStealingThreadsPool::workOnCurrentJob(std::size_t workerIdx)
+{
+	for (;;)
+	{
+		std::size_t chunkIdx;
+		while (popChunk(workerIdx, chunkIdx))
+			runChunk(chunkIdx);
+
+		if (!stealChunks(workerIdx)) break;
+	}
+}
+
+bool WorkStealingThreadsPool::popChunk(
+	std::size_t workerIdx, std::size_t& chunkIdx)
+{
+	auto& r = ranges_[workerIdx].range;
+	uint64_t v = r.load();
+	for (;;)
+	{
+		const std::size_t lo = rangeLo(v), hi = rangeHi(v);
+		if (lo >= hi) return false;
+		if (r.compare_exchange_weak(v, packRange(lo + 1, hi)))
+		{
+			chunkIdx = lo;
+			return true;
+		}
+	}
+}
+
+bool WorkStealingThreadsPool::stealChunks(std::size_t thiefIdx)
+{
+	for (std::size_t k = 1; k < numRanges_; k++)
+	{
+		const std::size_t victimIdx = (thiefIdx + k) % numRanges_;
+		auto& r = ranges_[victimIdx].range;
+		uint64_t v = r.load();
+		for (;;)
+		{
+			const std::size_t lo = rangeLo(v), hi = rangeHi(v);
+			if (lo >= hi) break;
+
+			// Take the back half [mid,hi):
+			const std::size_t mid = lo + (hi - lo) / 2;
+			if (r.compare_exchange_weak(v, packRange(lo, mid)))
+			{
+				// Our own range is empty, hence nobody else modifies it:
+				ranges_[thiefIdx].range.store(packRange(mid, hi));
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void WorkStealingThreadsPool::runChunk(std::size_t chunkIdx)
+{
+	// After an exception, just drain the remaining chunks:
+	if (job_failed_) return;
+
+	const std::size_t a = job_first_ + chunkIdx * job_chunk_;
+	const std::size_t b = std::min(a + job_chunk_, job_last_);
+
+	const auto* prevLoop = tlRunningLoopOf;
+	tlRunningLoopOf = this;
+	try
+	{
+		job_runner_(job_ctx_, chunkIdx, a, b);
+	}
+	catch (...)
+	{
+		std::unique_lock<std::mutex> lock(state_mutex_);
+		if (!job_exception_) job_exception_ = std::current_exception();
+		job_failed_ = true;
+	}
+	tlRunningLoopOf = prevLoop;
+}
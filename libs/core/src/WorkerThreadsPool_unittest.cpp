@@ -37,3 +37,101 @@ TEST(WorkerThreadsPool, runTasks)
 	EXPECT_EQ(accum, 6);
 }
 #endif	// !MRPT_IN_EMSCRIPTEN
+
+#if !MRPT_IN_EMSCRIPTEN	 // No multithreading
+TEST(WorkStealingThreadsPool, parallelFor)
+{
+	for (const std::size_t nThreads : {0, 1, 3, 7})
+	{
+		mrpt::WorkStealingThreadsPool pool(nThreads);
+
+		for (const std::size_t N : {0, 1, 5, 100, 10000})
+		{
+			std::vector<int> visits(N, 0);
+			pool.parallel_for(0, N, [&](std::size_t i) { visits[i]++; });
+
+			for (std::size_t i = 0; i < N; i++)
+				EXPECT_EQ(visits[i], 1) << "N=" << N << " i=" << i;
+		}
+
+		// Unbalanced workload, to force work stealing:
+		std::vector<std::atomic_int> visits(500);
+		pool.parallel_for(
+			10, 500,
+			[&](std::size_t i) {
+				if (i < 50)
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				visits[i]++;
+			},
+			1);
+		for (std::size_t i = 0; i < visits.size(); i++)
+			EXPECT_EQ(visits[i].load(), i < 10 ? 0 : 1);
+	}
+}
+
+TEST(WorkStealingThreadsPool, parallelReduce)
+{
+	const std::size_t N = 100000;
+	std::vector<double> v(N);
+	for (std::size_t i = 0; i < N; i++)
+		v[i] = 1.0 / (1.0 + i);
+
+	const auto accum = [&](double& acc, std::size_t i) { acc += v[i]; };
+	const auto combine = [](double a, double b) { return a + b; };
+
+	double serialSum = 0;
+	{
+		mrpt::WorkStealingThreadsPool pool(0);
+		serialSum = pool.parallel_reduce(0, N, 0.0, accum, combine, 128);
+	}
+
+	for (const std::size_t nThreads : {1, 2, 5})
+	{
+		mrpt::WorkStealingThreadsPool pool(nThreads);
+		// Same chunk size: results must be bit-exact:
+		const double sum =
+			pool.parallel_reduce(0, N, 0.0, accum, combine, 128);
+		EXPECT_EQ(sum, serialSum);
+
+		const auto count = pool.parallel_reduce(
+			std::size_t(0), N, std::size_t(0),
+			[](std::size_t& acc, std::size_t) { acc++; },
+			[](std::size_t a, std::size_t b) { return a + b; });
+		EXPECT_EQ(count, N);
+	}
+}
+
+TEST(WorkStealingThreadsPool, nestedAndExceptions)
+{
+	mrpt::WorkStealingThreadsPool pool(3);
+
+	std::atomic_int total{0};
+	pool.parallel_for(0, 20, [&](std::size_t) {
+		pool.parallel_for(0, 10, [&](std::size_t) { total++; });
+	});
+	EXPECT_EQ(total.load(), 200);
+
+	EXPECT_THROW(
+		pool.parallel_for(
+			0, 1000,
+			[](std::size_t i) {
+				if (i == 500) throw std::runtime_error("error");
+			}),
+		std::runtime_error);
+
+	// The pool must remain usable after an exception:
+	std::atomic_int count{0};
+	pool.parallel_for(0, 1000, [&](std::size_t) { count++; });
+	EXPECT_EQ(count.load(), 1000);
+}
+
+TEST(WorkStealingThreadsPool, shared)
+{
+	auto& a = mrpt::WorkStealingThreadsPool::shared(3, "test_a");
+	EXPECT_EQ(a.size(), 2U);
+	EXPECT_EQ(a.name(), "test_a");
+	EXPECT_EQ(&a, &mrpt::WorkStealingThreadsPool::shared(3, "test_a"));
+	EXPECT_NE(&a, &mrpt::WorkStealingThreadsPool::shared(3, "test_b"));
+	EXPECT_NE(&a, &mrpt::WorkStealingThreadsPool::shared(2, "test_a"));
+}
+#endif	// !MRPT_IN_EMSCRIPTEN
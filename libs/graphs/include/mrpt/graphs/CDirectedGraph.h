@@ -13,9 +13,12 @@
 #include <mrpt/graphs/TNodeID.h>
 #include <mrpt/typemeta/TTypeName.h>
 
+#include <algorithm>
 #include <fstream>
 #include <map>
+#include <numeric>
 #include <set>
+#include <vector>
 
 namespace mrpt
 {
@@ -275,7 +278,7 @@ class CDirectedGraph
 	 *  Possible values for the template argument MAP_NODEID_SET_NODEIDS are:
 	 *    - std::map<TNodeID, std::set<TNodeID> >
 	 *    - mrpt::containers::map_as_vector<TNodeID, std::set<TNodeID> >
-	 * \sa getNeighborsOf
+	 * \sa getNeighborsOf, getCompressedAdjacency
 	 */
 	template <class MAP_NODEID_SET_NODEIDS>
 	void getAdjacencyMatrix(MAP_NODEID_SET_NODEIDS& outAdjacency) const
@@ -311,6 +314,102 @@ class CDirectedGraph
 		}
 	}
 
+	/** Compressed (CSR) adjacency of the graph, regardless of the edge
+	 * direction, as returned by getCompressedAdjacency(). Nodes are referred
+	 * to by their index in \a nodeIDs.
+	 * \note (New in MRPT 2.7.1) */
+	struct TCompressedAdjacency
+	{
+		/** Sorted IDs of all the nodes that appear in the edges */
+		std::vector<TNodeID> nodeIDs;
+		/** The neighbors of the k'th node are the entries
+		 * `[offsets[k], offsets[k+1])` of \a neighbors and \a edges */
+		std::vector<size_t> offsets;
+		/** Index (in \a nodeIDs) of each neighbor, sorted, without
+		 * self-loops */
+		std::vector<size_t> neighbors;
+		/** The edge to each neighbor: the first `node->neighbor` edge, or the
+		 * first `neighbor->node` edge if there are none in that direction */
+		std::vector<const_iterator> edges;
+
+		size_t nodeCount() const { return nodeIDs.size(); }
+		/** Index of the given node ID, or nodeCount() if it does not exist */
+		size_t indexOf(const TNodeID id) const
+		{
+			const auto it =
+				std::lower_bound(nodeIDs.begin(), nodeIDs.end(), id);
+			return (it != nodeIDs.end() && *it == id)
+				? static_cast<size_t>(it - nodeIDs.begin())
+				: nodeIDs.size();
+		}
+	};
+
+	/** Builds the compressed (CSR) adjacency of the graph: all the
+	 * neighbors of each node, and an edge to each of them, are stored
+	 * contiguously, so graph traversals do not need to search edges or
+	 * allocate memory per node.
+	 * The returned iterators are valid while no edge is erased.
+	 * \sa getAdjacencyMatrix
+	 * \note (New in MRPT 2.7.1) */
+	void getCompressedAdjacency(TCompressedAdjacency& adj) const
+	{
+		adj.nodeIDs.clear();
+		adj.nodeIDs.reserve(2 * edges.size());
+		for (const auto& e : edges)
+		{
+			adj.nodeIDs.push_back(e.first.first);
+			adj.nodeIDs.push_back(e.first.second);
+		}
+		std::sort(adj.nodeIDs.begin(), adj.nodeIDs.end());
+		adj.nodeIDs.erase(
+			std::unique(adj.nodeIDs.begin(), adj.nodeIDs.end()),
+			adj.nodeIDs.end());
+		const size_t nNodes = adj.nodeIDs.size();
+
+		struct Entry
+		{
+			size_t node, neighbor;
+			bool reverse;
+			const_iterator edge;
+		};
+		std::vector<Entry> entries;
+		entries.reserve(2 * edges.size());
+		for (auto it = edges.begin(); it != edges.end(); ++it)
+		{
+			const TPairNodeIDs& ids = it->first;
+			if (ids.first == ids.second) continue;	// ignore self-loops
+			const size_t a = adj.indexOf(ids.first);
+			const size_t b = adj.indexOf(ids.second);
+			entries.push_back({a, b, false, it});
+			entries.push_back({b, a, true, it});
+		}
+		// (stable, to keep the first edge of each pair, as in edges.find())
+		std::stable_sort(
+			entries.begin(), entries.end(),
+			[](const Entry& e1, const Entry& e2) {
+				if (e1.node != e2.node) return e1.node < e2.node;
+				if (e1.neighbor != e2.neighbor)
+					return e1.neighbor < e2.neighbor;
+				return !e1.reverse && e2.reverse;
+			});
+
+		adj.offsets.assign(nNodes + 1, 0);
+		adj.neighbors.clear();
+		adj.edges.clear();
+		for (size_t k = 0; k < entries.size(); k++)
+		{
+			const Entry& e = entries[k];
+			if (k > 0 && entries[k - 1].node == e.node &&
+				entries[k - 1].neighbor == e.neighbor)
+				continue;
+			adj.neighbors.push_back(e.neighbor);
+			adj.edges.push_back(e.edge);
+			adj.offsets[e.node + 1]++;
+		}
+		std::partial_sum(
+			adj.offsets.begin(), adj.offsets.end(), adj.offsets.begin());
+	}
+
 	/** @} */  // end of edge/nodes utilities
 
 	/** @name I/O utilities
@@ -799,19 +799,21 @@ struct graph_ops
 				// edge_delta_pose,
 				//  taking into account that that edge may be in reverse order
 				//  and then have to invert the delta_pose:
+				// (Insert the child first: with map_as_vector, that may
+				// reallocate all the nodes)
+				auto& child_pose = m_g->nodes[child_id];
+				const auto& parent_pose = m_g->nodes[parent_id];
 				if ((!edge_to_child.reverse &&
 					 !m_g->edges_store_inverse_poses) ||
 					(edge_to_child.reverse && m_g->edges_store_inverse_poses))
 				{  // pose_child = p_parent (+) p_delta
-					m_g->nodes[child_id].composeFrom(
-						m_g->nodes[parent_id],
-						edge_to_child.data->getPoseMean());
+					child_pose.composeFrom(
+						parent_pose, edge_to_child.data->getPoseMean());
 				}
 				else
 				{  // pose_child = p_parent (+) [(-)p_delta]
-					m_g->nodes[child_id].composeFrom(
-						m_g->nodes[parent_id],
-						-edge_to_child.data->getPoseMean());
+					child_pose.composeFrom(
+						parent_pose, -edge_to_child.data->getPoseMean());
 				}
 			}
 		};
@@ -821,7 +823,9 @@ struct graph_ops
 		//
 		// Keep track of the NODE_ANNOTATIONS for each node and put it after
 		// the global pose computation
-		bool empty_node_annots = g->nodes.begin()->second.is_node_annots_empty;
+		// (The graph may have edges only, with no nodes yet)
+		const bool empty_node_annots =
+			typename graph_t::global_pose_t().is_node_annots_empty;
 		map<const TNodeID, TNodeAnnotations*> nodeID_to_annots;
 		if (!empty_node_annots)
 		{
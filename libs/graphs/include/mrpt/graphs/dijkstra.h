@@ -17,6 +17,7 @@
 #include <functional>
 #include <limits>
 #include <optional>
+#include <queue>
 #include <utility>
 #include <vector>
 
@@ -85,6 +86,11 @@ class NotConnectedGraph : public std::exception
  *    is much faster (avoids memory allocations), but should be only used if the
  *    node IDs start in 0 or a low value.
  *
+ * With any of them, the neighbors of each node and the edges to them are
+ * taken from a compressed (CSR) adjacency of the graph, built once at
+ * construction (see mrpt::graphs::CDirectedGraph::getCompressedAdjacency()),
+ * instead of searching the graph edges (New in MRPT 2.7.1).
+ *
  * See a complete [C++ code example](page_graphs_dijkstra_example.html).
  *
  * \ingroup mrpt_graphs_grp
@@ -141,6 +147,7 @@ class CDijkstra
 	id2pairIDs_map_t m_prev_arc;
 	std::set<TNodeID> m_lstNode_IDs;
 	list_all_neighbors_t m_allNeighbors;
+	typename TYPE_GRAPH::TCompressedAdjacency m_adjacency;
 
    public:
 	/** @name Useful typedefs
@@ -210,8 +217,13 @@ class CDijkstra
 		14               m_prev_node[v] := u
 		*/
 
+		// Precompute all neighbors of all the nodes in the given graph:
+		graph.getCompressedAdjacency(m_adjacency);
+		graph.getAdjacencyMatrix(m_allNeighbors);
+
 		// Make a list of all the nodes in the graph:
-		graph.getAllNodes(m_lstNode_IDs);
+		for (const TNodeID id : m_adjacency.nodeIDs)
+			m_lstNode_IDs.insert(m_lstNode_IDs.end(), id);
 		const size_t nNodes = m_lstNode_IDs.size();
 
 		if (m_lstNode_IDs.find(source_node_ID) == m_lstNode_IDs.end())
@@ -230,8 +242,13 @@ class CDijkstra
 		m_distances[source_node_ID] = 0;
 		m_distances_non_visited[source_node_ID] = 0;
 
-		// Precompute all neighbors of all the nodes in the given graph:
-		graph.getAdjacencyMatrix(m_allNeighbors);
+		// Min-heap of (distance,nodeID) of the non-visited nodes. Entries
+		// with an outdated distance are not removed, but skipped when popped.
+		using dist_node_t = std::pair<double, TNodeID>;
+		std::priority_queue<
+			dist_node_t, std::vector<dist_node_t>, std::greater<dist_node_t>>
+			non_visited_queue;
+		non_visited_queue.emplace(0, source_node_ID);
 
 		using namespace std;
 
@@ -240,19 +257,21 @@ class CDijkstra
 		do
 		{  // The algorithm:
 			// Find the nodeID with the minimum known distance so far
-			// considered:
+			// considered (the lowest ID in case of ties):
 			double min_d = std::numeric_limits<double>::max();
 			u = INVALID_NODEID;
 
-			// No need to check if the min. distance node is not visited yet,
-			// since we keep two lists: m_distances_non_visited & m_distances
-			for (const auto& dnv : m_distances_non_visited)
+			while (!non_visited_queue.empty())
 			{
-				if (dnv.second.dist < min_d)
-				{
-					u = dnv.first;
-					min_d = dnv.second.dist;
-				}
+				const auto [d, id] = non_visited_queue.top();
+				non_visited_queue.pop();
+				const auto itNV = m_distances_non_visited.find(id);
+				if (itNV == m_distances_non_visited.end() ||
+					itNV->second.dist != d)
+					continue;  // already visited, or outdated distance.
+				u = id;
+				min_d = d;
+				break;
 			}
 
 			if (min_d > maximum_distance)
@@ -291,66 +310,41 @@ class CDijkstra
 			// Let the user know about our progress...
 			if (functor_on_progress) functor_on_progress(graph, visitedCount);
 
+			// Relax the arc u<->i. Returns true if it is now in the tree.
+			auto relax_arc = [&](const TNodeID i, const double edge_ui_weight) {
+				const auto dist_ui = (min_d + edge_ui_weight);
+
+				if (dist_ui > maximum_distance)	 // out of radius of interest:
+					return false;
+
+				if (!(dist_ui < m_distances[i].dist)) return false;
+
+				// the [] creates the entry if needed
+				// update m_distances, m_distances_non_visited
+				m_distances_non_visited[i].dist = dist_ui;
+				m_distances[i].dist = dist_ui;
+				non_visited_queue.emplace(dist_ui, i);
+
+				m_prev_node[i].id = u;
+				return true;
+			};
+
 			// For each arc from "u":
-			const std::set<TNodeID>& neighborsOfU = m_allNeighbors[u];
-			for (unsigned long i : neighborsOfU)
+			const size_t uIdx = m_adjacency.indexOf(u);
+			for (size_t k = m_adjacency.offsets[uIdx];
+				 k < m_adjacency.offsets[uIdx + 1]; k++)
 			{
-				if (i == u) continue;  // ignore self-loops...
-
-				// the "edge_ui" may be searched here or a bit later, so the
-				// "bool" var will tell us.
-				typename graph_t::const_iterator edge_ui;
-				bool edge_ui_reverse = false;
-				bool edge_ui_found = false;
-
-				// Get weight of edge u<->i
-				double edge_ui_weight;
-				if (!functor_edge_weight) edge_ui_weight = 1.;
-				else
-				{  // edge may be i->u or u->i:
-					edge_ui = graph.edges.find(std::make_pair(u, i));
-					if (edge_ui == graph.edges.end())
-					{
-						edge_ui = graph.edges.find(std::make_pair(i, u));
-						edge_ui_reverse = true;
-					}
-					ASSERT_(edge_ui != graph.edges.end());
-					edge_ui_weight = functor_edge_weight(
-						graph, edge_ui->first.first, edge_ui->first.second,
-						edge_ui->second);
-					edge_ui_found = true;
-				}
+				const TNodeID i = m_adjacency.nodeIDs[m_adjacency.neighbors[k]];
+				const auto edge_ui = m_adjacency.edges[k];
 
-				const auto dist_ui = (min_d + edge_ui_weight);
+				const double edge_ui_weight = !functor_edge_weight
+					? 1.
+					: functor_edge_weight(
+						  graph, edge_ui->first.first, edge_ui->first.second,
+						  edge_ui->second);
 
-				if (dist_ui > maximum_distance)	 // out of radius of interest:
-					continue;
-
-				if (dist_ui < m_distances[i].dist)
-				{  // the [] creates the entry if needed
-					// update m_distances, m_distances_non_visited
-					m_distances_non_visited[i].dist = dist_ui;
-					m_distances[i].dist = dist_ui;
-
-					m_prev_node[i].id = u;
-					// If still not done above, detect the direction of the arc
-					// now:
-					if (!edge_ui_found)
-					{
-						edge_ui = graph.edges.find(std::make_pair(u, i));
-						if (edge_ui == graph.edges.end())
-						{
-							edge_ui = graph.edges.find(std::make_pair(i, u));
-							edge_ui_reverse = true;
-						}
-						ASSERT_(edge_ui != graph.edges.end());
-					}
-
-					if (!edge_ui_reverse)
-						m_prev_arc[i] = std::make_pair(u, i);  // *u -> *i
-					else
-						m_prev_arc[i] = std::make_pair(i, u);  // *i -> *u
-				}
+				if (relax_arc(i, edge_ui_weight))
+					m_prev_arc[i] = edge_ui->first;
 			}
 		} while (visitedCount < nNodes);
 
@@ -389,6 +383,18 @@ class CDijkstra
 		return m_allNeighbors;
 	}
 
+	/** Return the compressed adjacency of the input graph, cached at
+	 * construction.
+	 *
+	 * \sa  mrpt::graphs::CDirectedGraph::getCompressedAdjacency
+	 * \note (New in MRPT 2.7.1)
+	 */
+	const typename TYPE_GRAPH::TCompressedAdjacency&
+		getCachedCompressedAdjacency() const
+	{
+		return m_adjacency;
+	}
+
 	/** Returns the shortest path between the source node passed in the
 	 * constructor and the given target node. The reconstructed path
 	 * contains a list of arcs (all of them exist in the graph with the given
@@ -457,6 +463,11 @@ class CDijkstra
 			const TNodeID id_from = edge.second.first;
 			const TNodeID id_to = edge.second.second;
 
+			// Arcs are never self-loops: this is the empty entry of a node
+			// without arc (the root, or one out of maximum_distance), as
+			// created by map_as_vector when storing the arc of a higher ID.
+			if (id_from == id_to) continue;
+
 			auto& edges =
 				out_tree.edges_to_children[id == id_from ? id_to : id_from];
 			TreeEdgeInfo newEdge(id);
@@ -0,0 +1,143 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/graphs/CNetworkOfPoses.h>
+#include <mrpt/graphs/dijkstra.h>
+#include <mrpt/random.h>
+
+using namespace mrpt;
+using namespace mrpt::graphs;
+using namespace mrpt::containers;
+using namespace std;
+
+// A chain of nodes with random extra edges, in both directions, and some
+// duplicated edges and self-loops:
+template <class GRAPH_T>
+static void populateRandomGraph(GRAPH_T& g, const size_t nNodes)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+	for (TNodeID i = 1; i < nNodes; i++)
+		g.insertEdge(
+			i - 1, i,
+			mrpt::poses::CPose2D(
+				rng.drawUniform(0.5, 1.0), rng.drawUniform(-0.1, 0.1),
+				rng.drawUniform(-0.2, 0.2)));
+	for (size_t k = 0; k < nNodes; k++)
+	{
+		const TNodeID a = rng.drawUniform32bit() % nNodes;
+		const TNodeID b = rng.drawUniform32bit() % nNodes;
+		g.insertEdge(
+			a, b,
+			mrpt::poses::CPose2D(
+				rng.drawUniform(-5, 5), rng.drawUniform(-5, 5),
+				rng.drawUniform(-3, 3)));
+	}
+	g.root = 0;
+}
+
+TEST(Dijkstra, CompressedAdjacency)
+{
+	CNetworkOfPoses2D g;
+	populateRandomGraph(g, 50);
+
+	CNetworkOfPoses2D::TCompressedAdjacency adj;
+	g.getCompressedAdjacency(adj);
+
+	std::map<TNodeID, std::set<TNodeID>> adjRef;
+	g.getAdjacencyMatrix(adjRef);
+
+	ASSERT_EQ(adj.nodeCount(), adjRef.size());
+	ASSERT_EQ(adj.offsets.size(), adj.nodeCount() + 1);
+	for (size_t k = 0; k < adj.nodeCount(); k++)
+	{
+		const TNodeID id = adj.nodeIDs[k];
+		EXPECT_EQ(adj.indexOf(id), k);
+
+		std::set<TNodeID> neighbors = adjRef.at(id);
+		neighbors.erase(id);  // self-loops are not in the CSR adjacency
+		ASSERT_EQ(adj.offsets[k + 1] - adj.offsets[k], neighbors.size());
+
+		auto itRef = neighbors.begin();
+		for (size_t j = adj.offsets[k]; j < adj.offsets[k + 1]; j++, ++itRef)
+		{
+			const TNodeID nei = adj.nodeIDs[adj.neighbors[j]];
+			EXPECT_EQ(nei, *itRef);
+
+			auto itEdge = g.edges.find({id, nei});
+			if (itEdge == g.edges.end()) itEdge = g.edges.find({nei, id});
+			EXPECT_TRUE(adj.edges[j] == itEdge);
+		}
+	}
+	EXPECT_EQ(adj.indexOf(1000), adj.nodeCount());
+}
+
+template <class MAPS_IMPLEMENTATION>
+static void checkSameTreeAsStdMap(
+	const size_t maxDistance = std::numeric_limits<size_t>::max())
+{
+	using graph_ref_t = CNetworkOfPoses<mrpt::poses::CPose2D>;
+	using graph_t = CNetworkOfPoses<mrpt::poses::CPose2D, MAPS_IMPLEMENTATION>;
+
+	graph_ref_t gRef;
+	graph_t g;
+	populateRandomGraph(gRef, 200);
+	populateRandomGraph(g, 200);
+
+	// Weighted by the length of the edges:
+	auto weightRef = [](const graph_ref_t&, TNodeID, TNodeID,
+						const typename graph_ref_t::edge_t& e) {
+		return e.norm();
+	};
+	auto weight = [](const graph_t&, TNodeID, TNodeID,
+					 const typename graph_t::edge_t& e) { return e.norm(); };
+
+	CDijkstra<graph_ref_t> dijRef(gRef, 0, weightRef, {}, maxDistance);
+	CDijkstra<graph_t, MAPS_IMPLEMENTATION> dij(g, 0, weight, {}, maxDistance);
+
+	for (const TNodeID id : dijRef.getListOfAllNodes())
+	{
+		const auto dRef = dijRef.getNodeDistanceToRoot(id);
+		if (!dRef.has_value()) continue;
+		const auto d = dij.getNodeDistanceToRoot(id);
+		ASSERT_TRUE(d.has_value());
+		EXPECT_EQ(d.value(), dRef.value());
+		EXPECT_EQ(dij.getShortestPathTo(id), dijRef.getShortestPathTo(id));
+	}
+
+	// Node poses from the Dijkstra tree:
+	gRef.dijkstra_nodes_estimate();
+	g.dijkstra_nodes_estimate();
+	for (const auto& n : gRef.nodes)
+		EXPECT_EQ(
+			mrpt::poses::CPose2D(g.nodes.at(n.first)),
+			mrpt::poses::CPose2D(n.second))
+			<< "node: " << n.first;
+}
+
+TEST(Dijkstra, SameResultsMapAsVector)
+{
+	checkSameTreeAsStdMap<map_traits_map_as_vector>();
+	checkSameTreeAsStdMap<map_traits_map_as_vector>(20);
+}
+
+TEST(Dijkstra, CachedAdjacency)
+{
+	CNetworkOfPoses2D g;
+	populateRandomGraph(g, 30);
+
+	CDijkstra<CNetworkOfPoses2D> dij(g, 0);
+	EXPECT_EQ(dij.getCachedCompressedAdjacency().nodeCount(), 30U);
+
+	// Same adjacency as that of the graph:
+	std::map<TNodeID, std::set<TNodeID>> adjRef;
+	g.getAdjacencyMatrix(adjRef);
+	EXPECT_EQ(dij.getCachedAdjacencyMatrix(), adjRef);
+}
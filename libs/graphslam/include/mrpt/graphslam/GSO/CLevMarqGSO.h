@@ -22,7 +22,9 @@
 #include <cmath>
 #include <iostream>
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
 namespace mrpt::graphslam::optimizers
 {
@@ -66,6 +68,41 @@ namespace mrpt::graphslam::optimizers
  *  graph node are optimized according to the corresponding constraints between
  *  them
  *
+ * - \b incremental_optimization
+ *  + \a Section       : OptimizerParameters
+ *  + \a Default value : FALSE
+ *  + \a Required      : FALSE
+ *  + \a Description   : Instead of optimizing the whole graph, or the nodes
+ *  within \b optimization_distance, on each update, only relinearize the
+ *  nodes of the newly added edges (including loop closures). Whenever an
+ *  optimized node moves more than \b incremental_relinearize_threshold, it is
+ *  relinearized again in the next update together with its neighbours, so
+ *  corrections propagate through the graph while the cost of each update stays
+ *  bounded by \b incremental_max_nodes.
+ *  This is a local, approximate scheme: no factorization is kept between
+ *  updates (each one runs Levenberg-Marquardt from scratch on the selected
+ *  nodes, with the rest of the graph held fixed), and a correction only
+ *  reaches the neighbours of the moved nodes in each update. Hence, a loop
+ *  closure may need as many updates as nodes in the loop to spread along it,
+ *  and only the latency of each update is bounded, not the time until the
+ *  graph converges. Trigger a full optimization (\b keystroke_optimize_graph)
+ *  whenever a globally consistent graph is required.
+ *
+ * - \b incremental_relinearize_threshold
+ *  + \a Section       : OptimizerParameters
+ *  + \a Default value : 0.01
+ *  + \a Required      : FALSE
+ *  + \a Description   : Norm of the change of a node pose (translation and
+ *  angles) above which it and its neighbours are relinearized.
+ *
+ * - \b incremental_max_nodes
+ *  + \a Section       : OptimizerParameters
+ *  + \a Default value : 200
+ *  + \a Required      : FALSE
+ *  + \a Description   : Maximum number of nodes optimized in one incremental
+ *  update, the most recent ones first. The rest are kept for the next updates.
+ *  0 means no limit.
+ *
  * - \b verbose
  *  + \a Section       : OptimizerParameters
  *  + \a Default value : FALSE
@@ -128,6 +165,7 @@ class CLevMarqGSO
 		double, constraint_t::state_length, constraint_t::state_length>;
 	using grandpa = mrpt::graphslam::CRegistrationDeciderOrOptimizer<GRAPH_T>;
 	using parent = mrpt::graphslam::optimizers::CGraphSlamOptimizer<GRAPH_T>;
+	using edge_const_iterator = typename GRAPH_T::edges_map_t::const_iterator;
 	/**\}*/
 
 	CLevMarqGSO();
@@ -178,6 +216,17 @@ class CLevMarqGSO
 		// nodeID difference for an edge to be considered loop closure
 		int LC_min_nodeid_diff;
 
+		/**\brief Only relinearize the nodes affected by new edges on each
+		 * update. This is a local approximation of a full optimization, see
+		 * the class docs (New in MRPT 2.7.1) */
+		bool incremental_optimization;
+		/**\brief Pose change of an optimized node above which it and its
+		 * neighbours are relinearized in the next incremental update */
+		double incremental_relinearize_threshold;
+		/**\brief Maximum number of nodes optimized in each incremental update
+		 * (0: no limit) */
+		size_t incremental_max_nodes;
+
 		// Map of TPairNodesID to their corresponding edge as recorded in the
 		// last update of the optimizer state
 		typename GRAPH_T::edges_map_t last_pair_nodes_to_edge;
@@ -317,6 +366,34 @@ class CLevMarqGSO
 	void getNearbyNodesOf(
 		std::set<mrpt::graphs::TNodeID>* nodes_set,
 		const mrpt::graphs::TNodeID& cur_nodeID, double distance);
+	/**\brief Get the nodes to optimize in an incremental update: those of
+	 * the edges added since the last call, plus those pending relinearization
+	 * from previous updates.
+	 *
+	 * At most \b incremental_max_nodes are returned, the most recent first;
+	 * the rest stay pending for the next updates.
+	 *
+	 * \param[out] edges_set The edges incident to the returned nodes, so the
+	 * optimizer does not have to look for them among all the graph edges.
+	 */
+	void getIncrementallyAffectedNodes(
+		std::set<mrpt::graphs::TNodeID>* nodes_set,
+		std::vector<edge_const_iterator>* edges_set);
+	/**\brief Update the incident edges of each node with the edges added to
+	 * the graph since the last call, and mark their nodes as pending.
+	 *
+	 * Edges are only ever added to the graph, and std::multimap iterators
+	 * stay valid, so a single linear pass over the graph edges finds the new
+	 * ones, without any per-edge lookup.
+	 */
+	void registerIncrementalNewEdges();
+	/**\brief Mark for relinearization those optimized nodes that moved more
+	 * than \b incremental_relinearize_threshold, and their neighbours
+	 *
+	 * \param[in] prev_poses Poses of the optimized nodes before optimizing
+	 */
+	void updateIncrementalPendingNodes(
+		const std::map<mrpt::graphs::TNodeID, pose_t>& prev_poses);
 
 	// protected members
 	//////////////////////////////////////////////////////////////
@@ -385,6 +462,20 @@ class CLevMarqGSO
 
 	/**\brief Minimum number of nodes before we try optimizing the graph */
 	size_t m_min_nodes_for_optimization{3};
+
+	/**\name Incremental optimization
+	 * \sa getIncrementallyAffectedNodes, updateIncrementalPendingNodes
+	 */
+	/**\{*/
+	/**\brief Number of edges between each pair of nodes already seen */
+	std::map<mrpt::graphs::TPairNodeIDs, size_t> m_incremental_known_edges;
+	size_t m_incremental_num_known_edges{0};
+	/**\brief Incident edges of each node, among the edges already seen */
+	std::map<mrpt::graphs::TNodeID, std::vector<edge_const_iterator>>
+		m_incremental_node_edges;
+	/**\brief Nodes to be relinearized in the next incremental updates */
+	std::set<mrpt::graphs::TNodeID> m_incremental_pending;
+	/**\}*/
 };
 }  // namespace mrpt::graphslam::optimizers
 #include "CLevMarqGSO_impl.h"
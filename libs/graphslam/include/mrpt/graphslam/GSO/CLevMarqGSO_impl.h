@@ -48,7 +48,9 @@ bool CLevMarqGSO<GRAPH_T>::updateState(
 		}
 		else
 		{  // single threaded implementation
-			bool is_full_update = this->checkForFullOptimization();
+			// Incremental updates deal with loop closures on their own:
+			bool is_full_update = !opt_params.incremental_optimization &&
+				this->checkForFullOptimization();
 			this->_optimizeGraph(is_full_update);
 		}
 	}
@@ -403,6 +405,8 @@ void CLevMarqGSO<GRAPH_T>::_optimizeGraph(bool is_full_update /*=false*/)
 
 	// set of nodes for which the optimization procedure will take place
 	std::set<mrpt::graphs::TNodeID>* nodes_to_optimize;
+	// their edges, only known in incremental updates:
+	std::vector<edge_const_iterator> edges_to_optimize;
 
 	// fill in the nodes in certain distance to the current node, only if
 	// is_full_update is not instructed
@@ -412,6 +416,14 @@ void CLevMarqGSO<GRAPH_T>::_optimizeGraph(bool is_full_update /*=false*/)
 		// root
 		// node.
 		nodes_to_optimize = nullptr;
+		// everything is relinearized now:
+		m_incremental_pending.clear();
+	}
+	else if (opt_params.incremental_optimization)
+	{
+		nodes_to_optimize = new std::set<mrpt::graphs::TNodeID>;
+		this->getIncrementallyAffectedNodes(
+			nodes_to_optimize, &edges_to_optimize);
 	}
 	else
 	{
@@ -429,10 +441,22 @@ void CLevMarqGSO<GRAPH_T>::_optimizeGraph(bool is_full_update /*=false*/)
 
 	graphslam::TResultInfoSpaLevMarq levmarq_info;
 
+	const bool is_incremental_update =
+		!is_full_update && opt_params.incremental_optimization;
+	// poses before the optimization, to detect those nodes that moved:
+	std::map<mrpt::graphs::TNodeID, pose_t> prev_poses;
+	if (is_incremental_update)
+		for (const auto nodeID : *nodes_to_optimize)
+			prev_poses[nodeID] = this->m_graph->nodes.at(nodeID);
+
 	// Execute the optimization
-	mrpt::graphslam::optimize_graph_spa_levmarq(
-		*(this->m_graph), levmarq_info, nodes_to_optimize, opt_params.cfg,
-		&CLevMarqGSO<GRAPH_T>::levMarqFeedback);  // functor feedback
+	if (!nodes_to_optimize || !nodes_to_optimize->empty())
+		mrpt::graphslam::optimize_graph_spa_levmarq(
+			*(this->m_graph), levmarq_info, nodes_to_optimize, opt_params.cfg,
+			&CLevMarqGSO<GRAPH_T>::levMarqFeedback,	 // functor feedback
+			is_incremental_update ? &edges_to_optimize : nullptr);
+
+	if (is_incremental_update) this->updateIncrementalPendingNodes(prev_poses);
 
 	if (is_full_update) { m_just_fully_optimized_graph = true; }
 	else
@@ -616,6 +640,130 @@ void CLevMarqGSO<GRAPH_T>::getNearbyNodesOf(
 	MRPT_END
 }
 
+template <class GRAPH_T>
+void CLevMarqGSO<GRAPH_T>::registerIncrementalNewEdges()
+{
+	MRPT_START
+	const auto& edges = this->m_graph->edges;
+
+	// Edges are only ever added: look for new ones only if the count changed
+	if (edges.size() == m_incremental_num_known_edges) return;
+	if (edges.size() < m_incremental_num_known_edges)
+	{
+		// Edges were removed: our iterators may be invalid, start over.
+		m_incremental_known_edges.clear();
+		m_incremental_node_edges.clear();
+		m_incremental_pending.clear();
+	}
+
+	// Both containers are sorted by node IDs: walk them in parallel.
+	auto known_it = m_incremental_known_edges.begin();
+	for (auto it = edges.begin(); it != edges.end();)
+	{
+		const mrpt::graphs::TPairNodeIDs ids = it->first;
+		auto group_end = it;
+		size_t num_edges = 0;
+		while (group_end != edges.end() && group_end->first == ids)
+		{
+			++group_end;
+			++num_edges;
+		}
+
+		while (known_it != m_incremental_known_edges.end() &&
+			   known_it->first < ids)
+			++known_it;
+		if (known_it == m_incremental_known_edges.end() ||
+			known_it->first != ids)
+			known_it = m_incremental_known_edges.emplace_hint(known_it, ids, 0);
+
+		// Edges with the same IDs keep their insertion order: the new ones
+		// are the last ones.
+		std::advance(it, std::min(known_it->second, num_edges));
+		for (; it != group_end; ++it)
+		{
+			m_incremental_node_edges[ids.first].push_back(it);
+			if (ids.second != ids.first)
+				m_incremental_node_edges[ids.second].push_back(it);
+			m_incremental_pending.insert(ids.first);
+			m_incremental_pending.insert(ids.second);
+		}
+		known_it->second = num_edges;
+	}
+	m_incremental_num_known_edges = edges.size();
+
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CLevMarqGSO<GRAPH_T>::getIncrementallyAffectedNodes(
+	std::set<mrpt::graphs::TNodeID>* nodes_set,
+	std::vector<edge_const_iterator>* edges_set)
+{
+	MRPT_START
+
+	this->registerIncrementalNewEdges();
+
+	// The root node is always fixed:
+	m_incremental_pending.erase(this->m_graph->root);
+
+	// Most recent nodes first:
+	const size_t max_nodes = opt_params.incremental_max_nodes;
+	for (auto it = m_incremental_pending.rbegin();
+		 it != m_incremental_pending.rend() &&
+		 (max_nodes == 0 || nodes_set->size() < max_nodes);
+		 ++it)
+	{
+		nodes_set->insert(*it);
+	}
+	for (const auto nodeID : *nodes_set)
+		m_incremental_pending.erase(nodeID);
+
+	// Their edges, each one only once:
+	for (const auto nodeID : *nodes_set)
+		for (const auto& e : m_incremental_node_edges[nodeID])
+		{
+			const auto otherID =
+				e->first.first == nodeID ? e->first.second : e->first.first;
+			if (otherID < nodeID && nodes_set->count(otherID) != 0)
+				continue;  // Already added from the other node
+			edges_set->push_back(e);
+		}
+
+	MRPT_LOG_DEBUG_STREAM(
+		"Incremental optimization of " << nodes_set->size() << " nodes ("
+									   << edges_set->size() << " edges), "
+									   << m_incremental_pending.size()
+									   << " still pending.");
+
+	MRPT_END
+}
+
+template <class GRAPH_T>
+void CLevMarqGSO<GRAPH_T>::updateIncrementalPendingNodes(
+	const std::map<mrpt::graphs::TNodeID, pose_t>& prev_poses)
+{
+	MRPT_START
+
+	for (const auto& [nodeID, prev_pose] : prev_poses)
+	{
+		const pose_t pose_change =
+			pose_t(this->m_graph->nodes.at(nodeID)) - prev_pose;
+		if (pose_change.asVectorVal().norm() <=
+			opt_params.incremental_relinearize_threshold)
+			continue;
+
+		// The error of the edges to its neighbours has changed: relinearize
+		// them together with this node, so the optimized region grows
+		// instead of relaxing one node at a time.
+		for (const auto& e : m_incremental_node_edges[nodeID])
+			for (const auto neighborID : {e->first.first, e->first.second})
+				if (neighborID != this->m_graph->root)
+					m_incremental_pending.insert(neighborID);
+	}
+
+	MRPT_END
+}
+
 template <class GRAPH_T>
 void CLevMarqGSO<GRAPH_T>::printParams() const
 {
@@ -708,6 +856,15 @@ void CLevMarqGSO<GRAPH_T>::OptimizationParams::dumpToTextStream(
 		<< (optimization_on_second_thread ? "TRUE" : "FALSE") << std::endl;
 	out << "Optimize nodes in distance     = " << optimization_distance << "\n";
 	out << "Min. node difference for LC    = " << LC_min_nodeid_diff << "\n";
+	out << "Incremental optimization       = "
+		<< (incremental_optimization ? "TRUE" : "FALSE") << std::endl;
+	if (incremental_optimization)
+	{
+		out << "Incremental relin. threshold   = "
+			<< incremental_relinearize_threshold << "\n";
+		out << "Incremental max. nodes         = " << incremental_max_nodes
+			<< "\n";
+	}
 	// out << cfg.getAsString() << std::endl;
 	MRPT_END
 }
@@ -729,6 +886,13 @@ void CLevMarqGSO<GRAPH_T>::OptimizationParams::loadFromConfigFile(
 			"Invalid value for optimization distance: %.2f",
 			optimization_distance));
 
+	incremental_optimization =
+		source.read_bool(section, "incremental_optimization", false, false);
+	incremental_relinearize_threshold = source.read_double(
+		section, "incremental_relinearize_threshold", 0.01, false);
+	incremental_max_nodes =
+		source.read_uint64_t(section, "incremental_max_nodes", 200, false);
+
 	// optimization parameters
 	cfg["verbose"] = source.read_bool(section, "verbose", false, false);
 	cfg["profiler"] = source.read_bool(section, "profiler", false, false);
@@ -16,8 +16,11 @@
 // (Must come *after* "types.h" above)
 #include <mrpt/graphslam/levmarq_impl.h>  // Aux classes
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace mrpt::graphslam
 {
@@ -47,6 +50,11 @@ namespace mrpt::graphslam
  * \param[in] functor_feedback Optional: a pointer to a user function can be
  *set here to be called on each LM loop iteration (eg to refresh the current
  *state and error, refresh a GUI, etc.)
+ * \param[in] in_edges_to_optimize Optional, only along with
+ *\a in_nodes_to_optimize: the edges of \a graph incident to those nodes. If
+ *given, only these edges are considered, instead of looking for them among
+ *all graph.edges, which costs O(E) for each call. Edges without any node in
+ *\a in_nodes_to_optimize are ignored (New in MRPT 2.7.1).
  *
  * List of optional parameters by name in "extra_params":
  *		- "verbose": (default=0) If !=0, produce verbose ouput.
@@ -61,6 +69,12 @@ namespace mrpt::graphslam
  *		- "e2": (default=1e-6) Lev-marq algorithm iteration stopping criterion
  *#2:
  *|delta_incr| < e2*(x_norm+e2)
+ *		- "num_threads": (default=1) Number of threads to linearize edges and
+ *build the Hessian. 0 means as many as CPU cores (New in MRPT 2.7.1).
+ *		- "cholesky_backend": (default="csparse") Sparse Cholesky algorithm:
+ *"csparse" (scalar, cs_chol()), or "block" (dense blocks of the pose size,
+ *which also uses "num_threads"). See mrpt::math::TSparseCholeskyBackend
+ *(New in MRPT 2.7.1).
  *
  * \note The following graph types are supported:
  *mrpt::graphs::CNetworkOfPoses2D, mrpt::graphs::CNetworkOfPoses3D,
@@ -82,7 +96,9 @@ void optimize_graph_spa_levmarq(
 	GRAPH_T& graph, TResultInfoSpaLevMarq& out_info,
 	const std::set<mrpt::graphs::TNodeID>* in_nodes_to_optimize = nullptr,
 	const mrpt::containers::yaml& extra_params = {},
-	FEEDBACK_CALLABLE functor_feedback = FEEDBACK_CALLABLE())
+	FEEDBACK_CALLABLE functor_feedback = FEEDBACK_CALLABLE(),
+	const std::vector<typename graphslam_traits<GRAPH_T>::edge_const_iterator>*
+		in_edges_to_optimize = nullptr)
 {
 	using namespace mrpt;
 	using namespace mrpt::poses;
@@ -112,6 +128,26 @@ void optimize_graph_spa_levmarq(
 	const double tau = extra_params.getOrDefault<double>("tau", 1e-3);
 	const double e1 = extra_params.getOrDefault<double>("e1", 1e-6);
 	const double e2 = extra_params.getOrDefault<double>("e2", 1e-6);
+	size_t num_threads = extra_params.getOrDefault<size_t>("num_threads", 1);
+	if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+
+	mrpt::WorkStealingThreadsPool* pool = nullptr;
+	if (num_threads > 1)
+		pool = &mrpt::WorkStealingThreadsPool::shared(num_threads, "levmarq");
+
+	CSparseMatrix::CholeskyDecomp::TParameters cholParams;
+	const auto cholBackend = extra_params.getOrDefault<std::string>(
+		"cholesky_backend", "csparse");
+	if (cholBackend == "block")
+	{
+		cholParams.backend = TSparseCholeskyBackend::Block;
+		cholParams.blockSize = DIMS_POSE;
+		cholParams.pool = pool;
+	}
+	else
+		ASSERTMSG_(
+			cholBackend == "csparse",
+			"cholesky_backend: expected 'csparse' or 'block'");
 
 	mrpt::system::CTimeLogger profiler(enable_profiler);
 	profiler.enter("optimize_graph_spa_levmarq (entire)");
@@ -161,31 +197,51 @@ void optimize_graph_spa_levmarq(
 	// Note: We'll need those Jacobians{i->j} where at least one "i" or "j"
 	//        is a free variable (i.e. it's in nodes_to_optimize)
 	// Now, build the list of all relevent "observations":
-	for (const auto& e : graph.edges)
+	const auto addObservation =
+		[&](const typename gst::edge_map_entry_t& e) {
+			const auto& ids = e.first;
+			const auto& edge = e.second;
+
+			if (nodes_to_optimize->find(ids.first) ==
+					nodes_to_optimize->end() &&
+				nodes_to_optimize->find(ids.second) ==
+					nodes_to_optimize->end())
+				return;	 // Skip this edge, none of the IDs are free variables.
+
+			// get the current global poses of both nodes in this constraint:
+			auto itP1 = graph.nodes.find(ids.first);
+			auto itP2 = graph.nodes.find(ids.second);
+			ASSERTMSG_(
+				itP1 != graph.nodes.end(), "Edge node1 has no global pose");
+			ASSERTMSG_(
+				itP2 != graph.nodes.end(), "Edge node2 has no global pose");
+
+			const auto& EDGE_POSE = edge.getPoseMean();
+
+			// Add all the data to the list of relevant observations:
+			typename gst::observation_info_t new_entry;
+			new_entry.edge = &e;
+			new_entry.edge_mean = &EDGE_POSE;
+			new_entry.P1 = &itP1->second;
+			new_entry.P2 = &itP2->second;
+
+			lstObservationData.push_back(new_entry);
+		};
+	if (in_nodes_to_optimize && in_edges_to_optimize)
 	{
-		const auto& ids = e.first;
-		const auto& edge = e.second;
-
-		if (nodes_to_optimize->find(ids.first) == nodes_to_optimize->end() &&
-			nodes_to_optimize->find(ids.second) == nodes_to_optimize->end())
-			continue;  // Skip this edge, none of the IDs are free variables.
-
-		// get the current global poses of both nodes in this constraint:
-		auto itP1 = graph.nodes.find(ids.first);
-		auto itP2 = graph.nodes.find(ids.second);
-		ASSERTMSG_(itP1 != graph.nodes.end(), "Edge node1 has no global pose");
-		ASSERTMSG_(itP2 != graph.nodes.end(), "Edge node2 has no global pose");
-
-		const auto& EDGE_POSE = edge.getPoseMean();
-
-		// Add all the data to the list of relevant observations:
-		typename gst::observation_info_t new_entry;
-		new_entry.edge = &e;
-		new_entry.edge_mean = &EDGE_POSE;
-		new_entry.P1 = &itP1->second;
-		new_entry.P2 = &itP2->second;
-
-		lstObservationData.push_back(new_entry);
+		// Sorted by node IDs, as in graph.edges:
+		std::vector<typename gst::edge_const_iterator> edges =
+			*in_edges_to_optimize;
+		std::stable_sort(edges.begin(), edges.end(), [](auto a, auto b) {
+			return a->first < b->first;
+		});
+		for (const auto& e : edges)
+			addObservation(*e);
+	}
+	else
+	{
+		for (const auto& e : graph.edges)
+			addObservation(e);
 	}
 
 	// The number of constraints, or observations actually implied in this
@@ -201,8 +257,8 @@ void optimize_graph_spa_levmarq(
 	// The list of Jacobians: for each constraint i->j,
 	//  we need the pair of Jacobians: { dh(xi,xj)_dxi, dh(xi,xj)_dxj },
 	//  which are "first" and "second" in each pair.
-	// Index of the map are the node IDs {i,j} for each contraint.
-	typename gst::map_pairIDs_pairJacobs_t lstJacobians;
+	// In the same order as lstObservationData.
+	std::vector<typename gst::TPairJacobs> lstJacobians;
 	// The vector of errors: err_k = SE(2/3)::pseudo_Ln( P_i * EDGE_ij *
 	// inv(P_j) )
 	// Separated vectors for each edge. i \in [0,nObservations-1], in
@@ -214,7 +270,7 @@ void optimize_graph_spa_levmarq(
 	// ===================================
 	profiler.enter("optimize_graph_spa_levmarq.Jacobians&err");
 	double total_sqr_err = computeJacobiansAndErrors<GRAPH_T>(
-		graph, lstObservationData, lstJacobians, errs);
+		graph, lstObservationData, lstJacobians, errs, pool);
 	profiler.leave("optimize_graph_spa_levmarq.Jacobians&err");
 
 	// Only once (since this will be static along iterations), build a quick
@@ -227,19 +283,34 @@ void optimize_graph_spa_levmarq(
 	// is fixed, as defined by "nodes_to_optimize"
 	obsIdx2fnIdx.reserve(nObservations);
 	ASSERTDEB_(lstJacobians.size() == nObservations);
-	for (auto itJ = lstJacobians.begin(); itJ != lstJacobians.end(); ++itJ)
 	{
-		const TNodeID id1 = itJ->first.first;
-		const TNodeID id2 = itJ->first.second;
-		obsIdx2fnIdx.emplace_back(
-			mrpt::containers::find_in_vector(id1, *nodes_to_optimize),
-			mrpt::containers::find_in_vector(id2, *nodes_to_optimize));
+		// (sorted, since it comes from a std::set)
+		const std::vector<TNodeID> freeIDs(
+			nodes_to_optimize->begin(), nodes_to_optimize->end());
+		const auto freeNodeIndex = [&freeIDs](TNodeID id) -> size_t {
+			const auto it =
+				std::lower_bound(freeIDs.begin(), freeIDs.end(), id);
+			if (it == freeIDs.end() || *it != id) return string::npos;
+			return static_cast<size_t>(it - freeIDs.begin());
+		};
+		for (const auto& obs : lstObservationData)
+			obsIdx2fnIdx.emplace_back(
+				freeNodeIndex(obs.edge->first.first),
+				freeNodeIndex(obs.edge->first.second));
 	}
 
+	// The sparsity pattern of the Hessian only depends on the graph
+	// topology: compute it only once, then refill its values in place.
+	profiler.enter("optimize_graph_spa_levmarq.sp_H:structure");
+	detail::HessianBlockStructure<gst> H_blocks;
+	H_blocks.build(obsIdx2fnIdx, nFreeNodes);
+	CSparseMatrix sp_H;
+	H_blocks.initSparseMatrix(sp_H);
+	profiler.leave("optimize_graph_spa_levmarq.sp_H:structure");
+
 	// other important vars for the main loop:
 	CVectorDouble grad(nFreeNodes * DIMS_POSE);
 	grad.setZero();
-	using map_ID2matrix_TxT_t = std::map<TNodeID, typename gst::matrix_TxT>;
 
 	double lambda = initial_lambda;	 // Will be actually set on first iteration.
 	double v = 1;  // was 2, changed since it's modified in the first pass.
@@ -254,7 +325,6 @@ void optimize_graph_spa_levmarq(
 
 	for (size_t iter = 0; iter < max_iters; ++iter)
 	{
-		vector<map_ID2matrix_TxT_t> H_map(nFreeNodes);
 		last_iter = iter;
 
 		// This will be false only when the delta leads to a worst solution and
@@ -271,59 +341,8 @@ void optimize_graph_spa_levmarq(
 			// that is: g_i is the "dot-product" of the i'th (transposed)
 			// block-column of J and the vector of errors "errs"
 			profiler.enter("optimize_graph_spa_levmarq.grad");
-
-			grad.setZero();
-
-			// "lstJacobians" is sorted in the same order than
-			// "lstObservationData":
-			ASSERTDEB_EQUAL_(lstJacobians.size(), lstObservationData.size());
-			{
-				size_t idx_obs;
-				typename gst::map_pairIDs_pairJacobs_t::const_iterator itJ;
-
-				for (idx_obs = 0, itJ = lstJacobians.begin();
-					 itJ != lstJacobians.end(); ++itJ, ++idx_obs)
-				{
-					// make sure they're in the expected order!
-					ASSERTDEB_(
-						itJ->first == lstObservationData[idx_obs].edge->first);
-
-					//  grad[k] += J^t_{i->k} * Inf.Matrix * errs_i
-					//    k: [0,nFreeNodes-1]     <-- IDs.first & IDs.second
-					//    i: [0,nObservations-1]  <--- idx_obs
-
-					// Get the corresponding indices in the vector of "free
-					// variables" being optimized:
-					const size_t idx1 = obsIdx2fnIdx[idx_obs].first;
-					const size_t idx2 = obsIdx2fnIdx[idx_obs].second;
-
-					if (idx1 != string::npos)
-					{
-						typename gst::Array_O grad_idx1;
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiply_Jt_W_err(
-								itJ->second.first /* J */,
-								lstObservationData[idx_obs].edge /* W */,
-								errs[idx_obs] /* err */, grad_idx1 /* out */
-							);
-						for (unsigned int i = 0; i < DIMS_POSE; i++)
-							grad[DIMS_POSE * idx1 + i] += grad_idx1[i];
-					}
-
-					if (idx2 != string::npos)
-					{
-						typename gst::Array_O grad_idx2;
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiply_Jt_W_err(
-								itJ->second.second /* J */,
-								lstObservationData[idx_obs].edge /* W */,
-								errs[idx_obs] /* err */, grad_idx2 /* out */
-							);
-						for (unsigned int i = 0; i < DIMS_POSE; i++)
-							grad[DIMS_POSE * idx2 + i] += grad_idx2[i];
-					}
-				}
-			}
+			H_blocks.computeGradient(
+				lstObservationData, lstJacobians, errs, grad, pool);
 			profiler.leave("optimize_graph_spa_levmarq.grad");
 
 			// End condition #1
@@ -341,82 +360,12 @@ void optimize_graph_spa_levmarq(
 				break;
 			}
 
-			profiler.enter("optimize_graph_spa_levmarq.sp_H:build map");
-			// ======================================================================
-			// Build sparse representation of the upper triangular part of
-			//  the Hessian matrix H = J^t * J
-			//
-			// Sparse memory structure is a vector of maps, such as:
-			//  - H_map[i]: corresponds to the i'th column of H.
-			//              Here "i" corresponds to [0,N-1] indices of
-			//              appearance in the map "*nodes_to_optimize".
-			//  - H_map[i][j] is the entry for the j'th row, with "j" also in
-			//  the range [0,N-1] as ordered in "*nodes_to_optimize".
-			// ======================================================================
-			{
-				size_t idxObs;
-				typename gst::map_pairIDs_pairJacobs_t::const_iterator
-					itJacobPair;
-
-				for (idxObs = 0, itJacobPair = lstJacobians.begin();
-					 idxObs < nObservations; ++itJacobPair, ++idxObs)
-				{
-					const bool Hij_upper_triang =
-						itJacobPair->first.first < itJacobPair->first.second;
-
-					// Indices in the "H_map" vector:
-					const size_t idx_i = obsIdx2fnIdx[idxObs].first;
-					const size_t idx_j = obsIdx2fnIdx[idxObs].second;
-
-					const bool is_i_free_node = idx_i != string::npos;
-					const bool is_j_free_node = idx_j != string::npos;
-
-					// Take references to both Jacobians (wrt pose "i" and pose
-					// "j"), taking into account the possible
-					// switch in their order:
-					const typename gst::matrix_TxT& J1 =
-						itJacobPair->second.first;
-					const typename gst::matrix_TxT& J2 =
-						itJacobPair->second.second;
-
-					// Is "i" a free (to be optimized) node? -> Ji^t * Inf *  Ji
-					if (is_i_free_node)
-					{
-						typename gst::matrix_TxT JtJ(
-							mrpt::math::UNINITIALIZED_MATRIX);
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiplyJtLambdaJ(
-								J1, JtJ, lstObservationData[idxObs].edge);
-						H_map[idx_i][idx_i] += JtJ;
-					}
-					// Is "j" a free (to be optimized) node? -> Jj^t * Inf *  Jj
-					if (is_j_free_node)
-					{
-						typename gst::matrix_TxT JtJ(
-							mrpt::math::UNINITIALIZED_MATRIX);
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiplyJtLambdaJ(
-								J2, JtJ, lstObservationData[idxObs].edge);
-						H_map[idx_j][idx_j] += JtJ;
-					}
-					// Are both "i" and "j" free nodes? -> Ji^t * Inf *  Jj
-					if (is_i_free_node && is_j_free_node)
-					{
-						typename gst::matrix_TxT JtJ(
-							mrpt::math::UNINITIALIZED_MATRIX);
-						detail::AuxErrorEval<typename gst::edge_t, gst>::
-							multiplyJ1tLambdaJ2(
-								J1, J2, JtJ, lstObservationData[idxObs].edge);
-						// We sort IDs such as "i" < "j" and we can build just
-						// the upper triangular part of the Hessian:
-						if (Hij_upper_triang)  // H_map[col][row]
-							H_map[idx_j][idx_i] += JtJ;
-						else
-							H_map[idx_i][idx_j].sum_At(JtJ);
-					}
-				}
-			}
-			profiler.leave("optimize_graph_spa_levmarq.sp_H:build map");
+			// Compute the blocks of the upper triangular part of the Hessian
+			// matrix H = J^t * J, with rows and columns in the order of
+			// "nodes_to_optimize":
+			profiler.enter("optimize_graph_spa_levmarq.sp_H:blocks");
+			H_blocks.computeBlocks(lstObservationData, lstJacobians, pool);
+			profiler.leave("optimize_graph_spa_levmarq.sp_H:blocks");
 
 			// Just in the first iteration, we need to calculate an estimate for
 			// the first value of "lamdba":
@@ -424,20 +373,7 @@ void optimize_graph_spa_levmarq(
 			{
 				profiler.enter(
 					"optimize_graph_spa_levmarq.lambda_init");	// ---\  .
-				double H_diagonal_max = 0;
-				for (size_t i = 0; i < nFreeNodes; i++)
-					for (auto it = H_map[i].begin(); it != H_map[i].end(); ++it)
-					{
-						const size_t j =
-							it->first;	// entry submatrix is for (i,j).
-						if (i == j)
-						{
-							for (size_t k = 0; k < DIMS_POSE; k++)
-								mrpt::keep_max(
-									H_diagonal_max, it->second(k, k));
-						}
-					}
-				lambda = tau * H_diagonal_max;
+				lambda = tau * H_blocks.maxDiagonal();
 
 				profiler.leave(
 					"optimize_graph_spa_levmarq.lambda_init");	// ---/
@@ -465,47 +401,10 @@ void optimize_graph_spa_levmarq(
 		}
 
 		profiler.enter("optimize_graph_spa_levmarq.sp_H:build");
-		// Now, build the actual sparse matrix H:
-		// Note: we only need to fill out the upper diagonal part, since
-		// Cholesky will later on ignore the other part.
-		CSparseMatrix sp_H(nFreeNodes * DIMS_POSE, nFreeNodes * DIMS_POSE);
-		for (size_t i = 0; i < nFreeNodes; i++)
-		{
-			const size_t i_offset = i * DIMS_POSE;
-
-			for (auto it = H_map[i].begin(); it != H_map[i].end(); ++it)
-			{
-				const size_t j = it->first;	 // entry submatrix is for (i,j).
-				const size_t j_offset = j * DIMS_POSE;
-
-				// For i==j (diagonal blocks), it's different, since we only
-				// need to insert their
-				// upper-diagonal half and also we have to add the lambda*I to
-				// the diagonal from the Lev-Marq. algorithm:
-				if (i == j)
-				{
-					for (size_t r = 0; r < DIMS_POSE; r++)
-					{
-						// c=r: add lambda from LM
-						sp_H.insert_entry_fast(
-							j_offset + r, i_offset + r,
-							it->second(r, r) + lambda);
-						// c>r:
-						for (size_t c = r + 1; c < DIMS_POSE; c++)
-						{
-							sp_H.insert_entry_fast(
-								j_offset + r, i_offset + c, it->second(r, c));
-						}
-					}
-				}
-				else
-				{
-					sp_H.insert_submatrix(j_offset, i_offset, it->second);
-				}
-			}
-		}  // end for each free node, build sp_H
-
-		sp_H.compressFromTriplet();
+		// Now, fill the actual sparse matrix H (upper triangular part only,
+		// since Cholesky will later on ignore the other part), adding the
+		// lambda*I term from the Lev-Marq. algorithm:
+		H_blocks.fillSparseMatrix(sp_H, lambda, pool);
 		profiler.leave("optimize_graph_spa_levmarq.sp_H:build");
 
 		// Use the cparse Cholesky decomposition to efficiently solve:
@@ -518,7 +417,8 @@ void optimize_graph_spa_levmarq(
 		{
 			profiler.enter("optimize_graph_spa_levmarq.sp_H:chol");
 			if (!ptrCh.get())
-				ptrCh = std::make_unique<CSparseMatrix::CholeskyDecomp>(sp_H);
+				ptrCh = std::make_unique<CSparseMatrix::CholeskyDecomp>(
+					sp_H, cholParams);
 			else
 				ptrCh.get()->update(sp_H);
 			profiler.leave("optimize_graph_spa_levmarq.sp_H:chol");
@@ -612,12 +512,12 @@ void optimize_graph_spa_levmarq(
 			// =============================================================
 			// Compute Jacobians & errors with the new "graph.nodes" info:
 			// =============================================================
-			typename gst::map_pairIDs_pairJacobs_t new_lstJacobians;
+			std::vector<typename gst::TPairJacobs> new_lstJacobians;
 			std::vector<typename gst::Array_O> new_errs;
 
 			profiler.enter("optimize_graph_spa_levmarq.Jacobians&err");
 			double new_total_sqr_err = computeJacobiansAndErrors<GRAPH_T>(
-				graph, lstObservationData, new_lstJacobians, new_errs);
+				graph, lstObservationData, new_lstJacobians, new_errs, pool);
 			profiler.leave("optimize_graph_spa_levmarq.Jacobians&err");
 
 			// Now, to decide whether to accept the change:
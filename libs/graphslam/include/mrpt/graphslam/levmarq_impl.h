@@ -8,7 +8,12 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/core/WorkerThreadsPool.h>
+
 #include <Eigen/Dense>
+#include <algorithm>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace mrpt
@@ -144,59 +149,291 @@ struct AuxErrorEval<CPose3DPDFGaussianInf, gst>
 	}
 };
 
+// Sparse structure of the upper triangular part of the Hessian in
+// optimize_graph_spa_levmarq(), made of DxD blocks (D: DOFs of one pose).
+// It only depends on the graph topology, so it is built once. Then, on each
+// iteration, blocks are recomputed from the Jacobians (in parallel, one block
+// per task, without any write conflict) and copied into a column-compressed
+// sparse matrix whose structure never changes.
+template <class gst>
+struct HessianBlockStructure
+{
+	static constexpr size_t D = gst::SE_TYPE::DOFs;
+	using matrix_TxT = typename gst::matrix_TxT;
+	using aux_t = AuxErrorEval<typename gst::edge_t, gst>;
+
+	// What one observation adds to one block:
+	enum class term_t : uint8_t
+	{
+		J1tJ1 = 0,	// J1'*W*J1
+		J2tJ2,	// J2'*W*J2
+		J1tJ2,	// J1'*W*J2
+		J2tJ1  // J2'*W*J1, i.e. the transpose of J1'*W*J2
+	};
+	struct term_entry_t
+	{
+		size_t obs;
+		term_t term;
+	};
+
+	// Block column "c" has the blocks in [blockColPtr[c],blockColPtr[c+1]),
+	// sorted by row. The last one is always the diagonal block.
+	std::vector<size_t> blockColPtr;
+	std::vector<size_t> blockRow;
+	// Terms added to block "k": [termPtr[k],termPtr[k+1]), in the order of
+	// observations.
+	std::vector<size_t> termPtr;
+	std::vector<term_entry_t> terms;
+	// Current value of each block:
+	std::vector<matrix_TxT> blocks;
+	// Column pointers of the scalar column-compressed matrix:
+	std::vector<int> colPtr;
+
+	// obsIdx2fnIdx: indices of the free nodes of each observation, or
+	// std::string::npos for fixed nodes.
+	void build(
+		const std::vector<std::pair<size_t, size_t>>& obsIdx2fnIdx,
+		const size_t nFreeNodes)
+	{
+		constexpr size_t NONE = std::string::npos;
+		struct entry_t
+		{
+			size_t col, row, obs;
+			term_t term;
+		};
+		std::vector<entry_t> es;
+		es.reserve(3 * obsIdx2fnIdx.size() + nFreeNodes);
+
+		// Make sure all diagonal blocks exist:
+		for (size_t c = 0; c < nFreeNodes; c++)
+			es.push_back({c, c, NONE, term_t::J1tJ1});
+
+		for (size_t k = 0; k < obsIdx2fnIdx.size(); k++)
+		{
+			const size_t i = obsIdx2fnIdx[k].first;
+			const size_t j = obsIdx2fnIdx[k].second;
+			if (i != NONE) es.push_back({i, i, k, term_t::J1tJ1});
+			if (j != NONE) es.push_back({j, j, k, term_t::J2tJ2});
+			if (i != NONE && j != NONE)
+			{
+				if (i < j) es.push_back({j, i, k, term_t::J1tJ2});
+				else
+					es.push_back({i, j, k, term_t::J2tJ1});
+			}
+		}
+		// (stable: keep the order of observations within each block)
+		std::stable_sort(
+			es.begin(), es.end(), [](const entry_t& a, const entry_t& b) {
+				return a.col < b.col || (a.col == b.col && a.row < b.row);
+			});
+
+		blockColPtr.assign(nFreeNodes + 1, 0);
+		blockRow.clear();
+		termPtr.clear();
+		terms.clear();
+		for (size_t idx = 0; idx < es.size(); idx++)
+		{
+			const auto& e = es[idx];
+			if (idx == 0 || e.col != es[idx - 1].col ||
+				e.row != es[idx - 1].row)
+			{
+				blockRow.push_back(e.row);
+				termPtr.push_back(terms.size());
+				blockColPtr[e.col + 1] = blockRow.size();
+			}
+			if (e.obs != NONE) terms.push_back({e.obs, e.term});
+		}
+		termPtr.push_back(terms.size());
+		blocks.resize(blockRow.size());
+
+		// Scalar columns: D rows per off-diagonal block, plus the upper
+		// triangular part of the diagonal block:
+		colPtr.assign(nFreeNodes * D + 1, 0);
+		for (size_t c = 0; c < nFreeNodes; c++)
+		{
+			const size_t nOffDiag = blockColPtr[c + 1] - blockColPtr[c] - 1;
+			for (size_t cc = 0; cc < D; cc++)
+				colPtr[c * D + cc + 1] = colPtr[c * D + cc] +
+					static_cast<int>(nOffDiag * D + cc + 1);
+		}
+	}
+
+	size_t nFreeNodes() const { return blockColPtr.size() - 1; }
+
+	// Sets the (constant) structure of the sparse Hessian:
+	void initSparseMatrix(mrpt::math::CSparseMatrix& H) const
+	{
+		std::vector<int> rowIdx(colPtr.back());
+		for (size_t c = 0; c < nFreeNodes(); c++)
+			for (size_t cc = 0; cc < D; cc++)
+			{
+				int* r = &rowIdx[colPtr[c * D + cc]];
+				for (size_t k = blockColPtr[c]; k < blockColPtr[c + 1]; k++)
+				{
+					const bool isDiag = (k + 1 == blockColPtr[c + 1]);
+					const size_t nRows = isDiag ? cc + 1 : D;
+					for (size_t rr = 0; rr < nRows; rr++)
+						*r++ = static_cast<int>(blockRow[k] * D + rr);
+				}
+			}
+		H.setColumnCompressedStructure(
+			nFreeNodes() * D, nFreeNodes() * D, colPtr, rowIdx);
+	}
+
+	template <class OBS_DATA, class JACOBS>
+	void computeBlocks(
+		const OBS_DATA& obsData, const JACOBS& jacobians,
+		mrpt::WorkStealingThreadsPool* pool)
+	{
+		const auto computeBlock = [&](size_t k) {
+			matrix_TxT& B = blocks[k];
+			B.setZero();
+			matrix_TxT JtJ(mrpt::math::UNINITIALIZED_MATRIX);
+			for (size_t t = termPtr[k]; t < termPtr[k + 1]; t++)
+			{
+				const auto& te = terms[t];
+				const auto& J = jacobians[te.obs];
+				const auto* edge = obsData[te.obs].edge;
+				switch (te.term)
+				{
+					case term_t::J1tJ1:
+						aux_t::multiplyJtLambdaJ(J.first, JtJ, edge);
+						B += JtJ;
+						break;
+					case term_t::J2tJ2:
+						aux_t::multiplyJtLambdaJ(J.second, JtJ, edge);
+						B += JtJ;
+						break;
+					case term_t::J1tJ2:
+						aux_t::multiplyJ1tLambdaJ2(
+							J.first, J.second, JtJ, edge);
+						B += JtJ;
+						break;
+					case term_t::J2tJ1:
+						aux_t::multiplyJ1tLambdaJ2(
+							J.first, J.second, JtJ, edge);
+						B.sum_At(JtJ);
+						break;
+				};
+			}
+		};
+		if (pool) pool->parallel_for(0, blocks.size(), computeBlock);
+		else
+			for (size_t k = 0; k < blocks.size(); k++)
+				computeBlock(k);
+	}
+
+	// grad = J^t * W * errs, from the terms of the diagonal blocks:
+	template <class OBS_DATA, class JACOBS, class ERRS>
+	void computeGradient(
+		const OBS_DATA& obsData, const JACOBS& jacobians, const ERRS& errs,
+		mrpt::math::CVectorDouble& grad,
+		mrpt::WorkStealingThreadsPool* pool) const
+	{
+		grad.resize(nFreeNodes() * D);
+		const auto computeNode = [&](size_t c) {
+			typename gst::Array_O g;
+			g.setZero();
+			const size_t k = blockColPtr[c + 1] - 1;  // diagonal block
+			for (size_t t = termPtr[k]; t < termPtr[k + 1]; t++)
+			{
+				const auto& te = terms[t];
+				const auto& J = jacobians[te.obs];
+				const auto* edge = obsData[te.obs].edge;
+				if (te.term == term_t::J1tJ1)
+					aux_t::multiply_Jt_W_err(J.first, edge, errs[te.obs], g);
+				else if (te.term == term_t::J2tJ2)
+					aux_t::multiply_Jt_W_err(J.second, edge, errs[te.obs], g);
+			}
+			for (size_t i = 0; i < D; i++)
+				grad[c * D + i] = g[i];
+		};
+		if (pool) pool->parallel_for(0, nFreeNodes(), computeNode);
+		else
+			for (size_t c = 0; c < nFreeNodes(); c++)
+				computeNode(c);
+	}
+
+	double maxDiagonal() const
+	{
+		double m = 0;
+		for (size_t c = 0; c < nFreeNodes(); c++)
+		{
+			const matrix_TxT& B = blocks[blockColPtr[c + 1] - 1];
+			for (size_t i = 0; i < D; i++)
+				mrpt::keep_max(m, B(i, i));
+		}
+		return m;
+	}
+
+	// Copies the blocks into the sparse Hessian, adding lambda*I:
+	void fillSparseMatrix(
+		mrpt::math::CSparseMatrix& H, const double lambda,
+		mrpt::WorkStealingThreadsPool* pool) const
+	{
+		double* vals = H.columnCompressedValues();
+		const auto fillColumn = [&](size_t c) {
+			for (size_t cc = 0; cc < D; cc++)
+			{
+				double* v = vals + colPtr[c * D + cc];
+				for (size_t k = blockColPtr[c]; k < blockColPtr[c + 1]; k++)
+				{
+					const bool isDiag = (k + 1 == blockColPtr[c + 1]);
+					const size_t nRows = isDiag ? cc + 1 : D;
+					for (size_t rr = 0; rr < nRows; rr++)
+						*v++ = blocks[k](rr, cc);
+					if (isDiag) *(v - 1) += lambda;
+				}
+			}
+		};
+		if (pool) pool->parallel_for(0, nFreeNodes(), fillColumn);
+		else
+			for (size_t c = 0; c < nFreeNodes(); c++)
+				fillColumn(c);
+	}
+};
+
 }  // namespace detail
 
 // Compute, at once, jacobians and the error vectors for each constraint in
-// "lstObservationData", returns the overall squared error.
+// "lstObservationData", returns the overall squared error. Both output
+// vectors are in the same order as "lstObservationData". Edges are
+// linearized in parallel if a thread pool is given.
 template <class GRAPH_T>
 double computeJacobiansAndErrors(
 	[[maybe_unused]] const GRAPH_T& graph,
 	const std::vector<typename graphslam_traits<GRAPH_T>::observation_info_t>&
 		lstObservationData,
-	typename graphslam_traits<GRAPH_T>::map_pairIDs_pairJacobs_t& lstJacobians,
-	std::vector<typename graphslam_traits<GRAPH_T>::Array_O>& errs)
+	std::vector<typename graphslam_traits<GRAPH_T>::TPairJacobs>& jacobians,
+	std::vector<typename graphslam_traits<GRAPH_T>::Array_O>& errs,
+	mrpt::WorkStealingThreadsPool* pool = nullptr)
 {
 	using gst = graphslam_traits<GRAPH_T>;
-
-	lstJacobians.clear();
-	errs.clear();
+	using pose_t = typename gst::graph_t::constraint_t::type_value;
 
 	const size_t nObservations = lstObservationData.size();
+	jacobians.resize(nObservations);
+	errs.resize(nObservations);
 
-	for (size_t i = 0; i < nObservations; i++)
-	{
+	const auto linearize = [&](size_t i) {
 		const typename gst::observation_info_t& obs = lstObservationData[i];
-		auto e = obs.edge;
-		const typename gst::graph_t::constraint_t::type_value* EDGE_POSE =
-			obs.edge_mean;
-		typename gst::graph_t::constraint_t::type_value* P1 = obs.P1;
-		typename gst::graph_t::constraint_t::type_value* P2 = obs.P2;
-
-		const auto& ids = e->first;
-		// const auto& edge = e->second;
+		const pose_t& EDGE_POSE = *obs.edge_mean;
 
 		// Compute the residual pose error of these pair of nodes + its
 		// constraint:
 		// DinvP1invP2 = inv(EDGE) * inv(P1) * P2 = (P2 \ominus P1) \ominus EDGE
-		typename gst::graph_t::constraint_t::type_value DinvP1invP2 =
-			((*P2) - (*P1)) - *EDGE_POSE;
-
-		// Add to vector of errors:
-		errs.resize(errs.size() + 1);
-		errs.back() = gst::SE_TYPE::log(DinvP1invP2);
+		const pose_t DinvP1invP2 = ((*obs.P2) - (*obs.P1)) - EDGE_POSE;
+		errs[i] = gst::SE_TYPE::log(DinvP1invP2);
 
 		// Compute the jacobians:
-		alignas(MRPT_MAX_STATIC_ALIGN_BYTES)
-			std::pair<mrpt::graphs::TPairNodeIDs, typename gst::TPairJacobs>
-				newMapEntry;
-		newMapEntry.first = ids;
 		gst::SE_TYPE::jacob_dDinvP1invP2_de1e2(
-			-(*EDGE_POSE), *P1, *P2, newMapEntry.second.first,
-			newMapEntry.second.second);
-
-		// And insert into map of jacobians:
-		lstJacobians.insert(lstJacobians.end(), newMapEntry);
-	}
+			-EDGE_POSE, *obs.P1, *obs.P2, jacobians[i].first,
+			jacobians[i].second);
+	};
+	if (pool) pool->parallel_for(0, nObservations, linearize);
+	else
+		for (size_t i = 0; i < nObservations; i++)
+			linearize(i);
 
 	// return overall square error:  (Was:
 	// std::accumulate(...,mrpt::squareNorm_accum<>), but led to GCC
@@ -207,5 +444,27 @@ double computeJacobiansAndErrors(
 	return ret_err;
 }
 
+// Compute, at once, jacobians and the error vectors for each constraint in
+// "lstObservationData", returns the overall squared error.
+template <class GRAPH_T>
+double computeJacobiansAndErrors(
+	const GRAPH_T& graph,
+	const std::vector<typename graphslam_traits<GRAPH_T>::observation_info_t>&
+		lstObservationData,
+	typename graphslam_traits<GRAPH_T>::map_pairIDs_pairJacobs_t& lstJacobians,
+	std::vector<typename graphslam_traits<GRAPH_T>::Array_O>& errs)
+{
+	std::vector<typename graphslam_traits<GRAPH_T>::TPairJacobs> jacobians;
+	const double ret_err = computeJacobiansAndErrors<GRAPH_T>(
+		graph, lstObservationData, jacobians, errs);
+
+	lstJacobians.clear();
+	for (size_t i = 0; i < jacobians.size(); i++)
+		lstJacobians.emplace_hint(
+			lstJacobians.end(), lstObservationData[i].edge->first,
+			jacobians[i]);
+	return ret_err;
+}
+
 }  // namespace graphslam
 }  // namespace mrpt
@@ -0,0 +1,116 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/graphs/CNetworkOfPoses.h>
+#include <mrpt/graphslam.h>
+#include <mrpt/random.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace mrpt;
+using namespace mrpt::graphs;
+using namespace mrpt::poses;
+
+namespace
+{
+using graph_t = CNetworkOfPoses2DInf;
+
+// Exposes the optimization step, so pending corrections can be propagated
+// without adding more nodes:
+class IncrementalGSO : public graphslam::optimizers::CLevMarqGSO<graph_t>
+{
+   public:
+	IncrementalGSO()
+	{
+		opt_params.optimization_on_second_thread = false;
+		opt_params.optimization_distance = 5;
+		opt_params.LC_min_nodeid_diff = 30;
+		opt_params.incremental_optimization = true;
+		opt_params.incremental_relinearize_threshold = 1e-5;
+		opt_params.incremental_max_nodes = 0;
+		opt_params.cfg["max_iterations"] = 100;
+	}
+	using graphslam::optimizers::CLevMarqGSO<graph_t>::_optimizeGraph;
+};
+
+graph_t::constraint_t makeEdge(const CPose2D& p)
+{
+	mrpt::math::CMatrixDouble33 inf;
+	inf.setDiagonal(3, 100.0);
+	return {p, inf};
+}
+}  // namespace
+
+// A robot going around a ring with noisy odometry, closing the loop at the
+// end: the incremental updates must end up close to a full optimization.
+TEST(CLevMarqGSO, incrementalVsFullOptimizationRing)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+
+	const size_t N = 40;
+	const double R = 10;
+	std::vector<CPose2D> gt;
+	for (size_t i = 0; i < N; i++)
+	{
+		const double ang = 2 * M_PI * i / N;
+		gt.emplace_back(R * std::cos(ang), R * std::sin(ang), ang + M_PI / 2);
+	}
+
+	graph_t graph;
+	graph.root = 0;
+	graph.nodes[0] = gt[0];
+
+	IncrementalGSO gso;
+	gso.setGraphPtr(&graph);
+
+	for (TNodeID i = 1; i < N; i++)
+	{
+		const CPose2D odo = (gt[i] - gt[i - 1]) +
+			CPose2D(rng.drawGaussian1D(0, 0.05), rng.drawGaussian1D(0, 0.05),
+					rng.drawGaussian1D(0, 0.01));
+		graph.nodes[i] = graph.nodes[i - 1] + odo;
+		graph.insertEdge(i - 1, i, makeEdge(odo));
+		// Loop closure:
+		if (i == N - 1) graph.insertEdge(i, 0, makeEdge(gt[0] - gt[i]));
+
+		gso.updateState({}, {}, {});
+	}
+
+	// The same graph, before any optimization:
+	graph_t full = graph;
+	for (TNodeID i = 1; i < N; i++)
+		full.nodes[i] = full.nodes[i - 1] +
+			full.edges.find({i - 1, i})->second.getPoseMean();
+	const double chi2_init = full.chi2();
+
+	mrpt::containers::yaml params;
+	params["max_iterations"] = 100;
+	graphslam::TResultInfoSpaLevMarq info;
+	graphslam::optimize_graph_spa_levmarq(full, info, nullptr, params);
+
+	// Each update only moves the neighbours of the nodes moved in the former
+	// one, so let the loop closure correction spread along the whole ring:
+	for (size_t k = 0; k < 10 * N; k++)
+		gso._optimizeGraph();
+
+	const double chi2_full = full.chi2(), chi2_inc = graph.chi2();
+	EXPECT_LT(chi2_full, 1e-2 * chi2_init);
+	EXPECT_LT(chi2_inc, chi2_full + 1e-2 * (chi2_init - chi2_full));
+	for (TNodeID i = 0; i < N; i++)
+	{
+		const auto& p_inc = graph.nodes.at(i);
+		const auto& p_full = full.nodes.at(i);
+		EXPECT_NEAR(p_inc.x(), p_full.x(), 0.05) << "node: " << i;
+		EXPECT_NEAR(p_inc.y(), p_full.y(), 0.05) << "node: " << i;
+		EXPECT_NEAR(p_inc.phi(), p_full.phi(), 0.01) << "node: " << i;
+	}
+}
@@ -77,6 +77,57 @@ class GraphTester : public GraphSlamLevMarqTest<my_graph_t>,
 
 	}  // end test_ring_path
 
+	void test_parallel_same_result()
+	{
+		my_graph_t graph_serial;
+		GraphSlamLevMarqTest<my_graph_t>::create_ring_path(graph_serial);
+		my_graph_t graph_parallel = graph_serial;
+
+		mrpt::containers::yaml params;
+		params["max_iterations"] = 20;
+
+		graphslam::TResultInfoSpaLevMarq info_serial, info_parallel;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_serial, info_serial, nullptr, params);
+
+		params["num_threads"] = 4;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_parallel, info_parallel, nullptr, params);
+
+		// Each Hessian block and gradient entry is summed in the same order
+		// no matter the number of threads:
+		EXPECT_EQ(info_serial.num_iters, info_parallel.num_iters);
+		EXPECT_DOUBLE_EQ(
+			info_serial.final_total_sq_error,
+			info_parallel.final_total_sq_error);
+		compare_two_graphs(graph_serial, graph_parallel, 1e-9, 1e-9);
+	}
+
+	void test_block_cholesky_same_result()
+	{
+		my_graph_t graph_csparse;
+		GraphSlamLevMarqTest<my_graph_t>::create_ring_path(graph_csparse);
+		my_graph_t graph_block = graph_csparse;
+
+		mrpt::containers::yaml params;
+		params["max_iterations"] = 20;
+
+		graphslam::TResultInfoSpaLevMarq info_csparse, info_block;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_csparse, info_csparse, nullptr, params);
+
+		params["cholesky_backend"] = "block";
+		params["num_threads"] = 4;
+		graphslam::optimize_graph_spa_levmarq(
+			graph_block, info_block, nullptr, params);
+
+		// Only round-off differences, from the different orderings:
+		EXPECT_NEAR(
+			info_csparse.final_total_sq_error, info_block.final_total_sq_error,
+			1e-6);
+		compare_two_graphs(graph_csparse, graph_block, 1e-6, 1e-6);
+	}
+
 	void compare_two_graphs(
 		const my_graph_t& g1, const my_graph_t& g2,
 		const double eps_node_pos = 1e-3, const double eps_edges = 1e-3)
@@ -222,6 +273,16 @@ using GraphTester3DInf = GraphTester<CNetworkOfPoses3DInf>;
 			test_ring_path(#_TYPE);                                            \
 		}                                                                      \
 	}                                                                          \
+	TEST_F(_TYPE, OptimizeParallel)                                            \
+	{                                                                          \
+		getRandomGenerator().randomize(123);                                   \
+		test_parallel_same_result();                                           \
+	}                                                                          \
+	TEST_F(_TYPE, OptimizeBlockCholesky)                                       \
+	{                                                                          \
+		getRandomGenerator().randomize(123);                                   \
+		test_block_cholesky_same_result();                                     \
+	}                                                                          \
 	TEST_F(_TYPE, BinarySerialization)                                         \
 	{                                                                          \
 		getRandomGenerator().randomize(123);                                   \
@@ -18,14 +18,21 @@ namespace mrpt::io
  * it.
  * If the file is not a .gz file, it silently reads data from the file.
  *
- * \sa CFileInputStream
+ * Files in the BGZF ("blocked gzip") format, as written by
+ * CFileGZOutputStream::enableBlockCompression(), are automatically detected.
+ * For them, blocks are decompressed in parallel by a pool of threads, reading
+ * ahead of the current position, and Seek() jumps directly to the block
+ * holding the target position instead of decompressing all the file up to
+ * it. See setDecompressionThreads().
+ *
+ * \sa CFileInputStream, CFileGZOutputStream
  * \ingroup mrpt_io_grp
  */
 class CFileGZInputStream : public CStream
 {
    private:
 	struct Impl;
-	mrpt::pimpl<Impl> m_f;
+	spimpl::unique_impl_ptr<Impl> m_f;
 	/** Compressed file size */
 	uint64_t m_file_size{0};
 
@@ -56,6 +63,19 @@ class CFileGZInputStream : public CStream
 		mrpt::optional_ref<std::string> error_msg = std::nullopt);
 	/** Closes the file */
 	void close();
+
+	/** Sets the number of threads used to decompress BGZF files open after
+	 * this call. 0 (the default) means using as many threads as reported by
+	 * std::thread::hardware_concurrency(). 1 means decompressing in the
+	 * calling thread, without readahead.
+	 * Regular gzip files are always decompressed in the calling thread.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void setDecompressionThreads(std::size_t numThreads);
+
+	/** Returns true if the open file is in the BGZF format.
+	 * \note (New in MRPT 2.7.1) */
+	bool isBlockCompressed() const;
 	/** Returns true if the file was open without errors. */
 	bool fileOpenCorrectly() const;
 	/** Returns true if the file was open without errors. */
@@ -68,12 +88,21 @@ class CFileGZInputStream : public CStream
 	/** Method for getting the total number of <b>compressed</b> bytes of in the
 	 * file (the physical size of the compressed file). */
 	uint64_t getTotalBytesCount() const override;
-	/** Method for getting the current cursor position in the <b>compressed</b>,
-	 * where 0 is the first byte and TotalBytesCount-1 the last one. */
+	/** Method for getting the current cursor position in the
+	 * <b>uncompressed</b> data, where 0 is the first byte. */
 	uint64_t getPosition() const override;
 
-	/** This method is not implemented in this class */
-	uint64_t Seek(int64_t, CStream::TSeekOrigin = sFromBeginning) override;
+	/** Moves the read cursor to the given position of the <b>uncompressed</b>
+	 * data. For regular gzip files this is emulated by zlib, decompressing
+	 * data from the beginning of the file if needed, and sFromEnd is not
+	 * supported. For BGZF files, any origin is supported and seeking costs at
+	 * most one block decompression (plus a scan of the headers of blocks not
+	 * visited yet, for seeks beyond the furthest position read so far).
+	 * \return The new position in the uncompressed data.
+	 * \note Implemented since MRPT 2.7.1
+	 */
+	uint64_t Seek(
+		int64_t Offset, CStream::TSeekOrigin Origin = sFromBeginning) override;
 	size_t Read(void* Buffer, size_t Count) override;
 	size_t Write(const void* Buffer, size_t Count) override;
 };	// End of class def.
@@ -19,14 +19,21 @@ namespace mrpt::io
  * compression level.
  * The generated files are in gzip format ("file.gz").
  *
- * \sa CFileOutputStream
+ * Optionally, files can be written in the BGZF ("blocked gzip") format (see
+ * enableBlockCompression()): a sequence of independent gzip members of up to
+ * 64 KiB of uncompressed data each. BGZF files are still standard gzip
+ * files, readable by any gzip tool, but CFileGZInputStream can decompress
+ * them in parallel and seek within them efficiently. In this mode, blocks
+ * are also compressed in parallel while writing.
+ *
+ * \sa CFileOutputStream, CFileGZInputStream
  * \ingroup mrpt_io_grp
  */
 class CFileGZOutputStream : public CStream
 {
    private:
 	struct Impl;
-	mrpt::pimpl<Impl> m_f;
+	spimpl::unique_impl_ptr<Impl> m_f;
 
    public:
 	/** Constructor: opens an output file with the given compression level
@@ -65,7 +72,28 @@ class CFileGZOutputStream : public CStream
 		mrpt::optional_ref<std::string> error_msg = std::nullopt,
 		const OpenMode mode = OpenMode::TRUNCATE);
 
-	/** Close the file */
+	/** Enables or disables writing files in the BGZF block-compressed
+	 * format, for files open after this call.
+	 *
+	 * \param numThreads Number of threads used to compress blocks. 0 means
+	 * using as many threads as reported by
+	 * std::thread::hardware_concurrency(). 1 means compressing in the
+	 * calling thread.
+	 *
+	 * \note When appending to an existing BGZF file, the BGZF format is
+	 * always used, even if not enabled with this method, so that the file
+	 * remains seekable.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void enableBlockCompression(bool enable = true, std::size_t numThreads = 0);
+
+	/** Returns whether the open file is being written in the BGZF format
+	 * \note (New in MRPT 2.7.1) */
+	bool isBlockCompressed() const;
+
+	/** Close the file. In BGZF mode, this waits for all pending blocks to be
+	 * compressed and written, and writes the BGZF end-of-file marker.
+	 * \exception std::exception On errors writing pending blocks. */
 	void close();
 	/** Returns true if the file was open without errors. */
 	bool fileOpenCorrectly() const;
@@ -0,0 +1,67 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/pimpl.h>
+
+#include <cstdint>
+#include <string>
+
+namespace mrpt::io
+{
+/** A read-only memory mapping of a whole file.
+ *
+ * The mapping is shared: several processes mapping the same file share the
+ * same physical memory pages, which are loaded lazily by the OS upon access.
+ * The file contents must not be modified while mapped.
+ *
+ * \sa CFileInputStream
+ * \ingroup mrpt_io_grp
+ * \note (New in MRPT 2.7.1)
+ */
+class CMemoryMappedFile
+{
+   public:
+	/** Default constructor; use open() to map a file. */
+	CMemoryMappedFile();
+	/** Constructor that calls open().
+	 * \exception std::exception On error mapping the file.
+	 */
+	explicit CMemoryMappedFile(const std::string& fileName);
+	~CMemoryMappedFile();
+
+	CMemoryMappedFile(const CMemoryMappedFile&) = delete;
+	CMemoryMappedFile& operator=(const CMemoryMappedFile&) = delete;
+
+	/** Maps the given file into memory, closing any previous one.
+	 * \exception std::exception On error opening or mapping the file.
+	 */
+	void open(const std::string& fileName);
+
+	/** Unmaps the file. Automatically called from the destructor. */
+	void close();
+
+	/** Returns true if a file is currently mapped (it may be empty) */
+	bool isOpen() const;
+
+	/** The mapped file contents, or nullptr for closed or empty files */
+	const uint8_t* data() const;
+	/** The size of the mapped file, in bytes */
+	uint64_t size() const;
+
+	/** Hints the OS whether the mapping is going to be read sequentially
+	 * (enabling aggressive readahead) or randomly. Ignored in Windows. */
+	void adviseSequential(bool sequential);
+
+   private:
+	struct Impl;
+	spimpl::unique_impl_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::io
@@ -9,13 +9,21 @@
 
 #include "io-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/exceptions.h>
 #include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CFileInputStream.h>
 #include <mrpt/system/filesystem.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>	// strerror
+#include <deque>
+#include <future>
+#include <thread>
 #include <type_traits>
+
+#include "bgzf.h"
 //
 #include <mrpt/config.h>
 #if HAVE_UNISTD_H
@@ -36,10 +44,237 @@ struct CFileGZInputStream::Impl
 {
 	gzFile f = nullptr;
 	std::string filename;
+
+	std::size_t decompressionThreads = 0;
+
+	// BGZF mode state:
+	struct BlockInfo
+	{
+		uint64_t cOffset, uOffset;
+		uint32_t cSize, uSize;
+	};
+	struct DecodedBlock
+	{
+		std::size_t index = 0;
+		std::vector<uint8_t> data;
+	};
+
+	CFileInputStream bgzfFile;
+	uint64_t fileSize = 0;
+	/** Blocks discovered so far, in file order */
+	std::vector<BlockInfo> blocks;
+	bool allBlocksKnown = false;
+	/** Index of the next block to be read from the file and decompressed */
+	std::size_t nextToRead = 0;
+	std::unique_ptr<mrpt::WorkerThreadsPool> pool;
+	std::size_t readAhead = 1;
+	std::deque<std::future<DecodedBlock>> inFlight;
+	/** The block being consumed by Read() */
+	std::vector<uint8_t> cur;
+	std::size_t curPos = 0;
+	/** Position in the uncompressed data */
+	uint64_t uPos = 0;
+
+	bool isBGZF() const { return bgzfFile.fileOpenCorrectly(); }
+
+	void closeBGZF()
+	{
+		// Let readahead jobs finish, instead of aborting them:
+		for (auto& fut : inFlight)
+			fut.wait();
+		inFlight.clear();
+		pool.reset();
+		bgzfFile.close();
+		blocks.clear();
+		allBlocksKnown = false;
+		nextToRead = 0;
+		cur.clear();
+		curPos = 0;
+		uPos = 0;
+	}
+
+	void readFromFile(uint64_t offset, void* buf, std::size_t len)
+	{
+		if (bgzfFile.getPosition() != offset) bgzfFile.Seek(offset);
+		if (bgzfFile.Read(buf, len) != len)
+			THROW_EXCEPTION_FMT(
+				"Truncated BGZF file: '%s' at offset %lu", filename.c_str(),
+				static_cast<unsigned long>(offset));
+	}
+
+	/** Reads the header of the next unknown block, and appends it to
+	 * `blocks`. If `raw` is not null, the whole block is read into it.
+	 * \return false on EOF. */
+	bool discoverNextBlock(std::vector<uint8_t>* raw)
+	{
+		if (allBlocksKnown) return false;
+
+		const uint64_t cOffset =
+			blocks.empty() ? 0 : blocks.back().cOffset + blocks.back().cSize;
+		const uint64_t uOffset =
+			blocks.empty() ? 0 : blocks.back().uOffset + blocks.back().uSize;
+		if (cOffset >= fileSize)
+		{
+			allBlocksKnown = true;
+			return false;
+		}
+
+		uint8_t header[internal::BGZF_HEADER_SIZE];
+		readFromFile(cOffset, header, sizeof(header));
+		const std::size_t cSize = internal::bgzf_block_size(header);
+		if (cSize < internal::BGZF_HEADER_SIZE + internal::BGZF_FOOTER_SIZE)
+			THROW_EXCEPTION_FMT(
+				"File '%s' is not a valid BGZF file: unexpected data at "
+				"offset %lu. Note that appending regular gzip data to BGZF "
+				"files is not supported.",
+				filename.c_str(), static_cast<unsigned long>(cOffset));
+
+		uint32_t uSize = 0;
+		if (raw)
+		{
+			raw->resize(cSize);
+			std::memcpy(raw->data(), header, sizeof(header));
+			readFromFile(
+				cOffset + sizeof(header), raw->data() + sizeof(header),
+				cSize - sizeof(header));
+			uSize = internal::bgzf_block_data_size(raw->data(), cSize);
+		}
+		else
+		{
+			uint8_t isize[4];
+			readFromFile(cOffset + cSize - 4, isize, sizeof(isize));
+			uSize = static_cast<uint32_t>(isize[0]) |
+				(static_cast<uint32_t>(isize[1]) << 8) |
+				(static_cast<uint32_t>(isize[2]) << 16) |
+				(static_cast<uint32_t>(isize[3]) << 24);
+		}
+
+		blocks.push_back(
+			{cOffset, uOffset, static_cast<uint32_t>(cSize), uSize});
+		return true;
+	}
+
+	/** Reads the next block from the file and enqueues it for
+	 * decompression. \return false on EOF. */
+	bool enqueueNextBlock()
+	{
+		std::vector<uint8_t> raw;
+		if (nextToRead < blocks.size())
+		{
+			const auto& b = blocks[nextToRead];
+			raw.resize(b.cSize);
+			readFromFile(b.cOffset, raw.data(), b.cSize);
+		}
+		else if (!discoverNextBlock(&raw))
+			return false;
+
+		auto job = [idx = nextToRead](const std::vector<uint8_t>& blk) {
+			DecodedBlock b;
+			b.index = idx;
+			internal::bgzf_decompress_block(blk.data(), blk.size(), b.data);
+			return b;
+		};
+		nextToRead++;
+
+		if (pool) inFlight.emplace_back(pool->enqueue(job, std::move(raw)));
+		else
+			inFlight.emplace_back(
+				std::async(std::launch::deferred, job, std::move(raw)));
+		return true;
+	}
+
+	/** Makes the next block the current one. \return false on EOF */
+	bool nextBlock()
+	{
+		while (inFlight.size() < readAhead && enqueueNextBlock())
+		{
+		}
+		if (inFlight.empty()) return false;
+
+		auto fut = std::move(inFlight.front());
+		inFlight.pop_front();
+		cur = fut.get().data;
+		curPos = 0;
+
+		// Keep the readahead queue full while the caller consumes this one:
+		while (inFlight.size() < readAhead && enqueueNextBlock())
+		{
+		}
+		return true;
+	}
+
+	std::size_t read(uint8_t* buf, std::size_t count)
+	{
+		std::size_t total = 0;
+		while (count)
+		{
+			if (curPos >= cur.size())
+			{
+				if (!nextBlock()) break;
+				continue;
+			}
+			const std::size_t n = std::min(count, cur.size() - curPos);
+			std::memcpy(buf, cur.data() + curPos, n);
+			buf += n;
+			count -= n;
+			curPos += n;
+			total += n;
+		}
+		uPos += total;
+		return total;
+	}
+
+	uint64_t seek(uint64_t target)
+	{
+		// Discover blocks up to the target, if needed:
+		while (!allBlocksKnown &&
+			   (blocks.empty() ||
+				blocks.back().uOffset + blocks.back().uSize <= target))
+			discoverNextBlock(nullptr);
+
+		const uint64_t uTotal =
+			blocks.empty() ? 0 : blocks.back().uOffset + blocks.back().uSize;
+		target = std::min(target, uTotal);
+
+		inFlight.clear();
+		cur.clear();
+		curPos = 0;
+		uPos = target;
+
+		if (target == uTotal)
+		{
+			nextToRead = blocks.size();
+			return uPos;
+		}
+
+		// Last block starting at or before the target:
+		const auto it = std::upper_bound(
+			blocks.begin(), blocks.end(), target,
+			[](uint64_t t, const BlockInfo& b) { return t < b.uOffset; });
+		ASSERT_(it != blocks.begin());
+		nextToRead = static_cast<std::size_t>(it - blocks.begin()) - 1;
+		const uint64_t skip = target - blocks[nextToRead].uOffset;
+
+		if (!nextBlock()) THROW_EXCEPTION("Unexpected EOF in BGZF file");
+		curPos = static_cast<std::size_t>(skip);
+		return uPos;
+	}
 };
 
+namespace
+{
+bool isBGZFFile(const std::string& fileName)
+{
+	CFileInputStream f;
+	if (!f.open(fileName)) return false;
+	uint8_t header[internal::BGZF_HEADER_SIZE];
+	return f.Read(header, sizeof(header)) == sizeof(header) &&
+		internal::bgzf_block_size(header) != 0;
+}
+}  // namespace
+
 CFileGZInputStream::CFileGZInputStream()
-	: m_f(mrpt::make_impl<CFileGZInputStream::Impl>())
+	: m_f(spimpl::make_unique_impl<CFileGZInputStream::Impl>())
 {
 }
 
@@ -56,7 +291,7 @@ bool CFileGZInputStream::open(
 {
 	MRPT_START
 
-	if (m_f->f) gzclose(m_f->f);
+	close();
 
 	// Get compressed file size:
 	m_file_size = mrpt::system::getFileSize(fileName);
@@ -68,13 +303,34 @@ bool CFileGZInputStream::open(
 		return false;
 	}
 
+	m_f->filename = fileName;
+
+	if (isBGZFFile(fileName))
+	{
+		auto& d = *m_f;
+		if (!d.bgzfFile.open(fileName))
+		{
+			if (error_msg)
+				error_msg.value().get() = std::string(strerror(errno));
+			return false;
+		}
+		d.fileSize = m_file_size;
+
+		std::size_t nThreads = d.decompressionThreads;
+		if (nThreads == 0)
+			nThreads = std::max(1U, std::thread::hardware_concurrency());
+		if (nThreads > 1)
+			d.pool = std::make_unique<mrpt::WorkerThreadsPool>(
+				nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "bgzf_read");
+		d.readAhead = nThreads > 1 ? 2 * nThreads : 1;
+		return true;
+	}
+
 	// Open gz stream:
 	m_f->f = gzopen(fileName.c_str(), "rb");
 	if (m_f->f == nullptr && error_msg)
 		error_msg.value().get() = std::string(strerror(errno));
 
-	m_f->filename = fileName;
-
 	return m_f->f != nullptr;
 	MRPT_END
 }
@@ -85,13 +341,24 @@ void CFileGZInputStream::close()
 	{
 		gzclose(m_f->f);
 		m_f->f = nullptr;
-		m_f->filename.clear();
 	}
+	if (m_f->isBGZF()) m_f->closeBGZF();
+	m_f->filename.clear();
 }
 
+void CFileGZInputStream::setDecompressionThreads(std::size_t numThreads)
+{
+	m_f->decompressionThreads = numThreads;
+}
+
+bool CFileGZInputStream::isBlockCompressed() const { return m_f->isBGZF(); }
+
 CFileGZInputStream::~CFileGZInputStream() { close(); }
 size_t CFileGZInputStream::Read(void* Buffer, size_t Count)
 {
+	if (m_f->isBGZF())
+		return m_f->read(static_cast<uint8_t*>(Buffer), Count);
+
 	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
 
 	return gzread(m_f->f, Buffer, Count);
@@ -105,27 +372,70 @@ size_t CFileGZInputStream::Write(
 
 uint64_t CFileGZInputStream::getTotalBytesCount() const
 {
-	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
+	if (!fileOpenCorrectly()) { THROW_EXCEPTION("File is not open."); }
 	return m_file_size;
 }
 
 uint64_t CFileGZInputStream::getPosition() const
 {
+	if (m_f->isBGZF()) return m_f->uPos;
 	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
 	return gztell(m_f->f);
 }
 
-bool CFileGZInputStream::fileOpenCorrectly() const { return m_f->f != nullptr; }
+bool CFileGZInputStream::fileOpenCorrectly() const
+{
+	return m_f->f != nullptr || m_f->isBGZF();
+}
 bool CFileGZInputStream::checkEOF()
 {
+	if (m_f->isBGZF())
+	{
+		const auto& d = *m_f;
+		return d.curPos >= d.cur.size() && d.inFlight.empty() &&
+			d.allBlocksKnown && d.nextToRead >= d.blocks.size();
+	}
 	if (!m_f->f) return true;
 	else
 		return 0 != gzeof(m_f->f);
 }
 
-uint64_t CFileGZInputStream::Seek(int64_t, CStream::TSeekOrigin)
+uint64_t CFileGZInputStream::Seek(int64_t Offset, CStream::TSeekOrigin Origin)
 {
-	THROW_EXCEPTION("Method not available in this class.");
+	MRPT_START
+
+	if (m_f->isBGZF())
+	{
+		auto& d = *m_f;
+		int64_t target = Offset;
+		switch (Origin)
+		{
+			case sFromBeginning: break;
+			case sFromCurrent: target += static_cast<int64_t>(d.uPos); break;
+			case sFromEnd:
+				while (d.discoverNextBlock(nullptr))
+				{
+				}
+				if (!d.blocks.empty())
+					target += static_cast<int64_t>(
+						d.blocks.back().uOffset + d.blocks.back().uSize);
+				break;
+		}
+		ASSERTMSG_(target >= 0, "Seek to a negative position");
+		return d.seek(static_cast<uint64_t>(target));
+	}
+
+	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
+	ASSERTMSG_(
+		Origin != sFromEnd,
+		"sFromEnd is only supported for BGZF files in this class.");
+	const auto ret = gzseek(
+		m_f->f, static_cast<z_off_t>(Offset),
+		Origin == sFromBeginning ? SEEK_SET : SEEK_CUR);
+	if (ret < 0) THROW_EXCEPTION("gzseek() failed");
+	return static_cast<uint64_t>(ret);
+
+	MRPT_END
 }
 
 std::string CFileGZInputStream::getStreamDescription() const
@@ -9,12 +9,23 @@
 
 #include "io-precomp.h"	 // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/exceptions.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/system/filesystem.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>	// strerror
+#include <deque>
+#include <future>
+#include <iostream>
+#include <thread>
 #include <type_traits>
+
+#include "bgzf.h"
 //
 #include <mrpt/config.h>
 #if HAVE_UNISTD_H
@@ -30,10 +41,103 @@ struct CFileGZOutputStream::Impl
 {
 	gzFile f = nullptr;
 	std::string filename;
+
+	// BGZF options:
+	bool blockCompressionEnabled = false;
+	std::size_t blockCompressionThreads = 0;
+
+	// BGZF mode state:
+	CFileOutputStream bgzfFile;
+	int compressLevel = 1;
+	uint64_t bgzfPosition = 0;
+	std::vector<uint8_t> pendingData;
+	std::unique_ptr<mrpt::WorkerThreadsPool> pool;
+	std::deque<std::future<std::vector<uint8_t>>> inFlight;
+
+	bool isBGZF() const { return bgzfFile.fileOpenCorrectly(); }
+
+	void writeBytes(const void* data, std::size_t n)
+	{
+		if (bgzfFile.Write(data, n) != n)
+			THROW_EXCEPTION_FMT(
+				"Error writing to file: '%s'", filename.c_str());
+	}
+
+	void writeBlock(const std::vector<uint8_t>& block)
+	{
+		writeBytes(block.data(), block.size());
+	}
+
+	void writeFrontBlock()
+	{
+		auto fut = std::move(inFlight.front());
+		inFlight.pop_front();
+		writeBlock(fut.get());
+	}
+
+	void submitPendingBlock()
+	{
+		if (!pool)
+		{
+			writeBlock(internal::bgzf_compress_block(
+				pendingData.data(), pendingData.size(), compressLevel));
+			pendingData.clear();
+			return;
+		}
+
+		inFlight.emplace_back(pool->enqueue(
+			[level = compressLevel](const std::vector<uint8_t>& data) {
+				return internal::bgzf_compress_block(
+					data.data(), data.size(), level);
+			},
+			std::move(pendingData)));
+		pendingData.clear();
+		pendingData.reserve(internal::BGZF_BLOCK_DATA_SIZE);
+
+		// Bounded queue: do not let blocks pile up in memory:
+		while (inFlight.size() > 2 * pool->size())
+			writeFrontBlock();
+	}
+
+	void closeBGZF()
+	{
+		if (!isBGZF()) return;
+		try
+		{
+			if (!pendingData.empty()) submitPendingBlock();
+			while (!inFlight.empty())
+				writeFrontBlock();
+			writeBytes(
+				internal::BGZF_EOF_BLOCK, internal::BGZF_EOF_BLOCK_SIZE);
+		}
+		catch (...)
+		{
+			inFlight.clear();
+			pendingData.clear();
+			pool.reset();
+			bgzfFile.close();
+			throw;
+		}
+		pool.reset();
+		bgzfFile.close();
+	}
 };
 
+namespace
+{
+bool isBGZFFile(const std::string& fileName)
+{
+	if (!mrpt::system::fileExists(fileName)) return false;
+	CFileInputStream f;
+	if (!f.open(fileName)) return false;
+	uint8_t header[internal::BGZF_HEADER_SIZE];
+	return f.Read(header, sizeof(header)) == sizeof(header) &&
+		internal::bgzf_block_size(header) != 0;
+}
+}  // namespace
+
 CFileGZOutputStream::CFileGZOutputStream()
-	: m_f(mrpt::make_impl<CFileGZOutputStream::Impl>())
+	: m_f(spimpl::make_unique_impl<CFileGZOutputStream::Impl>())
 {
 }
 
@@ -56,7 +160,33 @@ bool CFileGZOutputStream::open(
 {
 	MRPT_START
 
-	if (m_f->f) gzclose(m_f->f);
+	close();
+
+	m_f->filename = fileName;
+
+	if (m_f->blockCompressionEnabled ||
+		(mode == OpenMode::APPEND && isBGZFFile(fileName)))
+	{
+		auto& d = *m_f;
+		if (!d.bgzfFile.open(fileName, mode))
+		{
+			if (error_msg)
+				error_msg.value().get() = std::string(strerror(errno));
+			return false;
+		}
+		d.compressLevel = std::clamp(compress_level, 0, 9);
+		d.bgzfPosition = 0;
+		d.pendingData.clear();
+		d.pendingData.reserve(internal::BGZF_BLOCK_DATA_SIZE);
+
+		std::size_t nThreads = d.blockCompressionThreads;
+		if (nThreads == 0)
+			nThreads = std::max(1U, std::thread::hardware_concurrency());
+		if (nThreads > 1)
+			d.pool = std::make_unique<mrpt::WorkerThreadsPool>(
+				nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "bgzf_write");
+		return true;
+	}
 
 	// Open gz stream:
 	m_f->f = gzopen(
@@ -66,22 +196,42 @@ bool CFileGZOutputStream::open(
 	if (m_f->f == nullptr && error_msg)
 		error_msg.value().get() = std::string(strerror(errno));
 
-	m_f->filename = fileName;
-
 	return m_f->f != nullptr;
 
 	MRPT_END
 }
 
-CFileGZOutputStream::~CFileGZOutputStream() { close(); }
+void CFileGZOutputStream::enableBlockCompression(
+	bool enable, std::size_t numThreads)
+{
+	m_f->blockCompressionEnabled = enable;
+	m_f->blockCompressionThreads = numThreads;
+}
+
+bool CFileGZOutputStream::isBlockCompressed() const { return m_f->isBGZF(); }
+
+CFileGZOutputStream::~CFileGZOutputStream()
+{
+	try
+	{
+		close();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[~CFileGZOutputStream] " << mrpt::exception_to_str(e)
+				  << std::endl;
+	}
+}
+
 void CFileGZOutputStream::close()
 {
 	if (m_f->f)
 	{
 		gzclose(m_f->f);
 		m_f->f = nullptr;
-		m_f->filename.clear();
 	}
+	if (m_f->isBGZF()) m_f->closeBGZF();
+	m_f->filename.clear();
 }
 
 size_t CFileGZOutputStream::Read(void*, size_t)
@@ -91,19 +241,40 @@ size_t CFileGZOutputStream::Read(void*, size_t)
 
 size_t CFileGZOutputStream::Write(const void* Buffer, size_t Count)
 {
+	if (m_f->isBGZF())
+	{
+		auto& d = *m_f;
+		const auto* data = static_cast<const uint8_t*>(Buffer);
+		size_t remaining = Count;
+		while (remaining)
+		{
+			const size_t n = std::min(
+				remaining,
+				internal::BGZF_BLOCK_DATA_SIZE - d.pendingData.size());
+			d.pendingData.insert(d.pendingData.end(), data, data + n);
+			data += n;
+			remaining -= n;
+			if (d.pendingData.size() == internal::BGZF_BLOCK_DATA_SIZE)
+				d.submitPendingBlock();
+		}
+		d.bgzfPosition += Count;
+		return Count;
+	}
+
 	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
 	return gzwrite(m_f->f, const_cast<void*>(Buffer), Count);
 }
 
 uint64_t CFileGZOutputStream::getPosition() const
 {
+	if (m_f->isBGZF()) return m_f->bgzfPosition;
 	if (!m_f->f) { THROW_EXCEPTION("File is not open."); }
 	return gztell(m_f->f);
 }
 
 bool CFileGZOutputStream::fileOpenCorrectly() const
 {
-	return m_f->f != nullptr;
+	return m_f->f != nullptr || m_f->isBGZF();
 }
 uint64_t CFileGZOutputStream::Seek(int64_t, CStream::TSeekOrigin)
 {
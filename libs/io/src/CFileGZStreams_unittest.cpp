@@ -157,3 +157,86 @@ TEST(CFileGZStreams, compareWithTestGZFiles)
 			<< " compress_level:" << compress_level;
 	}
 }
+
+TEST(CFileGZStreams, readwriteBlockCompressed)
+{
+	// Several BGZF blocks, with both compressible and random data:
+	std::vector<uint8_t> tst_data;
+	generate_test_data(tst_data);
+	std::vector<uint8_t> data;
+	mrpt::random::Generator_MT19937 rng;
+	rng.seed(321U);
+	for (int i = 0; i < 300; i++)
+	{
+		data.insert(data.end(), tst_data.begin(), tst_data.end());
+		for (int k = 0; k < 100; k++)
+			data.push_back(static_cast<uint8_t>(rng()));
+	}
+
+	for (size_t nThreads : {1U, 4U})
+	{
+		const std::string fil = mrpt::system::getTempFileName();
+		// Write, in chunks of different sizes:
+		{
+			mrpt::io::CFileGZOutputStream fil_out;
+			fil_out.enableBlockCompression(true, nThreads);
+			EXPECT_TRUE(fil_out.open(fil, 6));
+			EXPECT_TRUE(fil_out.isBlockCompressed());
+			size_t i = 0;
+			for (size_t chunk = 1; i < data.size(); chunk = (chunk * 7) % 5003)
+			{
+				const size_t n = std::min(chunk, data.size() - i);
+				EXPECT_EQ(fil_out.Write(&data[i], n), n);
+				i += n;
+			}
+			EXPECT_EQ(fil_out.getPosition(), data.size());
+		}
+		// Append (the BGZF format is kept automatically):
+		{
+			mrpt::io::CFileGZOutputStream fil_out;
+			EXPECT_TRUE(fil_out.open(
+				fil, 1, std::nullopt, mrpt::io::OpenMode::APPEND));
+			EXPECT_TRUE(fil_out.isBlockCompressed());
+			fil_out.Write(&tst_data[0], tst_data.size());
+		}
+		data.insert(data.end(), tst_data.begin(), tst_data.end());
+
+		// Read all:
+		mrpt::io::CFileGZInputStream fil_in;
+		fil_in.setDecompressionThreads(nThreads);
+		EXPECT_TRUE(fil_in.open(fil));
+		EXPECT_TRUE(fil_in.isBlockCompressed());
+
+		std::vector<uint8_t> rd_buf(data.size() + 10);
+		const size_t rd_count = fil_in.Read(rd_buf.data(), rd_buf.size());
+		EXPECT_EQ(rd_count, data.size());
+		EXPECT_TRUE(std::equal(data.begin(), data.end(), rd_buf.begin()));
+		EXPECT_TRUE(fil_in.checkEOF());
+
+		// Random access:
+		for (size_t pos : {size_t(0), size_t(70000), size_t(1), data.size() - 5,
+						   size_t(123456), size_t(65280), size_t(65279)})
+		{
+			EXPECT_EQ(fil_in.Seek(pos), pos);
+			EXPECT_EQ(fil_in.getPosition(), pos);
+			uint8_t buf[10];
+			const size_t n = std::min<size_t>(10, data.size() - pos);
+			EXPECT_EQ(fil_in.Read(buf, 10), n);
+			EXPECT_TRUE(std::equal(buf, buf + n, &data[pos]));
+		}
+		EXPECT_EQ(
+			fil_in.Seek(-3, mrpt::io::CStream::sFromEnd), data.size() - 3);
+		EXPECT_EQ(
+			fil_in.Seek(-1, mrpt::io::CStream::sFromCurrent), data.size() - 4);
+
+		// A new reader seeking to a block never visited before:
+		mrpt::io::CFileGZInputStream fil_in2(fil);
+		EXPECT_EQ(fil_in2.Seek(200000), 200000U);
+		uint8_t buf[10];
+		EXPECT_EQ(fil_in2.Read(buf, 10), 10U);
+		EXPECT_TRUE(std::equal(buf, buf + 10, &data[200000]));
+
+		data.resize(data.size() - tst_data.size());
+		mrpt::system::deleteFile(fil);
+	}
+}
@@ -0,0 +1,150 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "io-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/exceptions.h>
+#include <mrpt/io/CMemoryMappedFile.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace mrpt::io;
+
+struct CMemoryMappedFile::Impl
+{
+	const uint8_t* data = nullptr;
+	uint64_t size = 0;
+	bool isOpen = false;
+#ifdef _WIN32
+	HANDLE hFile = INVALID_HANDLE_VALUE;
+	HANDLE hMapping = nullptr;
+#else
+	int fd = -1;
+#endif
+};
+
+CMemoryMappedFile::CMemoryMappedFile()
+	: m_impl(spimpl::make_unique_impl<Impl>())
+{
+}
+
+CMemoryMappedFile::CMemoryMappedFile(const std::string& fileName)
+	: CMemoryMappedFile()
+{
+	open(fileName);
+}
+
+CMemoryMappedFile::~CMemoryMappedFile() { close(); }
+
+void CMemoryMappedFile::open(const std::string& fileName)
+{
+	close();
+
+	auto& d = *m_impl;
+#ifdef _WIN32
+	d.hFile = CreateFileA(
+		fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (d.hFile == INVALID_HANDLE_VALUE)
+		THROW_EXCEPTION_FMT("Cannot open file: `%s`", fileName.c_str());
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(d.hFile, &fileSize))
+	{
+		close();
+		THROW_EXCEPTION_FMT("Cannot stat file: `%s`", fileName.c_str());
+	}
+	d.size = static_cast<uint64_t>(fileSize.QuadPart);
+	d.isOpen = true;
+	if (d.size == 0) return;
+
+	d.hMapping =
+		CreateFileMappingA(d.hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!d.hMapping)
+	{
+		close();
+		THROW_EXCEPTION_FMT("Cannot map file: `%s`", fileName.c_str());
+	}
+	d.data = static_cast<const uint8_t*>(
+		MapViewOfFile(d.hMapping, FILE_MAP_READ, 0, 0, 0));
+	if (!d.data)
+	{
+		close();
+		THROW_EXCEPTION_FMT("Cannot map file: `%s`", fileName.c_str());
+	}
+#else
+	d.fd = ::open(fileName.c_str(), O_RDONLY);
+	if (d.fd < 0)
+		THROW_EXCEPTION_FMT("Cannot open file: `%s`", fileName.c_str());
+
+	struct stat st
+	{
+	};
+	if (0 != ::fstat(d.fd, &st))
+	{
+		close();
+		THROW_EXCEPTION_FMT("Cannot stat file: `%s`", fileName.c_str());
+	}
+	d.size = static_cast<uint64_t>(st.st_size);
+	d.isOpen = true;
+	if (d.size == 0) return;
+
+	void* p = ::mmap(nullptr, d.size, PROT_READ, MAP_SHARED, d.fd, 0);
+	if (p == MAP_FAILED)
+	{
+		close();
+		THROW_EXCEPTION_FMT("Cannot map file: `%s`", fileName.c_str());
+	}
+	d.data = static_cast<const uint8_t*>(p);
+#endif
+}
+
+void CMemoryMappedFile::close()
+{
+	auto& d = *m_impl;
+#ifdef _WIN32
+	if (d.data) UnmapViewOfFile(d.data);
+	if (d.hMapping) CloseHandle(d.hMapping);
+	if (d.hFile != INVALID_HANDLE_VALUE) CloseHandle(d.hFile);
+	d.hMapping = nullptr;
+	d.hFile = INVALID_HANDLE_VALUE;
+#else
+	if (d.data) ::munmap(const_cast<uint8_t*>(d.data), d.size);
+	if (d.fd >= 0) ::close(d.fd);
+	d.fd = -1;
+#endif
+	d.data = nullptr;
+	d.size = 0;
+	d.isOpen = false;
+}
+
+bool CMemoryMappedFile::isOpen() const { return m_impl->isOpen; }
+const uint8_t* CMemoryMappedFile::data() const { return m_impl->data; }
+uint64_t CMemoryMappedFile::size() const { return m_impl->size; }
+
+void CMemoryMappedFile::adviseSequential(bool sequential)
+{
+#ifndef _WIN32
+	auto& d = *m_impl;
+	if (d.data)
+		::madvise(
+			const_cast<uint8_t*>(d.data), d.size,
+			sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#else
+	(void)sequential;
+#endif
+}
@@ -0,0 +1,53 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryMappedFile.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cstring>
+
+TEST(CMemoryMappedFile, mapFile)
+{
+	const std::string fil = mrpt::system::getTempFileName();
+	const char msg[] = "Hello memory-mapped world!";
+	{
+		mrpt::io::CFileOutputStream f(fil);
+		f.Write(msg, sizeof(msg));
+	}
+
+	{
+		mrpt::io::CMemoryMappedFile m(fil);
+		EXPECT_TRUE(m.isOpen());
+		ASSERT_EQ(m.size(), sizeof(msg));
+		ASSERT_TRUE(m.data() != nullptr);
+		EXPECT_EQ(0, std::memcmp(m.data(), msg, sizeof(msg)));
+
+		m.close();
+		EXPECT_FALSE(m.isOpen());
+		EXPECT_TRUE(m.data() == nullptr);
+	}
+
+	// Empty files can be mapped too:
+	{
+		mrpt::io::CFileOutputStream f(fil);
+	}
+	{
+		mrpt::io::CMemoryMappedFile m(fil);
+		EXPECT_TRUE(m.isOpen());
+		EXPECT_EQ(m.size(), 0U);
+	}
+
+	mrpt::system::deleteFile(fil);
+
+	mrpt::io::CMemoryMappedFile m;
+	EXPECT_ANY_THROW(m.open(fil));
+	EXPECT_FALSE(m.isOpen());
+}
@@ -0,0 +1,157 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "io-precomp.h"	 // Precompiled headers
+//
+#include <mrpt/core/exceptions.h>
+
+#include <cstring>
+
+#include "bgzf.h"
+//
+#include <zlib.h>
+
+using namespace mrpt::io::internal;
+
+namespace
+{
+uint16_t get_u16(const uint8_t* p)
+{
+	return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+uint32_t get_u32(const uint8_t* p)
+{
+	return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+		(static_cast<uint32_t>(p[2]) << 16) |
+		(static_cast<uint32_t>(p[3]) << 24);
+}
+void put_u16(uint8_t* p, uint16_t v)
+{
+	p[0] = static_cast<uint8_t>(v);
+	p[1] = static_cast<uint8_t>(v >> 8);
+}
+void put_u32(uint8_t* p, uint32_t v)
+{
+	for (int i = 0; i < 4; i++)
+		p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+// gzip header with FEXTRA, and a "BC" subfield with the block size - 1:
+const uint8_t BGZF_HEADER_TEMPLATE[BGZF_HEADER_SIZE] = {
+	0x1f, 0x8b, 0x08, 0x04, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, 0, 0};
+
+}  // namespace
+
+const uint8_t mrpt::io::internal::BGZF_EOF_BLOCK[BGZF_EOF_BLOCK_SIZE] = {
+	0x1f, 0x8b, 0x08, 0x04, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C',
+	2, 0, 0x1b, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+std::size_t mrpt::io::internal::bgzf_block_size(const uint8_t* h)
+{
+	if (h[0] != 0x1f || h[1] != 0x8b || h[2] != 0x08 || (h[3] & 0x04) == 0 ||
+		get_u16(h + 10) != 6 || h[12] != 'B' || h[13] != 'C' ||
+		get_u16(h + 14) != 2)
+		return 0;
+	return static_cast<std::size_t>(get_u16(h + 16)) + 1;
+}
+
+uint32_t mrpt::io::internal::bgzf_block_data_size(
+	const uint8_t* block, std::size_t blockSize)
+{
+	ASSERT_GE_(blockSize, BGZF_HEADER_SIZE + BGZF_FOOTER_SIZE);
+	return get_u32(block + blockSize - 4);
+}
+
+std::vector<uint8_t> mrpt::io::internal::bgzf_compress_block(
+	const uint8_t* data, std::size_t len, int compressLevel)
+{
+	ASSERT_LE_(len, BGZF_BLOCK_DATA_SIZE);
+
+	std::vector<uint8_t> block(BGZF_MAX_BLOCK_SIZE);
+	const std::size_t maxPayload =
+		BGZF_MAX_BLOCK_SIZE - BGZF_HEADER_SIZE - BGZF_FOOTER_SIZE;
+
+	for (;;)
+	{
+		z_stream zs;
+		std::memset(&zs, 0, sizeof(zs));
+		// Negative window bits: raw deflate data, without zlib header.
+		if (deflateInit2(
+				&zs, compressLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) !=
+			Z_OK)
+			THROW_EXCEPTION("deflateInit2() failed");
+
+		zs.next_in = const_cast<Bytef*>(data);
+		zs.avail_in = static_cast<uInt>(len);
+		zs.next_out = block.data() + BGZF_HEADER_SIZE;
+		zs.avail_out = static_cast<uInt>(maxPayload);
+		const int ret = deflate(&zs, Z_FINISH);
+		const std::size_t payload = zs.total_out;
+		deflateEnd(&zs);
+
+		if (ret != Z_STREAM_END)
+		{
+			// It did not fit: only possible for incompressible data and
+			// compression levels other than "store".
+			if (compressLevel == 0) THROW_EXCEPTION("deflate() failed");
+			compressLevel = 0;
+			continue;
+		}
+
+		const std::size_t blockSize =
+			BGZF_HEADER_SIZE + payload + BGZF_FOOTER_SIZE;
+		std::memcpy(block.data(), BGZF_HEADER_TEMPLATE, BGZF_HEADER_SIZE);
+		put_u16(block.data() + 16, static_cast<uint16_t>(blockSize - 1));
+
+		uint8_t* footer = block.data() + BGZF_HEADER_SIZE + payload;
+		put_u32(
+			footer,
+			static_cast<uint32_t>(crc32(
+				crc32(0L, Z_NULL, 0), data, static_cast<uInt>(len))));
+		put_u32(footer + 4, static_cast<uint32_t>(len));
+
+		block.resize(blockSize);
+		return block;
+	}
+}
+
+void mrpt::io::internal::bgzf_decompress_block(
+	const uint8_t* block, std::size_t blockSize, std::vector<uint8_t>& out)
+{
+	ASSERT_GE_(blockSize, BGZF_HEADER_SIZE + BGZF_FOOTER_SIZE);
+
+	const uint8_t* footer = block + blockSize - BGZF_FOOTER_SIZE;
+	const uint32_t expectedCRC = get_u32(footer);
+	const uint32_t dataSize = get_u32(footer + 4);
+	ASSERT_LE_(dataSize, BGZF_MAX_BLOCK_SIZE);
+
+	out.resize(dataSize);
+	if (dataSize == 0) return;
+
+	z_stream zs;
+	std::memset(&zs, 0, sizeof(zs));
+	if (inflateInit2(&zs, -15) != Z_OK)
+		THROW_EXCEPTION("inflateInit2() failed");
+
+	zs.next_in = const_cast<Bytef*>(block + BGZF_HEADER_SIZE);
+	zs.avail_in =
+		static_cast<uInt>(blockSize - BGZF_HEADER_SIZE - BGZF_FOOTER_SIZE);
+	zs.next_out = out.data();
+	zs.avail_out = static_cast<uInt>(dataSize);
+	const int ret = inflate(&zs, Z_FINISH);
+	const auto totalOut = zs.total_out;
+	inflateEnd(&zs);
+
+	if (ret != Z_STREAM_END || totalOut != dataSize)
+		THROW_EXCEPTION("Corrupted BGZF block: inflate() failed");
+
+	const auto crc = static_cast<uint32_t>(
+		crc32(crc32(0L, Z_NULL, 0), out.data(), static_cast<uInt>(dataSize)));
+	if (crc != expectedCRC) THROW_EXCEPTION("Corrupted BGZF block: bad CRC");
+}
@@ -0,0 +1,52 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Helpers for the BGZF ("blocked gzip") format, as used in the SAM/BAM
+ * specification: a sequence of independent gzip members (blocks), each one
+ * storing its own compressed size in a "BC" extra subfield of the gzip header,
+ * and holding at most 64 KiB of data. Since each block is a standard gzip
+ * member, BGZF files can be read by any gzip decompressor. */
+namespace mrpt::io::internal
+{
+/** Maximum size of a whole (compressed) block, including header & footer */
+constexpr std::size_t BGZF_MAX_BLOCK_SIZE = 0x10000;
+/** Maximum uncompressed bytes per block, chosen so the compressed block of
+ * even incompressible data always fits into BGZF_MAX_BLOCK_SIZE */
+constexpr std::size_t BGZF_BLOCK_DATA_SIZE = 0xff00;
+constexpr std::size_t BGZF_HEADER_SIZE = 18;
+constexpr std::size_t BGZF_FOOTER_SIZE = 8;
+
+/** The empty block used as end-of-file marker */
+constexpr std::size_t BGZF_EOF_BLOCK_SIZE = 28;
+extern const uint8_t BGZF_EOF_BLOCK[BGZF_EOF_BLOCK_SIZE];
+
+/** If `header` (BGZF_HEADER_SIZE bytes) is the header of a BGZF block,
+ * returns the total size of the block in bytes. Returns 0 otherwise. */
+std::size_t bgzf_block_size(const uint8_t* header);
+
+/** Returns the uncompressed size of the block stored in its footer */
+uint32_t bgzf_block_data_size(const uint8_t* block, std::size_t blockSize);
+
+/** Compresses up to BGZF_BLOCK_DATA_SIZE bytes into one whole BGZF block.
+ * \exception std::exception On any zlib error. */
+std::vector<uint8_t> bgzf_compress_block(
+	const uint8_t* data, std::size_t len, int compressLevel);
+
+/** Decompresses one whole BGZF block, checking its CRC.
+ * \exception std::exception On corrupted data. */
+void bgzf_decompress_block(
+	const uint8_t* block, std::size_t blockSize, std::vector<uint8_t>& out);
+
+}  // namespace mrpt::io::internal
@@ -10,12 +10,15 @@
 
 #include <mrpt/config/CLoadableOptions.h>
 #include <mrpt/containers/CDynamicGrid.h>
+#include <mrpt/containers/NonCopiableData.h>
+#include <mrpt/containers/cow_tiled_grid.h>
 #include <mrpt/core/safe_pointers.h>
 #include <mrpt/img/CImage.h>
 #include <mrpt/maps/CLogOddsGridMap2D.h>
 #include <mrpt/maps/CLogOddsGridMapLUT.h>
 #include <mrpt/maps/CMetricMap.h>
 #include <mrpt/maps/OccupancyGridCellType.h>
+#include <mrpt/math/TPose2D.h>
 #include <mrpt/obs/CObservation2DRangeScanWithUncertainty.h>
 #include <mrpt/obs/obs_frwds.h>
 #include <mrpt/poses/CPosePDFGaussian.h>
@@ -24,6 +27,9 @@
 #include <mrpt/tfest/TMatchingPair.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <atomic>
+#include <mutex>
+
 namespace mrpt::maps
 {
 /** A class for storing an occupancy grid map.
@@ -80,8 +86,10 @@ class COccupancyGridMap2D
 	/** Lookup tables for log-odds */
 	static CLogOddsGridMapLUT<cellType>& get_logodd_lut();
 
-	/** Store of cell occupancy values. Order: row by row, from left to right */
-	std::vector<cellType> m_map;
+	/** Store of cell occupancy values. Order: row by row, from left to right.
+	 * Tiles of rows are shared among copies of the map (copy-on-write), so
+	 * copying a grid (e.g. when resampling RBPF particles) is cheap. */
+	mrpt::containers::cow_tiled_grid<cellType> m_map;
 	/** The size of the grid in cells */
 	uint32_t m_size_x = 0, m_size_y = 0;
 	/** The limits of the grid in "units" (meters) */
@@ -91,10 +99,30 @@ class COccupancyGridMap2D
 
 	/** Auxiliary variables to speed up the computation of observation
 	 * likelihood values for LF method among others, at a high cost in memory
-	 * (see TLikelihoodOptions::enableLikelihoodCache). */
-	mutable std::vector<double> m_precomputedLikelihood;
+	 * (see TLikelihoodOptions::enableLikelihoodCache).
+	 * Copies of the map start with an empty cache, so copying a map (e.g.
+	 * RBPF particles) does not copy one value per cell.
+	 * Cells are filled in lazily, possibly by several threads at once; all of
+	 * them write the same value to a given cell, so relaxed atomic accesses
+	 * suffice. */
+	mutable mrpt::containers::NonCopiableData<
+		std::vector<std::atomic<double>>>
+		m_precomputedLikelihood;
 	mutable bool m_likelihoodCacheOutDated{true};
 
+	/** Held while (re)allocating m_precomputedLikelihood or writing
+	 * likelihoodOutputs, so likelihoods can be evaluated from several threads
+	 * at once (e.g. by a parallel particle filter). */
+	mutable mrpt::containers::NonCopiableData<std::mutex> m_likelihoodMtx;
+
+	/** Resets m_precomputedLikelihood if m_likelihoodCacheOutDated, or if
+	 * it is empty (as in copies of the map) */
+	void resetLikelihoodCacheIfOutdated() const;
+
+	/** Computes the likelihood-field value of one cell, which must be within
+	 * the valid map limits. Used by computeLikelihoodField_Thrun() */
+	double computeLikelihoodField_Thrun_cell(int cx, int cy) const;
+
 	/** Used for Voronoi calculation.Same struct as "map", but contains a "0" if
 	 * not a basis point. */
 	mrpt::containers::CDynamicGrid<uint8_t> m_basis_map;
@@ -128,18 +156,18 @@ class COccupancyGridMap2D
 	/** Change the contents [0,1] of a cell, given its index */
 	inline void setCell_nocheck(int x, int y, float value)
 	{
-		m_map[x + y * m_size_x] = p2l(value);
+		m_map.mutableCell(x, y) = p2l(value);
 	}
 
 	/** Read the real valued [0,1] contents of a cell, given its index */
 	inline float getCell_nocheck(int x, int y) const
 	{
-		return l2p(m_map[x + y * m_size_x]);
+		return l2p(m_map(x, y));
 	}
 	/** Changes a cell by its absolute index (Do not use it normally) */
 	inline void setRawCell(unsigned int cellIndex, cellType b)
 	{
-		if (cellIndex < m_size_x * m_size_y) m_map[cellIndex] = b;
+		if (cellIndex < m_size_x * m_size_y) m_map.mutableCell(cellIndex) = b;
 	}
 
 	/** One of the methods that can be selected for implementing
@@ -202,8 +230,13 @@ class COccupancyGridMap2D
 
    public:
 	/** Read-only access to the raw cell contents (cells are in log-odd units)
+	 * \note Since MRPT 2.7.1 cells are stored in copy-on-write tiles of rows
+	 * instead of one std::vector.
 	 */
-	const std::vector<cellType>& getRawMap() const { return this->m_map; }
+	const mrpt::containers::cow_tiled_grid<cellType>& getRawMap() const
+	{
+		return this->m_map;
+	}
 	/** Performs the Bayesian fusion of a new observation of a cell  \sa
 	 * updateInfoChangeOnly, updateCell_fast_occupied, updateCell_fast_free */
 	void updateCell(int x, int y, float v);
@@ -259,6 +292,11 @@ class COccupancyGridMap2D
 	 * \param additionalMargin If set to true (default), an additional margin of
 	 * a few meters will be added to the grid, ONLY if the new coordinates are
 	 * larger than current ones.
+	 *
+	 * \note Growing only along "y" keeps the existing cell tiles shared with
+	 * other copies of this map (e.g. other RBPF particles), as long as it
+	 * grows towards larger "y" or additionalMargin is true. Otherwise, all
+	 * the cells are copied into new tiles, since each tile holds full rows.
 	 * \sa setSize
 	 */
 	void resizeGrid(
@@ -352,7 +390,7 @@ class COccupancyGridMap2D
 			static_cast<unsigned int>(y) >= m_size_y)
 			return;
 		else
-			m_map[x + y * m_size_x] = p2l(value);
+			m_map.mutableCell(x, y) = p2l(value);
 	}
 
 	/** Read the real valued [0,1] contents of a cell, given its index */
@@ -363,16 +401,17 @@ class COccupancyGridMap2D
 			static_cast<unsigned int>(y) >= m_size_y)
 			return 0.5f;
 		else
-			return l2p(m_map[x + y * m_size_x]);
+			return l2p(m_map(x, y));
 	}
 
 	/** Access to a "row": mainly used for drawing grid as a bitmap efficiently,
-	 * do not use it normally */
+	 * do not use it normally. Only the getSizeX() cells of the row are
+	 * contiguous in memory: rows are not contiguous among them. */
 	inline cellType* getRow(int cy)
 	{
 		if (cy < 0 || static_cast<unsigned int>(cy) >= m_size_y) return nullptr;
 		else
-			return &m_map[0 + cy * m_size_x];
+			return m_map.mutableRow(cy);
 	}
 
 	/** Access to a "row": mainly used for drawing grid as a bitmap efficiently,
@@ -381,7 +420,7 @@ class COccupancyGridMap2D
 	{
 		if (cy < 0 || static_cast<unsigned int>(cy) >= m_size_y) return nullptr;
 		else
-			return &m_map[0 + cy * m_size_x];
+			return m_map.row(cy);
 	}
 
 	/** Change the contents [0,1] of a cell, given its coordinates */
@@ -523,6 +562,19 @@ class COccupancyGridMap2D
 		/** Enabled: Rays widen with distance to approximate the real behavior
 		 * of lasers, disabled: insert rays as simple lines (Default=false) */
 		bool wideningBeamsWithDistance{false};
+		/** If enabled, the free cells crossed by the rays of a 2D scan are
+		 * updated only once per scan, instead of once per ray crossing them.
+		 * This avoids overconfident free space near the sensor, where many
+		 * rays overlap, and is much faster for dense scans. Only applies to
+		 * simple rays (wideningBeamsWithDistance=false). (Default=false)
+		 * \note (New in MRPT 2.7.1) */
+		bool freeCellsOncePerScan{false};
+		/** Number of threads used to insert 2D scans if freeCellsOncePerScan
+		 * is enabled: rays are traced in parallel in angular sectors (0: as
+		 * many as CPU cores). Results do not depend on the number of threads.
+		 * (Default=1)
+		 * \note (New in MRPT 2.7.1) */
+		unsigned int insertionThreads{1};
 	};
 
 	/** With this struct options are provided to the observation insertion
@@ -941,6 +993,32 @@ class COccupancyGridMap2D
 		const CPointsMap* pm,
 		const mrpt::poses::CPose2D* relativePose = nullptr) const;
 
+	/** Like computeLikelihoodField_Thrun(), but evaluates the same points map
+	 * at several candidate poses in one call, as required by particle filters
+	 * or scan matchers.
+	 *
+	 * Points are transformed and their likelihood-cache cells looked up with
+	 * SSE2 or AVX2 code paths (selected at runtime), falling back to a generic
+	 * implementation. Results match those of calling
+	 * computeLikelihoodField_Thrun() once per pose, up to floating-point
+	 * rounding.
+	 *
+	 * \param pm The points map, in the local frame of each pose.
+	 * \param poses The poses of the points map in this map's coordinates.
+	 * \param out_logLiks Output log-likelihoods, one per pose.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void computeLikelihoodField_Thrun(
+		const CPointsMap* pm, const std::vector<mrpt::math::TPose2D>& poses,
+		std::vector<double>& out_logLiks) const;
+
+	/** Like computeLikelihoodField_II(), for several candidate poses.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void computeLikelihoodField_II(
+		const CPointsMap* pm, const std::vector<mrpt::math::TPose2D>& poses,
+		std::vector<double>& out_logLiks) const;
+
 	/** Saves the gridmap as a graphical file (BMP,PNG,...).
 	 * The format will be derived from the file extension (see
 	 * CImage::saveToFile )
@@ -106,6 +106,20 @@ class COccupancyGridMap3D
 		const mrpt::math::TPoint3D& corner_max,
 		float new_voxels_default_value = 0.5f);
 
+	/** Selects whether voxels are stored in one contiguous block (default),
+	 * or in tiles of 16x16x16 voxels only allocated when first updated, so
+	 * memory follows the explored volume and resizeGrid() does not copy any
+	 * voxel. All previous contents are erased and voxels set to p=0.5.
+	 * \sa mrpt::containers::grid_storage_t
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void setSparseStorage(bool sparse);
+	bool isSparseStorage() const
+	{
+		return m_grid.getStorageMode() ==
+			mrpt::containers::grid_storage_t::SparseTiles;
+	}
+
 	/** Scales an integer representation of the log-odd into a real valued
 	 * probability in [0,1], using p=exp(l)/(1+exp(l))  */
 	static inline float l2p(const voxelType l)
@@ -134,7 +148,7 @@ class COccupancyGridMap3D
 	inline void setCellFreeness(
 		unsigned int cx, unsigned int cy, unsigned int cz, float value)
 	{
-		if (auto* c = m_grid.cellByIndex(cx, cy, cz); c != nullptr)
+		if (auto* c = m_grid.insertCellByIndex(cx, cy, cz); c != nullptr)
 			*c = p2l(value);
 	}
 
@@ -404,6 +418,8 @@ class COccupancyGridMap3D
 	float min_y{-5.0f}, max_y{5.0f};
 	float min_z{-5.0f}, max_z{5.0f};
 	float resolution{0.25f};
+	/** See COccupancyGridMap3D::setSparseStorage() */
+	bool sparse_storage{false};
 
 	/** Observations insertion options */
 	mrpt::maps::COccupancyGridMap3D::TInsertionOptions insertionOpts;
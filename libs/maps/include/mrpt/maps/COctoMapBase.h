@@ -85,6 +85,8 @@ class COctoMapBase : public mrpt::maps::CMetricMap
 			// Copy all but the m_parent pointer!
 			maxrange = o.maxrange;
 			pruning = o.pruning;
+			insertionThreads = o.insertionThreads;
+			voxelDownsampling = o.voxelDownsampling;
 			const bool o_has_parent = o.m_parent.get() != nullptr;
 			setOccupancyThres(
 				o_has_parent ? o.getOccupancyThres() : o.occupancyThres);
@@ -109,6 +111,20 @@ class COctoMapBase : public mrpt::maps::CMetricMap
 		bool pruning{true};	 //!< whether the tree is (losslessly) pruned after
 		//! insertion (default: true)
 
+		/** Number of threads used to insert point clouds. If not 1, the free
+		 * and occupied voxels of batches of rays are computed in parallel, and
+		 * the octree is then updated from one single thread (0: as many
+		 * threads as CPU cores). Results do not depend on the number of
+		 * threads, and are the same than with the octomap library insertion
+		 * used for 1 (Default=1).
+		 * \note (New in MRPT 2.7.1) */
+		unsigned int insertionThreads{1};
+		/** If true, the end points of point clouds are downsampled on the fly
+		 * to one per voxel (its center) before tracing rays, so dense clouds
+		 * trace much fewer rays (Default=false).
+		 * \note (New in MRPT 2.7.1) */
+		bool voxelDownsampling{false};
+
 		/// (key name in .ini files: "occupancyThres") sets the threshold for
 		/// occupancy (sensor model) (Default=0.5)
 		void setOccupancyThres(double prob)
@@ -375,6 +391,15 @@ class COctoMapBase : public mrpt::maps::CMetricMap
 		const std::optional<const mrpt::poses::CPose3D>& robotPose,
 		octomap_point3d& sensorPt, octomap_pointcloud& scan) const;
 
+	/** Inserts a point cloud in the octree according to insertionOptions:
+	 * with the octomap library method, or computing the free and occupied
+	 * keys in parallel (see TInsertionOptions::insertionThreads and
+	 * TInsertionOptions::voxelDownsampling).
+	 */
+	template <class octomap_point3d, class octomap_pointcloud>
+	void internal_insertPointCloud(
+		const octomap_point3d& sensorPt, const octomap_pointcloud& scan);
+
 	struct Impl;
 
 	mrpt::pimpl<Impl> m_impl;
@@ -654,7 +654,7 @@ class CPointsMap : public CMetricMap,
 	inline void insertPoint(float x, float y, float z = 0)
 	{
 		insertPointFast(x, y, z);
-		mark_as_modified();
+		mark_as_points_appended();
 	}
 	/// \overload
 	inline void insertPoint(const mrpt::math::TPoint3D& p)
@@ -1140,6 +1140,18 @@ class CPointsMap : public CMetricMap,
 		kdtree_mark_as_outdated();
 	}
 
+	/** Like mark_as_modified(), but for changes which only appended new points
+	 * at the end of the map, which allows incremental updates of the KD-tree
+	 * if `kdtree_search_params.incremental` is enabled.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	inline void mark_as_points_appended() const
+	{
+		m_largestDistanceFromOriginIsUpdated = false;
+		m_boundingBoxIsUpdated = false;
+		kdtree_mark_as_appended();
+	}
+
 	/** Returns a short description of the map. */
 	std::string asString() const override
 	{
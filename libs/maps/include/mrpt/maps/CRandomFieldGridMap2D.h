@@ -344,6 +344,12 @@ class CRandomFieldGridMap2D
 		const double y_max, const double resolution,
 		const TRandomFieldCell* fill_value = nullptr);
 
+	/** Random fields require dense storage: this throws if `mode` is not
+	 * mrpt::containers::grid_storage_t::Dense */
+	void setStorageMode(
+		mrpt::containers::grid_storage_t mode,
+		const TRandomFieldCell& fillValue = TRandomFieldCell()) override;
+
 	/** Base class for user-supplied objects capable of describing cells
 	 * connectivity, used to build prior factors of the MRF graph. \sa
 	 * setCellsConnectivity() */
@@ -156,6 +156,12 @@ class CRandomFieldGridMap3D
 		const double resolution_xy, const double resolution_z = -1.0,
 		const TRandomFieldVoxel* fill_value = nullptr) override;
 
+	/** Random fields require dense storage: this throws if `mode` is not
+	 * mrpt::containers::grid_storage_t::Dense */
+	void setStorageMode(
+		mrpt::containers::grid_storage_t mode,
+		const TRandomFieldVoxel& fillValue = TRandomFieldVoxel()) override;
+
 	/** Base class for user-supplied objects capable of describing voxels
 	 * connectivity, used to build prior factors of the MRF graph. \sa
 	 * setvoxelsConnectivity() */
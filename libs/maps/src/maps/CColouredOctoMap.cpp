@@ -192,9 +192,7 @@ bool CColouredOctoMap::internal_insertObservation(
 		}
 
 		// Insert rays:
-		m_impl->m_octomap.insertPointCloud(
-			scan, sensorPt, insertionOptions.maxrange,
-			insertionOptions.pruning);
+		internal_insertPointCloud(sensorPt, scan);
 		return true;
 	}
 	else if (IS_CLASS(obs, CObservation3DRangeScan))
@@ -234,19 +232,25 @@ bool CColouredOctoMap::internal_insertObservation(
 		}
 
 		// Insert rays:
-		octomap::KeySet free_cells, occupied_cells;
-		m_impl->m_octomap.computeUpdate(
-			scan, sensorPt, free_cells, occupied_cells,
-			insertionOptions.maxrange);
-
-		// insert data into tree  -----------------------
-		for (const auto& free_cell : free_cells)
-		{
-			m_impl->m_octomap.updateNode(free_cell, false, false);
-		}
-		for (const auto& occupied_cell : occupied_cells)
+		if (insertionOptions.insertionThreads != 1 ||
+			insertionOptions.voxelDownsampling)
+			internal_insertPointCloud(sensorPt, scan);
+		else
 		{
-			m_impl->m_octomap.updateNode(occupied_cell, true, false);
+			octomap::KeySet free_cells, occupied_cells;
+			m_impl->m_octomap.computeUpdate(
+				scan, sensorPt, free_cells, occupied_cells,
+				insertionOptions.maxrange);
+
+			// insert data into tree  -----------------------
+			for (const auto& free_cell : free_cells)
+			{
+				m_impl->m_octomap.updateNode(free_cell, false, false);
+			}
+			for (const auto& occupied_cell : occupied_cells)
+			{
+				m_impl->m_octomap.updateNode(occupied_cell, true, false);
+			}
 		}
 
 		// Update color -----------------------
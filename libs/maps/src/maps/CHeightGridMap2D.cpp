@@ -120,7 +120,7 @@ bool CHeightGridMap2D::insertIndividualPoint(
 	const double x, const double y, const double zz,
 	const CHeightGridMap2D_Base::TPointInsertParams& params)
 {
-	THeightGridmapCell* cell = cellByPos(x, y);
+	THeightGridmapCell* cell = insertCellByPos(x, y);
 	if (!cell)
 		return false;  // Out of the map: Ignore if we've not resized before.
 
@@ -173,11 +173,15 @@ void CHeightGridMap2D::serializeTo(mrpt::serialization::CArchive& out) const
 	out << n;
 
 	// Save the map contents:
-	n = static_cast<uint32_t>(m_map.size());
+	n = static_cast<uint32_t>(m_size_x * m_size_y);
 	out << n;
-	for (const auto& it : m_map)
-		out << it.h
-			<< it.w;  // This was removed in version 1: << it->history_Zs;
+	for (unsigned int cy = 0; cy < m_size_y; cy++)
+		for (unsigned int cx = 0; cx < m_size_x; cx++)
+		{
+			const auto& it = *cellByIndex(cx, cy);
+			out << it.h
+				<< it.w;  // This was removed in version 1: << it->history_Zs;
+		}
 
 	// Save the insertion options:
 	out << uint8_t(m_mapType);
@@ -363,9 +367,9 @@ size_t CHeightGridMap2D::countObservedCells() const
 		case mrSimpleAverage:
 		{
 			size_t obsCells = 0;
-			const size_t N = m_map.size();
-			for (size_t i = 0; i < N; i++)
-				if (m_map[i].w) obsCells++;
+			for (unsigned int cy = 0; cy < m_size_y; cy++)
+				for (unsigned int cx = 0; cx < m_size_x; cx++)
+					if (cellByIndex(cx, cy)->w) obsCells++;
 			return obsCells;
 		}
 		break;
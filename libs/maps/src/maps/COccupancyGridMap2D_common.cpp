@@ -183,7 +183,7 @@ void COccupancyGridMap2D::setSize(
 #endif
 
 	// Cells memory:
-	m_map.resize(m_size_x * m_size_y, p2l(default_value));
+	m_map.assign(m_size_x, m_size_y, p2l(default_value));
 
 	// Free these buffers also:
 	m_basis_map.clear();
@@ -200,7 +200,6 @@ void COccupancyGridMap2D::resizeGrid(
 {
 	unsigned int extra_x_izq = 0, extra_y_arr = 0, new_size_x = 0,
 				 new_size_y = 0;
-	std::vector<cellType> new_map;
 
 	if (new_x_min > new_x_max)
 	{
@@ -279,27 +278,26 @@ void COccupancyGridMap2D::resizeGrid(
 	assert(0 == (new_size_x % 16));
 #endif
 
-	// Reserve new mem block
-	new_map.resize(new_size_x * new_size_y, p2l(new_cells_default_value));
-
-	// Copy all the old map rows into the new map:
+	// If only the number of rows grows, extend the additional margin up to
+	// whole tiles, so all the existing tiles are kept (shared with other
+	// copies of this map) instead of copied. Not done without margin, since
+	// callers may then expect the exact requested limits:
+	if (additionalMargin && new_size_x == m_size_x && extra_y_arr != 0)
 	{
-		cellType* dest_ptr = &new_map[extra_x_izq + extra_y_arr * new_size_x];
-		cellType* src_ptr = &m_map[0];
-		size_t row_size = m_size_x * sizeof(cellType);
-
-		for (size_t y = 0; y < m_size_y; y++)
-		{
-#if defined(_DEBUG) || (MRPT_ALWAYS_CHECKS_DEBUG)
-			assert(dest_ptr + row_size - 1 <= &new_map[new_map.size() - 1]);
-			assert(src_ptr + row_size - 1 <= &m_map[m_map.size() - 1]);
-#endif
-			memcpy(dest_ptr, src_ptr, row_size);
-			dest_ptr += new_size_x;
-			src_ptr += m_size_x;
-		}
+		constexpr unsigned int TILE_ROWS = decltype(m_map)::TILE_ROWS;
+		const unsigned int extra =
+			(TILE_ROWS - extra_y_arr % TILE_ROWS) % TILE_ROWS;
+		extra_y_arr += extra;
+		new_size_y += extra;
+		new_y_min = m_yMin - extra_y_arr * m_resolution;
 	}
 
+	// Move the old cells into the new grid. This is a full copy of all cells
+	// (un-sharing all tiles) if the map grows along X:
+	m_map.grow(
+		new_size_x, new_size_y, extra_x_izq, extra_y_arr,
+		p2l(new_cells_default_value));
+
 	// Move new values into the new map:
 	m_xMin = new_x_min;
 	m_xMax = new_x_max;
@@ -309,9 +307,6 @@ void COccupancyGridMap2D::resizeGrid(
 	m_size_x = new_size_x;
 	m_size_y = new_size_y;
 
-	// Free old map, replace by new one:
-	m_map.swap(new_map);
-
 	// Free the other buffers:
 	m_basis_map.clear();
 	m_voronoi_diagram.clear();
@@ -386,15 +381,19 @@ void COccupancyGridMap2D::computeEntropy(TEntropyInfo& info) const
 
 	info.H = info.I = 0;
 	info.effectiveMappedCells = 0;
-	for (signed char it : m_map)
+	for (unsigned int cy = 0; cy < m_size_y; cy++)
 	{
-		auto ctu = static_cast<cellTypeUnsigned>(it);
-		auto h = entropyTable[ctu];
-		info.H += h;
-		if (h < (MAX_H - 0.001f))
+		const cellType* row = m_map.row(cy);
+		for (unsigned int cx = 0; cx < m_size_x; cx++)
 		{
-			info.effectiveMappedCells++;
-			info.I -= h;
+			auto ctu = static_cast<cellTypeUnsigned>(row[cx]);
+			auto h = entropyTable[ctu];
+			info.H += h;
+			if (h < (MAX_H - 0.001f))
+			{
+				info.effectiveMappedCells++;
+				info.I -= h;
+			}
 		}
 	}
 
@@ -433,9 +432,7 @@ void COccupancyGridMap2D::internal_clear()
  ---------------------------------------------------------------*/
 void COccupancyGridMap2D::fill(float default_value)
 {
-	cellType defValue = p2l(default_value);
-	for (auto it = m_map.begin(); it < m_map.end(); ++it)
-		*it = defValue;
+	m_map.fill(p2l(default_value));
 	// For the precomputed likelihood trick:
 	m_likelihoodCacheOutDated = true;
 }
@@ -451,7 +448,7 @@ void COccupancyGridMap2D::updateCell(int x, int y, float v)
 		return;
 
 	// Get the current contents of the cell:
-	cellType& theCell = m_map[x + y * m_size_x];
+	cellType& theCell = m_map.mutableCell(x, y);
 
 	// Compute the new Bayesian-fused value of the cell:
 	if (updateInfoChangeOnly.enabled)
@@ -487,7 +484,7 @@ void COccupancyGridMap2D::updateCell(int x, int y, float v)
  ---------------------------------------------------------------*/
 void COccupancyGridMap2D::subSample(int downRatio)
 {
-	std::vector<cellType> newMap;
+	mrpt::containers::cow_tiled_grid<cellType> newMap;
 
 	ASSERT_(downRatio > 0);
 
@@ -496,7 +493,7 @@ void COccupancyGridMap2D::subSample(int downRatio)
 	int newSizeX = round((m_xMax - m_xMin) / m_resolution);
 	int newSizeY = round((m_yMax - m_yMin) / m_resolution);
 
-	newMap.resize(newSizeX * newSizeY);
+	newMap.assign(newSizeX, newSizeY);
 
 	for (int x = 0; x < newSizeX; x++)
 	{
@@ -510,12 +507,12 @@ void COccupancyGridMap2D::subSample(int downRatio)
 
 			newCell /= (downRatio * downRatio);
 
-			newMap[x + y * newSizeX] = p2l(newCell);
+			newMap.mutableCell(x, y) = p2l(newCell);
 		}
 	}
 
 	setSize(m_xMin, m_xMax, m_yMin, m_yMax, m_resolution);
-	m_map = newMap;
+	m_map = std::move(newMap);
 }
 
 /*---------------------------------------------------------------
@@ -639,7 +636,7 @@ void COccupancyGridMap2D::determineMatching2D(
 			for (int cy = cy_min; cy <= cy_max; cy++)
 			{
 				// Is an occupied cell?
-				if (m_map[cx + cy * m_size_x] <
+				if (m_map(cx, cy) <
 					thresholdCellValue)	 //  getCell(cx,cy)<0.49)
 				{
 					const float residual_x = idx2x(cx) - x_local;
@@ -9,6 +9,7 @@
 
 #include "maps-precomp.h"  // Precomp header
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/round.h>  // round()
 #include <mrpt/maps/COccupancyGridMap2D.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
@@ -16,6 +17,9 @@
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/memory.h>	 // alloca()
 
+#include <atomic>
+#include <thread>
+
 #if HAVE_ALLOCA_H
 #include <alloca.h>
 #endif
@@ -27,6 +31,12 @@ using namespace mrpt::math;
 using namespace mrpt::poses;
 using namespace std;
 
+namespace
+{
+/** Marks of free cells, see TInsertionOptions::freeCellsOncePerScan */
+constexpr uint8_t MARK_FREE_ECHO = 0x01, MARK_FREE_NOECHO = 0x02;
+}  // namespace
+
 /** Local stucture used in the next method (must be here for usage within STL
  * stuff) */
 struct TLocalPoint
@@ -242,83 +252,237 @@ bool COccupancyGridMap2D::internal_insertObservation(
 				// -----------------------
 				resizeGrid(new_x_min, new_x_max, new_y_min, new_y_max, 0.5);
 
-				// For updateCell_fast methods:
-				cellType* theMapArray = &m_map[0];
-				unsigned theMapSize_x = m_size_x;
-
 				int cx0 =
 					x2idx(px);	// Remember: This must be after the resizeGrid!!
 				int cy0 = y2idx(py);
 
-				// Insert rays:
-				for (idx = 0; idx < nRanges; idx += K)
+				if (insertionOptions.freeCellsOncePerScan)
 				{
-					if (!o.getScanRangeValidity(idx) && !invalidAsFree)
-						continue;
+					// Target cells of all rays to be inserted, and their
+					// bounding box:
+					std::vector<size_t> rayIdxs;
+					std::vector<int> rayCx, rayCy;
+					rayIdxs.reserve(nRanges / K + 1);
+					rayCx.reserve(nRanges / K + 1);
+					rayCy.reserve(nRanges / K + 1);
+
+					int bbMinX = cx0, bbMaxX = cx0, bbMinY = cy0, bbMaxY = cy0;
+					for (idx = 0; idx < nRanges; idx += K)
+					{
+						if (!o.getScanRangeValidity(idx) && !invalidAsFree)
+							continue;
 
-					// Starting position: Laser position
-					cx = cx0;
-					cy = cy0;
+						const int trg_cx = x2idx(scanPoints_x[idx]);
+						const int trg_cy = y2idx(scanPoints_y[idx]);
+						ASSERT_(
+							static_cast<unsigned int>(trg_cx) < m_size_x &&
+							static_cast<unsigned int>(trg_cy) < m_size_y);
+
+						rayIdxs.push_back(idx);
+						rayCx.push_back(trg_cx);
+						rayCy.push_back(trg_cy);
+						mrpt::keep_min(bbMinX, trg_cx);
+						mrpt::keep_max(bbMaxX, trg_cx);
+						mrpt::keep_min(bbMinY, trg_cy);
+						mrpt::keep_max(bbMaxY, trg_cy);
+					}
+					// Rounding in the ray tracing may go one cell beyond the
+					// target:
+					bbMinX = std::max(0, bbMinX - 1);
+					bbMinY = std::max(0, bbMinY - 1);
+					bbMaxX = std::min<int>(m_size_x - 1, bbMaxX + 1);
+					bbMaxY = std::min<int>(m_size_y - 1, bbMaxY + 1);
+					const int bbW = bbMaxX - bbMinX + 1;
+					const int bbH = bbMaxY - bbMinY + 1;
+
+					// 1st stage: trace rays, just marking the cells they
+					// cross as free, so each cell is updated only once even
+					// if many rays cross it. Marks are atomic since rays are
+					// traced in parallel, but each cell is written at most
+					// twice per scan.
+					auto marks = std::make_unique<std::atomic<uint8_t>[]>(
+						static_cast<size_t>(bbW) * bbH);
+
+					const auto traceRays = [&](size_t first, size_t last) {
+						for (size_t r = first; r < last; r++)
+						{
+							const int Acx = rayCx[r] - cx0;
+							const int Acy = rayCy[r] - cy0;
+							const int Acx_ = std::abs(Acx);
+							const int Acy_ = std::abs(Acy);
+
+							const int nStepsRay = max(Acx_, Acy_);
+							if (!nStepsRay) continue;
+
+							// Same fixed-point stepping than below, written
+							// without loop-carried dependencies:
+							const float N_1 = 1.0f / nStepsRay;
+							const int frAcx = (Acx < 0 ? -1 : +1) *
+								round((Acx_ << FRBITS) * N_1);
+							const int frAcy = (Acy < 0 ? -1 : +1) *
+								round((Acy_ << FRBITS) * N_1);
+							const int frCX0 = cx0 << FRBITS;
+							const int frCY0 = cy0 << FRBITS;
+
+							const uint8_t mark =
+								o.getScanRangeValidity(rayIdxs[r])
+								? MARK_FREE_ECHO
+								: MARK_FREE_NOECHO;
+
+							for (int nStep = 0; nStep < nStepsRay; nStep++)
+							{
+								const unsigned int mx =
+									((frCX0 + nStep * frAcx) >> FRBITS) -
+									bbMinX;
+								const unsigned int my =
+									((frCY0 + nStep * frAcy) >> FRBITS) -
+									bbMinY;
+								if (mx >= static_cast<unsigned int>(bbW) ||
+									my >= static_cast<unsigned int>(bbH))
+									continue;
+
+								auto& m = marks[mx + my * bbW];
+								if ((m.load(std::memory_order_relaxed) &
+									 mark) == 0)
+									m.fetch_or(mark, std::memory_order_relaxed);
+							}
+						}
+					};
 
-					// Target, in cell indexes:
-					int trg_cx = x2idx(scanPoints_x[idx]);
-					int trg_cy = y2idx(scanPoints_y[idx]);
+					// 2nd stage: update all marked cells, row by row:
+					const auto updateRows = [&](size_t first, size_t last) {
+						for (size_t my = first; my < last; my++)
+						{
+							const std::atomic<uint8_t>* rowMarks =
+								&marks[my * bbW];
+							cellType* row =
+								m_map.mutableRow(bbMinY + my) + bbMinX;
+							for (int mx = 0; mx < bbW; mx++)
+							{
+								const uint8_t m = rowMarks[mx].load(
+									std::memory_order_relaxed);
+								if (!m) continue;
+								updateCell_fast_free(
+									row + mx,
+									(m & MARK_FREE_ECHO)
+										? logodd_observation_free
+										: logodd_noecho_free,
+									logodd_thres_free);
+							}
+						}
+					};
 
-					// The x> comparison implicitly holds if x<0
-					ASSERT_(
-						static_cast<unsigned int>(trg_cx) < m_size_x &&
-						static_cast<unsigned int>(trg_cy) < m_size_y);
+					unsigned int nThreads = insertionOptions.insertionThreads;
+					if (nThreads == 0)
+						nThreads =
+							std::max(1U, std::thread::hardware_concurrency());
 
-					// Use "fractional integers" to approximate float operations
-					//  during the ray tracing:
-					int Acx = trg_cx - cx;
-					int Acy = trg_cy - cy;
+					if (nThreads == 1 || rayIdxs.size() < 64)
+					{
+						traceRays(0, rayIdxs.size());
+						updateRows(0, bbH);
+					}
+					else
+					{
+						// Angular sectors of contiguous rays:
+						auto& pool = mrpt::WorkStealingThreadsPool::shared(
+							nThreads, "gridInsertion");
+						pool.parallel_for_chunked(
+							0, rayIdxs.size(), traceRays,
+							std::max<size_t>(
+								16, rayIdxs.size() / (4 * nThreads)));
+						// Clone shared map tiles before writing from threads:
+						m_map.makeRowsUnique(bbMinY, bbMinY + bbH - 1);
+						pool.parallel_for_chunked(
+							0, bbH, updateRows,
+							std::max<size_t>(8, bbH / (4 * nThreads)));
+					}
+
+					// And finally, the occupied cells at the end of each ray,
+					// only if it was a valid and not truncated range:
+					for (size_t r = 0; r < rayIdxs.size(); r++)
+					{
+						if (o.getScanRangeValidity(rayIdxs[r]) &&
+							o.getScanRange(rayIdxs[r]) < maxDistanceInsertion)
+							updateCell_fast_occupied(
+								&m_map.mutableCell(rayCx[r], rayCy[r]),
+								logodd_observation_occupied,
+								logodd_thres_occupied);
+					}
+				}
+				else
+				{
+					// Insert rays:
+					for (idx = 0; idx < nRanges; idx += K)
+					{
+						if (!o.getScanRangeValidity(idx) && !invalidAsFree)
+							continue;
 
-					int Acx_ = std::abs(Acx);
-					int Acy_ = std::abs(Acy);
+						// Starting position: Laser position
+						cx = cx0;
+						cy = cy0;
 
-					int nStepsRay = max(Acx_, Acy_);
-					if (!nStepsRay) continue;  // May be...
+						// Target, in cell indexes:
+						int trg_cx = x2idx(scanPoints_x[idx]);
+						int trg_cy = y2idx(scanPoints_y[idx]);
 
-					// Integers store "float values * 128"
-					float N_1 = 1.0f / nStepsRay;  // Avoid division twice.
+						// The x> comparison implicitly holds if x<0
+						ASSERT_(
+							static_cast<unsigned int>(trg_cx) < m_size_x &&
+							static_cast<unsigned int>(trg_cy) < m_size_y);
 
-					// Increments at each raytracing step:
-					int frAcx =
-						(Acx < 0 ? -1 : +1) * round((Acx_ << FRBITS) * N_1);
-					int frAcy =
-						(Acy < 0 ? -1 : +1) * round((Acy_ << FRBITS) * N_1);
-
-					int frCX = cx << FRBITS;
-					int frCY = cy << FRBITS;
-					const auto logodd_free = o.getScanRangeValidity(idx)
-						? logodd_observation_free
-						: logodd_noecho_free;
-
-					for (int nStep = 0; nStep < nStepsRay; nStep++)
-					{
-						updateCell_fast_free(
-							cx, cy, logodd_free, logodd_thres_free, theMapArray,
-							theMapSize_x);
+						// Use "fractional integers" to approximate float
+						// operations during the ray tracing:
+						int Acx = trg_cx - cx;
+						int Acy = trg_cy - cy;
 
-						frCX += frAcx;
-						frCY += frAcy;
+						int Acx_ = std::abs(Acx);
+						int Acy_ = std::abs(Acy);
 
-						cx = frCX >> FRBITS;
-						cy = frCY >> FRBITS;
-					}
+						int nStepsRay = max(Acx_, Acy_);
+						if (!nStepsRay) continue;  // May be...
 
-					// And finally, the occupied cell at the end:
-					// Only if:
-					//  - It was a valid ray, and
-					//  - The ray was not truncated
-					if (o.getScanRangeValidity(idx) &&
-						o.getScanRange(idx) < maxDistanceInsertion)
-						updateCell_fast_occupied(
-							trg_cx, trg_cy, logodd_observation_occupied,
-							logodd_thres_occupied, theMapArray, theMapSize_x);
+						// Integers store "float values * 128"
+						float N_1 = 1.0f / nStepsRay;  // Avoid division twice.
 
-				}  // End of each range
+						// Increments at each raytracing step:
+						int frAcx =
+							(Acx < 0 ? -1 : +1) * round((Acx_ << FRBITS) * N_1);
+						int frAcy =
+							(Acy < 0 ? -1 : +1) * round((Acy_ << FRBITS) * N_1);
+
+						int frCX = cx << FRBITS;
+						int frCY = cy << FRBITS;
+						const auto logodd_free = o.getScanRangeValidity(idx)
+							? logodd_observation_free
+							: logodd_noecho_free;
+
+						for (int nStep = 0; nStep < nStepsRay; nStep++)
+						{
+							updateCell_fast_free(
+								&m_map.mutableCell(cx, cy), logodd_free,
+								logodd_thres_free);
+
+							frCX += frAcx;
+							frCY += frAcy;
+
+							cx = frCX >> FRBITS;
+							cy = frCY >> FRBITS;
+						}
+
+						// And finally, the occupied cell at the end:
+						// Only if:
+						//  - It was a valid ray, and
+						//  - The ray was not truncated
+						if (o.getScanRangeValidity(idx) &&
+							o.getScanRange(idx) < maxDistanceInsertion)
+							updateCell_fast_occupied(
+								&m_map.mutableCell(trg_cx, trg_cy),
+								logodd_observation_occupied,
+								logodd_thres_occupied);
+
+					}  // End of each range
+				}
 
 				mrpt_alloca_free(scanPoints_x);
 				mrpt_alloca_free(scanPoints_y);
@@ -408,10 +572,6 @@ bool COccupancyGridMap2D::internal_insertObservation(
 				// -----------------------
 				resizeGrid(new_x_min, new_x_max, new_y_min, new_y_max, 0.5);
 
-				// For updateCell_fast methods:
-				cellType* theMapArray = &m_map[0];
-				unsigned theMapSize_x = m_size_x;
-
 				// int  cx0 = x2idx(px);		// Remember: This must be after
 				// the
 				// resizeGrid!!
@@ -518,8 +678,8 @@ bool COccupancyGridMap2D::internal_insertObservation(
 
 						for (int ccx = min_cx; ccx <= max_cx; ccx++)
 							updateCell_fast_free(
-								ccx, P0.cy, logodd_observation_free,
-								logodd_thres_free, theMapArray, theMapSize_x);
+								&m_map.mutableCell(ccx, P0.cy),
+								logodd_observation_free, logodd_thres_free);
 					}
 					else
 					{
@@ -604,9 +764,9 @@ bool COccupancyGridMap2D::internal_insertObservation(
 
 								for (int ccx = R1.cx; ccx <= R2.cx; ccx++)
 									updateCell_fast_free(
-										ccx, R1.cy, logodd_observation_free,
-										logodd_thres_free, theMapArray,
-										theMapSize_x);
+										&m_map.mutableCell(ccx, R1.cy),
+										logodd_observation_free,
+										logodd_thres_free);
 							}
 
 							R1.frX += frAx_R1;
@@ -692,9 +852,9 @@ bool COccupancyGridMap2D::internal_insertObservation(
 								last_insert_cy = R1.cy;
 								for (int ccx = R1.cx; ccx <= R2.cx; ccx++)
 									updateCell_fast_free(
-										ccx, R1.cy, logodd_observation_free,
-										logodd_thres_free, theMapArray,
-										theMapSize_x);
+										&m_map.mutableCell(ccx, R1.cy),
+										logodd_observation_free,
+										logodd_thres_free);
 							}
 
 							R1.frX += frAx_R1;
@@ -744,9 +904,9 @@ bool COccupancyGridMap2D::internal_insertObservation(
 						if (P2.cx == P1.cx && P2.cy == P1.cy)
 						{
 							updateCell_fast_occupied(
-								P1.cx, P1.cy, logodd_observation_occupied,
-								logodd_thres_occupied, theMapArray,
-								theMapSize_x);
+								&m_map.mutableCell(P1.cx, P1.cy),
+								logodd_observation_occupied,
+								logodd_thres_occupied);
 						}
 						else
 						{
@@ -774,9 +934,9 @@ bool COccupancyGridMap2D::internal_insertObservation(
 							for (int nStep = 0; nStep <= nSteps; nStep++)
 							{
 								updateCell_fast_occupied(
-									R1.cx, R1.cy, logodd_observation_occupied,
-									logodd_thres_occupied, theMapArray,
-									theMapSize_x);
+									&m_map.mutableCell(R1.cx, R1.cy),
+									logodd_observation_occupied,
+									logodd_thres_occupied);
 
 								R1.frX += frAcxE;
 								R1.frY += frAcyE;
@@ -927,10 +1087,6 @@ bool COccupancyGridMap2D::internal_insertObservation(
 			// -----------------------
 			resizeGrid(new_x_min, new_x_max, new_y_min, new_y_max, 0.5);
 
-			// For updateCell_fast methods:
-			cellType* theMapArray = &m_map[0];
-			unsigned theMapSize_x = m_size_x;
-
 			// int  cx0 = x2idx(px);		// Remember: This must be after the
 			// resizeGrid!!
 			// int  cy0 = y2idx(py);
@@ -1027,8 +1183,8 @@ bool COccupancyGridMap2D::internal_insertObservation(
 
 					for (int ccx = min_cx; ccx <= max_cx; ccx++)
 						updateCell_fast_free(
-							ccx, P0.cy, logodd_observation_free,
-							logodd_thres_free, theMapArray, theMapSize_x);
+							&m_map.mutableCell(ccx, P0.cy),
+							logodd_observation_free, logodd_thres_free);
 				}
 				else
 				{
@@ -1112,9 +1268,8 @@ bool COccupancyGridMap2D::internal_insertObservation(
 
 							for (int ccx = R1.cx; ccx <= R2.cx; ccx++)
 								updateCell_fast_free(
-									ccx, R1.cy, logodd_observation_free,
-									logodd_thres_free, theMapArray,
-									theMapSize_x);
+									&m_map.mutableCell(ccx, R1.cy),
+									logodd_observation_free, logodd_thres_free);
 						}
 
 						R1.frX += frAx_R1;
@@ -1199,9 +1354,8 @@ bool COccupancyGridMap2D::internal_insertObservation(
 							last_insert_cy = R1.cy;
 							for (int ccx = R1.cx; ccx <= R2.cx; ccx++)
 								updateCell_fast_free(
-									ccx, R1.cy, logodd_observation_free,
-									logodd_thres_free, theMapArray,
-									theMapSize_x);
+									&m_map.mutableCell(ccx, R1.cy),
+									logodd_observation_free, logodd_thres_free);
 						}
 
 						R1.frX += frAx_R1;
@@ -1250,8 +1404,8 @@ bool COccupancyGridMap2D::internal_insertObservation(
 					if (P2.cx == P1.cx && P2.cy == P1.cy)
 					{
 						updateCell_fast_occupied(
-							P1.cx, P1.cy, logodd_observation_occupied,
-							logodd_thres_occupied, theMapArray, theMapSize_x);
+							&m_map.mutableCell(P1.cx, P1.cy),
+							logodd_observation_occupied, logodd_thres_occupied);
 					}
 					else
 					{
@@ -1279,9 +1433,9 @@ bool COccupancyGridMap2D::internal_insertObservation(
 						for (int nStep = 0; nStep <= nSteps; nStep++)
 						{
 							updateCell_fast_occupied(
-								R1.cx, R1.cy, logodd_observation_occupied,
-								logodd_thres_occupied, theMapArray,
-								theMapSize_x);
+								&m_map.mutableCell(R1.cx, R1.cy),
+								logodd_observation_occupied,
+								logodd_thres_occupied);
 
 							R1.frX += frAcxE;
 							R1.frY += frAcyE;
@@ -1331,6 +1485,8 @@ void COccupancyGridMap2D::TInsertionOptions::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(CFD_features_gaussian_size, float, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(CFD_features_median_size, float, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(wideningBeamsWithDistance, bool, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(freeCellsOncePerScan, bool, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(insertionThreads, int, iniFile, section);
 }
 
 /*---------------------------------------------------------------
@@ -1355,6 +1511,8 @@ void COccupancyGridMap2D::TInsertionOptions::dumpToTextStream(
 	LOADABLEOPTS_DUMP_VAR(CFD_features_gaussian_size, float)
 	LOADABLEOPTS_DUMP_VAR(CFD_features_median_size, float)
 	LOADABLEOPTS_DUMP_VAR(wideningBeamsWithDistance, bool)
+	LOADABLEOPTS_DUMP_VAR(freeCellsOncePerScan, bool)
+	LOADABLEOPTS_DUMP_VAR(insertionThreads, int)
 
 	out << "\n";
 }
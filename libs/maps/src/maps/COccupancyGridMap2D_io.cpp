@@ -54,7 +54,7 @@ bool COccupancyGridMap2D::saveAsBitmapFile(const std::string& file) const
 	MRPT_END
 }
 
-uint8_t COccupancyGridMap2D::serializeGetVersion() const { return 6; }
+uint8_t COccupancyGridMap2D::serializeGetVersion() const { return 7; }
 void COccupancyGridMap2D::serializeTo(mrpt::serialization::CArchive& out) const
 {
 // Version 3: Change to log-odds. The only change is in the loader, when
@@ -73,7 +73,8 @@ void COccupancyGridMap2D::serializeTo(mrpt::serialization::CArchive& out) const
 	ASSERT_(m_size_x * m_size_y == m_map.size());
 
 #ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
-	out.WriteBuffer(&m_map[0], sizeof(m_map[0]) * m_size_x * m_size_y);
+	for (unsigned int cy = 0; cy < m_size_y; cy++)
+		out.WriteBuffer(m_map.row(cy), sizeof(cellType) * m_size_x);
 #else
 	out.WriteBufferFixEndianness(&map[0], size_x * m_size_y);
 #endif
@@ -110,6 +111,10 @@ void COccupancyGridMap2D::serializeTo(mrpt::serialization::CArchive& out) const
 
 	// Version: 5;
 	out << insertionOptions.wideningBeamsWithDistance;
+
+	// Version: 7;
+	out << insertionOptions.freeCellsOncePerScan
+		<< static_cast<uint32_t>(insertionOptions.insertionThreads);
 }
 
 void COccupancyGridMap2D::serializeFrom(
@@ -126,6 +131,7 @@ void COccupancyGridMap2D::serializeFrom(
 		case 4:
 		case 5:
 		case 6:
+		case 7:
 		{
 #ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
 			const uint8_t MyBitsPerCell = 8;
@@ -158,7 +164,9 @@ void COccupancyGridMap2D::serializeFrom(
 			{
 // Perfect:
 #ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
-				in.ReadBuffer(&m_map[0], sizeof(m_map[0]) * m_map.size());
+				for (unsigned int cy = 0; cy < m_size_y; cy++)
+					in.ReadBuffer(
+						m_map.mutableRow(cy), sizeof(cellType) * m_size_x);
 #else
 				in.ReadBufferFixEndianness(&map[0], map.size());
 #endif
@@ -172,11 +180,13 @@ void COccupancyGridMap2D::serializeFrom(
 				std::vector<uint16_t> auxMap(m_map.size());
 				in.ReadBuffer(&auxMap[0], sizeof(auxMap[0]) * auxMap.size());
 
-				size_t i, N = m_map.size();
-				auto* ptrTrg = (uint8_t*)&m_map[0];
 				const auto* ptrSrc = (const uint16_t*)&auxMap[0];
-				for (i = 0; i < N; i++)
-					*ptrTrg++ = (*ptrSrc++) >> 8;
+				for (unsigned int cy = 0; cy < m_size_y; cy++)
+				{
+					auto* ptrTrg = (uint8_t*)m_map.mutableRow(cy);
+					for (unsigned int cx = 0; cx < m_size_x; cx++)
+						*ptrTrg++ = (*ptrSrc++) >> 8;
+				}
 #else
 				// We are 16-bit, stream is 8-bit
 				ASSERT_(bitsPerCellStream == 8);
@@ -195,14 +205,16 @@ void COccupancyGridMap2D::serializeFrom(
 			// log-odds:
 			if (version < 3)
 			{
-				size_t i, N = m_map.size();
-				cellType* ptr = &m_map[0];
-				for (i = 0; i < N; i++)
+				for (unsigned int cy = 0; cy < m_size_y; cy++)
 				{
-					double p = cellTypeUnsigned(*ptr) * (1.0f / 0xFF);
-					if (p < 0) p = 0;
-					if (p > 1) p = 1;
-					*ptr++ = p2l(p);
+					cellType* ptr = m_map.mutableRow(cy);
+					for (unsigned int cx = 0; cx < m_size_x; cx++)
+					{
+						double p = cellTypeUnsigned(*ptr) * (1.0f / 0xFF);
+						if (p < 0) p = 0;
+						if (p > 1) p = 1;
+						*ptr++ = p2l(p);
+					}
 				}
 			}
 
@@ -263,6 +275,18 @@ void COccupancyGridMap2D::serializeFrom(
 			{
 				in >> insertionOptions.wideningBeamsWithDistance;
 			}
+
+			if (version >= 7)
+			{
+				uint32_t nThreads;
+				in >> insertionOptions.freeCellsOncePerScan >> nThreads;
+				insertionOptions.insertionThreads = nThreads;
+			}
+			else
+			{
+				insertionOptions.freeCellsOncePerScan = false;
+				insertionOptions.insertionThreads = 1;
+			}
 		}
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
@@ -0,0 +1,94 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/config.h>
+
+#include "COccupancyGridMap2D_likelihood_internal.h"
+
+#if MRPT_ARCH_INTEL_COMPATIBLE
+
+#include <immintrin.h>
+
+void mrpt::maps::internal::LF_Thrun_transform_and_gather_AVX2(
+	const LF_Thrun_kernel_input_t& in, int32_t* outIdx, double* outLik)
+{
+	const __m256d x0 = _mm256_set1_pd(in.x), y0 = _mm256_set1_pd(in.y);
+	const __m256d ccos = _mm256_set1_pd(in.ccos);
+	const __m256d ssin = _mm256_set1_pd(in.ssin);
+	const __m256d xMin = _mm256_set1_pd(in.xMin);
+	const __m256d yMin = _mm256_set1_pd(in.yMin);
+	const __m256d res = _mm256_set1_pd(in.resolution);
+	const __m256d minLik = _mm256_set1_pd(in.minimumLik);
+	const __m256d invalidLik = _mm256_set1_pd(LIK_LF_CACHE_INVALID);
+
+	const __m128i minus1 = _mm_set1_epi32(-1);
+	const __m128i size_x = _mm_set1_epi32(in.size_x);
+	const __m128i size_x_1 = _mm_set1_epi32(in.size_x_1);
+	const __m128i size_y_1 = _mm_set1_epi32(in.size_y_1);
+
+	const std::size_t nQuads = in.nPoints / 4;
+	for (std::size_t k = 0; k < nQuads; k++)
+	{
+		const std::size_t i = 4 * k;
+		const __m256d lx = _mm256_loadu_pd(in.xs + i);
+		const __m256d ly = _mm256_loadu_pd(in.ys + i);
+
+		// Same operation order as in the scalar version (and no FMA, since
+		// this file is not built with -mfma), to match its results:
+		const __m256d gx = _mm256_sub_pd(
+			_mm256_add_pd(x0, _mm256_mul_pd(lx, ccos)),
+			_mm256_mul_pd(ly, ssin));
+		const __m256d gy = _mm256_add_pd(
+			_mm256_add_pd(y0, _mm256_mul_pd(lx, ssin)),
+			_mm256_mul_pd(ly, ccos));
+
+		// Truncation, as static_cast<int>():
+		const __m128i cx =
+			_mm256_cvttpd_epi32(_mm256_div_pd(_mm256_sub_pd(gx, xMin), res));
+		const __m128i cy =
+			_mm256_cvttpd_epi32(_mm256_div_pd(_mm256_sub_pd(gy, yMin), res));
+
+		// Inside: 0 <= c < size_1  (as an unsigned comparison)
+		const __m128i inside = _mm_and_si128(
+			_mm_and_si128(
+				_mm_cmplt_epi32(cx, size_x_1), _mm_cmpgt_epi32(cx, minus1)),
+			_mm_and_si128(
+				_mm_cmplt_epi32(cy, size_y_1), _mm_cmpgt_epi32(cy, minus1)));
+
+		// Linear index, or -1 if outside:
+		const __m128i idx = _mm_blendv_epi8(
+			minus1, _mm_add_epi32(cx, _mm_mullo_epi32(cy, size_x)), inside);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outIdx + i), idx);
+
+		// Expand the 32bit lane mask to 64bit lanes, for the doubles:
+		const __m256d inside_pd =
+			_mm256_castsi256_pd(_mm256_cvtepi32_epi64(inside));
+
+		__m256d lik;
+		if (in.table)
+		{
+			// Gather cached values only for the cells inside the grid:
+			lik = _mm256_mask_i32gather_pd(
+				minLik, reinterpret_cast<const double*>(in.table),
+				_mm_and_si128(idx, inside), inside_pd, sizeof(double));
+		}
+		else
+		{
+			lik = _mm256_blendv_pd(minLik, invalidLik, inside_pd);
+		}
+		_mm256_storeu_pd(outLik + i, lik);
+	}
+
+	// Remaining points, if any:
+	LF_Thrun_transform_and_gather(in, 4 * nQuads, in.nPoints, outIdx, outLik);
+}
+
+#endif
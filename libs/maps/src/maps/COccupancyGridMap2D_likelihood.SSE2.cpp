@@ -0,0 +1,86 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+//
+#include <mrpt/config.h>
+
+#include "COccupancyGridMap2D_likelihood_internal.h"
+
+#if MRPT_ARCH_INTEL_COMPATIBLE
+
+#include <mrpt/core/SSE_types.h>
+
+void mrpt::maps::internal::LF_Thrun_transform_and_gather_SSE2(
+	const LF_Thrun_kernel_input_t& in, int32_t* outIdx, double* outLik)
+{
+	const __m128d x0 = _mm_set1_pd(in.x), y0 = _mm_set1_pd(in.y);
+	const __m128d ccos = _mm_set1_pd(in.ccos), ssin = _mm_set1_pd(in.ssin);
+	const __m128d xMin = _mm_set1_pd(in.xMin), yMin = _mm_set1_pd(in.yMin);
+	const __m128d res = _mm_set1_pd(in.resolution);
+
+	const __m128i minus1 = _mm_set1_epi32(-1);
+	const __m128i size_x_1 = _mm_set1_epi32(in.size_x_1);
+	const __m128i size_y_1 = _mm_set1_epi32(in.size_y_1);
+
+	const std::size_t nPairs = in.nPoints / 2;
+	for (std::size_t k = 0; k < nPairs; k++)
+	{
+		const std::size_t i = 2 * k;
+		const __m128d lx = _mm_loadu_pd(in.xs + i);
+		const __m128d ly = _mm_loadu_pd(in.ys + i);
+
+		// Same operation order as in the scalar version:
+		const __m128d gx = _mm_sub_pd(
+			_mm_add_pd(x0, _mm_mul_pd(lx, ccos)), _mm_mul_pd(ly, ssin));
+		const __m128d gy = _mm_add_pd(
+			_mm_add_pd(y0, _mm_mul_pd(lx, ssin)), _mm_mul_pd(ly, ccos));
+
+		// Truncation, as static_cast<int>(). Only the 2 low lanes are used:
+		const __m128i cx =
+			_mm_cvttpd_epi32(_mm_div_pd(_mm_sub_pd(gx, xMin), res));
+		const __m128i cy =
+			_mm_cvttpd_epi32(_mm_div_pd(_mm_sub_pd(gy, yMin), res));
+
+		// Inside: 0 <= c < size_1  (as an unsigned comparison)
+		const __m128i inside = _mm_and_si128(
+			_mm_and_si128(
+				_mm_cmplt_epi32(cx, size_x_1), _mm_cmpgt_epi32(cx, minus1)),
+			_mm_and_si128(
+				_mm_cmplt_epi32(cy, size_y_1), _mm_cmpgt_epi32(cy, minus1)));
+
+		alignas(16) int32_t cxs[4], cys[4], ins[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(cxs), cx);
+		_mm_store_si128(reinterpret_cast<__m128i*>(cys), cy);
+		_mm_store_si128(reinterpret_cast<__m128i*>(ins), inside);
+
+		// There is no 32bit integer multiplication nor gather in SSE2:
+		for (int l = 0; l < 2; l++)
+		{
+			if (!ins[l])
+			{
+				outIdx[i + l] = -1;
+				outLik[i + l] = in.minimumLik;
+			}
+			else
+			{
+				const int32_t idx = cxs[l] + cys[l] * in.size_x;
+				outIdx[i + l] = idx;
+				outLik[i + l] =
+					in.table ? in.table[idx].load(std::memory_order_relaxed)
+							 : LIK_LF_CACHE_INVALID;
+			}
+		}
+	}
+
+	// Remaining point, if any:
+	LF_Thrun_transform_and_gather(in, 2 * nPairs, in.nPoints, outIdx, outLik);
+}
+
+#endif
@@ -9,12 +9,17 @@
 
 #include "maps-precomp.h"  // Precomp header
 //
+#include <mrpt/core/cpu.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/CObservationRange.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <mutex>
+
+#include "COccupancyGridMap2D_likelihood_internal.h"
+
 using namespace mrpt;
 using namespace mrpt::math;
 using namespace mrpt::maps;
@@ -173,7 +178,8 @@ double COccupancyGridMap2D::computeObservationLikelihood_ConsensusOWA(
 	const size_t n = compareMap->size();
 
 	// Store the likelihood values in this vector:
-	likelihoodOutputs.OWA_pairList.clear();
+	std::vector<TPairLikelihoodIndex> pairList;
+	pairList.reserve(n);
 	for (size_t i = 0; i < n; i++)
 	{
 		// Get the point and pass it to global coordinates:
@@ -201,28 +207,32 @@ double COccupancyGridMap2D::computeObservationLikelihood_ConsensusOWA(
 		TPairLikelihoodIndex element;
 		element.first = lik;
 		element.second = pointGlobal;
-		likelihoodOutputs.OWA_pairList.push_back(element);
+		pairList.push_back(element);
 	}  // for each range point
 
 	// Sort the list of likelihood values, in descending order:
 	// ------------------------------------------------------------
-	std::sort(
-		likelihoodOutputs.OWA_pairList.begin(),
-		likelihoodOutputs.OWA_pairList.end());
+	std::sort(pairList.begin(), pairList.end());
 
 	// Cut the vector to the highest "likelihoodOutputs.OWA_length" elements:
 	size_t M = likelihoodOptions.OWA_weights.size();
-	ASSERT_(likelihoodOutputs.OWA_pairList.size() >= M);
+	ASSERT_(pairList.size() >= M);
 
-	likelihoodOutputs.OWA_pairList.resize(M);
-	likelihoodOutputs.OWA_individualLikValues.resize(M);
+	pairList.resize(M);
+	std::vector<double> individualLikValues(M);
 	likResult = 0;
 	for (size_t k = 0; k < M; k++)
 	{
-		likelihoodOutputs.OWA_individualLikValues[k] =
-			likelihoodOutputs.OWA_pairList[k].first;
-		likResult += likelihoodOptions.OWA_weights[k] *
-			likelihoodOutputs.OWA_individualLikValues[k];
+		individualLikValues[k] = pairList[k].first;
+		likResult += likelihoodOptions.OWA_weights[k] * individualLikValues[k];
+	}
+
+	// likelihoodOutputs is shared by all callers:
+	{
+		std::lock_guard<std::mutex> lck(m_likelihoodMtx.data);
+		likelihoodOutputs.OWA_pairList = std::move(pairList);
+		likelihoodOutputs.OWA_individualLikValues =
+			std::move(individualLikValues);
 	}
 
 	return log(likResult);
@@ -515,10 +525,6 @@ double COccupancyGridMap2D::computeLikelihoodField_Thrun(
 
 	double ret;
 	size_t N = pm->size();
-	int K = (int)ceil(
-		likelihoodOptions.LF_maxCorrsDistance /*m*/ /
-		m_resolution);	// The size of the checking area for matchings:
-
 	bool Product_T_OrSum_F = !likelihoodOptions.LF_alternateAverageMethod;
 
 	if (!N)
@@ -540,36 +546,23 @@ double COccupancyGridMap2D::computeLikelihoodField_Thrun(
 	unsigned int size_x_1 = m_size_x - 1;
 	unsigned int size_y_1 = m_size_y - 1;
 
-#define LIK_LF_CACHE_INVALID (66)
-
 	// Aux. variables for the "for j" loop:
 	double thisLik = LIK_LF_CACHE_INVALID;
 	double maxCorrDist_sq = square(likelihoodOptions.LF_maxCorrsDistance);
 	double minimumLik = zRandomTerm + zHit * exp(Q * maxCorrDist_sq);
 	double ccos, ssin;
 
+	// Only (re)allocating the cache needs the lock; its cells are then
+	// filled in concurrently with idempotent atomic stores:
+	auto& cache = m_precomputedLikelihood.data;
 	if (likelihoodOptions.enableLikelihoodCache)
 	{
-		// Reset the precomputed likelihood values map
-		if (m_likelihoodCacheOutDated)
-		{
-			if (!m_map.empty())
-				m_precomputedLikelihood.assign(
-					m_map.size(), LIK_LF_CACHE_INVALID);
-			else
-				m_precomputedLikelihood.clear();
-
-			m_likelihoodCacheOutDated = false;
-		}
+		std::lock_guard<std::mutex> lck(m_likelihoodMtx.data);
+		resetLikelihoodCacheIfOutdated();
 	}
 
-	cellType thresholdCellValue = p2l(0.5f);
 	int decimation = likelihoodOptions.LF_decimation;
 
-	const double _resolution = this->m_resolution;
-	const double constDist2DiscrUnits = 100 / (_resolution * _resolution);
-	const double constDist2DiscrUnits_INV = 1.0 / constDist2DiscrUnits;
-
 	if (N < 10) decimation = 1;
 
 	TPoint2D pointLocal;
@@ -616,69 +609,20 @@ double COccupancyGridMap2D::computeLikelihoodField_Thrun(
 			// We are into the map limits:
 			if (likelihoodOptions.enableLikelihoodCache)
 			{
-				thisLik = m_precomputedLikelihood[cx + cy * m_size_x];
+				thisLik = cache[cx + cy * m_size_x].load(
+					std::memory_order_relaxed);
 			}
 
 			if (!likelihoodOptions.enableLikelihoodCache ||
 				thisLik == LIK_LF_CACHE_INVALID)
 			{
 				// Compute now:
-				// -------------
-				// Find the closest occupied cell in a certain range, given by
-				// K:
-				int xx1 = max(0, cx - K);
-				int xx2 = min(size_x_1, (unsigned)(cx + K));
-				int yy1 = max(0, cy - K);
-				int yy2 = min(size_y_1, (unsigned)(cy + K));
-
-				// Optimized code: this part will be invoked a *lot* of times:
-				float occupiedMinDist;
-				{
-					// Initial pointer position
-					const cellType* mapPtr = &m_map[xx1 + yy1 * m_size_x];
-					unsigned incrAfterRow = m_size_x - ((xx2 - xx1) + 1);
-
-					signed int Ax0 = 10 * (xx1 - cx);
-					signed int Ay = 10 * (yy1 - cy);
-
-					unsigned int occupiedMinDistInt =
-						mrpt::round(maxCorrDist_sq * constDist2DiscrUnits);
-
-					for (int yy = yy1; yy <= yy2; yy++)
-					{
-						unsigned int Ay2 =
-							square((unsigned int)(Ay));	 // Square is faster
-						// with unsigned.
-						signed short Ax = Ax0;
-						cellType cell;
-
-						for (int xx = xx1; xx <= xx2; xx++)
-						{
-							if ((cell = *mapPtr++) < thresholdCellValue)
-							{
-								unsigned int d =
-									square((unsigned int)(Ax)) + Ay2;
-								keep_min(occupiedMinDistInt, d);
-							}
-							Ax += 10;
-						}
-						// Go to (xx1,yy++)
-						mapPtr += incrAfterRow;
-						Ay += 10;
-					}
-
-					occupiedMinDist =
-						occupiedMinDistInt * constDist2DiscrUnits_INV;
-				}
-
-				if (likelihoodOptions.LF_useSquareDist)
-					occupiedMinDist *= occupiedMinDist;
-
-				thisLik = zRandomTerm + zHit * exp(Q * occupiedMinDist);
+				thisLik = computeLikelihoodField_Thrun_cell(cx, cy);
 
 				if (likelihoodOptions.enableLikelihoodCache)
 					// And save it into the table and into "thisLik":
-					m_precomputedLikelihood[cx + cy * m_size_x] = thisLik;
+					cache[cx + cy * m_size_x].store(
+						thisLik, std::memory_order_relaxed);
 			}
 		}
 
@@ -698,6 +642,240 @@ double COccupancyGridMap2D::computeLikelihoodField_Thrun(
 	MRPT_END
 }
 
+void COccupancyGridMap2D::resetLikelihoodCacheIfOutdated() const
+{
+	// Reset the precomputed likelihood values map
+	auto& cache = m_precomputedLikelihood.data;
+	if (!m_likelihoodCacheOutDated && cache.size() == m_map.size()) return;
+
+	if (cache.size() != m_map.size())
+		cache = std::vector<std::atomic<double>>(m_map.size());
+	for (auto& c : cache)
+		c.store(LIK_LF_CACHE_INVALID, std::memory_order_relaxed);
+
+	m_likelihoodCacheOutDated = false;
+}
+
+double COccupancyGridMap2D::computeLikelihoodField_Thrun_cell(
+	int cx, int cy) const
+{
+	// The size of the checking area for matchings:
+	const int K =
+		(int)ceil(likelihoodOptions.LF_maxCorrsDistance /*m*/ / m_resolution);
+
+	const float stdHit = likelihoodOptions.LF_stdHit;
+	const float zHit = likelihoodOptions.LF_zHit;
+	const float zRandomTerm =
+		likelihoodOptions.LF_zRandom / likelihoodOptions.LF_maxRange;
+	const float Q = -0.5f / square(stdHit);
+
+	const unsigned int size_x_1 = m_size_x - 1;
+	const unsigned int size_y_1 = m_size_y - 1;
+
+	const double maxCorrDist_sq =
+		square(likelihoodOptions.LF_maxCorrsDistance);
+
+	const cellType thresholdCellValue = p2l(0.5f);
+
+	const double _resolution = this->m_resolution;
+	const double constDist2DiscrUnits = 100 / (_resolution * _resolution);
+	const double constDist2DiscrUnits_INV = 1.0 / constDist2DiscrUnits;
+
+	// Find the closest occupied cell in a certain range, given by K:
+	int xx1 = max(0, cx - K);
+	int xx2 = min(size_x_1, (unsigned)(cx + K));
+	int yy1 = max(0, cy - K);
+	int yy2 = min(size_y_1, (unsigned)(cy + K));
+
+	// Optimized code: this part will be invoked a *lot* of times:
+	float occupiedMinDist;
+	{
+		signed int Ax0 = 10 * (xx1 - cx);
+		signed int Ay = 10 * (yy1 - cy);
+
+		unsigned int occupiedMinDistInt =
+			mrpt::round(maxCorrDist_sq * constDist2DiscrUnits);
+
+		for (int yy = yy1; yy <= yy2; yy++)
+		{
+			const cellType* mapPtr = m_map.row(yy) + xx1;
+			unsigned int Ay2 = square((unsigned int)(Ay));	// Square is faster
+			// with unsigned.
+			signed short Ax = Ax0;
+			cellType cell;
+
+			for (int xx = xx1; xx <= xx2; xx++)
+			{
+				if ((cell = *mapPtr++) < thresholdCellValue)
+				{
+					unsigned int d = square((unsigned int)(Ax)) + Ay2;
+					keep_min(occupiedMinDistInt, d);
+				}
+				Ax += 10;
+			}
+			Ay += 10;
+		}
+
+		occupiedMinDist = occupiedMinDistInt * constDist2DiscrUnits_INV;
+	}
+
+	if (likelihoodOptions.LF_useSquareDist)
+		occupiedMinDist *= occupiedMinDist;
+
+	return zRandomTerm + zHit * exp(Q * occupiedMinDist);
+}
+
+/*---------------------------------------------------------------
+					computeLikelihoodField_Thrun (batch)
+ ---------------------------------------------------------------*/
+void COccupancyGridMap2D::computeLikelihoodField_Thrun(
+	const CPointsMap* pm, const std::vector<mrpt::math::TPose2D>& poses,
+	std::vector<double>& out_logLiks) const
+{
+	MRPT_START
+
+	ASSERT_(pm != nullptr);
+
+	const size_t N = pm->size();
+	out_logLiks.resize(poses.size());
+
+	if (!N)
+	{
+		// No way to estimate this likelihood!!
+		std::fill(out_logLiks.begin(), out_logLiks.end(), -100);
+		return;
+	}
+
+	const bool Product_T_OrSum_F =
+		!likelihoodOptions.LF_alternateAverageMethod;
+	const bool useCache = likelihoodOptions.enableLikelihoodCache;
+
+	// Same constants as in the single-pose version, so results match:
+	const float zHit = likelihoodOptions.LF_zHit;
+	const float zRandomTerm =
+		likelihoodOptions.LF_zRandom / likelihoodOptions.LF_maxRange;
+	const float Q = -0.5f / square(likelihoodOptions.LF_stdHit);
+	const double maxCorrDist_sq =
+		square(likelihoodOptions.LF_maxCorrsDistance);
+
+	// Only (re)allocating the cache needs the lock; its cells are then
+	// filled in concurrently with idempotent atomic stores:
+	auto& cache = m_precomputedLikelihood.data;
+	if (useCache)
+	{
+		std::lock_guard<std::mutex> lck(m_likelihoodMtx.data);
+		resetLikelihoodCacheIfOutdated();
+	}
+
+	const size_t decimation =
+		N < 10 ? 1 : std::max<size_t>(1, likelihoodOptions.LF_decimation);
+
+	// Decimated local points, converted only once for all the poses:
+	const auto& pxs = pm->getPointsBufferRef_x();
+	const auto& pys = pm->getPointsBufferRef_y();
+	std::vector<double> xs, ys;
+	xs.reserve(N / decimation + 1);
+	ys.reserve(N / decimation + 1);
+	for (size_t j = 0; j < N; j += decimation)
+	{
+		xs.push_back(pxs[j]);
+		ys.push_back(pys[j]);
+	}
+	const size_t nPts = xs.size();
+
+	internal::LF_Thrun_kernel_input_t in;
+	in.xs = xs.data();
+	in.ys = ys.data();
+	in.nPoints = nPts;
+	in.xMin = m_xMin;
+	in.yMin = m_yMin;
+	in.resolution = m_resolution;
+	in.size_x = m_size_x;
+	in.size_x_1 = static_cast<int32_t>(m_size_x) - 1;
+	in.size_y_1 = static_cast<int32_t>(m_size_y) - 1;
+	in.minimumLik = zRandomTerm + zHit * exp(Q * maxCorrDist_sq);
+	if (useCache && !cache.empty()) in.table = cache.data();
+
+	// Pick the best kernel for this CPU:
+	void (*kernel)(
+		const internal::LF_Thrun_kernel_input_t&, int32_t*, double*) =
+		nullptr;
+#if MRPT_ARCH_INTEL_COMPATIBLE
+	if (mrpt::cpu::supports(mrpt::cpu::feature::AVX2))
+		kernel = &internal::LF_Thrun_transform_and_gather_AVX2;
+	else if (mrpt::cpu::supports(mrpt::cpu::feature::SSE2))
+		kernel = &internal::LF_Thrun_transform_and_gather_SSE2;
+#endif
+
+	std::vector<int32_t> idxs(nPts);
+	std::vector<double> liks(nPts);
+
+	for (size_t k = 0; k < poses.size(); k++)
+	{
+		const auto& p = poses[k];
+		in.x = p.x;
+		in.y = p.y;
+		in.ccos = cos(p.phi);
+		in.ssin = sin(p.phi);
+
+		if (kernel) kernel(in, idxs.data(), liks.data());
+		else
+			internal::LF_Thrun_transform_and_gather(
+				in, 0, nPts, idxs.data(), liks.data());
+
+		// Fill in the cells not in the cache, and accumulate:
+		double ret = 0;
+		for (size_t i = 0; i < nPts; i++)
+		{
+			double thisLik = liks[i];
+			const int32_t idx = idxs[i];
+			if (idx >= 0 && thisLik == LIK_LF_CACHE_INVALID)
+			{
+				// It may have been just computed for a former point:
+				if (in.table)
+					thisLik = cache[idx].load(std::memory_order_relaxed);
+				if (thisLik == LIK_LF_CACHE_INVALID)
+				{
+					thisLik = computeLikelihoodField_Thrun_cell(
+						idx % m_size_x, idx / m_size_x);
+					if (in.table)
+						cache[idx].store(thisLik, std::memory_order_relaxed);
+				}
+			}
+
+			if (Product_T_OrSum_F) ret += log(thisLik);
+			else
+				ret += thisLik;
+		}
+		if (!Product_T_OrSum_F) ret = log(ret / nPts);
+
+		out_logLiks[k] = ret;
+	}
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+					computeLikelihoodField_II (batch)
+ ---------------------------------------------------------------*/
+void COccupancyGridMap2D::computeLikelihoodField_II(
+	const CPointsMap* pm, const std::vector<mrpt::math::TPose2D>& poses,
+	std::vector<double>& out_logLiks) const
+{
+	MRPT_START
+
+	ASSERT_(pm != nullptr);
+
+	out_logLiks.resize(poses.size());
+	for (size_t k = 0; k < poses.size(); k++)
+	{
+		const CPose2D p(poses[k]);
+		out_logLiks[k] = computeLikelihoodField_II(pm, &p);
+	}
+
+	MRPT_END
+}
+
 /*---------------------------------------------------------------
 					computeLikelihoodField_II
  ---------------------------------------------------------------*/
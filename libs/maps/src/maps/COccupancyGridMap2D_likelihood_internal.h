@@ -0,0 +1,107 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/config.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/** Marks an entry of COccupancyGridMap2D::m_precomputedLikelihood as not
+ * computed yet. */
+#define LIK_LF_CACHE_INVALID (66)
+
+namespace mrpt::maps::internal
+{
+/** Input data for the likelihood-field (Thrun) batch kernels: one pose, many
+ * local points. */
+struct LF_Thrun_kernel_input_t
+{
+	/** Local (sensor-frame) point coordinates, already decimated */
+	const double* xs = nullptr;
+	const double* ys = nullptr;
+	std::size_t nPoints = 0;
+
+	/** The pose of the points in the grid frame */
+	double x = 0, y = 0, ccos = 1, ssin = 0;
+
+	/** Grid geometry */
+	double xMin = 0, yMin = 0, resolution = 1;
+	int32_t size_x = 0;
+	/** Valid cell indices are in the range [0,size_x_1)x[0,size_y_1) */
+	int32_t size_x_1 = 0, size_y_1 = 0;
+
+	/** The likelihood cache, or nullptr if disabled. Several threads may
+	 * fill in its cells concurrently, always with the same value for a given
+	 * cell, so plain relaxed loads are enough to read it. */
+	const std::atomic<double>* table = nullptr;
+
+	/** Likelihood assigned to points falling outside of the grid */
+	double minimumLik = 0;
+};
+
+/** Transforms points [first,last) with the given pose, computes their cell
+ * linear indices into `outIdx` (-1 if out of the grid) and looks up their
+ * cached likelihood into `outLik` (`minimumLik` if out of the grid,
+ * LIK_LF_CACHE_INVALID if the cell likelihood is not known yet).
+ *
+ * This is the reference implementation; the SIMD versions follow the same
+ * operation order, but may still differ from it in the last bits if the
+ * compiler contracts this code into FMA instructions.
+ *
+ * It is `static` since it is compiled into TUs built with different
+ * instruction sets (e.g. AVX2), whose copies must not be merged by the
+ * linker. */
+static inline void LF_Thrun_transform_and_gather(
+	const LF_Thrun_kernel_input_t& in, std::size_t first, std::size_t last,
+	int32_t* outIdx, double* outLik)
+{
+	for (std::size_t i = first; i < last; i++)
+	{
+		const double gx = in.x + in.xs[i] * in.ccos - in.ys[i] * in.ssin;
+		const double gy = in.y + in.xs[i] * in.ssin + in.ys[i] * in.ccos;
+
+		const int cx = static_cast<int>((gx - in.xMin) / in.resolution);
+		const int cy = static_cast<int>((gy - in.yMin) / in.resolution);
+
+		if (static_cast<unsigned>(cx) >= static_cast<unsigned>(in.size_x_1) ||
+			static_cast<unsigned>(cy) >= static_cast<unsigned>(in.size_y_1))
+		{
+			outIdx[i] = -1;
+			outLik[i] = in.minimumLik;
+		}
+		else
+		{
+			const int32_t idx = cx + cy * in.size_x;
+			outIdx[i] = idx;
+			outLik[i] = in.table ? in.table[idx].load(std::memory_order_relaxed)
+								 : LIK_LF_CACHE_INVALID;
+		}
+	}
+}
+
+#if MRPT_ARCH_INTEL_COMPATIBLE
+// The SIMD kernels read the cache as plain doubles: on x86, aligned 64-bit
+// loads are single-copy atomic, and std::atomic<double> is a bare double.
+static_assert(
+	sizeof(std::atomic<double>) == sizeof(double) &&
+		std::atomic<double>::is_always_lock_free,
+	"The SIMD likelihood kernels require lock-free std::atomic<double>");
+
+/** SSE2 version of LF_Thrun_transform_and_gather(), for all points */
+void LF_Thrun_transform_and_gather_SSE2(
+	const LF_Thrun_kernel_input_t& in, int32_t* outIdx, double* outLik);
+
+/** AVX2 version of LF_Thrun_transform_and_gather(), for all points */
+void LF_Thrun_transform_and_gather_AVX2(
+	const LF_Thrun_kernel_input_t& in, int32_t* outIdx, double* outLik);
+#endif
+
+}  // namespace mrpt::maps::internal
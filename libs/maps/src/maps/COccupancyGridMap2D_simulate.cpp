@@ -154,7 +154,7 @@ void COccupancyGridMap2D::simulateScanRay(
 
 	while ((x = int_x2idx(rxi)) >= 0 && (y = int_y2idx(ryi)) >= 0 &&
 		   x < static_cast<int>(m_size_x) && y < static_cast<int>(m_size_y) &&
-		   (hitCellOcc_int = m_map[x + y * m_size_x]) > threshold_free_int &&
+		   (hitCellOcc_int = m_map(x, y)) > threshold_free_int &&
 		   ray_len < max_ray_len)
 	{
 		rxi += Arxi;
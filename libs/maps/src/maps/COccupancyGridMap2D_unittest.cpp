@@ -8,9 +8,12 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/stock_observations.h>
+#include <mrpt/serialization/CArchive.h>
 //
 #include <mrpt/config.h>
 #include <test_mrpt_common.h>
@@ -37,6 +40,165 @@ TEST(COccupancyGridMap2DTests, insert2DScan)
 	}
 }
 
+TEST(COccupancyGridMap2DTests, insert2DScanFreeCellsOncePerScan)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	const auto insertScan = [&](bool oncePerScan, unsigned int nThreads) {
+		auto grid = std::make_unique<COccupancyGridMap2D>(
+			-20.0f, 20.0f, -20.0f, 20.0f, 0.05f);
+		grid->insertionOptions.freeCellsOncePerScan = oncePerScan;
+		grid->insertionOptions.insertionThreads = nThreads;
+		for (int i = 0; i < 3; i++)
+			grid->insertObservation(scan1, CPose3D(0.1 * i, 0, 0));
+		return grid;
+	};
+
+	const auto gridRef = insertScan(false, 1);
+	const auto grid1 = insertScan(true, 1);
+
+	// The same cells are updated as with the classic method:
+	ASSERT_EQ(grid1->getSizeX(), gridRef->getSizeX());
+	ASSERT_EQ(grid1->getSizeY(), gridRef->getSizeY());
+	for (unsigned int cy = 0; cy < grid1->getSizeY(); cy++)
+		for (unsigned int cx = 0; cx < grid1->getSizeX(); cx++)
+			EXPECT_EQ(
+				grid1->getCell(cx, cy) == 0.5f,
+				gridRef->getCell(cx, cy) == 0.5f);
+
+	// Close to the sensor, where many rays overlap, free cells are updated
+	// once per scan only:
+	EXPECT_LT(grid1->getPos(0.2, 0), 0.49f);
+	EXPECT_GT(grid1->getPos(0.2, 0), gridRef->getPos(0.2, 0));
+
+	// Results do not depend on the number of threads:
+	for (const unsigned int nThreads : {2U, 4U, 0U})
+	{
+		const auto gridN = insertScan(true, nThreads);
+		ASSERT_EQ(gridN->getSizeX(), grid1->getSizeX());
+		ASSERT_EQ(gridN->getSizeY(), grid1->getSizeY());
+		for (unsigned int cy = 0; cy < grid1->getSizeY(); cy++)
+			for (unsigned int cx = 0; cx < grid1->getSizeX(); cx++)
+				ASSERT_EQ(gridN->getCell(cx, cy), grid1->getCell(cx, cy))
+					<< "nThreads=" << nThreads;
+	}
+}
+
+TEST(COccupancyGridMap2DTests, serializeInsertionOptions)
+{
+	COccupancyGridMap2D grid(-5.0f, 5.0f, -5.0f, 5.0f, 0.10f);
+	grid.insertionOptions.freeCellsOncePerScan = true;
+	grid.insertionOptions.insertionThreads = 3;
+
+	mrpt::io::CMemoryStream buf;
+	auto arch = mrpt::serialization::archiveFrom(buf);
+	arch << grid;
+	buf.Seek(0);
+	COccupancyGridMap2D loaded;
+	arch >> loaded;
+
+	EXPECT_TRUE(loaded.insertionOptions.freeCellsOncePerScan);
+	EXPECT_EQ(loaded.insertionOptions.insertionThreads, 3U);
+}
+
+TEST(COccupancyGridMap2DTests, copyOnWriteTiles)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D grid1(-20, 20, -20, 20, 0.05);
+	grid1.insertObservation(scan1);
+	const auto& raw1 = grid1.getRawMap();
+	const size_t nTiles = raw1.tileCount();
+	// Tiles far from the scan are still shared with the initial empty tile:
+	EXPECT_GT(raw1.sharedTileCount(), 0U);
+
+	COccupancyGridMap2D grid2 = grid1;
+	EXPECT_EQ(grid2.getRawMap().sharedTileCount(), nTiles);
+
+	// Modifying the copy only clones the affected tiles:
+	grid2.setCell(10, 10, 0.9f);
+	EXPECT_EQ(grid2.getRawMap().sharedTileCount(), nTiles - 1);
+	EXPECT_NEAR(grid2.getCell(10, 10), 0.9f, 0.01f);
+	EXPECT_NEAR(grid1.getCell(10, 10), 0.5f, 0.01f);
+
+	// And both maps are otherwise identical:
+	for (unsigned int cy = 0; cy < grid1.getSizeY(); cy++)
+		for (unsigned int cx = 0; cx < grid1.getSizeX(); cx++)
+		{
+			if (cx == 10 && cy == 10) continue;
+			EXPECT_EQ(grid1.getCell(cx, cy), grid2.getCell(cx, cy));
+		}
+}
+
+TEST(COccupancyGridMap2DTests, copyWithLikelihoodCache)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D grid1(-20.0f, 20.0f, -20.0f, 20.0f, 0.05f);
+	grid1.insertObservation(scan1);
+	grid1.likelihoodOptions.enableLikelihoodCache = true;
+
+	CSimplePointsMap pts;
+	pts.insertObservation(scan1);
+	const CPose2D p(0.1, -0.2, 0.05);
+	const double lik1 = grid1.computeLikelihoodField_Thrun(&pts, &p);
+
+	// The copy does not get the cache of grid1, but rebuilds its own one:
+	COccupancyGridMap2D grid2 = grid1;
+	EXPECT_DOUBLE_EQ(grid2.computeLikelihoodField_Thrun(&pts, &p), lik1);
+	COccupancyGridMap2D grid3;
+	grid3 = grid1;
+	EXPECT_DOUBLE_EQ(grid3.computeLikelihoodField_Thrun(&pts, &p), lik1);
+	EXPECT_DOUBLE_EQ(grid1.computeLikelihoodField_Thrun(&pts, &p), lik1);
+}
+
+TEST(COccupancyGridMap2DTests, computeLikelihoodFieldBatch)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COccupancyGridMap2D grid(-20.0f, 20.0f, -20.0f, 20.0f, 0.05f);
+	grid.insertObservation(scan1);
+
+	CSimplePointsMap pts;
+	pts.insertObservation(scan1);
+
+	// Include poses leaving part of the points out of the grid:
+	std::vector<TPose2D> poses;
+	for (int i = 0; i < 25; i++)
+		poses.emplace_back(0.1 * i - 1.0, 0.8 * i - 10.0, 0.07 * i);
+
+	for (const bool useCache : {true, false})
+	{
+		for (const bool altAverage : {false, true})
+		{
+			grid.likelihoodOptions.enableLikelihoodCache = useCache;
+			grid.likelihoodOptions.LF_alternateAverageMethod = altAverage;
+
+			std::vector<double> logLiksThrun, logLiksII;
+			grid.computeLikelihoodField_Thrun(&pts, poses, logLiksThrun);
+			grid.computeLikelihoodField_II(&pts, poses, logLiksII);
+			ASSERT_EQ(logLiksThrun.size(), poses.size());
+			ASSERT_EQ(logLiksII.size(), poses.size());
+
+			for (size_t i = 0; i < poses.size(); i++)
+			{
+				const CPose2D p(poses[i]);
+				EXPECT_NEAR(
+					logLiksThrun[i],
+					grid.computeLikelihoodField_Thrun(&pts, &p), 1e-6)
+					<< "useCache=" << useCache << " pose=" << poses[i];
+				EXPECT_NEAR(
+					logLiksII[i], grid.computeLikelihoodField_II(&pts, &p),
+					1e-6);
+			}
+		}
+	}
+}
+
 // We need OPENCV to read the image.
 #if MRPT_HAS_OPENCV && MRPT_HAS_FYAML
 
@@ -263,7 +263,7 @@ int COccupancyGridMap2D::computeClearance(
 		static_cast<unsigned>(cy) >= m_size_y)
 		return 0;
 
-	if (m_map[cx + cy * m_size_y] < thresholdCellValue) return 0;
+	if (m_map(cx, cy) < thresholdCellValue) return 0;
 
 	// Truco para acelerar MUCHO:
 	//  Si miramos un punto junto al mirado antes,
@@ -350,7 +350,7 @@ int COccupancyGridMap2D::computeClearance(
 				yy < static_cast<int>(m_size_y))
 			{
 				// if ( getCell(xx,yy)<=voroni_free_threshold )
-				if (m_map[xx + yy * m_size_y] < thresholdCellValue)
+				if (m_map(xx, yy) < thresholdCellValue)
 				{
 					if (!dentro_obs)
 					{
@@ -570,7 +570,7 @@ float COccupancyGridMap2D::computeClearance(
 
 	for (xx = xx1; xx <= xx2; xx++)
 		for (yy = yy1; yy <= yy2; yy++)
-			if (m_map[xx + yy * m_size_x] < thresholdCellValue)
+			if (m_map(xx, yy) < thresholdCellValue)
 				clearance_sq = min(
 					clearance_sq,
 					square(m_resolution) * (square(xx - cx) + square(yy - cy)));
@@ -40,6 +40,7 @@ void COccupancyGridMap3D::TMapDefinition::loadFromConfigFile_map_specific(
 	MRPT_LOAD_CONFIG_VAR(min_z, float, source, sSectCreation);
 	MRPT_LOAD_CONFIG_VAR(max_z, float, source, sSectCreation);
 	MRPT_LOAD_CONFIG_VAR(resolution, float, source, sSectCreation);
+	MRPT_LOAD_CONFIG_VAR(sparse_storage, bool, source, sSectCreation);
 
 	// [<sectionName>+"_occupancyGrid_##_insertOpts"]
 	insertionOpts.loadFromConfigFile(source, sect + "_insertOpts"s);
@@ -58,6 +59,7 @@ void COccupancyGridMap3D::TMapDefinition::dumpToTextStream_map_specific(
 	LOADABLEOPTS_DUMP_VAR(min_z, float);
 	LOADABLEOPTS_DUMP_VAR(max_z, float);
 	LOADABLEOPTS_DUMP_VAR(resolution, float);
+	LOADABLEOPTS_DUMP_VAR(sparse_storage, bool);
 
 	this->insertionOpts.dumpToTextStream(out);
 	this->likelihoodOpts.dumpToTextStream(out);
@@ -70,6 +72,7 @@ mrpt::maps::CMetricMap* COccupancyGridMap3D::internal_CreateFromMapDefinition(
 	auto* obj = new COccupancyGridMap3D(
 		mrpt::math::TPoint3D(def.min_x, def.min_y, def.min_z),
 		mrpt::math::TPoint3D(def.max_x, def.max_y, def.max_z), def.resolution);
+	if (def.sparse_storage) obj->setSparseStorage(true);
 	obj->insertionOptions = def.insertionOpts;
 	obj->likelihoodOptions = def.likelihoodOpts;
 	return obj;
@@ -119,6 +122,15 @@ void COccupancyGridMap3D::setSize(
 	MRPT_END
 }
 
+void COccupancyGridMap3D::setSparseStorage(bool sparse)
+{
+	m_grid.setStorageMode(
+		sparse ? mrpt::containers::grid_storage_t::SparseTiles
+			   : mrpt::containers::grid_storage_t::Dense,
+		p2l(0.5f));
+	m_is_empty = true;
+}
+
 void COccupancyGridMap3D::resizeGrid(
 	const mrpt::math::TPoint3D& cmin, const mrpt::math::TPoint3D& cmax,
 	float new_cells_default_value)
@@ -162,7 +174,7 @@ void COccupancyGridMap3D::updateCell(int x, int y, int z, float v)
 	if (m_grid.isOutOfBounds(x, y, z)) return;
 
 	// Get the current contents of the cell:
-	auto* cp = m_grid.cellByIndex(x, y, z);
+	auto* cp = m_grid.insertCellByIndex(x, y, z);
 	ASSERT_(cp != nullptr);
 	voxelType& theCell = *cp;
 
@@ -368,14 +380,35 @@ void COccupancyGridMap3D::serializeTo(mrpt::serialization::CArchive& out) const
 	// Save grid dimensions:
 	m_grid.dyngridcommon_writeToStream(out);
 
+	if (m_grid.getStorageMode() == mrpt::containers::grid_storage_t::Dense)
+	{
+#ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
+		out.WriteBuffer
+#else
+		out.WriteBufferFixEndianness
+#endif
+			(m_grid.cellByIndex(0, 0, 0),
+			 sizeof(cell_t) * m_grid.getSizeX() * m_grid.getSizeY() *
+				 m_grid.getSizeZ());
+	}
+	else
+	{
+		// Sparse tiles: write the same stream, one row of voxels at a time.
+		const unsigned int nx = m_grid.getSizeX();
+		std::vector<cell_t> row(nx);
+		for (unsigned int cz = 0; cz < m_grid.getSizeZ(); cz++)
+			for (unsigned int cy = 0; cy < m_grid.getSizeY(); cy++)
+			{
+				for (unsigned int cx = 0; cx < nx; cx++)
+					row[cx] = *m_grid.cellByIndex(cx, cy, cz);
+				if (!nx) continue;
 #ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
-	out.WriteBuffer
+				out.WriteBuffer(&row[0], sizeof(cell_t) * nx);
 #else
-	out.WriteBufferFixEndianness
+				out.WriteBufferFixEndianness(&row[0], nx);
 #endif
-		(m_grid.cellByIndex(0, 0, 0),
-		 sizeof(cell_t) * m_grid.getSizeX() * m_grid.getSizeY() *
-			 m_grid.getSizeZ());
+			}
+	}
 
 	// insertionOptions:
 	out << insertionOptions.maxDistanceInsertion
@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/maps/COccupancyGridMap3D.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/CObservation3DRangeScan.h>
@@ -33,6 +34,47 @@ TEST(COccupancyGridMap3DTests, insert2DScan)
 	}
 }
 
+TEST(COccupancyGridMap3DTests, sparseStorage)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	mrpt::obs::stock_observations::example2DRangeScan(scan1);
+
+	mrpt::maps::COccupancyGridMap3D dense, sparse;
+	sparse.setSparseStorage(true);
+	EXPECT_TRUE(sparse.isSparseStorage());
+	EXPECT_FALSE(dense.isSparseStorage());
+
+	dense.insertObservation(scan1);
+	sparse.insertObservation(scan1);
+
+	// Only the tiles touched by the scan are allocated:
+	const auto& g = sparse.m_grid;
+	EXPECT_GT(g.sparseStorage().tileCount(), 0U);
+	EXPECT_LT(
+		g.sparseStorage().tileCount() * g.sparseStorage().TILE_CELLS,
+		g.getVoxelCount());
+
+	const auto checkEqual = [&](const mrpt::maps::COccupancyGridMap3D& m) {
+		for (unsigned int cz = 0; cz < g.getSizeZ(); cz++)
+			for (unsigned int cy = 0; cy < g.getSizeY(); cy++)
+				for (unsigned int cx = 0; cx < g.getSizeX(); cx++)
+					EXPECT_EQ(
+						*m.m_grid.cellByIndex(cx, cy, cz),
+						*dense.m_grid.cellByIndex(cx, cy, cz));
+	};
+	checkEqual(sparse);
+
+	// Same stream format as dense maps:
+	mrpt::io::CMemoryStream buf;
+	auto arch = mrpt::serialization::archiveFrom(buf);
+	arch << sparse;
+	buf.Seek(0);
+	mrpt::maps::COccupancyGridMap3D loaded;
+	arch >> loaded;
+	EXPECT_FALSE(loaded.isSparseStorage());
+	checkEqual(loaded);
+}
+
 // We need OPENCV to read the image internal to CObservation3DRangeScan,
 // so skip this test if built without opencv.
 #if MRPT_HAS_OPENCV
@@ -143,8 +143,7 @@ bool COctoMap::internal_insertObservation(
 			obs, robotPose, sensorPt, scan))
 		return false;  // Nothing to do.
 	// Insert rays:
-	m_impl->m_octomap.insertPointCloud(
-		scan, sensorPt, insertionOptions.maxrange, insertionOptions.pruning);
+	internal_insertPointCloud(sensorPt, scan);
 	return true;
 }
 
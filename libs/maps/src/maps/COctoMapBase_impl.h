@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 
 // This file is to be included from <mrpt/maps/COctoMapBase.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/io/CFileOutputStream.h>
 #include <mrpt/maps/CPointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
@@ -16,6 +17,10 @@
 #include <mrpt/obs/CObservationVelodyneScan.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 namespace mrpt::maps
 {
 template <class OCTREE, class OCTREE_NODE>
@@ -183,6 +188,101 @@ bool COctoMapBase<OCTREE, OCTREE_NODE>::
 	return false;
 }
 
+template <class OCTREE, class OCTREE_NODE>
+template <class octomap_point3d, class octomap_pointcloud>
+void COctoMapBase<OCTREE, OCTREE_NODE>::internal_insertPointCloud(
+	const octomap_point3d& sensorPt, const octomap_pointcloud& scan)
+{
+	auto& tree = m_impl->m_octomap;
+
+	unsigned int nThreads = insertionOptions.insertionThreads;
+	if (nThreads == 1 && !insertionOptions.voxelDownsampling)
+	{
+		tree.insertPointCloud(
+			scan, sensorPt, insertionOptions.maxrange,
+			insertionOptions.pruning);
+		return;
+	}
+	if (nThreads == 0)
+		nThreads = std::max(1U, std::thread::hardware_concurrency());
+
+	// Ray end points, optionally downsampled to one per voxel:
+	std::vector<octomap::point3d> ends;
+	if (insertionOptions.voxelDownsampling)
+	{
+		octomap::KeySet endKeys;
+		octomap::OcTreeKey key;
+		ends.reserve(scan.size());
+		for (const auto& p : scan)
+			if (tree.coordToKeyChecked(p, key) && endKeys.insert(key).second)
+				ends.push_back(tree.keyToCoord(key));
+	}
+	else
+		ends.assign(scan.begin(), scan.end());
+
+	// Free and occupied keys of each batch of rays, as in
+	// octomap::OccupancyOcTreeBase::computeUpdate():
+	struct RayBatch
+	{
+		octomap::KeySet free, occupied;
+	};
+	const size_t batchSize =
+		std::max<size_t>(64, ends.size() / (4 * nThreads));
+	const size_t nBatches = (ends.size() + batchSize - 1) / batchSize;
+	std::vector<RayBatch> batches(nBatches);
+	const double maxrange = insertionOptions.maxrange;
+
+	auto traceBatch = [&](size_t b) {
+		auto& out = batches[b];
+		octomap::KeyRay ray;
+		octomap::OcTreeKey key;
+		const size_t iEnd = std::min(ends.size(), (b + 1) * batchSize);
+		for (size_t i = b * batchSize; i < iEnd; i++)
+		{
+			const auto& p = ends[i];
+			if (maxrange < 0 || (p - sensorPt).norm() <= maxrange)
+			{
+				if (tree.computeRayKeys(sensorPt, p, ray))
+					out.free.insert(ray.begin(), ray.end());
+				if (tree.coordToKeyChecked(p, key)) out.occupied.insert(key);
+			}
+			else
+			{
+				// Truncated ray: free space only, up to maxrange
+				const octomap::point3d newEnd = sensorPt +
+					(p - sensorPt).normalized() * static_cast<float>(maxrange);
+				if (tree.computeRayKeys(sensorPt, newEnd, ray))
+					out.free.insert(ray.begin(), ray.end());
+			}
+		}
+	};
+
+	if (nThreads == 1 || nBatches < 2)
+	{
+		for (size_t b = 0; b < nBatches; b++)
+			traceBatch(b);
+	}
+	else
+	{
+		mrpt::WorkStealingThreadsPool::shared(nThreads, "octomapInsertion")
+			.parallel_for(0, nBatches, traceBatch, 1 /*chunk*/);
+	}
+
+	// Single-threaded update of the tree. Voxels hit by any ray are only
+	// updated as occupied:
+	octomap::KeySet occupied, free;
+	for (const auto& b : batches)
+		occupied.insert(b.occupied.begin(), b.occupied.end());
+	for (const auto& b : batches)
+		for (const auto& k : b.free)
+			if (occupied.count(k) == 0) free.insert(k);
+
+	for (const auto& k : free)
+		tree.updateNode(k, false, insertionOptions.pruning);
+	for (const auto& k : occupied)
+		tree.updateNode(k, true, insertionOptions.pruning);
+}
+
 template <class OCTREE, class OCTREE_NODE>
 void COctoMapBase<OCTREE, OCTREE_NODE>::saveMetricMapRepresentationToFile(
 	const std::string& filNamePrefix) const
@@ -262,10 +362,22 @@ void COctoMapBase<OCTREE, OCTREE_NODE>::insertPointCloud(
 	size_t N;
 	const float *xs, *ys, *zs;
 	ptMap.getPointsBuffer(N, xs, ys, zs);
-	for (size_t i = 0; i < N; i++)
-		m_impl->m_octomap.insertRay(
-			sensorPt, octomap::point3d(xs[i], ys[i], zs[i]),
-			insertionOptions.maxrange, insertionOptions.pruning);
+	if (insertionOptions.insertionThreads != 1 ||
+		insertionOptions.voxelDownsampling)
+	{
+		octomap::Pointcloud scan;
+		scan.reserve(N);
+		for (size_t i = 0; i < N; i++)
+			scan.push_back(xs[i], ys[i], zs[i]);
+		internal_insertPointCloud(sensorPt, scan);
+	}
+	else
+	{
+		for (size_t i = 0; i < N; i++)
+			m_impl->m_octomap.insertRay(
+				sensorPt, octomap::point3d(xs[i], ys[i], zs[i]),
+				insertionOptions.maxrange, insertionOptions.pruning);
+	}
 	MRPT_END
 }
 
@@ -352,6 +464,8 @@ void COctoMapBase<OCTREE, OCTREE_NODE>::TInsertionOptions::dumpToTextStream(
 
 	LOADABLEOPTS_DUMP_VAR(maxrange, double);
 	LOADABLEOPTS_DUMP_VAR(pruning, bool);
+	LOADABLEOPTS_DUMP_VAR(insertionThreads, int);
+	LOADABLEOPTS_DUMP_VAR(voxelDownsampling, bool);
 
 	LOADABLEOPTS_DUMP_VAR(getOccupancyThres(), double);
 	LOADABLEOPTS_DUMP_VAR(getProbHit(), double);
@@ -381,6 +495,8 @@ void COctoMapBase<OCTREE, OCTREE_NODE>::TInsertionOptions::loadFromConfigFile(
 {
 	MRPT_LOAD_CONFIG_VAR(maxrange, double, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(pruning, bool, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(insertionThreads, int, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(voxelDownsampling, bool, iniFile, section);
 
 	MRPT_LOAD_CONFIG_VAR(occupancyThres, double, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(probHit, double, iniFile, section);
@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/maps/COctoMap.h>
+#include <mrpt/maps/CPointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/stock_observations.h>
 
@@ -60,3 +61,48 @@ TEST(COctoMapTests, insert2DScan)
 		map.insertObservation(scan1);
 	}
 }
+
+TEST(COctoMapTests, insert2DScanParallel)
+{
+	mrpt::obs::CObservation2DRangeScan scan1;
+	stock_observations::example2DRangeScan(scan1);
+
+	COctoMap mapRef(0.1);
+	mapRef.insertObservation(scan1);
+
+	for (const unsigned int nThreads : {2U, 4U, 0U})
+	{
+		COctoMap map(0.1);
+		map.insertionOptions.insertionThreads = nThreads;
+		map.insertObservation(scan1);
+
+		// Same voxels and occupancy than the octomap library insertion:
+		EXPECT_EQ(map.size(), mapRef.size());
+		for (double x = -5.0; x < 5.0; x += 0.05)
+			for (double y = -5.0; y < 5.0; y += 0.05)
+			{
+				double occ = 0, occRef = 0;
+				const bool mapped = map.getPointOccupancy(x, y, 0, occ);
+				const bool mappedRef =
+					mapRef.getPointOccupancy(x, y, 0, occRef);
+				EXPECT_EQ(mapped, mappedRef);
+				if (!mapped || !mappedRef) continue;
+				EXPECT_NEAR(occ, occRef, 1e-6);
+			}
+	}
+
+	// Voxel downsampling keeps all the scan end points occupied:
+	COctoMap mapDown(0.1);
+	mapDown.insertionOptions.voxelDownsampling = true;
+	mapDown.insertObservation(scan1);
+	const auto* pts = scan1.buildAuxPointsMap<mrpt::maps::CPointsMap>();
+	for (size_t i = 0; i < pts->size(); i++)
+	{
+		float x, y, z;
+		pts->getPointFast(i, x, y, z);
+		double occ = 0, occRef = 0;
+		if (!mapRef.getPointOccupancy(x, y, z, occRef)) continue;
+		EXPECT_TRUE(mapDown.getPointOccupancy(x, y, z, occ));
+		EXPECT_EQ(occ > 0.5, occRef > 0.5);
+	}
+}
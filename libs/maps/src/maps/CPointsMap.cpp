@@ -12,6 +12,7 @@
 #include <mrpt/config/CConfigFile.h>
 #include <mrpt/core/SSE_macros.h>
 #include <mrpt/core/SSE_types.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/maps/CPointsMap.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/math/TPose2D.h>
@@ -30,6 +31,7 @@
 
 #include <fstream>
 #include <sstream>
+#include <thread>
 
 #if MRPT_HAS_MATLAB
 #include <mexplus.h>
@@ -46,6 +48,47 @@ using namespace std;
 
 IMPLEMENTS_VIRTUAL_SERIALIZABLE(CPointsMap, CMetricMap, mrpt::maps)
 
+namespace
+{
+/** Runs `matchRange(first, last, pairs)` for the (decimated) "other map"
+ * points in [0,nPoints), either in this thread or in parallel. In the latter
+ * case, each chunk of points writes to its own list of pairs, and all lists
+ * are concatenated in order, so the output is identical in both cases. */
+template <class MATCH_RANGE>
+void runPointsMatching(
+	unsigned int parallelThreads, size_t nPoints, MATCH_RANGE&& matchRange,
+	TMatchingPairList& outPairs)
+{
+	const size_t chunkSize = 256;
+
+	if (parallelThreads == 0)
+		parallelThreads = std::max(1U, std::thread::hardware_concurrency());
+
+	if (parallelThreads == 1 || nPoints <= chunkSize)
+	{
+		matchRange(0, nPoints, outPairs);
+		return;
+	}
+
+	auto& pool = mrpt::WorkStealingThreadsPool::shared(
+		parallelThreads, "pointsMatching");
+
+	std::vector<TMatchingPairList> chunkPairs(
+		(nPoints + chunkSize - 1) / chunkSize);
+	pool.parallel_for_chunked(
+		0, nPoints,
+		[&](size_t first, size_t last) {
+			auto& pairs = chunkPairs[first / chunkSize];
+			pairs.reserve(last - first);
+			matchRange(first, last, pairs);
+		},
+		chunkSize);
+
+	for (const auto& pairs : chunkPairs)
+		outPairs.insert(outPairs.end(), pairs.begin(), pairs.end());
+}
+}  // namespace
+
 /*---------------------------------------------------------------
 						Constructor
   ---------------------------------------------------------------*/
@@ -304,12 +347,6 @@ void CPointsMap::determineMatching2D(
 
 	auto bbLocal = mrpt::math::TBoundingBoxf::PlusMinusInfinity();
 
-	double maxDistForCorrespondenceSquared;
-	float x_local, y_local;
-	unsigned int localIdx;
-
-	const float *x_other_it, *y_other_it, *z_other_it;
-
 	// Prepare output: no correspondences initially:
 	correspondences.clear();
 	correspondences.reserve(nLocalPoints);
@@ -435,68 +472,76 @@ void CPointsMap::determineMatching2D(
 
 	// Loop for each point in local map:
 	// --------------------------------------------------
-	for (localIdx = params.offset_other_map_points,
-		x_other_it = &otherMap->m_x[params.offset_other_map_points],
-		y_other_it = &otherMap->m_y[params.offset_other_map_points],
-		z_other_it = &otherMap->m_z[params.offset_other_map_points];
-		 localIdx < nLocalPoints;
-		 x_other_it += params.decimation_other_map_points,
-		y_other_it += params.decimation_other_map_points,
-		z_other_it += params.decimation_other_map_points,
-		localIdx += params.decimation_other_map_points)
-	{
-		// For speed-up:
-		x_local = x_locals[localIdx];  // *x_locals_it;
-		y_local = y_locals[localIdx];  // *y_locals_it;
+	// Make sure the KD-tree is built before running parallel queries:
+	kdTreeEnsureIndexBuilt2D();
+
+	const size_t decim = params.decimation_other_map_points;
+	const size_t nPointsToMatch =
+		params.offset_other_map_points < nLocalPoints
+		? (nLocalPoints - params.offset_other_map_points + decim - 1) / decim
+		: 0;
+
+	const auto matchRange = [&](size_t first, size_t last,
+								TMatchingPairList& pairs) {
+		for (size_t k = first; k < last; k++)
+		{
+			const size_t localIdx = params.offset_other_map_points + k * decim;
 
-		// Find all the matchings in the requested distance:
+			// For speed-up:
+			const float x_local = x_locals[localIdx];
+			const float y_local = y_locals[localIdx];
 
-		// KD-TREE implementation =================================
-		// Use a KD-tree to look for the nearnest neighbor of:
-		//   (x_local, y_local, z_local)
-		// In "this" (global/reference) points map.
+			// Find all the matchings in the requested distance:
 
-		float tentativ_err_sq;
-		unsigned int tentativ_this_idx = kdTreeClosestPoint2D(
-			x_local, y_local,  // Look closest to this guy
-			tentativ_err_sq	 // save here the min. distance squared
-		);
+			// KD-TREE implementation =================================
+			// Use a KD-tree to look for the nearnest neighbor of:
+			//   (x_local, y_local, z_local)
+			// In "this" (global/reference) points map.
 
-		// Compute max. allowed distance:
-		maxDistForCorrespondenceSquared = square(
-			params.maxAngularDistForCorrespondence *
-				std::sqrt(
-					square(params.angularDistPivotPoint.x - x_local) +
-					square(params.angularDistPivotPoint.y - y_local)) +
-			params.maxDistForCorrespondence);
+			float tentativ_err_sq;
+			const unsigned int tentativ_this_idx = kdTreeClosestPoint2D(
+				x_local, y_local,  // Look closest to this guy
+				tentativ_err_sq	 // save here the min. distance squared
+			);
 
-		// Distance below the threshold??
-		if (tentativ_err_sq < maxDistForCorrespondenceSquared)
-		{
-			// Save all the correspondences:
-			TMatchingPair& p = tempCorrs.emplace_back();
+			// Compute max. allowed distance:
+			const double maxDistForCorrespondenceSquared = square(
+				params.maxAngularDistForCorrespondence *
+					std::sqrt(
+						square(params.angularDistPivotPoint.x - x_local) +
+						square(params.angularDistPivotPoint.y - y_local)) +
+				params.maxDistForCorrespondence);
 
-			p.globalIdx = tentativ_this_idx;
-			p.global.x = m_x[tentativ_this_idx];
-			p.global.y = m_y[tentativ_this_idx];
-			p.global.z = m_z[tentativ_this_idx];
+			// Distance below the threshold??
+			if (tentativ_err_sq < maxDistForCorrespondenceSquared)
+			{
+				// Save all the correspondences:
+				TMatchingPair& p = pairs.emplace_back();
 
-			p.localIdx = localIdx;
-			p.local.x = *x_other_it;
-			p.local.y = *y_other_it;
-			p.local.z = *z_other_it;
+				p.globalIdx = tentativ_this_idx;
+				p.global.x = m_x[tentativ_this_idx];
+				p.global.y = m_y[tentativ_this_idx];
+				p.global.z = m_z[tentativ_this_idx];
 
-			p.errorSquareAfterTransformation = tentativ_err_sq;
+				p.localIdx = localIdx;
+				p.local.x = otherMap->m_x[localIdx];
+				p.local.y = otherMap->m_y[localIdx];
+				p.local.z = otherMap->m_z[localIdx];
 
-			// At least one:
-			nOtherMapPointsWithCorrespondence++;
+				p.errorSquareAfterTransformation = tentativ_err_sq;
+			}
+		}  // For each local point
+	};
 
-			// Accumulate the MSE:
-			_sumSqrDist += p.errorSquareAfterTransformation;
-			_sumSqrCount++;
-		}
+	runPointsMatching(
+		params.parallelThreads, nPointsToMatch, matchRange, tempCorrs);
 
-	}  // For each local point
+	// At least one correspondence for each of these, and accumulate the MSE
+	// (in order, so the sum does not depend on the number of threads):
+	nOtherMapPointsWithCorrespondence = tempCorrs.size();
+	_sumSqrCount = tempCorrs.size();
+	for (const auto& p : tempCorrs)
+		_sumSqrDist += p.errorSquareAfterTransformation;
 
 	// Additional consistency filter: "onlyKeepTheClosest" up to now
 	//  led to just one correspondence for each "local map" point, but
@@ -1028,8 +1073,6 @@ void CPointsMap::determineMatching3D(
 
 	auto bbLocal = mrpt::math::TBoundingBoxf::PlusMinusInfinity();
 
-	double maxDistForCorrespondenceSquared;
-
 	// Prepare output: no correspondences initially:
 	correspondences.clear();
 	correspondences.reserve(nLocalPoints);
@@ -1072,16 +1115,26 @@ void CPointsMap::determineMatching3D(
 
 	// Loop for each point in local map:
 	// --------------------------------------------------
-	for (unsigned int localIdx = params.offset_other_map_points;
-		 localIdx < nLocalPoints;
-		 localIdx += params.decimation_other_map_points)
-	{
-		// For speed-up:
-		const float x_local = x_locals[localIdx];
-		const float y_local = y_locals[localIdx];
-		const float z_local = z_locals[localIdx];
-
+	// Make sure the KD-tree is built before running parallel queries:
+	kdTreeEnsureIndexBuilt3D();
+
+	const size_t decim = params.decimation_other_map_points;
+	const size_t nPointsToMatch =
+		params.offset_other_map_points < nLocalPoints
+		? (nLocalPoints - params.offset_other_map_points + decim - 1) / decim
+		: 0;
+
+	const auto matchRange = [&](size_t first, size_t last,
+								TMatchingPairList& pairs) {
+		for (size_t k = first; k < last; k++)
 		{
+			const size_t localIdx = params.offset_other_map_points + k * decim;
+
+			// For speed-up:
+			const float x_local = x_locals[localIdx];
+			const float y_local = y_locals[localIdx];
+			const float z_local = z_locals[localIdx];
+
 			// KD-TREE implementation
 			// Use a KD-tree to look for the nearnest neighbor of:
 			//   (x_local, y_local, z_local)
@@ -1094,7 +1147,7 @@ void CPointsMap::determineMatching3D(
 			);
 
 			// Compute max. allowed distance:
-			maxDistForCorrespondenceSquared = square(
+			const double maxDistForCorrespondenceSquared = square(
 				params.maxAngularDistForCorrespondence *
 					params.angularDistPivotPoint.distanceTo(
 						TPoint3D(x_local, y_local, z_local)) +
@@ -1104,7 +1157,7 @@ void CPointsMap::determineMatching3D(
 			if (tentativ_err_sq < maxDistForCorrespondenceSquared)
 			{
 				// Save all the correspondences:
-				TMatchingPair& p = tempCorrs.emplace_back();
+				TMatchingPair& p = pairs.emplace_back();
 
 				p.globalIdx = tentativ_this_idx;
 				p.global.x = m_x[tentativ_this_idx];
@@ -1117,17 +1170,19 @@ void CPointsMap::determineMatching3D(
 				p.local.z = otherMap->m_z[localIdx];
 
 				p.errorSquareAfterTransformation = tentativ_err_sq;
-
-				// At least one:
-				nOtherMapPointsWithCorrespondence++;
-
-				// Accumulate the MSE:
-				_sumSqrDist += p.errorSquareAfterTransformation;
-				_sumSqrCount++;
 			}
+		}  // For each local point
+	};
 
-		}  // End of test_match
-	}  // For each local point
+	runPointsMatching(
+		params.parallelThreads, nPointsToMatch, matchRange, tempCorrs);
+
+	// At least one correspondence for each of these, and accumulate the MSE
+	// (in order, so the sum does not depend on the number of threads):
+	nOtherMapPointsWithCorrespondence = tempCorrs.size();
+	_sumSqrCount = tempCorrs.size();
+	for (const auto& p : tempCorrs)
+		_sumSqrDist += p.errorSquareAfterTransformation;
 
 	// Additional consistency filter: "onlyKeepTheClosest" up to now
 	//  led to just one correspondence for each "local map" point, but
@@ -1638,7 +1693,7 @@ void CPointsMap::insertAnotherMap(
 	// Also copy other data fields (color, ...)
 	addFrom_classSpecific(*otherMap, N_this, filterOutPointsAtZero);
 
-	mark_as_modified();
+	mark_as_points_appended();
 }
 
 /** Helper method for ::copyFrom() */
@@ -1692,7 +1747,7 @@ bool CPointsMap::internal_insertObservation(
 		/********************************************************************
 					OBSERVATION TYPE: CObservation2DRangeScan
 		 ********************************************************************/
-		mark_as_modified();
+		mark_as_points_appended();
 
 		const auto& o = static_cast<const CObservation2DRangeScan&>(obs);
 		// Insert only HORIZONTAL scans??
@@ -1786,7 +1841,7 @@ bool CPointsMap::internal_insertObservation(
 		/********************************************************************
 					OBSERVATION TYPE: CObservation3DRangeScan
 		 ********************************************************************/
-		mark_as_modified();
+		mark_as_points_appended();
 
 		const auto& o = static_cast<const CObservation3DRangeScan&>(obs);
 		// Insert only HORIZONTAL scans??
@@ -1843,7 +1898,7 @@ bool CPointsMap::internal_insertObservation(
 		/********************************************************************
 					OBSERVATION TYPE: CObservationRange  (IRs, Sonars, etc.)
 		 ********************************************************************/
-		mark_as_modified();
+		mark_as_points_appended();
 
 		const auto& o = static_cast<const CObservationRange&>(obs);
 
@@ -1916,7 +1971,7 @@ bool CPointsMap::internal_insertObservation(
 	}
 	else if (IS_CLASS(obs, CObservationPointCloud))
 	{
-		mark_as_modified();
+		mark_as_points_appended();
 
 		const auto& o = static_cast<const CObservationPointCloud&>(obs);
 		ASSERT_(o.pointcloud);
@@ -2039,6 +2094,9 @@ void CPointsMap::fuseWith(
 			if (notFusedPoints) (*notFusedPoints).push_back(false);
 		}
 	}
+
+	// The KD-tree was rebuilt by determineMatching2D() above:
+	mark_as_modified();
 }
 
 void CPointsMap::loadFromVelodyneScan(
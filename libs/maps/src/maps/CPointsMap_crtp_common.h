@@ -24,7 +24,10 @@ struct loadFromRangeImpl
 		using namespace mrpt::poses;
 		using mrpt::DEG2RAD;
 		using mrpt::square;
-		obj.mark_as_modified();
+		if (obj.insertionOptions.addToExistingPointsMap)
+			obj.mark_as_points_appended();
+		else
+			obj.mark_as_modified();
 
 		// The next may seem useless, but it's required in case the observation
 		// underwent a move or copy operator, which may change the reserved mem
@@ -379,7 +382,10 @@ struct loadFromRangeImpl
 	{
 		using namespace mrpt::poses;
 		using mrpt::square;
-		obj.mark_as_modified();
+		if (obj.insertionOptions.addToExistingPointsMap)
+			obj.mark_as_points_appended();
+		else
+			obj.mark_as_modified();
 
 		// If robot pose is supplied, compute sensor pose relative to it.
 		CPose3D sensorPose3D(UNINITIALIZED_POSE);
@@ -13,6 +13,8 @@
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/maps/CWeightedPointsMap.h>
 #include <mrpt/poses/CPoint2D.h>
+#include <mrpt/poses/CPose2D.h>
+#include <mrpt/poses/CPose3D.h>
 
 #include <sstream>
 
@@ -21,6 +23,7 @@ using namespace mrpt::maps;
 using namespace mrpt::obs;
 using namespace mrpt::poses;
 using namespace mrpt::math;
+using namespace mrpt::tfest;
 using namespace std;
 
 const size_t demo9_N = 9;
@@ -303,3 +306,156 @@ TEST(CColouredPointsMapTests, loadSaveStreams)
 {
 	do_tests_loadSaveStreams<CColouredPointsMap>();
 }
+
+TEST(CSimplePointsMapTests, determineMatchingParallel)
+{
+	// Two overlapping, deterministic pseudo-random clouds:
+	CSimplePointsMap globalMap, localMap;
+	for (int i = 0; i < 4000; i++)
+	{
+		globalMap.insertPoint(
+			10 * std::sin(i * 0.37), 10 * std::cos(i * 0.71),
+			std::sin(i * 1.3));
+		localMap.insertPoint(
+			9 * std::sin(i * 0.53), 9 * std::cos(i * 0.29),
+			std::cos(i * 0.9));
+	}
+
+	const auto expectSameResults = [](const TMatchingPairList& c1,
+									  const TMatchingExtraResults& e1,
+									  const TMatchingPairList& c2,
+									  const TMatchingExtraResults& e2) {
+		ASSERT_EQ(c1.size(), c2.size());
+		for (size_t i = 0; i < c1.size(); i++)
+		{
+			EXPECT_EQ(c1[i].localIdx, c2[i].localIdx);
+			EXPECT_EQ(c1[i].globalIdx, c2[i].globalIdx);
+			EXPECT_EQ(
+				c1[i].errorSquareAfterTransformation,
+				c2[i].errorSquareAfterTransformation);
+		}
+		EXPECT_EQ(e1.sumSqrDist, e2.sumSqrDist);
+		EXPECT_EQ(e1.correspondencesRatio, e2.correspondencesRatio);
+	};
+
+	for (const bool uniqueRobust : {false, true})
+	{
+		for (const size_t decimation : {1, 3})
+		{
+			TMatchingParams params;
+			params.maxDistForCorrespondence = 0.3f;
+			params.onlyUniqueRobust = uniqueRobust;
+			params.decimation_other_map_points = decimation;
+			params.offset_other_map_points = decimation - 1;
+
+			const CPose2D pose2D(0.1, -0.2, 0.05);
+			const CPose3D pose3D(0.1, -0.2, 0.05, 0.05, 0.01, -0.02);
+
+			TMatchingPairList c2D_1, c3D_1;
+			TMatchingExtraResults e2D_1, e3D_1;
+			params.parallelThreads = 1;
+			globalMap.determineMatching2D(
+				&localMap, pose2D, c2D_1, params, e2D_1);
+			globalMap.determineMatching3D(
+				&localMap, pose3D, c3D_1, params, e3D_1);
+			EXPECT_GT(c2D_1.size(), 0U);
+			EXPECT_GT(c3D_1.size(), 0U);
+
+			for (const unsigned int nThreads : {2, 4, 0})
+			{
+				TMatchingPairList c2D, c3D;
+				TMatchingExtraResults e2D, e3D;
+				params.parallelThreads = nThreads;
+				globalMap.determineMatching2D(
+					&localMap, pose2D, c2D, params, e2D);
+				globalMap.determineMatching3D(
+					&localMap, pose3D, c3D, params, e3D);
+
+				expectSameResults(c2D_1, e2D_1, c2D, e2D);
+				expectSameResults(c3D_1, e3D_1, c3D, e3D);
+			}
+		}
+	}
+}
+
+TEST(CSimplePointsMapTests, incrementalKDTree)
+{
+	// "ref" always rebuilds its KD-tree, "inc" updates it incrementally:
+	CSimplePointsMap ref, inc;
+	inc.kdtree_search_params.incremental = true;
+
+	const auto insertPts = [&](int first, int last) {
+		for (int i = first; i < last; i++)
+		{
+			const float x = 10 * std::sin(i * 0.37f);
+			const float y = 10 * std::cos(i * 0.71f);
+			const float z = std::sin(i * 1.3f);
+			ref.insertPoint(x, y, z);
+			inc.insertPoint(x, y, z);
+		}
+	};
+
+	int nPts = 0;
+	for (int step = 0; step < 40; step++)
+	{
+		// Append batches of different sizes, via different methods:
+		const int batch = 1 + (step * 37) % 150;
+		if (step % 3 == 0)
+		{
+			CSimplePointsMap other;
+			for (int i = 0; i < batch; i++)
+				other.insertPoint(
+					std::cos(i * 0.3f), std::sin(i * 0.5f), i * 0.01f);
+			const CPose3D p(step * 0.1, -1.0, 0.0, step * 0.2, 0.0, 0.0);
+			ref.insertAnotherMap(&other, p);
+			inc.insertAnotherMap(&other, p);
+		}
+		else
+		{
+			insertPts(nPts, nPts + batch);
+		}
+		nPts += batch;
+		ASSERT_EQ(ref.size(), inc.size());
+
+		for (int q = 0; q < 10; q++)
+		{
+			const float qx = 8 * std::sin(q * 1.1f + step);
+			const float qy = 8 * std::cos(q * 0.7f + step);
+			const float qz = 0.5f * std::sin(q * 0.3f);
+
+			float d1, d2;
+			EXPECT_EQ(
+				ref.kdTreeClosestPoint2D(qx, qy, d1),
+				inc.kdTreeClosestPoint2D(qx, qy, d2));
+			EXPECT_EQ(d1, d2);
+
+			EXPECT_EQ(
+				ref.kdTreeClosestPoint3D(qx, qy, qz, d1),
+				inc.kdTreeClosestPoint3D(qx, qy, qz, d2));
+			EXPECT_EQ(d1, d2);
+
+			std::vector<size_t> idx1, idx2;
+			std::vector<float> dist1, dist2;
+			ref.kdTreeNClosestPoint3DIdx(qx, qy, qz, 5, idx1, dist1);
+			inc.kdTreeNClosestPoint3DIdx(qx, qy, qz, 5, idx2, dist2);
+			EXPECT_EQ(idx1, idx2);
+			EXPECT_EQ(dist1, dist2);
+
+			std::vector<nanoflann::ResultItem<size_t, float>> r1, r2;
+			ref.kdTreeRadiusSearch2D(qx, qy, 1.0f, r1);
+			inc.kdTreeRadiusSearch2D(qx, qy, 1.0f, r2);
+			ASSERT_EQ(r1.size(), r2.size());
+			for (size_t i = 0; i < r1.size(); i++)
+				EXPECT_EQ(r1[i].second, r2[i].second);
+		}
+	}
+
+	// A non-append modification must still be handled:
+	inc.setPoint(0, 100.0f, 100.0f, 100.0f);
+	ref.setPoint(0, 100.0f, 100.0f, 100.0f);
+	float d1, d2;
+	EXPECT_EQ(
+		ref.kdTreeClosestPoint3D(99.0f, 99.0f, 99.0f, d1),
+		inc.kdTreeClosestPoint3D(99.0f, 99.0f, 99.0f, d2));
+	EXPECT_EQ(0U, inc.kdTreeClosestPoint3D(99.0f, 99.0f, 99.0f, d2));
+}
@@ -844,6 +844,15 @@ void CRandomFieldGridMap2D::getAsBitmapFile(mrpt::img::CImage& out_img) const
 	MRPT_END
 }
 
+void CRandomFieldGridMap2D::setStorageMode(
+	mrpt::containers::grid_storage_t mode, const TRandomFieldCell& fillValue)
+{
+	ASSERTMSG_(
+		mode == mrpt::containers::grid_storage_t::Dense,
+		"Random field grid maps only support dense storage");
+	CDynamicGrid<TRandomFieldCell>::setStorageMode(mode, fillValue);
+}
+
 /*---------------------------------------------------------------
 					resize
  ---------------------------------------------------------------*/
@@ -55,6 +55,15 @@ void CRandomFieldGridMap3D::setSize(
 	MRPT_END
 }
 
+void CRandomFieldGridMap3D::setStorageMode(
+	mrpt::containers::grid_storage_t mode, const TRandomFieldVoxel& fillValue)
+{
+	ASSERTMSG_(
+		mode == mrpt::containers::grid_storage_t::Dense,
+		"Random field grid maps only support dense storage");
+	CDynamicGrid3D<TRandomFieldVoxel>::setStorageMode(mode, fillValue);
+}
+
 void CRandomFieldGridMap3D::resize(
 	double new_x_min, double new_x_max, double new_y_min, double new_y_max,
 	double new_z_min, double new_z_max,
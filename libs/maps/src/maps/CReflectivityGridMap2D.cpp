@@ -145,7 +145,7 @@ bool CReflectivityGridMap2D::internal_insertObservation(
 		const cell_t logodd_observation = m_logodd_lut.p2l(o.reflectivityLevel);
 
 		// Update cell, with saturation:
-		cell_t* cell = cellByPos(sensor_pose.x(), sensor_pose.y());
+		cell_t* cell = insertCellByPos(sensor_pose.x(), sensor_pose.y());
 		if (!cell)
 		{
 			// We need to resize the grid!
@@ -160,7 +160,7 @@ bool CReflectivityGridMap2D::internal_insertObservation(
 				2.0 /* addit. margin */);
 
 			// Now we should get the cell:
-			cell = cellByPos(sensor_pose.x(), sensor_pose.y());
+			cell = insertCellByPos(sensor_pose.x(), sensor_pose.y());
 
 			ASSERTMSG_(
 				cell != nullptr, "cell==nullptr even after resizing grid!?");
@@ -230,9 +230,22 @@ void CReflectivityGridMap2D::serializeTo(
 	dyngridcommon_writeToStream(out);
 
 	// Map cells:
-	const auto n = static_cast<uint32_t>(m_map.size());
+	const auto n = static_cast<uint32_t>(m_size_x * m_size_y);
 	out << n;
-	if (n) out.WriteBuffer(&m_map[0], n);
+	if (getStorageMode() == mrpt::containers::grid_storage_t::Dense)
+	{
+		if (n) out.WriteBuffer(&m_map[0], n);
+	}
+	else
+	{
+		std::vector<cell_t> row(m_size_x);
+		for (unsigned int y = 0; y < m_size_y; y++)
+		{
+			for (unsigned int x = 0; x < m_size_x; x++)
+				row[x] = *cellByIndex(x, y);
+			if (m_size_x) out.WriteBuffer(&row[0], m_size_x);
+		}
+	}
 
 	// Save the insertion options
 	out << insertionOptions.channel;  // v3
@@ -312,7 +325,6 @@ void CReflectivityGridMap2D::getAsImage(
 	if (!forceRGB)
 	{  // 8bit gray-scale
 		img.resize(m_size_x, m_size_y, CH_GRAY);
-		const cell_t* srcPtr = &m_map[0];
 		unsigned char* destPtr;
 		for (unsigned int y = 0; y < m_size_y; y++)
 		{
@@ -321,14 +333,13 @@ void CReflectivityGridMap2D::getAsImage(
 				destPtr = img(0, y);
 			for (unsigned int x = 0; x < m_size_x; x++)
 			{
-				*destPtr++ = m_logodd_lut.l2p_255(*srcPtr++);
+				*destPtr++ = m_logodd_lut.l2p_255(*cellByIndex(x, y));
 			}
 		}
 	}
 	else
 	{  // 24bit RGB:
 		img.resize(m_size_x, m_size_y, CH_RGB);
-		const cell_t* srcPtr = &m_map[0];
 		unsigned char* destPtr;
 		for (unsigned int y = 0; y < m_size_y; y++)
 		{
@@ -337,7 +348,7 @@ void CReflectivityGridMap2D::getAsImage(
 				destPtr = img(0, y);
 			for (unsigned int x = 0; x < m_size_x; x++)
 			{
-				uint8_t c = m_logodd_lut.l2p_255(*srcPtr++);
+				uint8_t c = m_logodd_lut.l2p_255(*cellByIndex(x, y));
 				*destPtr++ = c;
 				*destPtr++ = c;
 				*destPtr++ = c;
@@ -362,7 +373,6 @@ void CReflectivityGridMap2D::getVisualizationInto(
 	CImage imgColor(m_size_x, m_size_y, CH_GRAY);
 	CImage imgTrans(m_size_x, m_size_y, CH_GRAY);
 
-	const cell_t* srcPtr = &m_map[0];
 	unsigned char* destPtr_color;
 	unsigned char* destPtr_trans;
 
@@ -372,7 +382,7 @@ void CReflectivityGridMap2D::getVisualizationInto(
 		destPtr_trans = imgTrans(0, y);
 		for (unsigned int x = 0; x < m_size_x; x++)
 		{
-			uint8_t cell255 = m_logodd_lut.l2p_255(*srcPtr++);
+			uint8_t cell255 = m_logodd_lut.l2p_255(*cellByIndex(x, y));
 			*destPtr_color++ = cell255;
 
 			int8_t auxC = (int8_t)((signed short)cell255) - 128;
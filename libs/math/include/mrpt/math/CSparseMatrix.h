@@ -9,12 +9,14 @@
 #pragma once
 
 #include <mrpt/config.h>  //MRPT_HAS_SUITESPARSE
+#include <mrpt/core/pimpl.h>
 #include <mrpt/math/CMatrixDynamic.h>
 #include <mrpt/math/CMatrixFixed.h>
 #include <mrpt/math/CSparseMatrixTemplate.h>
 #include <mrpt/math/CVectorDynamic.h>
 #include <mrpt/math/math_frwds.h>
 
+#include <cstdint>
 #include <cstring>	// memcpy
 #include <stdexcept>
 
@@ -32,6 +34,11 @@ extern "C"
 #endif
 }
 
+namespace mrpt
+{
+class WorkStealingThreadsPool;
+}
+
 namespace mrpt::math
 {
 /** Used in mrpt::math::CSparseMatrix */
@@ -40,6 +47,22 @@ struct CExceptionNotDefPos : public std::runtime_error
 	CExceptionNotDefPos(const char* s) : std::runtime_error(s) {}
 };
 
+/** Sparse Cholesky factorization algorithms for
+ * mrpt::math::CSparseMatrix::CholeskyDecomp
+ * \note (New in MRPT 2.7.1)
+ */
+enum class TSparseCholeskyBackend : uint8_t
+{
+	/** Scalar, left-looking factorization from CSparse (`cs_chol`) */
+	CSparse = 0,
+	/** Block factorization for matrices made of dense square blocks of a
+	 * fixed size, like the Hessian of pose graphs (3x3 or 6x6 blocks): AMD
+	 * ordering of the graph of blocks, and left-looking factorization with
+	 * dense block operations. Independent subtrees of the elimination tree
+	 * can be factorized in parallel. */
+	Block
+};
+
 /** A sparse matrix structure, wrapping T. Davis' CSparse library (part of
  *suitesparse)
  *  The type of the matrix entries is fixed to "double".
@@ -338,6 +361,32 @@ class CSparseMatrix
 	 */
 	void compressFromTriplet();
 
+	/** Makes this a column-compressed matrix with the given sparsity pattern
+	 * (CSC format), with all its entries set to zero. Values can be then
+	 * (re)filled in place via columnCompressedValues(), e.g. on each
+	 * iteration of an optimizer, without building a triplet matrix again.
+	 * \param colPointers Start of each column in `rowIndices`, with
+	 * `nCols+1` entries (the last one is the number of non-zero entries).
+	 * \param rowIndices The row of each non-zero entry, sorted within each
+	 * column.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void setColumnCompressedStructure(
+		const size_t nRows, const size_t nCols,
+		const std::vector<int>& colPointers,
+		const std::vector<int>& rowIndices);
+
+	/** ONLY for column-compressed matrices: direct access to the array of
+	 * non-zero values, in the same order as the row indices of each column.
+	 * \sa setColumnCompressedStructure, nonZeroCount
+	 * \note (New in MRPT 2.7.1)
+	 */
+	double* columnCompressedValues();
+
+	/** ONLY for column-compressed matrices: number of stored entries.
+	 * \note (New in MRPT 2.7.1) */
+	size_t nonZeroCount() const;
+
 	/** Return a dense representation of the sparse matrix.
 	 * \sa saveToTextFile_dense
 	 */
@@ -438,13 +487,34 @@ class CSparseMatrix
 	 */
 	class CholeskyDecomp
 	{
+	   public:
+		/** Parameters of the factorization \note (New in MRPT 2.7.1) */
+		struct TParameters
+		{
+			TSparseCholeskyBackend backend = TSparseCholeskyBackend::CSparse;
+			/** Size of the square blocks, for the Block backend. The matrix
+			 * size must be a multiple of it. */
+			size_t blockSize = 1;
+			/** If not null, the Block backend factorizes independent
+			 * subtrees of the elimination tree in parallel */
+			mrpt::WorkStealingThreadsPool* pool = nullptr;
+		};
+
 	   private:
-		css* m_symbolic_structure;
-		csn* m_numeric_structure;
+		css* m_symbolic_structure = nullptr;
+		csn* m_numeric_structure = nullptr;
 		/** A const reference to the original matrix used to build this
 		 * decomposition. */
 		const CSparseMatrix* m_originalSM;
 
+		TParameters m_params;
+		/** Symbolic and numeric data of the Block backend */
+		struct BlockImpl;
+		spimpl::unique_impl_ptr<BlockImpl> m_block;
+
+		void block_symbolic();
+		void block_numeric();
+
 	   public:
 		/** Constructor from a square definite-positive sparse matrix A, which
 		 * can be use to solve Ax=b
@@ -456,6 +526,13 @@ class CSparseMatrix
 		 * matrix as input.
 		 */
 		CholeskyDecomp(const CSparseMatrix& A);
+
+		/** Constructor with a selection of the factorization algorithm.
+		 * The fill-reducing ordering and the symbolic analysis are done
+		 * here only once, and reused by update().
+		 * \note (New in MRPT 2.7.1) */
+		CholeskyDecomp(const CSparseMatrix& A, const TParameters& params);
+
 		CholeskyDecomp(const CholeskyDecomp& A) = delete;
 
 		CholeskyDecomp& operator=(const CholeskyDecomp&) = delete;
@@ -471,7 +548,9 @@ class CSparseMatrix
 			return L;
 		}
 
-		/** Return the L matrix (L*L' = M), as a dense matrix. */
+		/** Return the L matrix (L*L' = M), as a dense matrix.
+		 * Note that it is the factor of the matrix with rows and columns
+		 * permuted with the fill-reducing ordering. */
 		void get_L(CMatrixDouble& out_L) const;
 
 		/** Return the vector from a back-substitution step that solves: Ux=b */
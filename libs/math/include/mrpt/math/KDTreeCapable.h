@@ -14,11 +14,19 @@
 #include <mrpt/math/TPoint2D.h>
 #include <mrpt/math/TPoint3D.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <memory>  // unique_ptr
 #include <mutex>
 #include <nanoflann.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace mrpt
+{
+class WorkStealingThreadsPool;
+}
 
 // Smooth transition to nanoflann>=1.5.0 for older versions:
 namespace nanoflann
@@ -72,11 +80,18 @@ namespace mrpt::math
  * The KD-tree index will be built on demand only upon call of any of the query
  * methods provided by this class.
  *
- * Notice that there is only ONE internal cached KD-tree, so if a method to
- * query a 2D point is called, then another method for 3D points, then again
- * the 2D method, three KD-trees will be built. So, try to group all the calls
- * for a given dimensionality together or build different class instances for
- * queries of each dimensionality.
+ * Both, a 2D and a 3D KD-tree can be cached at a time. Both are discarded
+ * when the data changes.
+ *
+ * If TKDTreeSearchParams::incremental is enabled, derived classes may call
+ * `kdtree_mark_as_appended()` instead of `kdtree_mark_as_outdated()` when
+ * the only change was appending new points at the end of the dataset. Then,
+ * instead of rebuilding the whole tree, the index is kept as a forest of
+ * static sub-trees over contiguous ranges of points with decreasing sizes
+ * (a "logarithmic method"): new points go into a new sub-tree, which is
+ * merged with the previous ones while they are not larger than it. Each point
+ * is thus re-indexed O(log n) times, and queries visit O(log n) sub-trees,
+ * returning exactly the same results than a single tree.
  *
  * \sa See some of the derived classes for example implementations. See also
  * the documentation of nanoflann
@@ -113,12 +128,53 @@ class KDTreeCapable
 		TKDTreeSearchParams() = default;
 		/** Max points per leaf */
 		size_t leaf_max_size = 10;
+
+		/** Use an incremental index, which is updated in amortized
+		 * O(log n) time per point when new points are appended to the data
+		 * set (see the class description). Only used for the default
+		 * (L2_Simple_Adaptor) metric.
+		 * \note (New in MRPT 2.7.1)
+		 */
+		bool incremental = false;
 	};
 
 	/** Parameters to tune KD-tree searches. Refer to nanoflann docs.
 	 */
 	TKDTreeSearchParams kdtree_search_params;
 
+	/** Output of batch KD-tree queries (e.g. kdTreeNClosestPoint3DBatch())
+	 * for N query points, in a flat layout: the neighbors of the i-th query
+	 * are `indices[j]` and `distSqr[j]` for `j` in the range
+	 * `[offsets[i], offsets[i+1])`, sorted by ascending distance.
+	 *
+	 * Pass the same object to successive queries to reuse its memory.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	struct TKDTreeBatchResults
+	{
+		/** Indices of the found neighbors, for all queries */
+		std::vector<size_t> indices;
+		/** Squared distances of the found neighbors, for all queries */
+		std::vector<num_t> distSqr;
+		/** Start of each query results. Length: number of queries + 1 */
+		std::vector<size_t> offsets;
+
+		/** Number of queries */
+		size_t size() const
+		{
+			return offsets.empty() ? 0 : offsets.size() - 1;
+		}
+		/** Number of neighbors found for the i-th query */
+		size_t count(size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+		/** Internal buffers for each chunk of queries (radius searches) */
+		struct TChunkBuffers
+		{
+			std::vector<nanoflann::ResultItem<size_t, num_t>> query, chunk;
+		};
+		std::vector<TChunkBuffers> chunkBuffers;
+	};
+
 	/** @name Public utility methods to query the KD-tree
 		@{ */
 
@@ -154,7 +210,7 @@ class KDTreeCapable
 		resultSet.init(&ret_index, &out_dist_sqr);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree2d_data.findNeighbors(resultSet, &query_point[0]);
 
 		// Copy output to user vars:
 		out_x = derived().kdtree_get_pt(ret_index, 0);
@@ -179,7 +235,7 @@ class KDTreeCapable
 		resultSet.init(&ret_index, &out_dist_sqr);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree2d_data.findNeighbors(resultSet, &query_point[0]);
 
 		return ret_index;
 		MRPT_END
@@ -248,7 +304,7 @@ class KDTreeCapable
 		resultSet.init(&ret_indexes[0], &ret_sqdist[0]);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree2d_data.findNeighbors(resultSet, &query_point[0]);
 
 		// Copy output to user vars:
 		out_x1 = derived().kdtree_get_pt(ret_indexes[0], 0);
@@ -314,7 +370,7 @@ class KDTreeCapable
 		resultSet.init(&ret_indexes[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree2d_data.findNeighbors(resultSet, &query_point[0]);
 
 		for (size_t i = 0; i < knn; i++)
 		{
@@ -372,7 +428,7 @@ class KDTreeCapable
 		resultSet.init(&out_idx[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 2> query_point{{x0, y0}};
-		m_kdtree2d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree2d_data.findNeighbors(resultSet, &query_point[0]);
 		MRPT_END
 	}
 
@@ -418,7 +474,7 @@ class KDTreeCapable
 		resultSet.init(&ret_index, &out_dist_sqr);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree3d_data.findNeighbors(resultSet, &query_point[0]);
 
 		// Copy output to user vars:
 		out_x = derived().kdtree_get_pt(ret_index, 0);
@@ -444,7 +500,7 @@ class KDTreeCapable
 		resultSet.init(&ret_index, &out_dist_sqr);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree3d_data.findNeighbors(resultSet, &query_point[0]);
 
 		return ret_index;
 		MRPT_END
@@ -505,7 +561,7 @@ class KDTreeCapable
 		resultSet.init(&ret_indexes[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree3d_data.findNeighbors(resultSet, &query_point[0]);
 
 		for (size_t i = 0; i < knn; i++)
 		{
@@ -559,7 +615,7 @@ class KDTreeCapable
 		resultSet.init(&out_idx[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree3d_data.findNeighbors(resultSet, &query_point[0]);
 
 		for (size_t i = 0; i < knn; i++)
 		{
@@ -615,8 +671,8 @@ class KDTreeCapable
 		if (m_kdtree3d_data.m_num_points != 0)
 		{
 			const num_t xyz[3] = {x0, y0, z0};
-			m_kdtree3d_data.index->radiusSearch(
-				&xyz[0], maxRadiusSqr, out_indices_dist, {});
+			m_kdtree3d_data.radiusSearch(
+				&xyz[0], maxRadiusSqr, out_indices_dist);
 		}
 		return out_indices_dist.size();
 		MRPT_END
@@ -649,8 +705,8 @@ class KDTreeCapable
 		if (m_kdtree2d_data.m_num_points != 0)
 		{
 			const num_t xyz[2] = {x0, y0};
-			m_kdtree2d_data.index->radiusSearch(
-				&xyz[0], maxRadiusSqr, out_indices_dist, {});
+			m_kdtree2d_data.radiusSearch(
+				&xyz[0], maxRadiusSqr, out_indices_dist);
 		}
 		return out_indices_dist.size();
 		MRPT_END
@@ -688,7 +744,7 @@ class KDTreeCapable
 		resultSet.init(&out_idx[0], &out_dist_sqr[0]);
 
 		const std::array<num_t, 3> query_point{{x0, y0, z0}};
-		m_kdtree3d_data.index->findNeighbors(resultSet, &query_point[0], {});
+		m_kdtree3d_data.findNeighbors(resultSet, &query_point[0]);
 		MRPT_END
 	}
 
@@ -700,20 +756,162 @@ class KDTreeCapable
 			d2f(p0.x), d2f(p0.y), d2f(p0.z), N, outIdx, outDistSqr);
 	}
 
-	inline void kdTreeEnsureIndexBuilt3D() { rebuild_kdTree_3D(); }
-	inline void kdTreeEnsureIndexBuilt2D() { rebuild_kdTree_2D(); }
+	/** Batch version of kdTreeNClosestPoint2DIdx(): finds the `knn` closest
+	 * points to each of the `nQueries` points with coordinates `xs[i],ys[i]`.
+	 * All queries get the same number of neighbors, `min(knn, number of
+	 * points)`, sorted by ascending distance.
+	 *
+	 * If a thread pool is given, queries are split among its threads. The
+	 * results are the same in both cases. Using the pool requires including
+	 * <mrpt/core/WorkerThreadsPool.h>.
+	 *
+	 * \sa TKDTreeBatchResults, kdTreeRadiusSearch2DBatch
+	 * \note (New in MRPT 2.7.1)
+	 */
+	inline void kdTreeNClosestPoint2DBatch(
+		const num_t* xs, const num_t* ys, size_t nQueries, size_t knn,
+		TKDTreeBatchResults& out,
+		mrpt::WorkStealingThreadsPool* pool = nullptr) const
+	{
+		MRPT_START
+		rebuild_kdTree_2D();  // First: Create the 2D KD-Tree if required
+		if (!m_kdtree2d_data.m_num_points)
+			THROW_EXCEPTION("There are no points in the KD-tree.");
+
+		kdTreeNClosestBatch(
+			m_kdtree2d_data, {{xs, ys}}, nQueries, knn, out, pool);
+		MRPT_END
+	}
+
+	/** Batch version of kdTreeNClosestPoint3DIdx().
+	 * \sa kdTreeNClosestPoint2DBatch
+	 * \note (New in MRPT 2.7.1)
+	 */
+	inline void kdTreeNClosestPoint3DBatch(
+		const num_t* xs, const num_t* ys, const num_t* zs, size_t nQueries,
+		size_t knn, TKDTreeBatchResults& out,
+		mrpt::WorkStealingThreadsPool* pool = nullptr) const
+	{
+		MRPT_START
+		rebuild_kdTree_3D();  // First: Create the 3D KD-Tree if required
+		if (!m_kdtree3d_data.m_num_points)
+			THROW_EXCEPTION("There are no points in the KD-tree.");
+
+		kdTreeNClosestBatch(
+			m_kdtree3d_data, {{xs, ys, zs}}, nQueries, knn, out, pool);
+		MRPT_END
+	}
+
+	/** Batch version of kdTreeRadiusSearch2D(): finds all points within a
+	 * maximum (squared) distance of each of the `nQueries` query points
+	 * `xs[i],ys[i]`.
+	 *
+	 * If a thread pool is given, queries are split among its threads. The
+	 * results are the same in both cases. Using the pool requires including
+	 * <mrpt/core/WorkerThreadsPool.h>.
+	 *
+	 * \sa TKDTreeBatchResults, kdTreeNClosestPoint2DBatch
+	 * \note (New in MRPT 2.7.1)
+	 */
+	inline void kdTreeRadiusSearch2DBatch(
+		const num_t* xs, const num_t* ys, size_t nQueries,
+		const num_t maxRadiusSqr, TKDTreeBatchResults& out,
+		mrpt::WorkStealingThreadsPool* pool = nullptr) const
+	{
+		MRPT_START
+		rebuild_kdTree_2D();  // First: Create the 2D KD-Tree if required
+		kdTreeRadiusSearchBatch(
+			m_kdtree2d_data, {{xs, ys}}, nQueries, maxRadiusSqr, out, pool);
+		MRPT_END
+	}
+
+	/** Batch version of kdTreeRadiusSearch3D().
+	 * \sa kdTreeRadiusSearch2DBatch
+	 * \note (New in MRPT 2.7.1)
+	 */
+	inline void kdTreeRadiusSearch3DBatch(
+		const num_t* xs, const num_t* ys, const num_t* zs, size_t nQueries,
+		const num_t maxRadiusSqr, TKDTreeBatchResults& out,
+		mrpt::WorkStealingThreadsPool* pool = nullptr) const
+	{
+		MRPT_START
+		rebuild_kdTree_3D();  // First: Create the 3D KD-Tree if required
+		kdTreeRadiusSearchBatch(
+			m_kdtree3d_data, {{xs, ys, zs}}, nQueries, maxRadiusSqr, out,
+			pool);
+		MRPT_END
+	}
+
+	inline void kdTreeEnsureIndexBuilt3D() const { rebuild_kdTree_3D(); }
+	inline void kdTreeEnsureIndexBuilt2D() const { rebuild_kdTree_2D(); }
 
 	/* @} */
 
    protected:
 	/** To be called by child classes when KD tree data changes. */
 	inline void kdtree_mark_as_outdated() const
+	{
+		std::lock_guard<std::mutex> lck(m_kdtree_mtx);
+		m_kdtree_is_uptodate = false;
+		m_kdtree_only_appended = false;
+	}
+
+	/** To be called by child classes when new points have been appended at the
+	 * end of the data set, without modifying existing ones. In incremental
+	 * mode, this allows updating the KD-tree instead of rebuilding it.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	inline void kdtree_mark_as_appended() const
 	{
 		std::lock_guard<std::mutex> lck(m_kdtree_mtx);
 		m_kdtree_is_uptodate = false;
 	}
 
    private:
+	/** The metric used for sub-trees in incremental mode */
+	struct TPointsSubset;
+	using subset_metric_t = nanoflann::L2_Simple_Adaptor<num_t, TPointsSubset>;
+
+	/** Incremental mode is only implemented for the default metric */
+	static constexpr bool kdtree_incremental_supported = std::is_same_v<
+		metric_t, nanoflann::L2_Simple_Adaptor<num_t, Derived>>;
+
+	/** A contiguous range of points of the derived class, used as the
+	 * dataset of each sub-tree in incremental mode */
+	struct TPointsSubset
+	{
+		const Derived& data;
+		size_t offset = 0, count = 0;
+
+		size_t kdtree_get_point_count() const { return count; }
+		num_t kdtree_get_pt(size_t idx, int dim) const
+		{
+			return data.kdtree_get_pt(offset + idx, dim);
+		}
+		template <class BBOX>
+		bool kdtree_get_bbox(BBOX&) const
+		{
+			return false;
+		}
+	};
+
+	/** Forwards results from a sub-tree to the user result set, translating
+	 * point indices */
+	template <class RESULTSET>
+	struct TOffsetResultSet
+	{
+		RESULTSET& rs;
+		size_t offset;
+
+		bool addPoint(num_t dist, size_t index)
+		{
+			return rs.addPoint(dist, index + offset);
+		}
+		num_t worstDist() const { return rs.worstDist(); }
+		bool full() const { return rs.full(); }
+		size_t size() const { return rs.size(); }
+	};
+
 	/** Internal structure with the KD-tree representation (mainly used to avoid
 	 * copying pointers with the = operator) */
 	template <int _DIM = -1>
@@ -734,91 +932,270 @@ class KDTreeCapable
 		}
 
 		/** Free memory (if allocated)  */
-		inline void clear() noexcept { index.reset(); }
+		inline void clear() noexcept
+		{
+			index.reset();
+			forest.clear();
+		}
 		using kdtree_index_t = nanoflann::KDTreeSingleIndexAdaptor<
 			metric_t, Derived, _DIM, std::size_t /*index*/>;
+		using subtree_index_t = nanoflann::KDTreeSingleIndexAdaptor<
+			subset_metric_t, TPointsSubset, _DIM, std::size_t /*index*/>;
 
 		/** nullptr or the up-to-date index */
 		std::unique_ptr<kdtree_index_t> index;
 
+		/** One sub-tree of the incremental index */
+		struct TSubTree
+		{
+			std::unique_ptr<TPointsSubset> dataset;
+			std::unique_ptr<subtree_index_t> index;
+		};
+		/** The incremental index: sub-trees, sorted by decreasing size */
+		std::vector<TSubTree> forest;
+
 		/** Dimensionality. typ: 2,3 */
 		size_t m_dim = _DIM;
 		size_t m_num_points = 0;
-	};
 
-	mutable std::mutex m_kdtree_mtx;
-	mutable TKDTreeDataHolder<2> m_kdtree2d_data;
-	mutable TKDTreeDataHolder<3> m_kdtree3d_data;
-	/** whether the KD tree needs to be rebuilt or not. */
-	mutable std::atomic_bool m_kdtree_is_uptodate{false};
+		bool hasIndex() const { return index || !forest.empty(); }
 
-	/// Rebuild, if needed the KD-tree for 2D (nDims=2), 3D (nDims=3), ...
-	/// asking the child class for the data points.
-	void rebuild_kdTree_2D() const
-	{
-		if (m_kdtree_is_uptodate) return;
+		/** Updates the incremental index for points [m_num_points, N) */
+		void appendPoints(const Derived& d, size_t N, size_t leafMaxSize)
+		{
+			if (index)
+			{
+				// Not an incremental index: must be rebuilt.
+				clear();
+				return;
+			}
+			if (forest.empty() || N <= m_num_points) return;
 
-		std::lock_guard<std::mutex> lck(m_kdtree_mtx);
-		using tree2d_t = typename TKDTreeDataHolder<2>::kdtree_index_t;
+			// Merge the new points with existing sub-trees not larger than
+			// them, so sizes keep strictly decreasing:
+			size_t offset = m_num_points, count = N - m_num_points;
+			while (!forest.empty() && forest.back().dataset->count <= count)
+			{
+				offset = forest.back().dataset->offset;
+				count += forest.back().dataset->count;
+				forest.pop_back();
+			}
+			addSubTree(d, offset, count, leafMaxSize);
+			m_num_points = N;
+		}
 
-		if (!m_kdtree_is_uptodate)
+		void addSubTree(
+			const Derived& d, size_t offset, size_t count, size_t leafMaxSize)
 		{
-			m_kdtree2d_data.clear();
-			m_kdtree3d_data.clear();
+			TSubTree& t = forest.emplace_back();
+			t.dataset.reset(new TPointsSubset{d, offset, count});
+			t.index = std::make_unique<subtree_index_t>(
+				static_cast<int>(m_dim), *t.dataset,
+				nanoflann::KDTreeSingleIndexAdaptorParams(leafMaxSize));
+			t.index->buildIndex();
 		}
 
-		if (!m_kdtree2d_data.index)
+		/** Runs a query over the index, or over all sub-trees */
+		template <class RESULTSET>
+		void findNeighbors(RESULTSET& resultSet, const num_t* pt) const
 		{
-			// Erase previous tree:
-			m_kdtree2d_data.clear();
-			// And build new index:
-			const size_t N = derived().kdtree_get_point_count();
-			m_kdtree2d_data.m_num_points = N;
-			m_kdtree2d_data.m_dim = 2;
-			if (N)
+			if (index)
+			{
+				index->findNeighbors(resultSet, pt, {});
+				return;
+			}
+			for (const auto& t : forest)
+			{
+				TOffsetResultSet<RESULTSET> rs{resultSet, t.dataset->offset};
+				t.index->findNeighbors(rs, pt, {});
+			}
+		}
+
+		void radiusSearch(
+			const num_t* pt, const num_t maxRadiusSqr,
+			std::vector<nanoflann::ResultItem<size_t, num_t>>& out) const
+		{
+			if (index)
 			{
-				m_kdtree2d_data.index = std::make_unique<tree2d_t>(
-					2, derived(),
-					nanoflann::KDTreeSingleIndexAdaptorParams(
-						kdtree_search_params.leaf_max_size));
-				m_kdtree2d_data.index->buildIndex();
+				index->radiusSearch(pt, maxRadiusSqr, out, {});
+				return;
 			}
-			m_kdtree_is_uptodate = true;
+			nanoflann::RadiusResultSet<num_t, size_t> resultSet(
+				maxRadiusSqr, out);
+			findNeighbors(resultSet, pt);
+			std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) {
+				return a.second < b.second;
+			});
 		}
+	};
+
+	// POOL is always mrpt::WorkStealingThreadsPool. It is a template argument
+	// so this header only needs its forward declaration.
+	template <int DIM, class POOL>
+	void kdTreeNClosestBatch(
+		const TKDTreeDataHolder<DIM>& data,
+		const std::array<const num_t*, DIM>& coords, size_t nQueries,
+		size_t knn, TKDTreeBatchResults& out, POOL* pool) const
+	{
+		// Same number of results for all queries:
+		const size_t k = std::min(knn, data.m_num_points);
+		out.offsets.resize(nQueries + 1);
+		for (size_t i = 0; i <= nQueries; i++)
+			out.offsets[i] = i * k;
+		out.indices.resize(nQueries * k);
+		out.distSqr.resize(nQueries * k);
+		if (!k) return;
+
+		auto search = [&](size_t first, size_t last) {
+			std::array<num_t, DIM> query_point;
+			for (size_t i = first; i < last; i++)
+			{
+				for (int d = 0; d < DIM; d++)
+					query_point[d] = coords[d][i];
+
+				nanoflann::KNNResultSet<num_t> resultSet(k);
+				resultSet.init(&out.indices[i * k], &out.distSqr[i * k]);
+				data.findNeighbors(resultSet, &query_point[0]);
+			}
+		};
+		if (pool) pool->parallel_for_chunked(0, nQueries, search);
+		else
+			search(0, nQueries);
+	}
+
+	template <int DIM, class POOL>
+	void kdTreeRadiusSearchBatch(
+		const TKDTreeDataHolder<DIM>& data,
+		const std::array<const num_t*, DIM>& coords, size_t nQueries,
+		const num_t maxRadiusSqr, TKDTreeBatchResults& out, POOL* pool) const
+	{
+		out.offsets.assign(nQueries + 1, 0);
+		out.indices.clear();
+		out.distSqr.clear();
+		if (!nQueries) return;
+
+		// 1st pass: search, keeping the results of each chunk of queries in
+		// its own buffer, and the count of each query in offsets[i+1]:
+		const size_t chunkSize =
+			pool ? pool->effectiveChunkSize(nQueries, 0) : nQueries;
+		const size_t nChunks = (nQueries + chunkSize - 1) / chunkSize;
+		if (out.chunkBuffers.size() < nChunks)
+			out.chunkBuffers.resize(nChunks);
+
+		auto search = [&](size_t first, size_t last) {
+			auto& buf = out.chunkBuffers[first / chunkSize];
+			buf.chunk.clear();
+			std::array<num_t, DIM> query_point;
+			for (size_t i = first; i < last; i++)
+			{
+				for (int d = 0; d < DIM; d++)
+					query_point[d] = coords[d][i];
+
+				buf.query.clear();
+				if (data.m_num_points != 0)
+					data.radiusSearch(&query_point[0], maxRadiusSqr, buf.query);
+				buf.chunk.insert(
+					buf.chunk.end(), buf.query.begin(), buf.query.end());
+				out.offsets[i + 1] = buf.query.size();
+			}
+		};
+		// 2nd pass: copy each chunk results to its final place:
+		auto gather = [&](size_t first, size_t) {
+			const auto& buf = out.chunkBuffers[first / chunkSize];
+			size_t j = out.offsets[first];
+			for (const auto& r : buf.chunk)
+			{
+				out.indices[j] = r.first;
+				out.distSqr[j] = r.second;
+				j++;
+			}
+		};
+
+		if (pool) pool->parallel_for_chunked(0, nQueries, search, chunkSize);
+		else
+			search(0, nQueries);
+
+		for (size_t i = 0; i < nQueries; i++)
+			out.offsets[i + 1] += out.offsets[i];
+		out.indices.resize(out.offsets.back());
+		out.distSqr.resize(out.offsets.back());
+
+		if (pool) pool->parallel_for_chunked(0, nQueries, gather, chunkSize);
+		else
+			gather(0, nQueries);
 	}
 
+	mutable std::mutex m_kdtree_mtx;
+	mutable TKDTreeDataHolder<2> m_kdtree2d_data;
+	mutable TKDTreeDataHolder<3> m_kdtree3d_data;
+	/** whether the KD tree needs to be rebuilt or not. */
+	mutable std::atomic_bool m_kdtree_is_uptodate{false};
+	/** whether all changes since the last (incremental) build only appended
+	 * new points. Protected by m_kdtree_mtx */
+	mutable bool m_kdtree_only_appended = false;
+
 	/// Rebuild, if needed the KD-tree for 2D (nDims=2), 3D (nDims=3), ...
 	/// asking the child class for the data points.
-	void rebuild_kdTree_3D() const
+	void rebuild_kdTree_2D() const { rebuild_kdTree(m_kdtree2d_data); }
+
+	/// Rebuild, if needed the KD-tree for 2D (nDims=2), 3D (nDims=3), ...
+	/// asking the child class for the data points.
+	void rebuild_kdTree_3D() const { rebuild_kdTree(m_kdtree3d_data); }
+
+	template <int DIM>
+	void rebuild_kdTree(TKDTreeDataHolder<DIM>& data) const
 	{
-		if (m_kdtree_is_uptodate) return;
+		// Note: the other index may be the only one built so far:
+		if (m_kdtree_is_uptodate && data.hasIndex()) return;
+
 		std::lock_guard<std::mutex> lck(m_kdtree_mtx);
-		using tree3d_t = typename TKDTreeDataHolder<3>::kdtree_index_t;
+
+		const size_t N = derived().kdtree_get_point_count();
+		const size_t leafMaxSize = kdtree_search_params.leaf_max_size;
+		const bool incremental =
+			kdtree_incremental_supported && kdtree_search_params.incremental;
 
 		if (!m_kdtree_is_uptodate)
 		{
-			m_kdtree2d_data.clear();
-			m_kdtree3d_data.clear();
+			if (incremental && m_kdtree_only_appended)
+			{
+				m_kdtree2d_data.appendPoints(derived(), N, leafMaxSize);
+				m_kdtree3d_data.appendPoints(derived(), N, leafMaxSize);
+			}
+			else
+			{
+				m_kdtree2d_data.clear();
+				m_kdtree3d_data.clear();
+			}
 		}
 
-		if (!m_kdtree3d_data.index)
+		if (!data.hasIndex())
 		{
 			// Erase previous tree:
-			m_kdtree3d_data.clear();
+			data.clear();
 			// And build new index:
-			const size_t N = derived().kdtree_get_point_count();
-			m_kdtree3d_data.m_num_points = N;
-			m_kdtree3d_data.m_dim = 3;
+			data.m_num_points = N;
+			data.m_dim = DIM;
 			if (N)
 			{
-				m_kdtree3d_data.index = std::make_unique<tree3d_t>(
-					3, derived(),
-					nanoflann::KDTreeSingleIndexAdaptorParams(
-						kdtree_search_params.leaf_max_size));
-				m_kdtree3d_data.index->buildIndex();
+				if (incremental)
+				{
+					data.addSubTree(derived(), 0, N, leafMaxSize);
+				}
+				else
+				{
+					data.index = std::make_unique<
+						typename TKDTreeDataHolder<DIM>::kdtree_index_t>(
+						DIM, derived(),
+						nanoflann::KDTreeSingleIndexAdaptorParams(
+							leafMaxSize));
+					data.index->buildIndex();
+				}
 			}
-			m_kdtree_is_uptodate = true;
 		}
+		m_kdtree_is_uptodate = true;
+		// From now on, appended points can be indexed incrementally:
+		m_kdtree_only_appended = incremental;
 	}
 
 };	// end of KDTreeCapable
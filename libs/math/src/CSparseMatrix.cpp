@@ -9,10 +9,14 @@
 
 #include "math-precomp.h"  // Precompiled headers
 //
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/CSparseMatrix.h>
 
+#include <Eigen/Dense>
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <string>
 
 using std::cout;
@@ -276,6 +280,41 @@ void CSparseMatrix::compressFromTriplet()
 	// internal buffers, now set to NULL.
 }
 
+void CSparseMatrix::setColumnCompressedStructure(
+	const size_t nRows, const size_t nCols, const std::vector<int>& colPointers,
+	const std::vector<int>& rowIndices)
+{
+	ASSERT_EQUAL_(colPointers.size(), nCols + 1);
+	ASSERT_EQUAL_(static_cast<size_t>(colPointers.back()), rowIndices.size());
+
+	internal_free_mem();
+
+	const size_t nnz = rowIndices.size();
+	sparse_matrix.m = nRows;
+	sparse_matrix.n = nCols;
+	sparse_matrix.nzmax = std::max<size_t>(nnz, 1);
+	sparse_matrix.nz = -1;	// -1: column-compressed
+	sparse_matrix.p = (int*)cs_malloc(nCols + 1, sizeof(int));
+	sparse_matrix.i = (int*)cs_malloc(sparse_matrix.nzmax, sizeof(int));
+	sparse_matrix.x = (double*)cs_calloc(sparse_matrix.nzmax, sizeof(double));
+
+	std::memcpy(sparse_matrix.p, colPointers.data(), sizeof(int) * (nCols + 1));
+	if (nnz)
+		std::memcpy(sparse_matrix.i, rowIndices.data(), sizeof(int) * nnz);
+}
+
+double* CSparseMatrix::columnCompressedValues()
+{
+	ASSERT_(isColumnCompressed());
+	return sparse_matrix.x;
+}
+
+size_t CSparseMatrix::nonZeroCount() const
+{
+	ASSERT_(isColumnCompressed());
+	return static_cast<size_t>(sparse_matrix.p[sparse_matrix.n]);
+}
+
 /** save as a dense matrix to a text file \return False on any error.
  */
 bool CSparseMatrix::saveToTextFile_dense(const std::string& filName)
@@ -357,13 +396,30 @@ bool CSparseMatrix::saveToTextFile_sparse(const std::string& filName)
  * matrix as input.
  */
 CSparseMatrix::CholeskyDecomp::CholeskyDecomp(const CSparseMatrix& SM)
-	: m_symbolic_structure(nullptr),
-	  m_numeric_structure(nullptr),
-	  m_originalSM(&SM)
+	: CholeskyDecomp(SM, TParameters())
+{
+}
+
+CSparseMatrix::CholeskyDecomp::CholeskyDecomp(
+	const CSparseMatrix& SM, const TParameters& params)
+	: m_originalSM(&SM), m_params(params), m_block(nullptr, nullptr)
 {
 	ASSERT_(SM.cols() == SM.rows());
 	ASSERT_(SM.isColumnCompressed());
 
+	if (params.backend == TSparseCholeskyBackend::Block)
+	{
+		ASSERT_(params.blockSize > 0);
+		ASSERTMSG_(
+			SM.cols() % params.blockSize == 0,
+			"Matrix size must be a multiple of blockSize");
+
+		m_block = spimpl::make_unique_impl<BlockImpl>();
+		block_symbolic();
+		block_numeric();
+		return;
+	}
+
 	// symbolic decomposition:
 	m_symbolic_structure =
 		cs_schol(1 /* order */, &m_originalSM->sparse_matrix);
@@ -384,10 +440,256 @@ CSparseMatrix::CholeskyDecomp::~CholeskyDecomp()
 	cs_sfree(m_symbolic_structure);
 }
 
+/** Data of the Block backend. The factor L of the permuted matrix is stored
+ * by columns of blocks: each one is a dense panel with all its non-zero
+ * blocks stacked vertically, the diagonal block first. */
+struct CSparseMatrix::CholeskyDecomp::BlockImpl
+{
+	static constexpr size_t INVALID = std::numeric_limits<size_t>::max();
+
+	size_t B = 0;  //!< block size
+	size_t nBlocks = 0;
+	/** Fill-reducing ordering: perm[new]=old, pinv[old]=new */
+	std::vector<size_t> perm, pinv;
+
+	/** Block rows of L column J: rows[colPtr[J]:colPtr[J+1]], sorted, with
+	 * J itself first. */
+	std::vector<size_t> colPtr, rows;
+	/** Column J of L: dense column-major panel of (nRows(J)*B) x B values
+	 * at `values[colPtr[J]*B*B]` */
+	std::vector<double> values;
+
+	/** Row structure of L: for each J, the pairs (K,q) with
+	 * `rows[colPtr[K]+q]==J`, K<J */
+	std::vector<size_t> rowPtr;
+	std::vector<std::pair<size_t, size_t>> rowEntries;
+
+	/** Columns of L grouped by their height in the elimination tree: all
+	 * columns in one level only depend on columns of previous levels. */
+	std::vector<std::vector<size_t>> levels;
+
+	/** For each non-zero of the input matrix, its index in `values`, or
+	 * INVALID for entries in the (ignored) lower triangle. */
+	std::vector<size_t> scatter;
+	int inputNNZ = 0;
+
+	size_t nRows(size_t J) const { return colPtr[J + 1] - colPtr[J]; }
+	double* panel(size_t J) { return &values[colPtr[J] * B * B]; }
+	const double* panel(size_t J) const { return &values[colPtr[J] * B * B]; }
+};
+
+void CSparseMatrix::CholeskyDecomp::block_symbolic()
+{
+	MRPT_START
+
+	auto& d = *m_block;
+	const cs& A = m_originalSM->sparse_matrix;
+	const size_t B = m_params.blockSize;
+	const size_t nb = static_cast<size_t>(A.n) / B;
+	d.B = B;
+	d.nBlocks = nb;
+	d.inputNNZ = A.p[A.n];
+
+	// Graph of blocks, and its AMD ordering:
+	const int nbi = static_cast<int>(nb), Bi = static_cast<int>(B);
+	cs* T = cs_spalloc(nbi, nbi, A.p[A.n] + nbi, 1, 1);
+	for (int b = 0; b < nbi; b++)
+		cs_entry(T, b, b, 1.0);
+	for (int c = 0; c < A.n; c++)
+		for (int k = A.p[c]; k < A.p[c + 1]; k++)
+			if (A.i[k] <= c) cs_entry(T, A.i[k] / Bi, c / Bi, 1.0);
+	cs* G = cs_compress(T);
+	cs_spfree(T);
+	cs_dupl(G);
+	int* P = cs_amd(1, G);
+	ASSERT_(P != nullptr);
+	d.perm.assign(P, P + nb);
+	cs_free(P);
+	d.pinv.resize(nb);
+	for (size_t k = 0; k < nb; k++)
+		d.pinv[d.perm[k]] = k;
+
+	// Lower triangle adjacency of the permuted graph:
+	std::vector<std::vector<size_t>> adj(nb);
+	for (int c = 0; c < G->n; c++)
+		for (int k = G->p[c]; k < G->p[c + 1]; k++)
+		{
+			const size_t r = d.pinv[G->i[k]], cc = d.pinv[c];
+			if (r != cc) adj[std::min(r, cc)].push_back(std::max(r, cc));
+		}
+	cs_spfree(G);
+
+	// Block structure of L, column by column: the non-zeros of each column
+	// are those in A, plus those of its children in the elimination tree.
+	std::vector<std::vector<size_t>> children(nb);
+	std::vector<size_t> height(nb, 0);
+	d.colPtr.assign(nb + 1, 0);
+	d.rows.clear();
+	for (size_t J = 0; J < nb; J++)
+	{
+		std::vector<size_t>& rowsJ = adj[J];
+		rowsJ.push_back(J);
+		for (const size_t C : children[J])
+		{
+			rowsJ.insert(
+				rowsJ.end(), d.rows.begin() + d.colPtr[C] + 1,
+				d.rows.begin() + d.colPtr[C + 1]);
+			height[J] = std::max(height[J], height[C] + 1);
+		}
+		std::sort(rowsJ.begin(), rowsJ.end());
+		rowsJ.erase(std::unique(rowsJ.begin(), rowsJ.end()), rowsJ.end());
+
+		d.rows.insert(d.rows.end(), rowsJ.begin(), rowsJ.end());
+		d.colPtr[J + 1] = d.rows.size();
+		if (rowsJ.size() > 1) children[rowsJ[1]].push_back(J);
+		std::vector<size_t>().swap(rowsJ);
+	}
+	d.values.assign(d.rows.size() * B * B, 0.0);
+
+	d.levels.clear();
+	for (size_t J = 0; J < nb; J++)
+	{
+		if (height[J] >= d.levels.size()) d.levels.resize(height[J] + 1);
+		d.levels[height[J]].push_back(J);
+	}
+
+	// Row structure:
+	d.rowPtr.assign(nb + 1, 0);
+	for (size_t K = 0; K < nb; K++)
+		for (size_t k = d.colPtr[K] + 1; k < d.colPtr[K + 1]; k++)
+			d.rowPtr[d.rows[k] + 1]++;
+	for (size_t J = 0; J < nb; J++)
+		d.rowPtr[J + 1] += d.rowPtr[J];
+	d.rowEntries.resize(d.rowPtr[nb]);
+	{
+		std::vector<size_t> next(d.rowPtr.begin(), d.rowPtr.end() - 1);
+		for (size_t K = 0; K < nb; K++)
+			for (size_t k = d.colPtr[K] + 1; k < d.colPtr[K + 1]; k++)
+				d.rowEntries[next[d.rows[k]]++] = {K, k - d.colPtr[K]};
+	}
+
+	// Destination of each input entry in the panels of L:
+	d.scatter.assign(d.inputNNZ, BlockImpl::INVALID);
+	for (int c = 0; c < A.n; c++)
+		for (int k = A.p[c]; k < A.p[c + 1]; k++)
+		{
+			const size_t r = static_cast<size_t>(A.i[k]);
+			if (r > static_cast<size_t>(c)) continue;
+			const size_t pr = d.pinv[r / B], pc = d.pinv[c / B];
+			// Entry (row,col) of the lower triangle of the permuted matrix:
+			size_t K = pc, R = pr, lr = r % B, lc = c % B;
+			if (pr < pc || (pr == pc && lr < lc))
+			{
+				std::swap(K, R);
+				std::swap(lr, lc);
+			}
+			const auto itBeg = d.rows.begin() + d.colPtr[K];
+			const auto it =
+				std::lower_bound(itBeg, d.rows.begin() + d.colPtr[K + 1], R);
+			const size_t q = static_cast<size_t>(it - itBeg);
+			d.scatter[k] =
+				d.colPtr[K] * B * B + lc * d.nRows(K) * B + q * B + lr;
+		}
+
+	MRPT_END
+}
+
+void CSparseMatrix::CholeskyDecomp::block_numeric()
+{
+	using Panel = Eigen::Map<Eigen::MatrixXd>;
+
+	auto& d = *m_block;
+	const cs& A = m_originalSM->sparse_matrix;
+	const size_t B = d.B;
+
+	std::fill(d.values.begin(), d.values.end(), 0.0);
+	for (int k = 0; k < d.inputNNZ; k++)
+		if (d.scatter[k] != BlockImpl::INVALID)
+			d.values[d.scatter[k]] += A.x[k];
+
+	// Left-looking factorization of one column of blocks. Returns false if
+	// its diagonal block is not positive definite.
+	auto factorColumn = [&d, B](size_t J) -> bool {
+		const size_t nrJ = d.nRows(J);
+		Panel PJ(d.panel(J), nrJ * B, B);
+		const size_t* rowsJ = &d.rows[d.colPtr[J]];
+
+		// Subtract the contributions of previous columns K with L(J,K)!=0:
+		for (size_t e = d.rowPtr[J]; e < d.rowPtr[J + 1]; e++)
+		{
+			const auto [K, q] = d.rowEntries[e];
+			const size_t nrK = d.nRows(K);
+			const Panel PK(const_cast<double*>(d.panel(K)), nrK * B, B);
+			const size_t* rowsK = &d.rows[d.colPtr[K]];
+			const Eigen::MatrixXd LJKt = PK.middleRows(q * B, B).transpose();
+			// rows of K below J are a subset of the rows of J:
+			for (size_t qK = q, t = 0; qK < nrK; qK++)
+			{
+				while (rowsJ[t] < rowsK[qK])
+					t++;
+				PJ.middleRows(t * B, B).noalias() -=
+					PK.middleRows(qK * B, B) * LJKt;
+			}
+		}
+
+		// In-place factorization of the diagonal block:
+		Eigen::Ref<Eigen::MatrixXd> LJJ = PJ.topRows(B);
+		Eigen::LLT<Eigen::Ref<Eigen::MatrixXd>> llt(LJJ);
+		if (llt.info() != Eigen::Success) return false;
+		LJJ.triangularView<Eigen::StrictlyUpper>().setZero();
+		// Off-diagonal blocks: L(:,J) = A(:,J) * L(J,J)^{-T}
+		if (nrJ > 1)
+			LJJ.triangularView<Eigen::Lower>()
+				.transpose()
+				.solveInPlace<Eigen::OnTheRight>(PJ.bottomRows((nrJ - 1) * B));
+		return true;
+	};
+
+	bool allOk = true;
+	for (const auto& level : d.levels)
+	{
+		if (m_params.pool && level.size() > 1)
+		{
+			std::vector<uint8_t> ok(level.size(), 1);
+			m_params.pool->parallel_for(0, level.size(), [&](size_t i) {
+				ok[i] = factorColumn(level[i]) ? 1 : 0;
+			});
+			allOk = std::all_of(
+				ok.begin(), ok.end(), [](uint8_t v) { return v != 0; });
+		}
+		else
+		{
+			for (const size_t J : level)
+				if (!(allOk = factorColumn(J))) break;
+		}
+		if (!allOk) break;
+	}
+	if (!allOk)
+		throw mrpt::math::CExceptionNotDefPos(
+			"CSparseMatrix::CholeskyDecomp: Not positive definite matrix.");
+}
+
 /** Return the L matrix (L*L' = M), as a dense matrix. */
 void CSparseMatrix::CholeskyDecomp::get_L(CMatrixDouble& L) const
 {
-	CSparseMatrix::cs2dense(*m_numeric_structure->L, L);
+	if (!m_block)
+	{
+		CSparseMatrix::cs2dense(*m_numeric_structure->L, L);
+		return;
+	}
+	const auto& d = *m_block;
+	const size_t B = d.B;
+	L.setZero(d.nBlocks * B, d.nBlocks * B);
+	for (size_t J = 0; J < d.nBlocks; J++)
+	{
+		const size_t nrJ = d.nRows(J);
+		const double* P = d.panel(J);
+		for (size_t q = 0; q < nrJ; q++)
+			for (size_t c = 0; c < B; c++)
+				for (size_t r = 0; r < B; r++)
+					L(d.rows[d.colPtr[J] + q] * B + r, J * B + c) =
+						P[c * nrJ * B + q * B + r];
+	}
 }
 
 /** Return the vector from a back-substitution step that solves: Ux=b   */
@@ -406,6 +708,45 @@ void CSparseMatrix::CholeskyDecomp::backsub(
 	ASSERT_(N > 0);
 	std::vector<double> tmp(N);
 
+	if (m_block)
+	{
+		using Panel = Eigen::Map<const Eigen::MatrixXd>;
+		using Vec = Eigen::Map<Eigen::VectorXd>;
+
+		const auto& d = *m_block;
+		const size_t B = d.B, nb = d.nBlocks;
+		ASSERT_EQUAL_(N, nb * B);
+		for (size_t k = 0; k < nb; k++)
+			std::memcpy(&tmp[d.pinv[k] * B], &b[k * B], sizeof(double) * B);
+
+		// tmp = L\tmp
+		for (size_t J = 0; J < nb; J++)
+		{
+			const size_t nrJ = d.nRows(J);
+			const Panel PJ(d.panel(J), nrJ * B, B);
+			Vec xJ(&tmp[J * B], B);
+			PJ.topRows(B).triangularView<Eigen::Lower>().solveInPlace(xJ);
+			for (size_t q = 1; q < nrJ; q++)
+				Vec(&tmp[d.rows[d.colPtr[J] + q] * B], B).noalias() -=
+					PJ.middleRows(q * B, B) * xJ;
+		}
+		// tmp = L'\tmp
+		for (size_t J = nb; J-- > 0;)
+		{
+			const size_t nrJ = d.nRows(J);
+			const Panel PJ(d.panel(J), nrJ * B, B);
+			Vec xJ(&tmp[J * B], B);
+			for (size_t q = 1; q < nrJ; q++)
+				xJ.noalias() -= PJ.middleRows(q * B, B).transpose() *
+					Vec(&tmp[d.rows[d.colPtr[J] + q] * B], B);
+			PJ.topRows(B).triangularView<Eigen::Lower>().transpose().solveInPlace(
+				xJ);
+		}
+		for (size_t k = 0; k < nb; k++)
+			std::memcpy(&sol[k * B], &tmp[d.pinv[k] * B], sizeof(double) * B);
+		return;
+	}
+
 	cs_ipvec(
 		m_symbolic_structure->pinv, &b[0], &tmp[0], N); /* tmp = PERMUT*b */
 	// permute con. pivoting
@@ -435,6 +776,15 @@ void CSparseMatrix::CholeskyDecomp::update(const CSparseMatrix& new_SM)
 
 	m_originalSM = &new_SM;	 // Just copy the reference.
 
+	if (m_block)
+	{
+		ASSERTMSG_(
+			m_block->inputNNZ == new_SM.sparse_matrix.p[new_SM.sparse_matrix.n],
+			"New matrix doesn't have the same sparse structure!");
+		block_numeric();
+		return;
+	}
+
 	// Release old data:
 	cs_nfree(m_numeric_structure);
 	m_numeric_structure = nullptr;
@@ -9,6 +9,7 @@
 
 #include <CTraitsTest.h>
 #include <gtest/gtest.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/CSparseMatrix.h>
 #include <mrpt/random.h>
 
@@ -235,3 +236,137 @@ TEST(SparseMatrix, CholeskyDecomp)
 	const double err = (Ud.transpose() - L.asEigen()).array().abs().mean();
 	EXPECT_TRUE(err < 1e-8);
 }
+
+// Symmetric, diagonally dominant matrix made of BxB blocks, with the pattern
+// of a pose graph: a chain of nodes plus some random loop closures.
+static CMatrixDouble generateBlockSPDMatrix(size_t nBlocks, size_t B)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	const size_t N = nBlocks * B;
+	CMatrixDouble D(N, N);
+	D.setZero();
+	auto addEdge = [&](size_t i, size_t j) {
+		for (size_t r = 0; r < B; r++)
+			for (size_t c = 0; c < B; c++)
+			{
+				const double v = rng.drawGaussian1D(0, 1);
+				D(i * B + r, j * B + c) += v;
+				D(j * B + c, i * B + r) += v;
+			}
+	};
+	for (size_t i = 1; i < nBlocks; i++)
+		addEdge(i - 1, i);
+	for (size_t k = 0; k < nBlocks / 4; k++)
+	{
+		const size_t i = rng.drawUniform32bit() % nBlocks;
+		const size_t j = rng.drawUniform32bit() % nBlocks;
+		if (i != j) addEdge(i, j);
+	}
+	for (size_t r = 0; r < N; r++)
+		D(r, r) = D.row(r).array().abs().sum() + 1.0;
+	return D;
+}
+
+static void upperTriangleToSparse(const CMatrixDouble& D, CSparseMatrix& SM)
+{
+	SM.clear(D.rows(), D.cols());
+	for (int c = 0; c < D.cols(); c++)
+		for (int r = 0; r <= c; r++)
+			if (D(r, c) != 0) SM.insert_entry(r, c, D(r, c));
+	SM.compressFromTriplet();
+}
+
+TEST(SparseMatrix, CholeskyDecompBlockBackend)
+{
+	mrpt::random::getRandomGenerator().randomize(1234);
+	mrpt::WorkStealingThreadsPool pool(2);
+
+	for (const size_t B : {1U, 3U, 6U})
+	{
+		for (const bool parallel : {false, true})
+		{
+			const size_t nBlocks = 40;
+			CSparseMatrix SM;
+			upperTriangleToSparse(generateBlockSPDMatrix(nBlocks, B), SM);
+
+			CSparseMatrix::CholeskyDecomp::TParameters p;
+			p.backend = TSparseCholeskyBackend::Block;
+			p.blockSize = B;
+			if (parallel) p.pool = &pool;
+
+			CSparseMatrix::CholeskyDecomp cholRef(SM);
+			CSparseMatrix::CholeskyDecomp chol(SM, p);
+
+			CVectorDouble b(nBlocks * B), x, xRef;
+			for (int i = 0; i < b.size(); i++)
+				b[i] = mrpt::random::getRandomGenerator().drawGaussian1D(0, 1);
+
+			chol.backsub(b, x);
+			cholRef.backsub(b, xRef);
+			EXPECT_LT((x.asEigen() - xRef.asEigen()).norm(), 1e-9)
+				<< "B=" << B;
+
+			// L*L^T must be the permuted input matrix:
+			const CMatrixDouble L = chol.get_L();
+			CMatrixDouble D;
+			SM.get_dense(D);
+			const Eigen::MatrixXd LLt = L.asEigen() * L.asEigen().transpose();
+			EXPECT_NEAR(LLt.trace(), D.asEigen().trace(), 1e-6);
+			EXPECT_NEAR(LLt.norm(), D.asEigen().selfadjointView<Eigen::Upper>()
+											.toDenseMatrix()
+											.norm(),
+						1e-6);
+
+			// New values, same structure:
+			double* vals = SM.columnCompressedValues();
+			for (size_t i = 0; i < SM.nonZeroCount(); i++)
+				vals[i] *= 2.0;
+			chol.update(SM);
+			cholRef.update(SM);
+			chol.backsub(b, x);
+			cholRef.backsub(b, xRef);
+			EXPECT_LT((x.asEigen() - xRef.asEigen()).norm(), 1e-9)
+				<< "B=" << B;
+
+			// Non definite-positive input:
+			vals[0] = -1.0;
+			EXPECT_THROW(chol.update(SM), CExceptionNotDefPos);
+		}
+	}
+}
+
+TEST(SparseMatrix, InitFromColumnCompressedStructure)
+{
+	// 3x4 matrix with non-zero entries at (0,0), (2,0), (1,2) and (2,3):
+	CSparseMatrix SM;
+	SM.setColumnCompressedStructure(3, 4, {0, 2, 2, 3, 4}, {0, 2, 1, 2});
+	EXPECT_TRUE(SM.isColumnCompressed());
+	EXPECT_EQ(SM.rows(), 3U);
+	EXPECT_EQ(SM.cols(), 4U);
+	ASSERT_EQ(SM.nonZeroCount(), 4U);
+
+	CMatrixDouble D(3, 4), dense_out;
+	SM.get_dense(dense_out);
+	EXPECT_TRUE(dense_out == D);
+
+	// Refill values in place:
+	double* vals = SM.columnCompressedValues();
+	vals[0] = 1.0;
+	vals[1] = -2.0;
+	vals[2] = 3.0;
+	vals[3] = 4.0;
+	D(0, 0) = 1.0;
+	D(2, 0) = -2.0;
+	D(1, 2) = 3.0;
+	D(2, 3) = 4.0;
+
+	SM.get_dense(dense_out);
+	EXPECT_TRUE(dense_out == D) << "Dense: \n"
+								<< D << "Sparse:\n"
+								<< dense_out << endl;
+
+	// Copies keep the structure:
+	const CSparseMatrix SM2 = SM;
+	SM2.get_dense(dense_out);
+	EXPECT_TRUE(dense_out == D);
+}
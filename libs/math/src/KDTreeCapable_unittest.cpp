@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 
 #include <gtest/gtest.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/KDTreeCapable.h>
 #include <mrpt/random.h>
 
@@ -17,3 +18,129 @@ using namespace mrpt::random;
 using namespace std;
 
 TEST(KDTreeCapable, test1) { MRPT_TODO("Write me!"); }
+
+namespace
+{
+// A minimal point cloud, in SoA layout:
+struct TestPointCloud : public mrpt::math::KDTreeCapable<TestPointCloud>
+{
+	std::vector<float> xs, ys, zs;
+
+	void insert(float x, float y, float z)
+	{
+		xs.push_back(x);
+		ys.push_back(y);
+		zs.push_back(z);
+		kdtree_mark_as_outdated();
+	}
+
+	size_t kdtree_get_point_count() const { return xs.size(); }
+	float kdtree_get_pt(size_t idx, int dim) const
+	{
+		return dim == 0 ? xs[idx] : (dim == 1 ? ys[idx] : zs[idx]);
+	}
+	template <class BBOX>
+	bool kdtree_get_bbox(BBOX&) const
+	{
+		return false;
+	}
+};
+}  // namespace
+
+TEST(KDTreeCapable, batchQueries)
+{
+	auto& rng = getRandomGenerator();
+	rng.randomize(123);
+
+	TestPointCloud pts, queries;
+	for (int i = 0; i < 2000; i++)
+		pts.insert(
+			rng.drawUniform<float>(-10, 10), rng.drawUniform<float>(-10, 10),
+			rng.drawUniform<float>(-1, 1));
+	for (int i = 0; i < 500; i++)
+		queries.insert(
+			rng.drawUniform<float>(-11, 11), rng.drawUniform<float>(-11, 11),
+			rng.drawUniform<float>(-1, 1));
+	const size_t nQ = queries.xs.size();
+	const float* qx = queries.xs.data();
+	const float* qy = queries.ys.data();
+	const float* qz = queries.zs.data();
+
+	mrpt::WorkStealingThreadsPool pool(3, "kdtree_test");
+	TestPointCloud::TKDTreeBatchResults res;
+
+	mrpt::WorkStealingThreadsPool* noPool = nullptr;
+	for (auto* p : {noPool, &pool})
+	{
+		// KNN, 2D and 3D:
+		const size_t knn = 7;
+		pts.kdTreeNClosestPoint2DBatch(qx, qy, nQ, knn, res, p);
+		ASSERT_EQ(res.size(), nQ);
+		for (size_t i = 0; i < nQ; i++)
+		{
+			std::vector<size_t> idx;
+			std::vector<float> dist;
+			pts.kdTreeNClosestPoint2DIdx(qx[i], qy[i], knn, idx, dist);
+			ASSERT_EQ(res.count(i), knn);
+			for (size_t j = 0; j < knn; j++)
+			{
+				EXPECT_EQ(res.indices[res.offsets[i] + j], idx[j]);
+				EXPECT_EQ(res.distSqr[res.offsets[i] + j], dist[j]);
+			}
+		}
+
+		pts.kdTreeNClosestPoint3DBatch(qx, qy, qz, nQ, knn, res, p);
+		ASSERT_EQ(res.size(), nQ);
+		for (size_t i = 0; i < nQ; i++)
+		{
+			std::vector<size_t> idx;
+			std::vector<float> dist;
+			pts.kdTreeNClosestPoint3DIdx(qx[i], qy[i], qz[i], knn, idx, dist);
+			ASSERT_EQ(res.count(i), knn);
+			for (size_t j = 0; j < knn; j++)
+			{
+				EXPECT_EQ(res.indices[res.offsets[i] + j], idx[j]);
+				EXPECT_EQ(res.distSqr[res.offsets[i] + j], dist[j]);
+			}
+		}
+
+		// Radius, 2D and 3D:
+		const float r2 = 0.5f;
+		pts.kdTreeRadiusSearch2DBatch(qx, qy, nQ, r2, res, p);
+		ASSERT_EQ(res.size(), nQ);
+		for (size_t i = 0; i < nQ; i++)
+		{
+			std::vector<nanoflann::ResultItem<size_t, float>> found;
+			pts.kdTreeRadiusSearch2D(qx[i], qy[i], r2, found);
+			ASSERT_EQ(res.count(i), found.size());
+			for (size_t j = 0; j < found.size(); j++)
+			{
+				EXPECT_EQ(res.indices[res.offsets[i] + j], found[j].first);
+				EXPECT_EQ(res.distSqr[res.offsets[i] + j], found[j].second);
+			}
+		}
+
+		pts.kdTreeRadiusSearch3DBatch(qx, qy, qz, nQ, r2, res, p);
+		ASSERT_EQ(res.size(), nQ);
+		for (size_t i = 0; i < nQ; i++)
+		{
+			std::vector<nanoflann::ResultItem<size_t, float>> found;
+			pts.kdTreeRadiusSearch3D(qx[i], qy[i], qz[i], r2, found);
+			ASSERT_EQ(res.count(i), found.size());
+			for (size_t j = 0; j < found.size(); j++)
+			{
+				EXPECT_EQ(res.indices[res.offsets[i] + j], found[j].first);
+				EXPECT_EQ(res.distSqr[res.offsets[i] + j], found[j].second);
+			}
+		}
+	}
+
+	// Less points than requested neighbors:
+	TestPointCloud few;
+	few.insert(0, 0, 0);
+	few.insert(1, 0, 0);
+	few.kdTreeNClosestPoint3DBatch(qx, qy, qz, nQ, 5, res, &pool);
+	ASSERT_EQ(res.size(), nQ);
+	EXPECT_EQ(res.count(0), 2U);
+	EXPECT_EQ(res.indices.size(), 2 * nQ);
+}
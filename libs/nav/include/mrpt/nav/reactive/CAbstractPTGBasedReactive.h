@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/maps/CPointCloudFilterBase.h>
 #include <mrpt/math/CPolygon.h>
 #include <mrpt/math/filters.h>
@@ -223,6 +224,17 @@ class CAbstractPTGBasedReactive : public CWaypointsNavigator
 		 * evaluation. */
 		double max_dist_for_timebased_path_prediction{2.0};
 
+		/** Number of threads used to evaluate the PTGs concurrently (obstacle
+		 * transformation to TP-Space, holonomic method and candidate scoring
+		 * of each PTG). Default=1: evaluate all PTGs sequentially in the
+		 * calling thread. 0: use as many threads as CPU cores. Results and log
+		 * records are identical to the sequential evaluation.
+		 * \note If derived classes override STEP3_WSpaceToTPSpace(), it must
+		 * be safe to call it concurrently for different PTG indices.
+		 * \note (New in MRPT 2.7.1)
+		 */
+		unsigned int ptg_eval_threads{1};
+
 		void loadFromConfigFile(
 			const mrpt::config::CConfigFileBase& c,
 			const std::string& s) override;
@@ -314,6 +326,12 @@ class CAbstractPTGBasedReactive : public CWaypointsNavigator
 	mrpt::system::CTimeLogger m_timelogger{false};	// default: disabled
 	bool m_PTGsMustBeReInitialized{true};
 
+	/** Used if TAbstractPTGNavigatorParams::ptg_eval_threads!=1 */
+	std::unique_ptr<mrpt::WorkStealingThreadsPool> m_ptgEvalThreadsPool;
+	/** True while PTGs are evaluated in parallel threads, whose calls are
+	 * then timed as a whole instead of per-PTG sections */
+	bool m_ptgEvalInParallel{false};
+
 	/** @name Variables for CReactiveNavigationSystem::performNavigationStep
 		@{ */
 	mrpt::system::CTicTac totalExecutionTime, executionTime, tictac;
@@ -425,12 +443,16 @@ class CAbstractPTGBasedReactive : public CWaypointsNavigator
 	std::vector<TInfoPerPTG> m_infoPerPTG;
 	mrpt::system::TTimeStamp m_infoPerPTG_timestamp{INVALID_TIMESTAMP};
 
+	/** Evaluates one PTG. `log` is the entry of `newLogRec.infoPerPTG` for
+	 * this PTG, passed apart so parallel evaluations can each use their own
+	 * `newLogRec` for the rest of log fields. */
 	void build_movement_candidate(
 		CParameterizedTrajectoryGenerator* ptg, const size_t indexPTG,
 		const std::vector<mrpt::math::TPose2D>& relTargets,
 		const mrpt::math::TPose2D& rel_pose_PTG_origin_wrt_sense,
 		TInfoPerPTG& ipf, TCandidateMovementPTG& holonomicMovement,
-		CLogFileRecord& newLogRec, const bool this_is_PTG_continuation,
+		CLogFileRecord::TInfoPerPTG& log, CLogFileRecord& newLogRec,
+		const bool this_is_PTG_continuation,
 		mrpt::nav::CAbstractHolonomicReactiveMethod& holoMethod,
 		const mrpt::system::TTimeStamp tim_start_iteration,
 		const TNavigationParams& navp = TNavigationParams(),
@@ -13,6 +13,8 @@
 #include <mrpt/nav/tpspace/CParameterizedTrajectoryGenerator.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <memory>
+
 namespace mrpt
 {
 namespace nav
@@ -48,6 +50,14 @@ mrpt::serialization::CArchive& operator>>(
  * Collision grids must be calculated before calling getTPObstacle(). Robot
  * shape must be set before initializing with setRobotShape().
  * The rest of PTG parameters should have been set at the constructor.
+ *
+ * Once built, collision grids are also stored in a compact, read-only binary
+ * file (see collisionGridCacheFileFor()) in the directory of the cache file
+ * passed to `initialize()`, named after a hash of the robot shape and all PTG
+ * parameters. Later initializations with the same parameters, from this or
+ * any other process, memory-map that file instead of computing or
+ * deserializing the grid, so startup is almost instantaneous and all
+ * processes share the same physical memory for it.
  */
 class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 {
@@ -99,6 +109,9 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 		double ox, double oy, std::vector<double>& tp_obstacles) const override;
 	void updateTPObstacleSingle(
 		double ox, double oy, uint16_t k, double& tp_obstacle_k) const override;
+	void updateTPObstacleBatch(
+		const float* xs, const float* ys, size_t n,
+		std::vector<double>& tp_obstacles) const override;
 
 	/** This family of PTGs ignores the dynamic states */
 	void onNewNavDynamicState() override
@@ -111,6 +124,15 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 	double getMax_V() const { return V_MAX; }
 	double getMax_W() const { return W_MAX; }
 
+	/** Returns the name of the memory-mapped collision grid cache file that
+	 * `initialize(cacheFilename)` would use for the current robot shape and
+	 * PTG parameters: a file in the same directory than `cacheFilename`,
+	 * named after a hash of the parameters.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	std::string collisionGridCacheFileFor(
+		const std::string& cacheFilename) const;
+
    protected:
 	CPTG_DiffDrive_CollisionGridBased();
 
@@ -216,9 +238,26 @@ class CPTG_DiffDrive_CollisionGridBased : public CPTG_RobotShape_Polygonal
 		const std::string& filename,
 		const mrpt::math::CPolygon& current_robotShape);  // true = OK
 
-	/** The collision grid */
+	/** The collision grid, only used while building it or loading it from
+	 * the legacy cache files. Queries use m_compactGrid instead. */
 	CCollisionGrid m_collisionGrid;
 
+	/** Read-only version of the collision grid in compressed sparse row
+	 * format, either memory-mapped from a cache file or stored in the heap.
+	 * It is shared among copies of this object. */
+	struct TCompactCollisionGrid;
+	std::shared_ptr<const TCompactCollisionGrid> m_compactGrid;
+
+	/** Builds m_compactGrid from m_collisionGrid */
+	void buildCompactCollisionGrid();
+	/** Saves m_compactGrid to a cache file. \return false on any error */
+	bool saveCompactCollisionGrid(const std::string& file) const;
+	/** Memory-maps m_compactGrid from a cache file. \return false on any
+	 * error, or if it does not match the current PTG parameters. */
+	bool loadCompactCollisionGrid(const std::string& file);
+	/** A text uniquely identifying the robot shape and PTG parameters */
+	std::string collisionGridCacheKey() const;
+
 	/** Specifies the min/max values for "k" and "n", respectively.
 	 * \sa m_lambdaFunctionOptimizer
 	 */
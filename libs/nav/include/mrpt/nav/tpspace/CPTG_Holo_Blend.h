@@ -67,6 +67,9 @@ class CPTG_Holo_Blend : public CPTG_RobotShape_Circular
 		double ox, double oy, std::vector<double>& tp_obstacles) const override;
 	void updateTPObstacleSingle(
 		double ox, double oy, uint16_t k, double& tp_obstacle_k) const override;
+	void updateTPObstacleBatch(
+		const float* xs, const float* ys, size_t n,
+		std::vector<double>& tp_obstacles) const override;
 
 	/** Duration of each PTG "step"  (default: 10e-3=10 ms) */
 	static double PATH_TIME_STEP;
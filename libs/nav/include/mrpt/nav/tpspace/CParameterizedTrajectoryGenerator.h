@@ -274,6 +274,22 @@ class CParameterizedTrajectoryGenerator
 	virtual void updateTPObstacleSingle(
 		double ox, double oy, uint16_t k, double& tp_obstacle_k) const = 0;
 
+	/** Batch version of updateTPObstacle(), for a whole cloud of `n` obstacle
+	 * points given as a structure of arrays (e.g. as returned by
+	 * mrpt::maps::CPointsMap::getPointsBuffer() after transforming them into
+	 * the PTG frame). The result is the same than calling updateTPObstacle()
+	 * for each point, but PTG families may override it with more efficient
+	 * implementations that amortize per-path or per-grid-cell costs among
+	 * all points, which makes a difference for dense clouds (e.g. 3D
+	 * LiDARs). The default implementation just calls updateTPObstacle().
+	 * \note `tp_obstacles` must be initialized with initTPObstacles() before
+	 * call.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	virtual void updateTPObstacleBatch(
+		const float* xs, const float* ys, size_t n,
+		std::vector<double>& tp_obstacles) const;
+
 	/** Loads a set of default parameters into the PTG. Users normally will call
 	 * `loadFromConfigFile()` instead, this method is provided
 	 * exclusively for the PTG-configurator tool. */
@@ -188,6 +188,9 @@ void PlannerTPS_VirtualBase::spaceTransformer(
 		// Init obs ranges:
 		in_PTG->initTPObstacles(out_TPObstacles);
 
+		std::vector<float> xs, ys;
+		xs.reserve(nObs);
+		ys.reserve(nObs);
 		for (size_t obs = 0; obs < nObs; obs++)
 		{
 			const float ox = obs_xs[obs];
@@ -197,8 +200,11 @@ void PlannerTPS_VirtualBase::spaceTransformer(
 				continue;  // ignore this obstacle: anyway, I don't know how to
 			// map it to TP-Obs!
 
-			in_PTG->updateTPObstacle(ox, oy, out_TPObstacles);
+			xs.push_back(ox);
+			ys.push_back(oy);
 		}
+		in_PTG->updateTPObstacleBatch(
+			xs.data(), ys.data(), xs.size(), out_TPObstacles);
 
 		// Leave distances in out_TPObstacles un-normalized ([0,1]), so they
 		// just represent real distances in meters.
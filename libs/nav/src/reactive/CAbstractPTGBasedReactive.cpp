@@ -25,6 +25,8 @@
 #include <array>
 #include <iomanip>
 #include <limits>
+#include <optional>
+#include <thread>
 
 using namespace mrpt;
 using namespace mrpt::io;
@@ -521,13 +523,7 @@ void CAbstractPTGBasedReactive::performNavigationStep()
 			nPTGs + 1);	 // the last extra one is for the evaluation of "NOP
 		// motion command" choice.
 
-		for (size_t indexPTG = 0; indexPTG < nPTGs; indexPTG++)
-		{
-			mrpt::system::CTimeLoggerEntry tle2(
-				m_navProfiler,
-				"CAbstractPTGBasedReactive::performNavigationStep().eval_"
-				"regular_PTG");
-
+		auto lambdaEvalPTG = [&](size_t indexPTG, CLogFileRecord& logRec) {
 			CParameterizedTrajectoryGenerator* ptg = getPTG(indexPTG);
 			TInfoPerPTG& ipf = m_infoPerPTG[indexPTG];
 
@@ -543,9 +539,65 @@ void CAbstractPTGBasedReactive::performNavigationStep()
 			ASSERT_(m_navigationParams);
 			build_movement_candidate(
 				ptg, indexPTG, relTargets, rel_pose_PTG_origin_wrt_sense, ipf,
-				cm, newLogRec, false /* this is a regular PTG reactive case */,
+				cm, newLogRec.infoPerPTG[indexPTG], logRec,
+				false /* this is a regular PTG reactive case */,
 				*holoMethod, tim_start_iteration, *m_navigationParams);
-		}  // end for each PTG
+		};
+
+		unsigned int nEvalThreads =
+			params_abstract_ptg_navigator.ptg_eval_threads;
+		if (nEvalThreads == 0)
+			nEvalThreads = std::max(1U, std::thread::hardware_concurrency());
+		nEvalThreads =
+			std::min<unsigned int>(nEvalThreads, static_cast<unsigned>(nPTGs));
+
+		m_ptgEvalInParallel = nEvalThreads > 1;
+		if (!m_ptgEvalInParallel)
+		{
+			for (size_t indexPTG = 0; indexPTG < nPTGs; indexPTG++)
+			{
+				mrpt::system::CTimeLoggerEntry tle2(
+					m_navProfiler,
+					"CAbstractPTGBasedReactive::performNavigationStep().eval_"
+					"regular_PTG");
+				lambdaEvalPTG(indexPTG, newLogRec);
+			}
+		}
+		else
+		{
+			// Sections timed from several threads at once would mix up their
+			// enter and leave times, so the parallel region is timed as a
+			// whole instead:
+			mrpt::system::CTimeLoggerEntry tle2(
+				m_navProfiler,
+				"CAbstractPTGBasedReactive::performNavigationStep().eval_"
+				"regular_PTGs_parallel");
+
+			if (!m_ptgEvalThreadsPool ||
+				m_ptgEvalThreadsPool->size() + 1 != nEvalThreads)
+				m_ptgEvalThreadsPool =
+					std::make_unique<mrpt::WorkStealingThreadsPool>(
+						nEvalThreads - 1 /* the caller also works */,
+						"ptg_eval");
+
+			// Each PTG writes its own entry of newLogRec.infoPerPTG, and the
+			// rest of fields to its own log record. These are merged below in
+			// PTG order, so the result is the same than the sequential one:
+			std::vector<CLogFileRecord> logRecPerPTG(nPTGs);
+
+			m_ptgEvalThreadsPool->parallel_for(
+				0, nPTGs,
+				[&](size_t indexPTG) {
+					lambdaEvalPTG(indexPTG, logRecPerPTG[indexPTG]);
+				},
+				1 /* chunk size */);
+			m_ptgEvalInParallel = false;
+
+			for (auto& lr : logRecPerPTG)
+				for (auto& kv : lr.additional_debug_msgs)
+					newLogRec.additional_debug_msgs[kv.first] =
+						std::move(kv.second);
+		}
 
 		// check for collision, which is reflected by ALL TP-Obstacles being
 		// zero:
@@ -697,7 +749,8 @@ void CAbstractPTGBasedReactive::performNavigationStep()
 				build_movement_candidate(
 					last_sent_ptg, m_lastSentVelCmd.ptg_index, relTargets_NOPs,
 					rel_pose_PTG_origin_wrt_sense_NOP, m_infoPerPTG[nPTGs],
-					candidate_movs[nPTGs], newLogRec,
+					candidate_movs[nPTGs], newLogRec.infoPerPTG[nPTGs],
+					newLogRec,
 					true /* this is the PTG continuation (NOP) choice */,
 					*getHoloMethod(m_lastSentVelCmd.ptg_index),
 					tim_start_iteration, *m_navigationParams,
@@ -1016,9 +1069,11 @@ void CAbstractPTGBasedReactive::calc_move_candidate_scores(
 	const mrpt::nav::CHolonomicLogFileRecord::Ptr& hlfr)
 {
 	MRPT_START
-	mrpt::system::CTimeLoggerEntry tle(
-		m_navProfiler,
-		"CAbstractPTGBasedReactive::calc_move_candidate_scores()");
+	std::optional<mrpt::system::CTimeLoggerEntry> tle;
+	if (!m_ptgEvalInParallel)
+		tle.emplace(
+			m_navProfiler,
+			"CAbstractPTGBasedReactive::calc_move_candidate_scores()");
 
 	const double ref_dist = cm.PTG->getRefDistance();
 
@@ -1519,20 +1574,23 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 	CParameterizedTrajectoryGenerator* ptg, const size_t indexPTG,
 	const std::vector<mrpt::math::TPose2D>& relTargets,
 	const mrpt::math::TPose2D& rel_pose_PTG_origin_wrt_sense, TInfoPerPTG& ipf,
-	TCandidateMovementPTG& cm, CLogFileRecord& newLogRec,
-	const bool this_is_PTG_continuation,
+	TCandidateMovementPTG& cm, CLogFileRecord::TInfoPerPTG& log,
+	CLogFileRecord& newLogRec, const bool this_is_PTG_continuation,
 	mrpt::nav::CAbstractHolonomicReactiveMethod& holoMethod,
 	const mrpt::system::TTimeStamp tim_start_iteration,
 	const TNavigationParams& navp,
 	const mrpt::math::TPose2D& rel_cur_pose_wrt_last_vel_cmd_NOP)
 {
-	mrpt::system::CTimeLoggerEntry tle(
-		m_navProfiler, "CAbstractPTGBasedReactive::build_movement_candidate()");
+	std::optional<mrpt::system::CTimeLoggerEntry> tle;
+	if (!m_ptgEvalInParallel)
+		tle.emplace(
+			m_navProfiler,
+			"CAbstractPTGBasedReactive::build_movement_candidate()");
 
-	ASSERT_(ptg);
+	// Not using the `tictac` member, since this may run in parallel threads:
+	mrpt::system::CTicTac tictac;
 
-	const size_t idx_in_log_infoPerPTGs =
-		this_is_PTG_continuation ? getPTG_count() : indexPTG;
+	ASSERT_(ptg);
 
 	CHolonomicLogFileRecord::Ptr HLFR;
 	cm.PTG = ptg;
@@ -1711,12 +1769,14 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 		// STEP5: Evaluate each movement to assign them a "evaluation" value.
 		// ---------------------------------------------------------------------
 		{
-			CTimeLoggerEntry tle2(
-				m_timelogger, "navigationStep.calc_move_candidate_scores");
+			std::optional<CTimeLoggerEntry> tle2;
+			if (!m_ptgEvalInParallel)
+				tle2.emplace(
+					m_timelogger, "navigationStep.calc_move_candidate_scores");
 
 			calc_move_candidate_scores(
 				cm, ipf.TP_Obstacles, ipf.clearance, relTargets, ipf.targets,
-				newLogRec.infoPerPTG[idx_in_log_infoPerPTGs], newLogRec,
+				log, newLogRec,
 				this_is_PTG_continuation, rel_cur_pose_wrt_last_vel_cmd_NOP,
 				indexPTG, tim_start_iteration, HLFR);
 
@@ -1726,7 +1786,7 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 				: .0;
 
 			//  SAVE LOG
-			newLogRec.infoPerPTG[idx_in_log_infoPerPTGs].evalFactors = cm.props;
+			log.evalFactors = cm.props;
 		}
 
 	}  // end "valid_TP"
@@ -1736,8 +1796,7 @@ void CAbstractPTGBasedReactive::build_movement_candidate(
 		(m_logFile != nullptr || m_enableKeepLogRecords);
 	if (fill_log_record)
 	{
-		CLogFileRecord::TInfoPerPTG& ipp =
-			newLogRec.infoPerPTG[idx_in_log_infoPerPTGs];
+		CLogFileRecord::TInfoPerPTG& ipp = log;
 		if (!this_is_PTG_continuation) ipp.PTG_desc = ptg->getDescription();
 		else
 			ipp.PTG_desc = mrpt::format(
@@ -1780,6 +1839,7 @@ void CAbstractPTGBasedReactive::TAbstractPTGNavigatorParams::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR_CS(enable_obstacle_filtering, bool);
 	MRPT_LOAD_CONFIG_VAR_CS(evaluate_clearance, bool);
 	MRPT_LOAD_CONFIG_VAR_CS(max_dist_for_timebased_path_prediction, double);
+	MRPT_LOAD_CONFIG_VAR_CS(ptg_eval_threads, int);
 
 	MRPT_END
 }
@@ -1856,6 +1916,10 @@ void CAbstractPTGBasedReactive::TAbstractPTGNavigatorParams::saveToConfigFile(
 		max_dist_for_timebased_path_prediction,
 		"Max dist [meters] to use time-based path prediction for NOP "
 		"evaluation");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		ptg_eval_threads,
+		"Number of threads to evaluate PTGs concurrently (default=1: "
+		"sequential; 0: as many as CPU cores)");
 }
 
 CAbstractPTGBasedReactive::TAbstractPTGNavigatorParams::
@@ -240,6 +240,12 @@ void CReactiveNavigationSystem::STEP3_WSpaceToTPSpace(
 	const float *xs, *ys, *zs;
 	m_WS_Obstacles.getPointsBuffer(nObs, xs, ys, zs);
 
+	// Transform and filter all points first, then update the TP-Obstacles
+	// of all of them at once:
+	std::vector<float> ptg_xs, ptg_ys;
+	ptg_xs.reserve(nObs);
+	ptg_ys.reserve(nObs);
+
 	for (size_t obs = 0; obs < nObs; obs++)
 	{
 		double ox, oy, oz = zs[obs];
@@ -249,10 +255,19 @@ void CReactiveNavigationSystem::STEP3_WSpaceToTPSpace(
 			oy < OBS_MAX_XY && oz >= params_reactive_nav.min_obstacles_height &&
 			oz <= params_reactive_nav.max_obstacles_height)
 		{
-			ptg->updateTPObstacle(ox, oy, out_TPObstacles);
-			if (eval_clearance) { ptg->updateClearance(ox, oy, out_clearance); }
+			ptg_xs.push_back(static_cast<float>(ox));
+			ptg_ys.push_back(static_cast<float>(oy));
 		}
 	}
+
+	ptg->updateTPObstacleBatch(
+		ptg_xs.data(), ptg_ys.data(), ptg_xs.size(), out_TPObstacles);
+
+	if (eval_clearance)
+	{
+		for (size_t i = 0; i < ptg_xs.size(); i++)
+			ptg->updateClearance(ptg_xs[i], ptg_ys[i], out_clearance);
+	}
 }
 
 /** Generates a pointcloud of obstacles, and the robot shape, to be saved in the
@@ -260,24 +260,35 @@ void CReactiveNavigationSystem3D::STEP3_WSpaceToTPSpace(
 	const mrpt::poses::CPose2D rel_pose_PTG_origin_wrt_sense(
 		rel_pose_PTG_origin_wrt_sense_);
 
+	// Obstacles of each height level, in the PTG frame:
+	std::vector<float> ptg_xs, ptg_ys;
+
 	for (size_t j = 0; j < m_robotShape.size(); j++)
 	{
 		size_t nObs;
 		const float *xs, *ys, *zs;
 		m_WS_Obstacles_inlevels[j].getPointsBuffer(nObs, xs, ys, zs);
 
+		const auto& ptg = m_ptgmultilevel[ptg_idx].PTGs[j];
+
+		ptg_xs.resize(nObs);
+		ptg_ys.resize(nObs);
 		for (size_t obs = 0; obs < nObs; obs++)
 		{
 			double ox, oy;
 			rel_pose_PTG_origin_wrt_sense.composePoint(
 				xs[obs], ys[obs], ox, oy);
-			m_ptgmultilevel[ptg_idx].PTGs[j]->updateTPObstacle(
-				ox, oy, out_TPObstacles);
-			if (eval_clearance)
-			{
-				m_ptgmultilevel[ptg_idx].PTGs[j]->updateClearance(
-					ox, oy, out_clearance);
-			}
+			ptg_xs[obs] = static_cast<float>(ox);
+			ptg_ys[obs] = static_cast<float>(oy);
+		}
+
+		ptg->updateTPObstacleBatch(
+			ptg_xs.data(), ptg_ys.data(), nObs, out_TPObstacles);
+
+		if (eval_clearance)
+		{
+			for (size_t obs = 0; obs < nObs; obs++)
+				ptg->updateClearance(ptg_xs[obs], ptg_ys[obs], out_clearance);
 		}
 	}
 
@@ -24,7 +24,8 @@ void run_rnav_test_impl(
 	const TPoint2D& nav_target, const TPoint2D& world_topleft,
 	const TPoint2D& world_rightbottom,
 	const TPoint2D& block_obstacle_topleft = TPoint2D(0, 0),
-	const TPoint2D& block_obstacle_rightbottom = TPoint2D(0, 0))
+	const TPoint2D& block_obstacle_rightbottom = TPoint2D(0, 0),
+	unsigned int ptgEvalThreads = 1)
 {
 	using namespace std;
 	using namespace mrpt;
@@ -42,6 +43,7 @@ void run_rnav_test_impl(
 
 	mrpt::config::CConfigFile cfg(sFil);
 	cfg.write("CAbstractPTGBasedReactive", "holonomic_method", sHoloMethod);
+	cfg.write("CAbstractPTGBasedReactive", "ptg_eval_threads", ptgEvalThreads);
 	cfg.discardSavingChanges();
 
 	// Create a grid map with a synthetic test environment with a simple
@@ -195,14 +197,15 @@ void run_rnav_test(
 	const TPoint2D& nav_target, const TPoint2D& world_topleft,
 	const TPoint2D& world_rightbottom,
 	const TPoint2D& block_obstacle_topleft = TPoint2D(0, 0),
-	const TPoint2D& block_obstacle_rightbottom = TPoint2D(0, 0))
+	const TPoint2D& block_obstacle_rightbottom = TPoint2D(0, 0),
+	unsigned int ptgEvalThreads = 1)
 {
 	try
 	{
 		run_rnav_test_impl<RNAVCLASS>(
 			sFilename, sHoloMethod, nav_target, world_topleft,
 			world_rightbottom, block_obstacle_topleft,
-			block_obstacle_rightbottom);
+			block_obstacle_rightbottom, ptgEvalThreads);
 	}
 	catch (const std::exception& e)
 	{
@@ -290,3 +293,18 @@ TEST(CReactiveNavigationSystem3D, with_obstacle_nav_FullEval)
 		"reactive3d_config.ini", "CHolonomicFullEval", with_obs_trg,
 		with_obs_topleft, with_obs_bottomright, obs_tl, obs_br);
 }
+
+TEST(CReactiveNavigationSystem, with_obstacle_nav_FullEval_parallel)
+{
+	run_rnav_test<mrpt::nav::CReactiveNavigationSystem>(
+		"reactive2d_config.ini", "CHolonomicFullEval", with_obs_trg,
+		with_obs_topleft, with_obs_bottomright, obs_tl, obs_br,
+		4 /*ptgEvalThreads*/);
+}
+TEST(CReactiveNavigationSystem3D, with_obstacle_nav_FullEval_parallel)
+{
+	run_rnav_test<mrpt::nav::CReactiveNavigationSystem3D>(
+		"reactive3d_config.ini", "CHolonomicFullEval", with_obs_trg,
+		with_obs_topleft, with_obs_bottomright, obs_tl, obs_br,
+		4 /*ptgEvalThreads*/);
+}
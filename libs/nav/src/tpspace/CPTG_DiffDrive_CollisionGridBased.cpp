@@ -9,15 +9,22 @@
 
 #include "nav-precomp.h"  // Precomp header
 //
+#include <mrpt/config/CConfigFileMemory.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryMappedFile.h>
 #include <mrpt/kinematics/CVehicleVelCmd_DiffDriven.h>
 #include <mrpt/math/geometry.h>
 #include <mrpt/nav/tpspace/CPTG_DiffDrive_CollisionGridBased.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/serialization/stl_serialization.h>
 #include <mrpt/system/CTicTac.h>
+#include <mrpt/system/filesystem.h>
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
 #include <iostream>
 
 using namespace mrpt::nav;
@@ -372,6 +379,276 @@ bool CPTG_DiffDrive_CollisionGridBased::loadColGridsFromFile(
 	}
 }
 
+namespace
+{
+/* Layout of the memory-mapped collision grid cache files: this header,
+ * followed by these arrays, each one starting at a multiple of 8 bytes:
+ *  - char key[keyLength]: The text returned by collisionGridCacheKey()
+ *  - uint32_t cellStart[sizeX*sizeY+1]: Entries of the i-th cell (in
+ *    row-major order) are those in the range [cellStart[i],cellStart[i+1]).
+ *  - float dists[numEntries]: Minimum collision distance of each entry.
+ *  - uint16_t ks[numEntries]: Path index of each entry.
+ */
+struct ColGridCacheHeader
+{
+	char magic[8];
+	uint32_t endianness;
+	uint32_t version;
+	uint64_t keyHash;
+	uint64_t keyLength;
+	int32_t sizeX, sizeY;
+	double xMin, yMin, resolution;
+	uint64_t numEntries;
+	uint64_t totalSize;
+};
+
+const char COLGRID_CACHE_MAGIC[8] = {'M', 'R', 'P', 'T', 'C', 'G', 'R', 'D'};
+constexpr uint32_t COLGRID_CACHE_ENDIANNESS = 0x01020304;
+constexpr uint32_t COLGRID_CACHE_VERSION = 1;
+
+constexpr uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+// Offsets of each array within the file:
+struct ColGridCacheLayout
+{
+	ColGridCacheLayout(const ColGridCacheHeader& h)
+	{
+		const uint64_t nCells = uint64_t(h.sizeX) * uint64_t(h.sizeY);
+		key = align8(sizeof(ColGridCacheHeader));
+		cellStart = key + align8(h.keyLength);
+		dists = cellStart + align8((nCells + 1) * sizeof(uint32_t));
+		ks = dists + align8(h.numEntries * sizeof(float));
+		totalSize = ks + align8(h.numEntries * sizeof(uint16_t));
+	}
+	uint64_t key, cellStart, dists, ks, totalSize;
+};
+
+// 64-bit FNV-1a hash
+uint64_t fnv1a_64(const std::string& s)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (const char c : s)
+	{
+		h ^= static_cast<uint8_t>(c);
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+}  // namespace
+
+struct CPTG_DiffDrive_CollisionGridBased::TCompactCollisionGrid
+{
+	int sizeX = 0, sizeY = 0;
+	double xMin = 0, yMin = 0, resolution = 1;
+	const uint32_t* cellStart = nullptr;
+	const float* dists = nullptr;
+	const uint16_t* ks = nullptr;
+
+	/** The storage: either a memory-mapped file, or the same file image in
+	 * the heap (as uint64_t to ensure the alignment of all arrays) */
+	mrpt::io::CMemoryMappedFile mappedFile;
+	std::vector<uint64_t> heapImage;
+
+	/** Same cell indexing than in CDynamicGrid::cellByPos(). Returns the
+	 * linear index of the cell, or -1 if it is out of the grid. */
+	int cellIndex(const float x, const float y) const
+	{
+		const int cx = static_cast<int>((x - xMin) / resolution);
+		const int cy = static_cast<int>((y - yMin) / resolution);
+		if (cx < 0 || cx >= sizeX || cy < 0 || cy >= sizeY) return -1;
+		return cx + cy * sizeX;
+	}
+
+	/** Sets the pointers to the arrays in a file image, checking it is
+	 * consistent. Returns false on any error. */
+	bool assignImage(
+		const uint8_t* img, uint64_t len, const std::string& expectedKey,
+		uint16_t numPaths)
+	{
+		if (len < sizeof(ColGridCacheHeader)) return false;
+		ColGridCacheHeader h;
+		std::memcpy(&h, img, sizeof(h));
+		if (0 != std::memcmp(h.magic, COLGRID_CACHE_MAGIC, sizeof(h.magic)) ||
+			h.endianness != COLGRID_CACHE_ENDIANNESS ||
+			h.version != COLGRID_CACHE_VERSION || h.totalSize != len ||
+			h.sizeX <= 0 || h.sizeY <= 0 || !(h.resolution > 0) ||
+			h.keyLength != expectedKey.size() ||
+			h.keyHash != fnv1a_64(expectedKey))
+			return false;
+
+		const ColGridCacheLayout l(h);
+		if (l.totalSize != len ||
+			0 != std::memcmp(img + l.key, expectedKey.data(), h.keyLength))
+			return false;
+
+		const auto* cs = reinterpret_cast<const uint32_t*>(img + l.cellStart);
+		const auto* ds = reinterpret_cast<const float*>(img + l.dists);
+		const auto* kk = reinterpret_cast<const uint16_t*>(img + l.ks);
+
+		// Make sure a corrupted file cannot lead to out-of-range accesses:
+		const size_t nCells = size_t(h.sizeX) * size_t(h.sizeY);
+		if (cs[0] != 0 || cs[nCells] != h.numEntries) return false;
+		for (size_t i = 0; i < nCells; i++)
+			if (cs[i] > cs[i + 1]) return false;
+		for (uint64_t i = 0; i < h.numEntries; i++)
+			if (kk[i] >= numPaths) return false;
+
+		sizeX = h.sizeX;
+		sizeY = h.sizeY;
+		xMin = h.xMin;
+		yMin = h.yMin;
+		resolution = h.resolution;
+		cellStart = cs;
+		dists = ds;
+		ks = kk;
+		return true;
+	}
+};
+
+std::string CPTG_DiffDrive_CollisionGridBased::collisionGridCacheKey() const
+{
+	// All PTG parameters, including those of derived classes:
+	mrpt::config::CConfigFileMemory cfg;
+	this->saveToConfigFile(cfg, "ptg");
+
+	std::string key = mrpt::format(
+		"%s\n%s\n", GetRuntimeClass()->className, cfg.getContent().c_str());
+
+	// And the exact values of the most relevant ones:
+	key += mrpt::format(
+		"%u %a %a %a %a %a\n", static_cast<unsigned>(m_alphaValuesCount),
+		refDistance, m_resolution, V_MAX, W_MAX, turningRadiusReference);
+	for (size_t i = 0; i < m_robotShape.size(); i++)
+		key += mrpt::format(
+			"%a %a\n", m_robotShape.GetVertex_x(i),
+			m_robotShape.GetVertex_y(i));
+	return key;
+}
+
+std::string CPTG_DiffDrive_CollisionGridBased::collisionGridCacheFileFor(
+	const std::string& cacheFilename) const
+{
+	std::string dir = mrpt::system::extractFileDirectory(cacheFilename);
+	if (dir.empty()) dir = ".";
+	return mrpt::format(
+		"%s/colgrid_%016" PRIx64 ".bin", dir.c_str(),
+		fnv1a_64(collisionGridCacheKey()));
+}
+
+void CPTG_DiffDrive_CollisionGridBased::buildCompactCollisionGrid()
+{
+	const auto& g = m_collisionGrid;
+	const std::string key = collisionGridCacheKey();
+
+	ColGridCacheHeader h;
+	std::memcpy(h.magic, COLGRID_CACHE_MAGIC, sizeof(h.magic));
+	h.endianness = COLGRID_CACHE_ENDIANNESS;
+	h.version = COLGRID_CACHE_VERSION;
+	h.keyHash = fnv1a_64(key);
+	h.keyLength = key.size();
+	h.sizeX = static_cast<int32_t>(g.getSizeX());
+	h.sizeY = static_cast<int32_t>(g.getSizeY());
+	h.xMin = g.getXMin();
+	h.yMin = g.getYMin();
+	h.resolution = g.getResolution();
+
+	const size_t nCells = g.getSizeX() * g.getSizeY();
+	h.numEntries = 0;
+	for (size_t i = 0; i < nCells; i++)
+		h.numEntries += g.cellByIndex(i % h.sizeX, i / h.sizeX)->size();
+	ASSERT_LT_(h.numEntries, std::numeric_limits<uint32_t>::max());
+
+	const ColGridCacheLayout l(h);
+	h.totalSize = l.totalSize;
+
+	auto cg = std::make_shared<TCompactCollisionGrid>();
+	cg->heapImage.assign(l.totalSize / sizeof(uint64_t), 0);
+	auto* img = reinterpret_cast<uint8_t*>(cg->heapImage.data());
+
+	std::memcpy(img, &h, sizeof(h));
+	std::memcpy(img + l.key, key.data(), key.size());
+	auto* cs = reinterpret_cast<uint32_t*>(img + l.cellStart);
+	auto* ds = reinterpret_cast<float*>(img + l.dists);
+	auto* kk = reinterpret_cast<uint16_t*>(img + l.ks);
+
+	uint32_t n = 0;
+	for (size_t i = 0; i < nCells; i++)
+	{
+		cs[i] = n;
+		for (const auto& e : *g.cellByIndex(i % h.sizeX, i / h.sizeX))
+		{
+			kk[n] = e.first;
+			ds[n] = e.second;
+			n++;
+		}
+	}
+	cs[nCells] = n;
+
+	const bool ok =
+		cg->assignImage(img, l.totalSize, key, getAlphaValuesCount());
+	ASSERT_(ok);
+	m_compactGrid = std::move(cg);
+}
+
+bool CPTG_DiffDrive_CollisionGridBased::saveCompactCollisionGrid(
+	const std::string& file) const
+{
+	if (!m_compactGrid) return false;
+
+	const auto& cg = *m_compactGrid;
+	const uint8_t* img = cg.mappedFile.isOpen()
+		? cg.mappedFile.data()
+		: reinterpret_cast<const uint8_t*>(cg.heapImage.data());
+	ColGridCacheHeader h;
+	std::memcpy(&h, img, sizeof(h));
+
+	// Write to a temporary file and rename it, so other processes never see
+	// an incomplete cache file:
+	const std::string tmpFile = mrpt::format(
+		"%s.%016" PRIx64 ".tmp", file.c_str(),
+		static_cast<uint64_t>(mrpt::Clock::now().time_since_epoch().count()));
+	try
+	{
+		mrpt::io::CFileOutputStream fo;
+		if (!fo.open(tmpFile)) return false;
+		fo.Write(img, h.totalSize);
+		fo.close();
+	}
+	catch (...)
+	{
+		mrpt::system::deleteFile(tmpFile);
+		return false;
+	}
+	if (!mrpt::system::renameFile(tmpFile, file))
+	{
+		// e.g. someone else just created it
+		mrpt::system::deleteFile(tmpFile);
+		return mrpt::system::fileExists(file);
+	}
+	return true;
+}
+
+bool CPTG_DiffDrive_CollisionGridBased::loadCompactCollisionGrid(
+	const std::string& file)
+{
+	if (!mrpt::system::fileExists(file)) return false;
+	try
+	{
+		auto cg = std::make_shared<TCompactCollisionGrid>();
+		cg->mappedFile.open(file);
+		if (!cg->assignImage(
+				cg->mappedFile.data(), cg->mappedFile.size(),
+				collisionGridCacheKey(), getAlphaValuesCount()))
+			return false;
+		m_compactGrid = std::move(cg);
+		return true;
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+}
+
 const uint32_t COLGRID_FILE_MAGIC = 0xC0C0C0C3;
 
 /*---------------------------------------------------------------
@@ -675,6 +952,7 @@ void CPTG_DiffDrive_CollisionGridBased::internal_processNewRobotShape()
 void CPTG_DiffDrive_CollisionGridBased::internal_deinitialize()
 {
 	m_trajectory.clear();  // Free trajectories
+	m_compactGrid.reset();
 }
 
 void CPTG_DiffDrive_CollisionGridBased::internal_initialize(
@@ -725,6 +1003,16 @@ void CPTG_DiffDrive_CollisionGridBased::internal_initialize(
 	const size_t Ki = getAlphaValuesCount();
 	ASSERTMSG_(Ki > 0, "The PTG seems to be not initialized!");
 
+	// Map the shared, compact cache file, if it exists:
+	const std::string compactCacheFile =
+		collisionGridCacheFileFor(cacheFilename);
+	if (loadCompactCollisionGrid(compactCacheFile))
+	{
+		if (verbose)
+			cout << "mapped from '" << compactCacheFile << "' OK" << endl;
+		return;
+	}
+
 	// Load the cached version, if possible
 	if (loadColGridsFromFile(cacheFilename, m_robotShape))
 	{
@@ -825,6 +1113,13 @@ void CPTG_DiffDrive_CollisionGridBased::internal_initialize(
 
 	}  // "else" recompute all PTG
 
+	// Build the compact grid used for queries, save it for the next run and
+	// map it back, so the memory is shared with other processes:
+	buildCompactCollisionGrid();
+	m_collisionGrid.clear();
+	if (saveCompactCollisionGrid(compactCacheFile))
+		loadCompactCollisionGrid(compactCacheFile);
+
 	MRPT_END
 }
 
@@ -880,12 +1175,58 @@ void CPTG_DiffDrive_CollisionGridBased::updateTPObstacle(
 	double ox, double oy, std::vector<double>& tp_obstacles) const
 {
 	ASSERTMSG_(!m_trajectory.empty(), "PTG has not been initialized!");
-	const TCollisionCell& cell = m_collisionGrid.getTPObstacle(ox, oy);
+	if (!m_compactGrid) return;
+	const auto& grid = *m_compactGrid;
+	const int idx = grid.cellIndex(ox, oy);
+	if (idx < 0) return;
 	// Keep the minimum distance:
-	for (const auto& i : cell)
+	for (uint32_t i = grid.cellStart[idx]; i < grid.cellStart[idx + 1]; i++)
+	{
+		const double dist = grid.dists[i];
+		internal_TPObsDistancePostprocess(
+			ox, oy, dist, tp_obstacles[grid.ks[i]]);
+	}
+}
+
+void CPTG_DiffDrive_CollisionGridBased::updateTPObstacleBatch(
+	const float* xs, const float* ys, size_t n,
+	std::vector<double>& tp_obstacles) const
+{
+	ASSERTMSG_(!m_trajectory.empty(), "PTG has not been initialized!");
+
+	// All obstacles falling into the same grid cell lead to exactly the same
+	// (k,dist) updates, unless they are inside the robot shape (see
+	// internal_TPObsDistancePostprocess()). So: collect the linear index of
+	// the cells of all obstacles, sort them, and visit each distinct cell only
+	// once, in memory order.
+	if (!m_compactGrid) return;
+	const auto& grid = *m_compactGrid;
+	const double R2 = mrpt::square(getMaxRobotRadius());
+
+	std::vector<uint32_t> cellIdxs;
+	cellIdxs.reserve(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		const double ox = xs[i], oy = ys[i];
+		if (ox * ox + oy * oy <= R2 && isPointInsideRobotShape(ox, oy))
+		{
+			updateTPObstacle(ox, oy, tp_obstacles);
+			continue;
+		}
+		const int idx = grid.cellIndex(xs[i], ys[i]);
+		if (idx < 0) continue;
+		cellIdxs.push_back(static_cast<uint32_t>(idx));
+	}
+	std::sort(cellIdxs.begin(), cellIdxs.end());
+	cellIdxs.erase(
+		std::unique(cellIdxs.begin(), cellIdxs.end()), cellIdxs.end());
+
+	for (const uint32_t idx : cellIdxs)
 	{
-		const double dist = i.second;
-		internal_TPObsDistancePostprocess(ox, oy, dist, tp_obstacles[i.first]);
+		// Keep the minimum distance:
+		for (uint32_t i = grid.cellStart[idx]; i < grid.cellStart[idx + 1];
+			 i++)
+			mrpt::keep_min(tp_obstacles[grid.ks[i]], double(grid.dists[i]));
 	}
 }
 
@@ -893,12 +1234,15 @@ void CPTG_DiffDrive_CollisionGridBased::updateTPObstacleSingle(
 	double ox, double oy, uint16_t k, double& tp_obstacle_k) const
 {
 	ASSERTMSG_(!m_trajectory.empty(), "PTG has not been initialized!");
-	const TCollisionCell& cell = m_collisionGrid.getTPObstacle(ox, oy);
+	if (!m_compactGrid) return;
+	const auto& grid = *m_compactGrid;
+	const int idx = grid.cellIndex(ox, oy);
+	if (idx < 0) return;
 	// Keep the minimum distance:
-	for (const auto& i : cell)
-		if (i.first == k)
+	for (uint32_t i = grid.cellStart[idx]; i < grid.cellStart[idx + 1]; i++)
+		if (grid.ks[i] == k)
 		{
-			const double dist = i.second;
+			const double dist = grid.dists[i];
 			internal_TPObsDistancePostprocess(ox, oy, dist, tp_obstacle_k);
 		}
 }
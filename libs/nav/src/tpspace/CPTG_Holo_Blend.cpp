@@ -622,12 +622,23 @@ bool CPTG_Holo_Blend::getPathStepForDist(
 		return false;
 }
 
-void CPTG_Holo_Blend::updateTPObstacleSingle(
-	double ox, double oy, uint16_t k, double& tp_obstacle_k) const
+namespace
 {
-	const double R = m_robotRadius;
-	const double dir = CParameterizedTrajectoryGenerator::index2alpha(k);
-	COMMON_PTG_DESIGN_PARAMS;
+// The constants of the collision equations for one path "k":
+struct HoloBlendPathConsts
+{
+	double vxi, vyi, vf_mod, vxf, vyf, T_ramp, V_MAX, R;
+};
+
+// Computes the distance along the path until the robot collides with the
+// obstacle (ox,oy). Returns false if it does not collide at all.
+bool holo_blend_collision_distance(
+	const HoloBlendPathConsts& pc, const double ox, const double oy,
+	double& dist)
+{
+	const double vxi = pc.vxi, vyi = pc.vyi, vf_mod = pc.vf_mod,
+				 vxf = pc.vxf, vyf = pc.vyf, T_ramp = pc.T_ramp,
+				 V_MAX = pc.V_MAX, R = pc.R;
 
 	const double TR2_ = 1.0 / (2 * T_ramp);
 	const double TR_2 = T_ramp * 0.5;
@@ -656,14 +667,14 @@ void CPTG_Holo_Blend::updateTPObstacleSingle(
 
 	double roots[4];
 	int num_real_sols = 0;
-	if (std::abs(a) > eps)
+	if (std::abs(a) > CPTG_Holo_Blend::eps)
 	{
 		// General case: 4th order equation
 		// a * x^4 + b * x^3 + c * x^2 + d * x + e
 		num_real_sols =
 			mrpt::math::solve_poly4(roots, b / a, c / a, d / a, e / a);
 	}
-	else if (std::abs(b) > eps)
+	else if (std::abs(b) > CPTG_Holo_Blend::eps)
 	{
 		// Special case: k2=k4=0 (straight line path, no blend)
 		// 3rd order equation:
@@ -729,15 +740,29 @@ void CPTG_Holo_Blend::updateTPObstacleSingle(
 	}
 
 	// Valid solution?
-	if (sol_t < 0) return;
+	if (sol_t < 0) return false;
 	// Compute the transversed distance:
-	double dist;
-
 	if (sol_t < T_ramp)
-		dist = calc_trans_distance_t_below_Tramp(k2, k4, vxi, vyi, sol_t);
+		dist = CPTG_Holo_Blend::calc_trans_distance_t_below_Tramp(
+			k2, k4, vxi, vyi, sol_t);
 	else
 		dist = (sol_t - T_ramp) * V_MAX +
-			calc_trans_distance_t_below_Tramp(k2, k4, vxi, vyi, T_ramp);
+			CPTG_Holo_Blend::calc_trans_distance_t_below_Tramp(
+				k2, k4, vxi, vyi, T_ramp);
+	return true;
+}
+}  // namespace
+
+void CPTG_Holo_Blend::updateTPObstacleSingle(
+	double ox, double oy, uint16_t k, double& tp_obstacle_k) const
+{
+	const double dir = CParameterizedTrajectoryGenerator::index2alpha(k);
+	COMMON_PTG_DESIGN_PARAMS;
+	const HoloBlendPathConsts pc = {
+		vxi, vyi, vf_mod, vxf, vyf, T_ramp, V_MAX, m_robotRadius};
+
+	double dist;
+	if (!holo_blend_collision_distance(pc, ox, oy, dist)) return;
 
 	// Store in the output variable:
 	internal_TPObsDistancePostprocess(ox, oy, dist, tp_obstacle_k);
@@ -754,6 +779,54 @@ void CPTG_Holo_Blend::updateTPObstacle(
 	}  // end for each "k" alpha
 }
 
+void CPTG_Holo_Blend::updateTPObstacleBatch(
+	const float* xs, const float* ys, size_t n,
+	std::vector<double>& tp_obstacles) const
+{
+	PERFORMANCE_BENCHMARK;
+
+	const double R = m_robotRadius;
+
+	// Squared distances of all obstacles to the origin, in a tight loop
+	// the compiler can vectorize:
+	std::vector<double> obsDist2(n);
+	for (size_t i = 0; i < n; i++)
+		obsDist2[i] = double(xs[i]) * xs[i] + double(ys[i]) * ys[i];
+
+	// Loop over paths first, so the path constants (which involve evaluating
+	// the user-given expressions) are computed only once per "k":
+	for (unsigned int k = 0; k < m_alphaValuesCount; k++)
+	{
+		const double dir = CParameterizedTrajectoryGenerator::index2alpha(k);
+		COMMON_PTG_DESIGN_PARAMS;
+		const HoloBlendPathConsts pc = {
+			vxi, vyi, vf_mod, vxf, vyf, T_ramp, V_MAX, R};
+
+		double& tp_obs_k = tp_obstacles[k];
+
+		// The robot center has to move at least |o|-R to touch an obstacle
+		// "o", so obstacles farther than that cannot shorten the current
+		// collision-free distance (a small margin accounts for the numerical
+		// tolerance of the solvers):
+		const auto farThreshold2 = [&]() {
+			return mrpt::square(std::max(tp_obs_k, .0) + R + 1e-3);
+		};
+		double thres2 = farThreshold2();
+
+		for (size_t i = 0; i < n; i++)
+		{
+			if (obsDist2[i] > thres2) continue;
+
+			const double ox = xs[i], oy = ys[i];
+			double dist;
+			if (!holo_blend_collision_distance(pc, ox, oy, dist)) continue;
+
+			internal_TPObsDistancePostprocess(ox, oy, dist, tp_obs_k);
+			thres2 = farThreshold2();
+		}
+	}  // end for each "k" alpha
+}
+
 void CPTG_Holo_Blend::internal_processNewRobotShape()
 {
 	// Nothing to do in a closed-form PTG.
@@ -264,6 +264,14 @@ void CParameterizedTrajectoryGenerator::initTPObstacleSingle(
 	TP_Obstacle_k = refDistance;
 }
 
+void CParameterizedTrajectoryGenerator::updateTPObstacleBatch(
+	const float* xs, const float* ys, size_t n,
+	std::vector<double>& tp_obstacles) const
+{
+	for (size_t i = 0; i < n; i++)
+		updateTPObstacle(xs[i], ys[i], tp_obstacles);
+}
+
 bool CParameterizedTrajectoryGenerator::debugDumpInFiles(
 	const std::string& ptg_name) const
 {
@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/config/CConfigFile.h>
+#include <mrpt/nav/tpspace/CPTG_DiffDrive_CollisionGridBased.h>
 #include <mrpt/nav/tpspace/CParameterizedTrajectoryGenerator.h>
 #include <mrpt/system/filesystem.h>
 #include <test_mrpt_common.h>
@@ -180,9 +181,110 @@ TEST(NavTests, PTGs_tests)
 			EXPECT_TRUE(any_change_all);
 		}
 
+		// TEST: batch TP_obstacles == one by one
+		{
+			std::vector<float> xs, ys;
+			for (double ox = -refDist * 0.6; ox < refDist * 0.6; ox += 0.07)
+				for (double oy = -refDist * 0.6; oy < refDist * 0.6;
+					 oy += 0.07)
+				{
+					xs.push_back(static_cast<float>(ox));
+					ys.push_back(static_cast<float>(oy));
+				}
+
+			std::vector<double> TP_obs_single, TP_obs_batch;
+			ptg->initTPObstacles(TP_obs_single);
+			ptg->initTPObstacles(TP_obs_batch);
+
+			for (size_t i = 0; i < xs.size(); i++)
+				ptg->updateTPObstacle(xs[i], ys[i], TP_obs_single);
+			ptg->updateTPObstacleBatch(
+				xs.data(), ys.data(), xs.size(), TP_obs_batch);
+
+			ASSERT_EQ(TP_obs_single.size(), TP_obs_batch.size());
+			for (size_t k = 0; k < TP_obs_single.size(); k++)
+				EXPECT_NEAR(TP_obs_single[k], TP_obs_batch[k], 1e-6)
+					<< "PTG: " << sPTGDesc << " k=" << k << endl;
+			num_tests_run++;
+		}
+
 		printf(
 			"PTG `%50s` run %6u tests.\n", sPTGDesc.c_str(),
 			(unsigned int)num_tests_run);
 
 	}  // for each ptg
 }
+
+TEST(NavTests, PTGs_collisionGridCache)
+{
+	using namespace std;
+	using namespace mrpt;
+	using namespace mrpt::nav;
+
+	const string sFil =
+		mrpt::UNITTEST_BASEDIR() + string("/tests/PTGs_for_tests.ini");
+	if (!mrpt::system::fileExists(sFil))
+	{
+		cerr << "**WARNING* Skipping tests since file cannot be found: '"
+			 << sFil << "'\n";
+		return;
+	}
+	mrpt::config::CConfigFile cfg(sFil);
+
+	const string sDir = mrpt::system::getTempFileName() + "_ptgcache";
+	mrpt::system::createDirectory(sDir);
+	const string sCache = sDir + "/ReacNavGrid_000.dat.gz";
+
+	const unsigned int PTG_COUNT =
+		cfg.read_int("PTG_UNIT_TESTS", "PTG_COUNT", 0, true);
+	for (unsigned int n = 0; n < PTG_COUNT; n++)
+	{
+		const string sPTGName = cfg.read_string(
+			"PTG_UNIT_TESTS", format("PTG%u_Type", n), "", true);
+		const auto createPTG = [&]() {
+			return CParameterizedTrajectoryGenerator::CreatePTG(
+				sPTGName, cfg, "PTG_UNIT_TESTS", format("PTG%u_", n));
+		};
+
+		auto ptg1 = createPTG();
+		const auto* gridPTG =
+			dynamic_cast<CPTG_DiffDrive_CollisionGridBased*>(ptg1.get());
+		if (!gridPTG) continue;
+
+		const string sGridCache = gridPTG->collisionGridCacheFileFor(sCache);
+		mrpt::system::deleteFile(sGridCache);
+
+		// 1st one builds the grid, 2nd one maps it from the cache:
+		ptg1->initialize(sCache, false /*verbose */);
+		EXPECT_TRUE(mrpt::system::fileExists(sGridCache));
+		mrpt::system::deleteFile(sCache);
+
+		auto ptg2 = createPTG();
+		ptg2->initialize(sCache, false /*verbose */);
+		EXPECT_FALSE(mrpt::system::fileExists(sCache));
+
+		const double refDist = ptg1->getRefDistance();
+		for (double ox = -refDist; ox < refDist; ox += 0.13)
+			for (double oy = -refDist; oy < refDist; oy += 0.13)
+			{
+				std::vector<double> TP_obs1, TP_obs2;
+				ptg1->initTPObstacles(TP_obs1);
+				ptg2->initTPObstacles(TP_obs2);
+				ptg1->updateTPObstacle(ox, oy, TP_obs1);
+				ptg2->updateTPObstacle(ox, oy, TP_obs2);
+				EXPECT_EQ(TP_obs1, TP_obs2) << "PTG: " << sPTGName << endl;
+			}
+
+		// A different robot shape must not use the same cache file:
+		auto ptg3 = createPTG();
+		auto* gridPTG3 =
+			dynamic_cast<CPTG_DiffDrive_CollisionGridBased*>(ptg3.get());
+		auto shape = gridPTG3->getRobotShape();
+		shape[0].x *= 1.01;
+		gridPTG3->setRobotShape(shape);
+		EXPECT_NE(gridPTG3->collisionGridCacheFileFor(sCache), sGridCache);
+
+		mrpt::system::deleteFile(sGridCache);
+	}
+	mrpt::system::deleteFilesInDirectory(sDir, true);
+}
@@ -40,6 +40,13 @@ struct TMatchingParams
 	/** The point used to calculate angular distances: e.g. the coordinates of
 	 * the sensor for a 2D laser scanner. */
 	mrpt::math::TPoint3D angularDistPivotPoint{0, 0, 0};
+	/** Number of threads to use for the correspondence search in point maps
+	 * (CPointsMap::determineMatching2D() and
+	 * CPointsMap::determineMatching3D()). 1=single thread (default), 0=as
+	 * many as CPU cores. Results are identical for any value.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	unsigned int parallelThreads{1};
 
 	/** Ctor: default values */
 	TMatchingParams() = default;
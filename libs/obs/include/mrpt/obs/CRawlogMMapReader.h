@@ -0,0 +1,160 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/pimpl.h>
+#include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CRawlog.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/system/datetime.h>
+
+#include <cstdint>
+#include <string>
+
+namespace mrpt::obs
+{
+/** Random-access, read-only reader of large, uncompressed rawlog files.
+ *
+ * Unlike CRawlog::loadFromRawLogFile(), which deserializes the whole dataset
+ * into memory, this class memory-maps the rawlog file and keeps only a
+ * compact index of the entries (file offset, size, class and timestamp of
+ * each serialized object). Objects are deserialized lazily, upon request,
+ * so memory usage does not depend on the dataset size and any entry can be
+ * accessed in O(1) by its index, or in O(log N) by its timestamp.
+ *
+ * The index is built the first time a file is opened, by means of a single
+ * sequential pass over the mapped file, and it is stored into a sidecar file
+ * (see indexFileFor()) so further openings of the same rawlog start
+ * instantly. The sidecar index is automatically rebuilt if the rawlog file
+ * changes (its size or modification time do not match those stored in the
+ * index), or if it cannot be parsed.
+ *
+ * Entries are classified exactly as in CRawlog::getType(). All objects in
+ * the file are indexed, including mrpt::obs::CObservationComment and
+ * non-observation objects, so entry indices match the order of objects in
+ * the file.
+ *
+ * Example:
+ * \code
+ * mrpt::obs::CRawlogMMapReader rawlog("dataset.rawlog");
+ * const size_t i = rawlog.findEntryByTimestamp(t);
+ * if (i < rawlog.size() &&
+ *     rawlog.getType(i) == mrpt::obs::CRawlog::etObservation)
+ * {
+ *    auto obs = rawlog.getAsObservation(i);
+ *    // ...
+ * }
+ * \endcode
+ *
+ * All `get*()` methods are const and can be safely called from several
+ * threads at once.
+ *
+ * \note Compressed (`.rawlog` files in gz format) rawlogs cannot be
+ *       memory-mapped, and will raise an exception in open(). Decompress
+ *       them first, e.g. with `gunzip -c in.rawlog > out.rawlog`.
+ *
+ * \note Rawlog files containing one single serialized CRawlog object
+ *       (instead of a sequence of observations) cannot be indexed either.
+ *
+ * \sa CRawlog
+ * \ingroup mrpt_obs_grp
+ * \note (New in MRPT 2.7.1)
+ */
+class CRawlogMMapReader
+{
+   public:
+	/** Default constructor; use open() to access a file. */
+	CRawlogMMapReader();
+	/** Constructor that calls open() with the given arguments. */
+	explicit CRawlogMMapReader(
+		const std::string& rawlogFile, bool useIndexFile = true);
+	~CRawlogMMapReader();
+
+	CRawlogMMapReader(const CRawlogMMapReader&) = delete;
+	CRawlogMMapReader& operator=(const CRawlogMMapReader&) = delete;
+
+	/** Maps the given rawlog file into memory and loads its index.
+	 *
+	 * \param[in] useIndexFile If true (default), the sidecar index file
+	 *  (indexFileFor()) is loaded if it exists and is up to date, or
+	 *  (re)built and saved otherwise. Failing to write it (e.g. read-only
+	 *  directories) is not an error. If false, the index is always built in
+	 *  memory and never saved.
+	 *
+	 * \exception std::exception On any error opening or mapping the file, if
+	 *  it is gz-compressed or if it contains a whole CRawlog object.
+	 */
+	void open(const std::string& rawlogFile, bool useIndexFile = true);
+
+	/** Unmaps the file and frees the index. Automatically called from the
+	 * destructor. */
+	void close();
+
+	/** Returns true if a rawlog file is currently mapped */
+	bool isOpen() const;
+
+	/** The name of the currently open rawlog file */
+	const std::string& filename() const;
+
+	/** Returns the number of entries (serialized objects) in the rawlog */
+	size_t size() const;
+	bool empty() const { return size() == 0; }
+
+	/** Returns the type of the given entry, without deserializing it */
+	CRawlog::TEntryType getType(size_t index) const;
+
+	/** Returns the timestamp of the given entry, without deserializing it.
+	 * For sensory frames and action collections, this is the timestamp of
+	 * their first element. INVALID_TIMESTAMP is returned for entries without
+	 * a timestamp. */
+	mrpt::system::TTimeStamp getTimestamp(size_t index) const;
+
+	/** Returns the class name of the given entry (e.g.
+	 * "mrpt::obs::CObservation2DRangeScan"), without deserializing it. */
+	const std::string& getClassName(size_t index) const;
+
+	/** Returns the offset of the entry in the rawlog file, in bytes */
+	uint64_t getEntryOffset(size_t index) const;
+
+	/** Returns the length of the serialized entry in the file, in bytes */
+	uint64_t getEntrySize(size_t index) const;
+
+	/** Returns the index of the first entry, in timestamp order, whose
+	 * timestamp is equal to or later than `t`, or size() if there is none.
+	 * Entries without a valid timestamp are never returned. */
+	size_t findEntryByTimestamp(const mrpt::system::TTimeStamp t) const;
+
+	/** Deserializes and returns the given entry, of any class. */
+	mrpt::serialization::CSerializable::Ptr getAsGeneric(size_t index) const;
+
+	/** Deserializes and returns the given entry, which must be of type
+	 * CRawlog::etObservation.
+	 * \exception std::exception If the entry is of a different type */
+	CObservation::Ptr getAsObservation(size_t index) const;
+
+	/** Deserializes and returns the given entry, which must be of type
+	 * CRawlog::etSensoryFrame.
+	 * \exception std::exception If the entry is of a different type */
+	CSensoryFrame::Ptr getAsObservations(size_t index) const;
+
+	/** Deserializes and returns the given entry, which must be of type
+	 * CRawlog::etActionCollection.
+	 * \exception std::exception If the entry is of a different type */
+	CActionCollection::Ptr getAsAction(size_t index) const;
+
+	/** Returns the name of the sidecar index file used for a given rawlog
+	 * file: the same file name with the extra extension `.idx` */
+	static std::string indexFileFor(const std::string& rawlogFile);
+
+   private:
+	struct Impl;
+	spimpl::unique_impl_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::obs
@@ -0,0 +1,404 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+//
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryMappedFile.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/obs/CRawlogMMapReader.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/filesystem.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <map>
+
+using namespace mrpt::obs;
+using namespace mrpt::io;
+using namespace mrpt::serialization;
+
+namespace
+{
+/** Signature and version of the sidecar index files */
+const char* const IDX_FILE_SIGNATURE = "MRPT_RAWLOG_INDEX";
+constexpr uint32_t IDX_FILE_VERSION = 1;
+
+CRawlog::TEntryType classifyEntry(const CSerializable& obj)
+{
+	const auto* cls = obj.GetRuntimeClass();
+	if (cls->derivedFrom(CLASS_ID(CObservation)))
+		return CRawlog::etObservation;
+	else if (cls == CLASS_ID(CActionCollection))
+		return CRawlog::etActionCollection;
+	else if (cls == CLASS_ID(CSensoryFrame))
+		return CRawlog::etSensoryFrame;
+	else
+		return CRawlog::etOther;
+}
+
+mrpt::system::TTimeStamp entryTimestamp(const CSerializable& obj)
+{
+	if (const auto* o = dynamic_cast<const CObservation*>(&obj); o)
+		return o->timestamp;
+	if (const auto* sf = dynamic_cast<const CSensoryFrame*>(&obj);
+		sf && sf->size() != 0)
+		return (*sf->begin())->timestamp;
+	if (const auto* acts = dynamic_cast<const CActionCollection*>(&obj);
+		acts && acts->size() != 0)
+		return acts->get(0).timestamp;
+	return INVALID_TIMESTAMP;
+}
+
+}  // namespace
+
+struct CRawlogMMapReader::Impl
+{
+	std::string fileName;
+	CMemoryMappedFile file;
+
+	/** Index, as a structure of arrays. `offsets` has one more element than
+	 * the number of entries, with the end of the last one. */
+	std::vector<int64_t> offsets;
+	std::vector<int64_t> timestamps;
+	std::vector<uint16_t> classIdx;
+	std::vector<uint8_t> types;
+	std::vector<std::string> classNames;
+
+	/** Indices of entries with a valid timestamp, sorted by timestamp */
+	std::vector<size_t> byTime;
+
+	size_t size() const { return types.size(); }
+
+	void clearIndex()
+	{
+		offsets.clear();
+		timestamps.clear();
+		classIdx.clear();
+		types.clear();
+		classNames.clear();
+		byTime.clear();
+	}
+
+	void checkIndex(size_t index) const
+	{
+		ASSERT_LT_(index, size());
+	}
+
+	void buildIndex();
+	bool loadIndex(const std::string& idxFile);
+	void saveIndex(const std::string& idxFile) const;
+	void buildTimeIndex();
+};
+
+void CRawlogMMapReader::Impl::buildIndex()
+{
+	clearIndex();
+	file.adviseSequential(true);
+
+	std::map<std::string, uint16_t> classToIdx;
+
+	CMemoryStream ms;
+	ms.assignMemoryNotOwn(file.data(), file.size());
+	auto arch = archiveFrom(ms);
+
+	offsets.push_back(0);
+	for (;;)
+	{
+		CSerializable::Ptr obj;
+		try
+		{
+			obj = arch.ReadObject();
+		}
+		catch (const CExceptionEOF&)
+		{  // EOF, just finish the loop
+			break;
+		}
+		catch (const std::exception& e)
+		{
+			// Truncated or corrupted file: index all entries read so far.
+			std::cerr << "[CRawlogMMapReader] Stopping indexing of `"
+					  << fileName << "` at offset " << offsets.back()
+					  << ":\n"
+					  << mrpt::exception_to_str(e) << std::endl;
+			break;
+		}
+
+		CRawlog::TEntryType type = CRawlog::etOther;
+		std::string className = "nullptr";
+		mrpt::system::TTimeStamp t = INVALID_TIMESTAMP;
+		if (obj)
+		{
+			if (IS_CLASS(*obj, CRawlog))
+				THROW_EXCEPTION_FMT(
+					"File `%s` contains a whole CRawlog object, which cannot "
+					"be indexed. Use CRawlog::loadFromRawLogFile() instead.",
+					fileName.c_str());
+
+			type = classifyEntry(*obj);
+			className = obj->GetRuntimeClass()->className;
+			t = entryTimestamp(*obj);
+		}
+
+		auto itCls = classToIdx.find(className);
+		if (itCls == classToIdx.end())
+		{
+			ASSERT_LT_(
+				classNames.size(), std::numeric_limits<uint16_t>::max());
+			itCls = classToIdx
+						.emplace(
+							className,
+							static_cast<uint16_t>(classNames.size()))
+						.first;
+			classNames.push_back(className);
+		}
+
+		offsets.push_back(static_cast<int64_t>(ms.getPosition()));
+		timestamps.push_back(t.time_since_epoch().count());
+		classIdx.push_back(itCls->second);
+		types.push_back(static_cast<uint8_t>(type));
+	}
+
+	file.adviseSequential(false);
+}
+
+bool CRawlogMMapReader::Impl::loadIndex(const std::string& idxFile)
+{
+	if (!mrpt::system::fileExists(idxFile)) return false;
+
+	clearIndex();
+	try
+	{
+		CFileInputStream f(idxFile);
+		auto arch = archiveFrom(f);
+
+		std::string signature;
+		uint32_t version = 0;
+		uint64_t rawlogSize = 0;
+		int64_t rawlogModTime = 0;
+		arch >> signature >> version >> rawlogSize >> rawlogModTime;
+		if (signature != IDX_FILE_SIGNATURE || version != IDX_FILE_VERSION ||
+			rawlogSize != file.size() ||
+			rawlogModTime !=
+				static_cast<int64_t>(
+					mrpt::system::getFileModificationTime(fileName)))
+			return false;
+
+		arch >> classNames >> offsets >> timestamps >> classIdx >> types;
+
+		// Sanity checks:
+		const size_t N = types.size();
+		bool ok = offsets.size() == N + 1 && timestamps.size() == N &&
+			classIdx.size() == N;
+		for (size_t i = 0; ok && i < N; i++)
+			ok = offsets[i] <= offsets[i + 1] &&
+				classIdx[i] < classNames.size() &&
+				types[i] <= static_cast<uint8_t>(CRawlog::etOther);
+		ok = ok && !offsets.empty() &&
+			static_cast<uint64_t>(offsets.back()) <= file.size();
+		if (!ok)
+		{
+			clearIndex();
+			return false;
+		}
+		return true;
+	}
+	catch (const std::exception&)
+	{
+		clearIndex();
+		return false;
+	}
+}
+
+void CRawlogMMapReader::Impl::saveIndex(const std::string& idxFile) const
+{
+	CFileOutputStream f;
+	if (!f.open(idxFile)) return;  // e.g. read-only directory
+
+	auto arch = archiveFrom(f);
+	arch << std::string(IDX_FILE_SIGNATURE) << IDX_FILE_VERSION
+		 << file.size()
+		 << static_cast<int64_t>(
+				mrpt::system::getFileModificationTime(fileName));
+	arch << classNames << offsets << timestamps << classIdx << types;
+}
+
+void CRawlogMMapReader::Impl::buildTimeIndex()
+{
+	const auto invalid = INVALID_TIMESTAMP.time_since_epoch().count();
+
+	byTime.clear();
+	for (size_t i = 0; i < timestamps.size(); i++)
+		if (timestamps[i] != invalid) byTime.push_back(i);
+
+	std::stable_sort(byTime.begin(), byTime.end(), [this](size_t a, size_t b) {
+		return timestamps[a] < timestamps[b];
+	});
+}
+
+CRawlogMMapReader::CRawlogMMapReader()
+	: m_impl(spimpl::make_unique_impl<Impl>())
+{
+}
+
+CRawlogMMapReader::CRawlogMMapReader(
+	const std::string& rawlogFile, bool useIndexFile)
+	: CRawlogMMapReader()
+{
+	open(rawlogFile, useIndexFile);
+}
+
+CRawlogMMapReader::~CRawlogMMapReader() { close(); }
+
+void CRawlogMMapReader::open(const std::string& rawlogFile, bool useIndexFile)
+{
+	MRPT_START
+
+	close();
+
+	auto& d = *m_impl;
+	d.fileName = rawlogFile;
+	try
+	{
+		d.file.open(rawlogFile);
+
+		// gzip signature:
+		const uint8_t* p = d.file.data();
+		if (d.file.size() >= 2 && p[0] == 0x1f && p[1] == 0x8b)
+			THROW_EXCEPTION_FMT(
+				"File `%s` is gz-compressed and cannot be memory-mapped. "
+				"Decompress it first.",
+				rawlogFile.c_str());
+
+		const std::string idxFile = indexFileFor(rawlogFile);
+		if (!useIndexFile || !d.loadIndex(idxFile))
+		{
+			d.buildIndex();
+			if (useIndexFile) d.saveIndex(idxFile);
+		}
+		d.buildTimeIndex();
+	}
+	catch (...)
+	{
+		close();
+		throw;
+	}
+
+	MRPT_END
+}
+
+void CRawlogMMapReader::close()
+{
+	m_impl->file.close();
+	m_impl->clearIndex();
+	m_impl->fileName.clear();
+}
+
+bool CRawlogMMapReader::isOpen() const { return !m_impl->fileName.empty(); }
+
+const std::string& CRawlogMMapReader::filename() const
+{
+	return m_impl->fileName;
+}
+
+size_t CRawlogMMapReader::size() const { return m_impl->size(); }
+
+CRawlog::TEntryType CRawlogMMapReader::getType(size_t index) const
+{
+	m_impl->checkIndex(index);
+	return static_cast<CRawlog::TEntryType>(m_impl->types[index]);
+}
+
+mrpt::system::TTimeStamp CRawlogMMapReader::getTimestamp(size_t index) const
+{
+	m_impl->checkIndex(index);
+	return mrpt::system::TTimeStamp(
+		mrpt::Clock::duration(m_impl->timestamps[index]));
+}
+
+const std::string& CRawlogMMapReader::getClassName(size_t index) const
+{
+	m_impl->checkIndex(index);
+	return m_impl->classNames[m_impl->classIdx[index]];
+}
+
+uint64_t CRawlogMMapReader::getEntryOffset(size_t index) const
+{
+	m_impl->checkIndex(index);
+	return static_cast<uint64_t>(m_impl->offsets[index]);
+}
+
+uint64_t CRawlogMMapReader::getEntrySize(size_t index) const
+{
+	m_impl->checkIndex(index);
+	return static_cast<uint64_t>(
+		m_impl->offsets[index + 1] - m_impl->offsets[index]);
+}
+
+size_t CRawlogMMapReader::findEntryByTimestamp(
+	const mrpt::system::TTimeStamp t) const
+{
+	const auto& d = *m_impl;
+	const int64_t tq = t.time_since_epoch().count();
+	const auto it = std::lower_bound(
+		d.byTime.begin(), d.byTime.end(), tq,
+		[&d](size_t i, int64_t v) { return d.timestamps[i] < v; });
+	return it == d.byTime.end() ? size() : *it;
+}
+
+CSerializable::Ptr CRawlogMMapReader::getAsGeneric(size_t index) const
+{
+	MRPT_START
+	const auto& d = *m_impl;
+	d.checkIndex(index);
+
+	CMemoryStream ms;
+	ms.assignMemoryNotOwn(
+		d.file.data() + d.offsets[index],
+		static_cast<uint64_t>(d.offsets[index + 1] - d.offsets[index]));
+	return archiveFrom(ms).ReadObject();
+	MRPT_END
+}
+
+CObservation::Ptr CRawlogMMapReader::getAsObservation(size_t index) const
+{
+	MRPT_START
+	ASSERTMSG_(
+		getType(index) == CRawlog::etObservation,
+		"Entry is not of type etObservation");
+	return std::dynamic_pointer_cast<CObservation>(getAsGeneric(index));
+	MRPT_END
+}
+
+CSensoryFrame::Ptr CRawlogMMapReader::getAsObservations(size_t index) const
+{
+	MRPT_START
+	ASSERTMSG_(
+		getType(index) == CRawlog::etSensoryFrame,
+		"Entry is not of type etSensoryFrame");
+	return std::dynamic_pointer_cast<CSensoryFrame>(getAsGeneric(index));
+	MRPT_END
+}
+
+CActionCollection::Ptr CRawlogMMapReader::getAsAction(size_t index) const
+{
+	MRPT_START
+	ASSERTMSG_(
+		getType(index) == CRawlog::etActionCollection,
+		"Entry is not of type etActionCollection");
+	return std::dynamic_pointer_cast<CActionCollection>(getAsGeneric(index));
+	MRPT_END
+}
+
+std::string CRawlogMMapReader::indexFileFor(const std::string& rawlogFile)
+{
+	return rawlogFile + std::string(".idx");
+}
@@ -0,0 +1,150 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          https://www.mrpt.org/                         |
+   |                                                                        |
+   | Copyright (c) 2005-2023, Individual contributors, see AUTHORS file     |
+   | See: https://www.mrpt.org/Authors - All rights reserved.               |
+   | Released under BSD License. See: https://www.mrpt.org/License          |
+   +------------------------------------------------------------------------+ */
+
+#include <gtest/gtest.h>
+#include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/obs/CObservationComment.h>
+#include <mrpt/obs/CObservationOdometry.h>
+#include <mrpt/obs/CRawlogMMapReader.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/filesystem.h>
+
+using namespace mrpt::obs;
+
+namespace
+{
+mrpt::system::TTimeStamp tsFromIndex(int i)
+{
+	return mrpt::Clock::fromDouble(1000.0 + 0.5 * i);
+}
+
+// Writes: 1 comment, then N x (odometry obs, sensory frame, action)
+void writeTestRawlog(const std::string& fil, int N)
+{
+	mrpt::io::CFileOutputStream f(fil);
+	auto arch = mrpt::serialization::archiveFrom(f);
+
+	CObservationComment comment;
+	comment.text = "test dataset";
+	arch << comment;
+
+	for (int i = 0; i < N; i++)
+	{
+		CObservationOdometry odo;
+		odo.timestamp = tsFromIndex(3 * i);
+		odo.odometry = mrpt::poses::CPose2D(i, 0, 0);
+		arch << odo;
+
+		CSensoryFrame sf;
+		auto o = CObservationOdometry::Create();
+		o->timestamp = tsFromIndex(3 * i + 1);
+		sf.insert(o);
+		arch << sf;
+
+		CActionCollection acts;
+		CActionRobotMovement2D act;
+		act.timestamp = tsFromIndex(3 * i + 2);
+		acts.insert(act);
+		arch << acts;
+	}
+}
+}  // namespace
+
+TEST(CRawlogMMapReader, readAndIndex)
+{
+	const std::string fil = mrpt::system::getTempFileName() + ".rawlog";
+	const std::string idxFil = CRawlogMMapReader::indexFileFor(fil);
+	const int N = 20;
+	writeTestRawlog(fil, N);
+	mrpt::system::deleteFile(idxFil);
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		// 1st pass builds the index, 2nd one reuses it:
+		CRawlogMMapReader r(fil);
+		EXPECT_TRUE(mrpt::system::fileExists(idxFil));
+		ASSERT_TRUE(r.isOpen());
+		ASSERT_EQ(r.size(), 1U + 3U * N);
+
+		EXPECT_EQ(r.getType(0), CRawlog::etObservation);
+		EXPECT_EQ(r.getClassName(0), "mrpt::obs::CObservationComment");
+		EXPECT_EQ(r.getEntryOffset(0), 0U);
+
+		for (int i = 0; i < N; i++)
+		{
+			const size_t idx = 1 + 3 * i;
+			EXPECT_EQ(r.getType(idx), CRawlog::etObservation);
+			EXPECT_EQ(r.getType(idx + 1), CRawlog::etSensoryFrame);
+			EXPECT_EQ(r.getType(idx + 2), CRawlog::etActionCollection);
+			for (int k = 0; k < 3; k++)
+				EXPECT_EQ(r.getTimestamp(idx + k), tsFromIndex(3 * i + k));
+			EXPECT_EQ(
+				r.getEntryOffset(idx),
+				r.getEntryOffset(idx - 1) + r.getEntrySize(idx - 1));
+		}
+
+		// Random access, in reverse order:
+		for (int i = N - 1; i >= 0; i--)
+		{
+			const size_t idx = 1 + 3 * i;
+			auto odo = std::dynamic_pointer_cast<CObservationOdometry>(
+				r.getAsObservation(idx));
+			ASSERT_TRUE(odo);
+			EXPECT_NEAR(odo->odometry.x(), i, 1e-9);
+
+			auto sf = r.getAsObservations(idx + 1);
+			ASSERT_TRUE(sf);
+			EXPECT_EQ(sf->size(), 1U);
+
+			auto acts = r.getAsAction(idx + 2);
+			ASSERT_TRUE(acts);
+			EXPECT_EQ(acts->size(), 1U);
+		}
+		EXPECT_ANY_THROW(r.getAsObservation(2));
+		EXPECT_ANY_THROW(r.getType(r.size()));
+
+		// Seek by timestamp:
+		EXPECT_EQ(r.findEntryByTimestamp(tsFromIndex(0)), 1U);
+		EXPECT_EQ(r.findEntryByTimestamp(tsFromIndex(7)), 1U + 7U);
+		EXPECT_EQ(
+			r.findEntryByTimestamp(
+				tsFromIndex(7) - std::chrono::milliseconds(100)),
+			1U + 7U);
+		EXPECT_EQ(r.findEntryByTimestamp(tsFromIndex(3 * N)), r.size());
+	}
+
+	// A stale index is detected and rebuilt:
+	writeTestRawlog(fil, N / 2);
+	{
+		CRawlogMMapReader r(fil);
+		EXPECT_EQ(r.size(), 1U + 3U * (N / 2));
+	}
+
+	mrpt::system::deleteFile(fil);
+	mrpt::system::deleteFile(idxFil);
+}
+
+TEST(CRawlogMMapReader, rejectsCompressedFiles)
+{
+	const std::string fil = mrpt::system::getTempFileName() + ".rawlog";
+	{
+		mrpt::io::CFileGZOutputStream f(fil);
+		auto arch = mrpt::serialization::archiveFrom(f);
+		CObservationComment comment;
+		arch << comment;
+	}
+
+	CRawlogMMapReader r;
+	EXPECT_ANY_THROW(r.open(fil, false));
+	EXPECT_FALSE(r.isOpen());
+
+	mrpt::system::deleteFile(fil);
+}
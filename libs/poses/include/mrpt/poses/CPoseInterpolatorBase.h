@@ -9,11 +9,15 @@
 #pragma once
 
 #include <mrpt/core/Clock.h>
+#include <mrpt/core/exceptions.h>
 #include <mrpt/poses/Lie/Euclidean.h>
 #include <mrpt/poses/Lie/SE.h>
 #include <mrpt/poses/poses_frwds.h>
 #include <mrpt/typemeta/TEnumType.h>
 
+#include <map>
+#include <vector>
+
 namespace mrpt::poses
 {
 /** Type to select the interpolation method in CPoseInterpolatorBase derived
@@ -54,6 +58,8 @@ class CPoseInterpolatorBase
 	CPoseInterpolatorBase();
 
 	/** @name Type definitions and STL-like container interface
+	 * These methods give access to the default std::map storage only, and
+	 * must not be used after setFlatStorage(true). See flatPath().
 	 * @{ */
 
 	/** TPose2D or TPose3D */
@@ -70,51 +76,90 @@ class CPoseInterpolatorBase
 	using reverse_iterator = typename TPath::reverse_iterator;
 	using const_reverse_iterator = typename TPath::const_reverse_iterator;
 
-	inline iterator begin() { return m_path.begin(); }
-	inline const_iterator begin() const { return m_path.begin(); }
-	inline const_iterator cbegin() const { return m_path.cbegin(); }
-	inline iterator end() { return m_path.end(); }
-	inline const_iterator end() const { return m_path.end(); }
-	inline const_iterator cend() const { return m_path.cend(); }
-	inline reverse_iterator rbegin() { return m_path.rbegin(); }
-	inline const_reverse_iterator rbegin() const { return m_path.rbegin(); }
-	inline reverse_iterator rend() { return m_path.rend(); }
-	inline const_reverse_iterator rend() const { return m_path.rend(); }
+	inline iterator begin() { return mapPath().begin(); }
+	inline const_iterator begin() const { return mapPath().begin(); }
+	inline const_iterator cbegin() const { return mapPath().cbegin(); }
+	inline iterator end() { return mapPath().end(); }
+	inline const_iterator end() const { return mapPath().end(); }
+	inline const_iterator cend() const { return mapPath().cend(); }
+	inline reverse_iterator rbegin() { return mapPath().rbegin(); }
+	inline const_reverse_iterator rbegin() const { return mapPath().rbegin(); }
+	inline reverse_iterator rend() { return mapPath().rend(); }
+	inline const_reverse_iterator rend() const { return mapPath().rend(); }
 	iterator lower_bound(const mrpt::Clock::time_point& t)
 	{
-		return m_path.lower_bound(t);
+		return mapPath().lower_bound(t);
 	}
 	const_iterator lower_bound(const mrpt::Clock::time_point& t) const
 	{
-		return m_path.lower_bound(t);
+		return mapPath().lower_bound(t);
 	}
 
 	iterator upper_bound(const mrpt::Clock::time_point& t)
 	{
-		return m_path.upper_bound(t);
+		return mapPath().upper_bound(t);
 	}
 	const_iterator upper_bound(const mrpt::Clock::time_point& t) const
 	{
-		return m_path.upper_bound(t);
+		return mapPath().upper_bound(t);
 	}
 
 	iterator erase(iterator element_to_erase)
 	{
-		m_path.erase(element_to_erase++);
+		mapPath().erase(element_to_erase++);
 		return element_to_erase;
 	}
 
-	size_t size() const { return m_path.size(); }
-	bool empty() const { return m_path.empty(); }
-	iterator find(const mrpt::Clock::time_point& t) { return m_path.find(t); }
+	size_t size() const
+	{
+		return m_flat_storage ? m_flat_path.size() : m_path.size();
+	}
+	bool empty() const { return size() == 0; }
+	iterator find(const mrpt::Clock::time_point& t)
+	{
+		return mapPath().find(t);
+	}
 	const_iterator find(const mrpt::Clock::time_point& t) const
 	{
-		return m_path.find(t);
+		return mapPath().find(t);
 	}
-	pose_t& at(const mrpt::Clock::time_point& t) { return m_path.at(t); }
+	pose_t& at(const mrpt::Clock::time_point& t) { return mapPath().at(t); }
 	const pose_t& at(const mrpt::Clock::time_point& t) const
 	{
-		return m_path.at(t);
+		return mapPath().at(t);
+	}
+	/** @} */
+
+	/** @name Storage backend
+	 * @{ */
+
+	/** Selects how the sequence of poses is stored: in a std::map (default),
+	 * or in one contiguous std::vector sorted by time ("flat" storage).
+	 *
+	 * Flat storage takes much less memory and is faster to search, which pays
+	 * off for long paths with many high-rate poses (e.g. IMU or odometry
+	 * ground truth). Poses inserted in time order are appended in amortized
+	 * constant time, but inserting in the middle of the path is O(N).
+	 *
+	 * The existing poses are moved to the new storage. In flat mode, the
+	 * STL-like interface above (iterators, find(), at(), erase()...) is not
+	 * available: use flatPath() instead.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void setFlatStorage(bool flat);
+	/** \sa setFlatStorage() */
+	bool isFlatStorage() const { return m_flat_storage; }
+
+	/** The sequence of poses, sorted by time, if flat storage is enabled
+	 * (empty otherwise). \sa setFlatStorage()
+	 * \note (New in MRPT 2.7.1) */
+	const std::vector<TTimePosePair>& flatPath() const { return m_flat_path; }
+
+	/** Reserves memory for `n` poses, in flat storage mode only.
+	 * \note (New in MRPT 2.7.1) */
+	void reserve(size_t n)
+	{
+		if (m_flat_storage) m_flat_path.reserve(n);
 	}
 	/** @} */
 
@@ -141,6 +186,21 @@ class CPoseInterpolatorBase
 		const mrpt::Clock::time_point& t, cpose_t& out_interp,
 		bool& out_valid_interp) const;
 
+	/** Interpolates the path at a sequence of times sorted in ascending order,
+	 * e.g. the timestamps of the points of one lidar scan, for deskewing.
+	 * The result is the same as calling interpolate() for each time, but
+	 * each search starts at the position found for the previous query time.
+	 * \param ts The query times, in ascending order.
+	 * \param out_interp The output interpolated poses, one per query time.
+	 * \param out_valid_interp Whether each pose could be interpolated.
+	 * \exception std::exception If the query times are not sorted.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void interpolate(
+		const std::vector<mrpt::Clock::time_point>& ts,
+		std::vector<pose_t>& out_interp,
+		std::vector<bool>& out_valid_interp) const;
+
 	/** Clears the current sequence of poses */
 	void clear();
 
@@ -203,8 +263,25 @@ class CPoseInterpolatorBase
 	void filter(unsigned int component, unsigned int samples);
 
    protected:
-	/** The sequence of poses */
+	/** The sequence of poses (default storage) */
 	TPath m_path;
+
+	/** m_path, for the STL-like interface, which is not available in flat
+	 * storage mode */
+	TPath& mapPath()
+	{
+		ASSERTMSG_(
+			!m_flat_storage,
+			"This method is not available with flat storage, see flatPath()");
+		return m_path;
+	}
+	const TPath& mapPath() const
+	{
+		return const_cast<CPoseInterpolatorBase*>(this)->mapPath();
+	}
+	/** The sequence of poses, sorted by time (flat storage) */
+	std::vector<TTimePosePair> m_flat_path;
+	bool m_flat_storage = false;
 	/** Maximum time considered to interpolate. If the difference between the
 	 * desired timestamp where to interpolate and the next timestamp stored in
 	 * the map is bigger than this value, the interpolation will not be done. */
@@ -217,6 +294,17 @@ class CPoseInterpolatorBase
 		const TInterpolatorMethod method, const mrpt::Clock::time_point& td,
 		pose_t& out_interp) const;
 
+	/** Interpolates at time `t`, given the first path element with a time
+	 * equal or greater than `t` */
+	template <typename It>
+	void impl_interpolate_at(
+		It it_ge1, It first, It last, const mrpt::Clock::time_point& t,
+		pose_t& out_interp, bool& out_valid_interp) const;
+
+	/** Index of the first element in m_flat_path with a time equal or greater
+	 * than `t`, searching (exponentially) forward from index `hint`. */
+	size_t flatLowerBound(const mrpt::Clock::time_point& t, size_t hint) const;
+
 };	// End of class def.
 }  // namespace mrpt::poses
 MRPT_ENUM_TYPE_BEGIN(mrpt::poses::TInterpolatorMethod)
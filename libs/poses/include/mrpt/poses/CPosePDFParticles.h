@@ -131,6 +131,13 @@ class CPosePDFParticles : public CPosePDF,
 	 */
 	void drawSingleSample(CPose2D& outPart) const override;
 
+	/** \overload Draws the sample with the given random generator instead
+	 * of the global one.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void drawSingleSample(
+		CPose2D& outPart, mrpt::random::CRandomGenerator& rng) const;
+
 	/** Appends (pose-composition) a given pose "p" to each particle
 	 */
 	void operator+=(const mrpt::math::TPose2D& Ap);
@@ -8,11 +8,17 @@
    +------------------------------------------------------------------------+ */
 #pragma once
 
+#include <mrpt/poses/CPose2DInterpolator.h>
+#include <mrpt/poses/CPose3DInterpolator.h>
 #include <mrpt/poses/Lie/SE.h>
 #include <mrpt/system/datetime.h>
 
-#include <map>
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace mrpt::poses
 {
@@ -82,6 +88,22 @@ class FrameTransformerInterface
 
 /** See docs in FrameTransformerInterface.
  *   This class is an implementation for standalone (non ROS) applications.
+ *
+ * Frames form a tree: each frame has at most one parent, the one given in
+ * the last sendTransform() where it was the child. Each edge keeps a
+ * time-buffered history of poses (see setBufferDuration()) in a
+ * CPose2DInterpolator or CPose3DInterpolator, so lookupTransform() can
+ * compose and interpolate the transform between any two connected frames
+ * at past timestamps. Edges with one single pose are considered static, i.e.
+ * valid at any time.
+ *
+ * Frame names are interned into integer IDs (see frameId()), and the chain of
+ * edges between each pair of frames is cached, so lookups by ID neither
+ * compare strings nor search the tree. Lookups of the latest transforms are
+ * also cached until the next sendTransform().
+ *
+ * All methods are thread-safe.
+ *
  * \ingroup poses_grp
  * \sa FrameTransformerInterface
  */
@@ -90,6 +112,12 @@ class FrameTransformer : public FrameTransformerInterface<DIM>
 {
    public:
 	using base_t = FrameTransformerInterface<DIM>;
+	/** Integer ID of an interned frame name */
+	using frame_id_t = uint32_t;
+	/** CPose2DInterpolator (DIM=2) or CPose3DInterpolator (DIM=3) */
+	using interpolator_t = std::conditional_t<
+		DIM == 2, mrpt::poses::CPose2DInterpolator,
+		mrpt::poses::CPose3DInterpolator>;
 
 	FrameTransformer();
 	~FrameTransformer() override;
@@ -122,30 +150,83 @@ class FrameTransformer : public FrameTransformerInterface<DIM>
 		return ret;
 	}
 
+	/** @name Faster API with interned frame IDs
+	 * \note (New in MRPT 2.7.1)
+	 * @{ */
+
+	/** Returns the ID of a frame, registering it if it did not exist yet */
+	frame_id_t frameId(const std::string& frame_name);
+	/** Returns the name of a frame from its ID */
+	std::string frameName(frame_id_t id) const;
+
+	/** \overload with frame IDs */
+	void sendTransform(
+		frame_id_t parent_frame, frame_id_t child_frame,
+		const typename base_t::pose_t& child_wrt_parent,
+		const mrpt::system::TTimeStamp& timestamp = mrpt::system::now());
+
+	/** \overload with frame IDs. Returns LKUP_EXTRAPOLATION_ERROR if
+	 * `query_time` is out of the time span buffered for any edge. */
+	FrameLookUpStatus lookupTransform(
+		frame_id_t target_frame, frame_id_t source_frame,
+		typename base_t::light_type& child_wrt_parent,
+		const mrpt::system::TTimeStamp query_time = INVALID_TIMESTAMP);
+
+	/** @} */
+
+	/** Sets the time span of poses kept for each edge, before its latest
+	 * pose [s] (Default: 10 s).
+	 * \note (New in MRPT 2.7.1) */
+	void setBufferDuration(double seconds);
+	double getBufferDuration() const;
+
+	/** Sets the interpolation method for all edges (Default: imLinearSlerp)
+	 * \note (New in MRPT 2.7.1) */
+	void setInterpolationMethod(TInterpolatorMethod method);
+
    protected:
-	// double m_max_extrapolation_time;  //!< for extrapolation in the past or
-	// in the future [s]
-	// double m_max_age_pose_cache;      //!< Max age of stored poses [s]
+	static constexpr frame_id_t INVALID_FRAME = static_cast<frame_id_t>(-1);
 
+	/** The edge from a frame to its parent */
 	struct TF_TreeEdge
 	{
-		// TODO: CPose{2,3}DInterpolator?
-		typename base_t::pose_t pose;
-		mrpt::system::TTimeStamp timestamp;
-
-		TF_TreeEdge(
-			const typename base_t::pose_t& pose_,
-			const mrpt::system::TTimeStamp& timestamp_)
-			: pose(pose_), timestamp(timestamp_)
-		{
-		}
-		TF_TreeEdge() : timestamp(INVALID_TIMESTAMP) {}
+		frame_id_t parent = INVALID_FRAME;
+		/** Buffered poses of the child wrt the parent */
+		interpolator_t poses;
 	};
 
-	// map: [parent] -> { [child] -> relPoseChildWRTParent }
-	using pose_tree_t =
-		std::map<std::string, std::map<std::string, TF_TreeEdge>>;
-	pose_tree_t m_pose_edges_buffer;
+	/** Edges of the tree from each child to its parent, in the order of
+	 * chains from the source and target frames up to their common ancestor.
+	 */
+	struct TF_Path
+	{
+		bool connected = false;
+		std::vector<frame_id_t> up_source, up_target;
+	};
+
+	mutable std::mutex m_mtx;
+	std::unordered_map<std::string, frame_id_t> m_frame_ids;
+	std::vector<std::string> m_frame_names;
+	/** Indexed by child frame ID */
+	std::vector<TF_TreeEdge> m_edges;
+	double m_buffer_duration = 10.0;
+	TInterpolatorMethod m_method = mrpt::poses::imLinearSlerp;
+
+	/** Key: (target<<32 | source) */
+	std::unordered_map<uint64_t, TF_Path> m_path_cache;
+	std::unordered_map<uint64_t, typename base_t::light_type>
+		m_latest_cache;
+
+	frame_id_t internal_frameId(const std::string& frame_name);
+	const TF_Path& internal_path(frame_id_t target, frame_id_t source);
+	/** Pose of the child in edge `e` at time `t`, false if not available */
+	bool internal_edgePose(
+		const TF_TreeEdge& e, const mrpt::system::TTimeStamp& t,
+		typename base_t::pose_t& pose) const;
+	FrameLookUpStatus internal_lookup(
+		frame_id_t target, frame_id_t source,
+		typename base_t::light_type& child_wrt_parent,
+		const mrpt::system::TTimeStamp& query_time);
 };
 
 }  // namespace mrpt::poses
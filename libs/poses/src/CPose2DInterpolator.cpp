@@ -23,11 +23,14 @@ IMPLEMENTS_SERIALIZABLE(CPose2DInterpolator, CSerializable, mrpt::poses)
 uint8_t CPose2DInterpolator::serializeGetVersion() const { return 0; }
 void CPose2DInterpolator::serializeTo(mrpt::serialization::CArchive& out) const
 {
-	out << m_path;
+	if (isFlatStorage()) out << TPath(m_flat_path.begin(), m_flat_path.end());
+	else
+		out << m_path;
 }
 void CPose2DInterpolator::serializeFrom(
 	mrpt::serialization::CArchive& in, uint8_t version)
 {
+	clear();
 	switch (version)
 	{
 		case 0:
@@ -37,6 +40,8 @@ void CPose2DInterpolator::serializeFrom(
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
 	};
+	// Move to the flat vector, if that storage is selected:
+	setFlatStorage(isFlatStorage());
 }
 
 namespace mrpt::poses
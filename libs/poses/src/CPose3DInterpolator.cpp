@@ -23,11 +23,14 @@ IMPLEMENTS_SERIALIZABLE(CPose3DInterpolator, CSerializable, mrpt::poses)
 uint8_t CPose3DInterpolator::serializeGetVersion() const { return 1; }
 void CPose3DInterpolator::serializeTo(mrpt::serialization::CArchive& out) const
 {
-	out << m_path;	// v1: change container element CPose3D->TPose3D
+	if (isFlatStorage()) out << TPath(m_flat_path.begin(), m_flat_path.end());
+	else
+		out << m_path;	// v1: change container element CPose3D->TPose3D
 }
 void CPose3DInterpolator::serializeFrom(
 	mrpt::serialization::CArchive& in, uint8_t version)
 {
+	clear();
 	switch (version)
 	{
 		case 0:
@@ -48,6 +51,8 @@ void CPose3DInterpolator::serializeFrom(
 		break;
 		default: MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
 	};
+	// Move to the flat vector, if that storage is selected:
+	setFlatStorage(isFlatStorage());
 }
 
 namespace mrpt::poses
@@ -52,3 +52,100 @@ TEST(CPose3DInterpolator, interp)
 			.sum(),
 		2e-4);
 }
+
+TEST(CPose3DInterpolator, flatStorageAndBatchInterp)
+{
+	using namespace mrpt::poses;
+	using mrpt::math::TPose3D;
+
+	const auto t0 = mrpt::Clock::now();
+	const mrpt::Clock::duration dt(std::chrono::milliseconds(10));
+
+	CPose3DInterpolator path_map, path_flat;
+	path_flat.setFlatStorage(true);
+	EXPECT_TRUE(path_flat.isFlatStorage());
+
+	// Insert in time order, except for a few poses:
+	const auto poseAt = [](int i) {
+		return TPose3D(0.1 * i, 0.01 * i * i, 0.5, 0.02 * i, 0.01 * i, 0);
+	};
+	for (int i = 0; i < 100; i++)
+	{
+		if (i == 50) continue;
+		path_map.insert(t0 + i * dt, poseAt(i));
+		path_flat.insert(t0 + i * dt, poseAt(i));
+	}
+	path_map.insert(t0 + 50 * dt, poseAt(50));
+	path_flat.insert(t0 + 50 * dt, poseAt(50));
+	// Overwrite:
+	path_map.insert(t0 + 7 * dt, poseAt(8));
+	path_flat.insert(t0 + 7 * dt, poseAt(8));
+
+	EXPECT_EQ(path_flat.size(), 100U);
+	EXPECT_EQ(path_flat.flatPath().size(), 100U);
+	// The std::map interface is not available in flat mode:
+	EXPECT_ANY_THROW(path_flat.begin());
+	EXPECT_ANY_THROW(path_flat.find(t0));
+	for (size_t i = 1; i < path_flat.flatPath().size(); i++)
+		EXPECT_LT(
+			path_flat.flatPath()[i - 1].first, path_flat.flatPath()[i].first);
+
+	for (const auto method : {imLinearSlerp, imSpline})
+	{
+		path_map.setInterpolationMethod(method);
+		path_flat.setInterpolationMethod(method);
+
+		// Query times, sorted, including out-of-range ones:
+		std::vector<mrpt::Clock::time_point> ts;
+		for (int i = -5; i < 1050; i += 3)
+			ts.push_back(t0 + i * dt / 10);
+
+		std::vector<TPose3D> batch_map, batch_flat;
+		std::vector<bool> valid_map, valid_flat;
+		path_map.interpolate(ts, batch_map, valid_map);
+		path_flat.interpolate(ts, batch_flat, valid_flat);
+		ASSERT_EQ(batch_map.size(), ts.size());
+		ASSERT_EQ(batch_flat.size(), ts.size());
+
+		for (size_t i = 0; i < ts.size(); i++)
+		{
+			TPose3D p;
+			bool valid;
+			path_map.interpolate(ts[i], p, valid);
+			EXPECT_EQ(valid, valid_map[i]);
+			EXPECT_EQ(valid, valid_flat[i]);
+			if (!valid) continue;
+			for (int k = 0; k < 6; k++)
+			{
+				EXPECT_DOUBLE_EQ(p[k], batch_map[i][k]);
+				EXPECT_DOUBLE_EQ(p[k], batch_flat[i][k]);
+			}
+		}
+		EXPECT_FALSE(valid_flat.front());
+		EXPECT_TRUE(valid_flat[10]);
+		EXPECT_FALSE(valid_flat.back());
+	}
+
+	TPose3D prev_map, prev_flat;
+	EXPECT_TRUE(
+		path_map.getPreviousPoseWithMinDistance(t0 + 60 * dt, 1.0, prev_map));
+	EXPECT_TRUE(
+		path_flat.getPreviousPoseWithMinDistance(t0 + 60 * dt, 1.0, prev_flat));
+	EXPECT_EQ(prev_map, prev_flat);
+
+	// Back to the default storage:
+	path_flat.setFlatStorage(false);
+	EXPECT_TRUE(path_flat.flatPath().empty());
+	ASSERT_EQ(path_flat.size(), path_map.size());
+	EXPECT_TRUE(std::equal(
+		path_flat.begin(), path_flat.end(), path_map.begin(),
+		[](const auto& a, const auto& b) {
+			return a.first == b.first && a.second == b.second;
+		}));
+
+	// Unsorted query times:
+	std::vector<TPose3D> out;
+	std::vector<bool> valid;
+	EXPECT_ANY_THROW(
+		path_flat.interpolate({t0 + 2 * dt, t0 + dt}, out, valid));
+}
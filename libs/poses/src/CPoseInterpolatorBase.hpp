@@ -19,6 +19,7 @@
 #include <mrpt/serialization/stl_serialization.h>
 #include <mrpt/system/datetime.h>
 
+#include <algorithm>
 #include <fstream>
 #include <mrpt/math/interp_fit.hpp>
 
@@ -35,19 +36,76 @@ template <int DIM>
 void CPoseInterpolatorBase<DIM>::clear()
 {
 	m_path.clear();
+	m_flat_path.clear();
 }
 
 template <int DIM>
 void CPoseInterpolatorBase<DIM>::insert(
 	const mrpt::Clock::time_point& t, const cpose_t& p)
 {
-	m_path[t] = p.asTPose();
+	insert(t, p.asTPose());
 }
 template <int DIM>
 void CPoseInterpolatorBase<DIM>::insert(
 	const mrpt::Clock::time_point& t, const pose_t& p)
 {
-	m_path[t] = p;
+	if (!m_flat_storage)
+	{
+		m_path[t] = p;
+		return;
+	}
+	// Fast path: appending in time order
+	if (m_flat_path.empty() || m_flat_path.back().first < t)
+	{
+		m_flat_path.emplace_back(t, p);
+		return;
+	}
+	const size_t idx = flatLowerBound(t, 0);
+	if (m_flat_path[idx].first == t) m_flat_path[idx].second = p;
+	else
+		m_flat_path.emplace(m_flat_path.begin() + idx, t, p);
+}
+
+template <int DIM>
+void CPoseInterpolatorBase<DIM>::setFlatStorage(bool flat)
+{
+	if (flat && !m_path.empty())
+	{
+		m_flat_path.assign(m_path.begin(), m_path.end());
+		m_path.clear();
+	}
+	else if (!flat && !m_flat_path.empty())
+	{
+		m_path = TPath(m_flat_path.begin(), m_flat_path.end());
+		m_flat_path.clear();
+		m_flat_path.shrink_to_fit();
+	}
+	m_flat_storage = flat;
+}
+
+template <int DIM>
+size_t CPoseInterpolatorBase<DIM>::flatLowerBound(
+	const mrpt::Clock::time_point& t, size_t hint) const
+{
+	const size_t N = m_flat_path.size();
+	if (hint >= N) return N;
+	if (m_flat_path[hint].first >= t) return hint;
+
+	// Exponential search for a range [lo,hi) with the answer, then bisect it:
+	size_t lo = hint + 1, step = 1, hi = lo;
+	while (hi < N && m_flat_path[hi].first < t)
+	{
+		lo = hi + 1;
+		hi += step;
+		step *= 2;
+	}
+	hi = std::min(hi, N);
+	const auto it = std::lower_bound(
+		m_flat_path.begin() + lo, m_flat_path.begin() + hi, t,
+		[](const TTimePosePair& e, const mrpt::Clock::time_point& tq) {
+			return e.first < tq;
+		});
+	return static_cast<size_t>(it - m_flat_path.begin());
 }
 
 /*---------------------------------------------------------------
@@ -70,6 +128,72 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 	CPoseInterpolatorBase<DIM>::interpolate(
 		const mrpt::Clock::time_point& t, pose_t& out_interp,
 		bool& out_valid_interp) const
+{
+	if (m_flat_storage)
+	{
+		const auto first = m_flat_path.begin(), last = m_flat_path.end();
+		impl_interpolate_at(
+			first + flatLowerBound(t, 0), first, last, t, out_interp,
+			out_valid_interp);
+	}
+	else
+	{
+		impl_interpolate_at(
+			m_path.lower_bound(t), m_path.begin(), m_path.end(), t,
+			out_interp, out_valid_interp);
+	}
+	return out_interp;
+}
+
+template <int DIM>
+void CPoseInterpolatorBase<DIM>::interpolate(
+	const std::vector<mrpt::Clock::time_point>& ts,
+	std::vector<pose_t>& out_interp, std::vector<bool>& out_valid_interp) const
+{
+	MRPT_START
+	ASSERTMSG_(
+		std::is_sorted(ts.begin(), ts.end()),
+		"Query times must be sorted in ascending order");
+
+	const size_t N = ts.size();
+	out_interp.resize(N);
+	out_valid_interp.resize(N);
+
+	size_t hint = 0;
+	auto it_map = m_path.begin();
+	for (size_t i = 0; i < N; i++)
+	{
+		const auto& t = ts[i];
+		bool valid = false;
+		if (m_flat_storage)
+		{
+			hint = flatLowerBound(t, hint);
+			impl_interpolate_at(
+				m_flat_path.begin() + hint, m_flat_path.begin(),
+				m_flat_path.end(), t, out_interp[i], valid);
+		}
+		else
+		{
+			// Walk forward a few elements before falling back to a search
+			// in the whole tree:
+			const auto last = m_path.end();
+			for (int k = 0; k < 8 && it_map != last && it_map->first < t; k++)
+				++it_map;
+			if (it_map != last && it_map->first < t)
+				it_map = m_path.lower_bound(t);
+			impl_interpolate_at(
+				it_map, m_path.begin(), last, t, out_interp[i], valid);
+		}
+		out_valid_interp[i] = valid;
+	}
+	MRPT_END
+}
+
+template <int DIM>
+template <typename It>
+void CPoseInterpolatorBase<DIM>::impl_interpolate_at(
+	It it_ge1, It first, It last, const mrpt::Clock::time_point& t,
+	pose_t& out_interp, bool& out_valid_interp) const
 {
 	// Default value in case of invalid interp
 	for (size_t k = 0; k < pose_t::static_size; k++)
@@ -91,33 +215,30 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 		default: interp_method_requires_4pts = true; break;
 	};
 
-	// Out of range?
-	auto it_ge1 = m_path.lower_bound(t);
-
 	// Exact match?
-	if (it_ge1 != m_path.end() && it_ge1->first == t)
+	if (it_ge1 != last && it_ge1->first == t)
 	{
 		out_interp = it_ge1->second;
 		out_valid_interp = true;
-		return out_interp;
+		return;
 	}
 
 	// Are we in the beginning or the end of the path?
-	if (it_ge1 == m_path.end() || it_ge1 == m_path.begin())
+	if (it_ge1 == last || it_ge1 == first)
 	{
 		out_valid_interp = false;
-		return out_interp;
+		return;
 	}  // end
 
 	p3 = *it_ge1;  // Third pair
 	auto it_ge2 = it_ge1;
 	++it_ge2;
-	if (it_ge2 == m_path.end())
+	if (it_ge2 == last)
 	{
 		if (interp_method_requires_4pts)
 		{
 			out_valid_interp = false;
-			return out_interp;
+			return;
 		}
 	}
 	else
@@ -127,12 +248,12 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 
 	p2 = *(--it_ge1);  // Second pair
 
-	if (it_ge1 == m_path.begin())
+	if (it_ge1 == first)
 	{
 		if (interp_method_requires_4pts)
 		{
 			out_valid_interp = false;
-			return out_interp;
+			return;
 		}
 	}
 	else
@@ -155,7 +276,7 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 		 dt34 > maxTimeInterpolation))
 	{
 		out_valid_interp = false;
-		return out_interp;
+		return;
 	}
 
 	// Do interpolation:
@@ -169,8 +290,6 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 	impl_interpolation(p1, p2, p3, p4, m_method, t, out_interp);
 
 	out_valid_interp = true;
-	return out_interp;
-
 }  // end interpolate
 
 template <int DIM>
@@ -187,30 +306,35 @@ template <int DIM>
 bool CPoseInterpolatorBase<DIM>::getPreviousPoseWithMinDistance(
 	const mrpt::Clock::time_point& t, double distance, pose_t& out_pose)
 {
-	if (m_path.size() == 0 || distance <= 0) return false;
+	if (empty() || distance <= 0) return false;
 
-	pose_t myPose;
+	// Search for the desired timestamp, then walk backwards:
+	const auto impl = [&](auto it, auto first, auto last) {
+		if (it == last || it == first || it->first != t) return false;
+		const pose_t myPose = it->second;
 
-	// Search for the desired timestamp
-	auto it = m_path.find(t);
-	if (it != m_path.end() && it != m_path.begin()) myPose = it->second;
-	else
-		return false;
+		double d = 0.0;
+		do
+		{
+			--it;
+			d = (point_t(myPose) - point_t(it->second)).norm();
+		} while (d < distance && it != first);
 
-	double d = 0.0;
-	do
-	{
-		--it;
-		d = (point_t(myPose) - point_t(it->second)).norm();
-	} while (d < distance && it != m_path.begin());
+		if (d >= distance)
+		{
+			out_pose = it->second;
+			return true;
+		}
+		else
+			return false;
+	};
 
-	if (d >= distance)
-	{
-		out_pose = it->second;
-		return true;
-	}
+	if (m_flat_storage)
+		return impl(
+			m_flat_path.cbegin() + flatLowerBound(t, 0), m_flat_path.cbegin(),
+			m_flat_path.cend());
 	else
-		return false;
+		return impl(m_path.find(t), m_path.cbegin(), m_path.cend());
 }  // end getPreviousPose
 
 template <int DIM>
@@ -235,19 +359,24 @@ bool CPoseInterpolatorBase<DIM>::saveToTextFile(const std::string& s) const
 		std::ofstream f;
 		f.open(s);
 		if (!f.is_open()) return false;
-		std::string str;
-		for (auto i = m_path.begin(); i != m_path.end(); ++i)
-		{
-			const double t = mrpt::system::timestampTotime_t(i->first);
-			const auto& p = i->second;
-
-			str = mrpt::format("%.06f ", t);
-			for (unsigned int k = 0; k < p.size(); k++)
-				str += mrpt::format("%.06f ", p[k]);
-			str += std::string("\n");
-
-			f << str;
-		}
+		const auto save = [&f](const auto& path) {
+			std::string str;
+			for (auto i = path.begin(); i != path.end(); ++i)
+			{
+				const double t = mrpt::system::timestampTotime_t(i->first);
+				const auto& p = i->second;
+
+				str = mrpt::format("%.06f ", t);
+				for (unsigned int k = 0; k < p.size(); k++)
+					str += mrpt::format("%.06f ", p[k]);
+				str += std::string("\n");
+
+				f << str;
+			}
+		};
+		if (m_flat_storage) save(m_flat_path);
+		else
+			save(m_path);
 		return true;
 	}
 	catch (...)
@@ -266,12 +395,16 @@ bool CPoseInterpolatorBase<DIM>::saveInterpolatedToTextFile(
 		std::ofstream f;
 		f.open(s);
 		if (!f.is_open()) return false;
-		if (m_path.empty()) return true;
+		if (empty()) return true;
 
 		std::string str;
 
-		const Clock::time_point t_ini = m_path.begin()->first;
-		const Clock::time_point t_end = m_path.rbegin()->first;
+		const Clock::time_point t_ini = m_flat_storage
+			? m_flat_path.front().first
+			: m_path.begin()->first;
+		const Clock::time_point t_end = m_flat_storage
+			? m_flat_path.back().first
+			: m_path.rbegin()->first;
 
 		pose_t p;
 		bool valid;
@@ -333,7 +466,7 @@ void CPoseInterpolatorBase<DIM>::getBoundingBox(
 	point_t& Min, point_t& Max) const
 {
 	MRPT_START
-	ASSERT_(!m_path.empty());
+	ASSERT_(!empty());
 
 	for (unsigned int k = 0; k < point_t::static_size; k++)
 	{
@@ -341,14 +474,19 @@ void CPoseInterpolatorBase<DIM>::getBoundingBox(
 		Max[k] = -std::numeric_limits<double>::max();
 	}
 
-	for (auto p = m_path.begin(); p != m_path.end(); ++p)
-	{
-		for (unsigned int k = 0; k < point_t::static_size; k++)
+	const auto update = [&](const auto& path) {
+		for (auto p = path.begin(); p != path.end(); ++p)
 		{
-			mrpt::keep_min(Min[k], p->second[k]);
-			mrpt::keep_max(Max[k], p->second[k]);
+			for (unsigned int k = 0; k < point_t::static_size; k++)
+			{
+				mrpt::keep_min(Min[k], p->second[k]);
+				mrpt::keep_max(Max[k], p->second[k]);
+			}
 		}
-	}
+	};
+	if (m_flat_storage) update(m_flat_path);
+	else
+		update(m_path);
 	MRPT_END
 }
 
@@ -369,7 +507,16 @@ template <int DIM>
 void CPoseInterpolatorBase<DIM>::filter(
 	unsigned int component, unsigned int samples)
 {
-	if (m_path.empty()) return;
+	if (empty()) return;
+
+	if (m_flat_storage)
+	{
+		// Filter in the default storage, then move back:
+		setFlatStorage(false);
+		filter(component, samples);
+		setFlatStorage(true);
+		return;
+	}
 
 	TPath aux;
 
@@ -182,14 +182,19 @@ void CPoseRandomSampler::setPosePDF(const CPose3DPDF& pdf)
 					drawSample
   ---------------------------------------------------------------*/
 CPose2D& CPoseRandomSampler::drawSample(CPose2D& p) const
+{
+	return drawSample(p, getRandomGenerator());
+}
+
+CPose2D& CPoseRandomSampler::drawSample(CPose2D& p, CRandomGenerator& rng) const
 {
 	MRPT_START
 
-	if (m_pdf2D) { do_sample_2D(p); }
+	if (m_pdf2D) { do_sample_2D(p, rng); }
 	else if (m_pdf3D)
 	{
 		CPose3D q;
-		do_sample_3D(q);
+		do_sample_3D(q, rng);
 		p.x(q.x());
 		p.y(q.y());
 		p.phi(q.yaw());
@@ -205,18 +210,23 @@ CPose2D& CPoseRandomSampler::drawSample(CPose2D& p) const
 					drawSample
   ---------------------------------------------------------------*/
 CPose3D& CPoseRandomSampler::drawSample(CPose3D& p) const
+{
+	return drawSample(p, getRandomGenerator());
+}
+
+CPose3D& CPoseRandomSampler::drawSample(CPose3D& p, CRandomGenerator& rng) const
 {
 	MRPT_START
 
 	if (m_pdf2D)
 	{
 		CPose2D q;
-		do_sample_2D(q);
+		do_sample_2D(q, rng);
 		p.setFromValues(q.x(), q.y(), 0, q.phi(), 0, 0);
 	}
 	else if (m_pdf3D)
 	{
-		do_sample_3D(p);
+		do_sample_3D(p, rng);
 	}
 	else
 		THROW_EXCEPTION("No associated pdf: setPosePDF must be called first.");
@@ -228,7 +238,8 @@ CPose3D& CPoseRandomSampler::drawSample(CPose3D& p) const
 /*---------------------------------------------------------------
 				  do_sample_2D: Sample from a 2D PDF
   ---------------------------------------------------------------*/
-void CPoseRandomSampler::do_sample_2D(CPose2D& p) const
+void CPoseRandomSampler::do_sample_2D(
+	CPose2D& p, CRandomGenerator& rng) const
 {
 	MRPT_START
 	ASSERT_(m_pdf2D);
@@ -243,7 +254,7 @@ void CPoseRandomSampler::do_sample_2D(CPose2D& p) const
 		rndVector.setZero();
 		for (size_t i = 0; i < 3; i++)
 		{
-			double rnd = getRandomGenerator().drawGaussian1D_normalized();
+			double rnd = rng.drawGaussian1D_normalized();
 			for (size_t d = 0; d < 3; d++)
 				rndVector[d] += (m_fastdraw_gauss_Z3(d, i) * rnd);
 		}
@@ -266,7 +277,7 @@ void CPoseRandomSampler::do_sample_2D(CPose2D& p) const
 		//      Particles: just sample as usual
 		// -------------------------------------
 		const auto& pdf = dynamic_cast<const CPosePDFParticles&>(*m_pdf2D);
-		pdf.drawSingleSample(p);
+		pdf.drawSingleSample(p, rng);
 	}
 	else
 		THROW_EXCEPTION_FMT(
@@ -278,7 +289,8 @@ void CPoseRandomSampler::do_sample_2D(CPose2D& p) const
 /*---------------------------------------------------------------
 				  do_sample_3D: Sample from a 3D PDF
   ---------------------------------------------------------------*/
-void CPoseRandomSampler::do_sample_3D(CPose3D& p) const
+void CPoseRandomSampler::do_sample_3D(
+	CPose3D& p, CRandomGenerator& rng) const
 {
 	MRPT_START
 	ASSERT_(m_pdf3D);
@@ -293,7 +305,7 @@ void CPoseRandomSampler::do_sample_3D(CPose3D& p) const
 		rndVector.setZero();
 		for (size_t i = 0; i < 6; i++)
 		{
-			double rnd = getRandomGenerator().drawGaussian1D_normalized();
+			double rnd = rng.drawGaussian1D_normalized();
 			for (size_t d = 0; d < 6; d++)
 				rndVector[d] += (m_fastdraw_gauss_Z6(d, i) * rnd);
 		}
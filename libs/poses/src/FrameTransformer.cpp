@@ -15,6 +15,7 @@
 #include <mrpt/poses/FrameTransformer.h>  // for FrameTransformer, FrameTran...
 #include <mrpt/system/datetime.h>  // for TTimeStamp, INVALID_TIMESTAMP
 
+#include <algorithm>
 #include <string>  // for string
 
 using namespace mrpt::poses;
@@ -41,19 +42,186 @@ FrameTransformer<DIM>::FrameTransformer() = default;
 template <int DIM>
 FrameTransformer<DIM>::~FrameTransformer() = default;
 
+template <int DIM>
+typename FrameTransformer<DIM>::frame_id_t
+	FrameTransformer<DIM>::internal_frameId(const std::string& frame_name)
+{
+	const auto it = m_frame_ids.find(frame_name);
+	if (it != m_frame_ids.end()) return it->second;
+
+	const auto id = static_cast<frame_id_t>(m_frame_names.size());
+	m_frame_ids[frame_name] = id;
+	m_frame_names.push_back(frame_name);
+	m_edges.emplace_back();
+	return id;
+}
+
+template <int DIM>
+typename FrameTransformer<DIM>::frame_id_t FrameTransformer<DIM>::frameId(
+	const std::string& frame_name)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return internal_frameId(frame_name);
+}
+
+template <int DIM>
+std::string FrameTransformer<DIM>::frameName(frame_id_t id) const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	ASSERT_LT_(id, m_frame_names.size());
+	return m_frame_names[id];
+}
+
 template <int DIM>
 void FrameTransformer<DIM>::sendTransform(
 	const std::string& parent_frame, const std::string& child_frame,
 	const typename base_t::pose_t& child_wrt_parent,
 	const mrpt::system::TTimeStamp& timestamp)
 {
-	m_pose_edges_buffer[parent_frame][child_frame] =
-		TF_TreeEdge(child_wrt_parent, timestamp);
+	frame_id_t parent, child;
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		parent = internal_frameId(parent_frame);
+		child = internal_frameId(child_frame);
+	}
+	sendTransform(parent, child, child_wrt_parent, timestamp);
 }
 
-// future work: allow graph traversal and do pose chain composition?
-// We dont need to replicate the full functionality of ROS tf, though... just
-// what we really need.
+template <int DIM>
+void FrameTransformer<DIM>::sendTransform(
+	frame_id_t parent_frame, frame_id_t child_frame,
+	const typename base_t::pose_t& child_wrt_parent,
+	const mrpt::system::TTimeStamp& timestamp)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	ASSERT_LT_(parent_frame, m_edges.size());
+	ASSERT_LT_(child_frame, m_edges.size());
+	ASSERT_(parent_frame != child_frame);
+
+	auto& e = m_edges[child_frame];
+	if (e.parent != parent_frame)
+	{
+		// Topology change: refuse loops, and forget the former parent.
+		for (frame_id_t f = parent_frame; f != INVALID_FRAME;
+			 f = m_edges[f].parent)
+			ASSERTMSG_(
+				f != child_frame,
+				mrpt::format(
+					"sendTransform(): '%s'->'%s' would create a loop",
+					m_frame_names[parent_frame].c_str(),
+					m_frame_names[child_frame].c_str()));
+
+		e.parent = parent_frame;
+		e.poses.clear();
+		e.poses.setInterpolationMethod(m_method);
+		m_path_cache.clear();
+	}
+	e.poses.insert(timestamp, child_wrt_parent);
+
+	// Remove old poses:
+	const auto tLatest = e.poses.rbegin()->first;
+	const auto tOldest =
+		tLatest - std::chrono::duration_cast<mrpt::Clock::duration>(
+					  std::chrono::duration<double>(m_buffer_duration));
+	while (e.poses.size() > 1 && e.poses.begin()->first < tOldest)
+		e.poses.erase(e.poses.begin());
+
+	m_latest_cache.clear();
+}
+
+template <int DIM>
+const typename FrameTransformer<DIM>::TF_Path&
+	FrameTransformer<DIM>::internal_path(frame_id_t target, frame_id_t source)
+{
+	const uint64_t key = (static_cast<uint64_t>(target) << 32) | source;
+	if (auto it = m_path_cache.find(key); it != m_path_cache.end())
+		return it->second;
+
+	TF_Path& path = m_path_cache[key];
+
+	// All ancestors of the source frame (including itself):
+	std::vector<frame_id_t> srcAncestors;
+	for (frame_id_t f = source; f != INVALID_FRAME; f = m_edges[f].parent)
+		srcAncestors.push_back(f);
+
+	// Go up from the target until reaching one of them:
+	for (frame_id_t f = target; f != INVALID_FRAME; f = m_edges[f].parent)
+	{
+		const auto itCommon =
+			std::find(srcAncestors.begin(), srcAncestors.end(), f);
+		if (itCommon != srcAncestors.end())
+		{
+			path.connected = true;
+			path.up_source.assign(srcAncestors.begin(), itCommon);
+			break;
+		}
+		path.up_target.push_back(f);
+	}
+	if (!path.connected) path.up_target.clear();
+	return path;
+}
+
+template <int DIM>
+bool FrameTransformer<DIM>::internal_edgePose(
+	const TF_TreeEdge& e, const mrpt::system::TTimeStamp& t,
+	typename base_t::pose_t& pose) const
+{
+	if (e.poses.empty()) return false;
+	// Latest, or static transform:
+	if (t == INVALID_TIMESTAMP || e.poses.size() == 1)
+	{
+		pose = typename base_t::pose_t(e.poses.rbegin()->second);
+		return true;
+	}
+	bool valid = false;
+	e.poses.interpolate(t, pose, valid);
+	return valid;
+}
+
+template <int DIM>
+FrameLookUpStatus FrameTransformer<DIM>::internal_lookup(
+	frame_id_t target, frame_id_t source,
+	typename base_t::light_type& child_wrt_parent,
+	const mrpt::system::TTimeStamp& query_time)
+{
+	const uint64_t key = (static_cast<uint64_t>(target) << 32) | source;
+	if (query_time == INVALID_TIMESTAMP)
+	{
+		if (auto it = m_latest_cache.find(key); it != m_latest_cache.end())
+		{
+			child_wrt_parent = it->second;
+			return LKUP_GOOD;
+		}
+	}
+
+	const TF_Path& path = internal_path(target, source);
+	if (!path.connected) return LKUP_NO_CONNECTIVITY;
+
+	// Compose each chain from the common ancestor down to its frame:
+	const auto chainPose = [&](const std::vector<frame_id_t>& chain,
+							   typename base_t::pose_t& out) {
+		out = typename base_t::pose_t();
+		typename base_t::pose_t edgePose;
+		for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+		{
+			if (!internal_edgePose(m_edges[*it], query_time, edgePose))
+				return false;
+			out = out + edgePose;
+		}
+		return true;
+	};
+	typename base_t::pose_t srcPose, trgPose;
+	if (!chainPose(path.up_source, srcPose) ||
+		!chainPose(path.up_target, trgPose))
+		return LKUP_EXTRAPOLATION_ERROR;
+
+	child_wrt_parent = (trgPose - srcPose).asTPose();
+
+	if (query_time == INVALID_TIMESTAMP)
+		m_latest_cache[key] = child_wrt_parent;
+
+	return LKUP_GOOD;
+}
 
 template <int DIM>
 FrameLookUpStatus FrameTransformer<DIM>::lookupTransform(
@@ -64,20 +232,54 @@ FrameLookUpStatus FrameTransformer<DIM>::lookupTransform(
 	ASSERTMSG_(
 		timeout_secs == .0,
 		"timeout_secs!=0: Blocking calls not supported yet!");
-	ASSERTMSG_(
-		query_time == INVALID_TIMESTAMP,
-		"`query_time` different than 'latest' not supported yet!");
 
-	const auto& it_src = m_pose_edges_buffer.find(source_frame);
-	if (it_src == m_pose_edges_buffer.end()) { return LKUP_UNKNOWN_FRAME; }
+	std::lock_guard<std::mutex> lck(m_mtx);
 
-	const auto& it_dst = it_src->second.find(target_frame);
-	if (it_dst == it_src->second.end()) { return LKUP_NO_CONNECTIVITY; }
+	const auto itTrg = m_frame_ids.find(target_frame);
+	const auto itSrc = m_frame_ids.find(source_frame);
+	if (itTrg == m_frame_ids.end() || itSrc == m_frame_ids.end())
+		return LKUP_UNKNOWN_FRAME;
 
-	const TF_TreeEdge& te = it_dst->second;
-	child_wrt_parent = te.pose.asTPose();
+	return internal_lookup(
+		itTrg->second, itSrc->second, child_wrt_parent, query_time);
+}
 
-	return LKUP_GOOD;
+template <int DIM>
+FrameLookUpStatus FrameTransformer<DIM>::lookupTransform(
+	frame_id_t target_frame, frame_id_t source_frame,
+	typename base_t::light_type& child_wrt_parent,
+	const mrpt::system::TTimeStamp query_time)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	if (target_frame >= m_edges.size() || source_frame >= m_edges.size())
+		return LKUP_UNKNOWN_FRAME;
+
+	return internal_lookup(
+		target_frame, source_frame, child_wrt_parent, query_time);
+}
+
+template <int DIM>
+void FrameTransformer<DIM>::setBufferDuration(double seconds)
+{
+	ASSERT_GE_(seconds, .0);
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_buffer_duration = seconds;
+}
+
+template <int DIM>
+double FrameTransformer<DIM>::getBufferDuration() const
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	return m_buffer_duration;
+}
+
+template <int DIM>
+void FrameTransformer<DIM>::setInterpolationMethod(TInterpolatorMethod method)
+{
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_method = method;
+	for (auto& e : m_edges)
+		e.poses.setInterpolationMethod(method);
 }
 
 namespace mrpt
@@ -47,3 +47,68 @@ TEST(FrameTransformer, SimplePublishAndLookup)
 	run_tf_test1<2>(test_A2B);
 	run_tf_test1<3>(test_A2B);
 }
+
+TEST(FrameTransformer, ChainAndPastLookups)
+{
+	using namespace mrpt::poses;
+	using mrpt::Clock;
+	using namespace std::chrono_literals;
+
+	FrameTransformer<3> tf;
+	const auto t0 = Clock::fromDouble(1000.0);
+
+	// map -> odom -> base_link -> laser (static):
+	const CPose3D laser_wrt_base(0.2, 0, 0.3, 0, 0, 0);
+	tf.sendTransform("base_link", "laser", laser_wrt_base, t0);
+	tf.sendTransform("map", "odom", CPose3D(1.0, 0, 0, 0, 0, 0), t0);
+	tf.sendTransform("odom", "base_link", CPose3D(0, 0, 0, 0, 0, 0), t0);
+	tf.sendTransform(
+		"odom", "base_link", CPose3D(2.0, 0, 0, 0, 0, 0), t0 + 2s);
+
+	const auto map = tf.frameId("map");
+	const auto laser = tf.frameId("laser");
+	EXPECT_EQ(tf.frameName(laser), "laser");
+
+	// Latest:
+	mrpt::math::TPose3D p;
+	EXPECT_EQ(tf.lookupTransform(laser, map, p), LKUP_GOOD);
+	EXPECT_NEAR(p.x, 3.2, 1e-6);
+	EXPECT_NEAR(p.z, 0.3, 1e-6);
+
+	// Interpolated at a past time:
+	EXPECT_EQ(tf.lookupTransform("laser", "map", p, t0 + 1s), LKUP_GOOD);
+	EXPECT_NEAR(p.x, 2.2, 1e-6);
+
+	// Inverse direction:
+	EXPECT_EQ(tf.lookupTransform(map, laser, p, t0 + 1s), LKUP_GOOD);
+	EXPECT_NEAR(p.x, -2.2, 1e-6);
+	EXPECT_NEAR(p.z, -0.3, 1e-6);
+
+	// Between siblings through their common ancestor:
+	tf.sendTransform("map", "dock", CPose3D(0, 5.0, 0, 0, 0, 0), t0);
+	EXPECT_EQ(tf.lookupTransform("dock", "odom", p), LKUP_GOOD);
+	EXPECT_NEAR(p.x, -1.0, 1e-6);
+	EXPECT_NEAR(p.y, 5.0, 1e-6);
+
+	// Errors:
+	EXPECT_EQ(
+		tf.lookupTransform("laser", "map", p, t0 + 10s),
+		LKUP_EXTRAPOLATION_ERROR);
+	EXPECT_EQ(
+		tf.lookupTransform("laser", "nonexistent", p), LKUP_UNKNOWN_FRAME);
+	tf.frameId("isolated");
+	EXPECT_EQ(tf.lookupTransform("isolated", "map", p), LKUP_NO_CONNECTIVITY);
+	EXPECT_ANY_THROW(tf.sendTransform("laser", "map", CPose3D(), t0));
+
+	// Old poses are discarded:
+	tf.setBufferDuration(1.0);
+	tf.sendTransform(
+		"odom", "base_link", CPose3D(3.0, 0, 0, 0, 0, 0), t0 + 3s);
+	EXPECT_EQ(
+		tf.lookupTransform("laser", "map", p, t0 + 1s),
+		LKUP_EXTRAPOLATION_ERROR);
+	EXPECT_EQ(
+		tf.lookupTransform("laser", "map", p, Clock::fromDouble(1002.5)),
+		LKUP_GOOD);
+	EXPECT_NEAR(p.x, 3.7, 1e-6);
+}
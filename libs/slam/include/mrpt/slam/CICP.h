@@ -174,6 +174,13 @@ class CICP : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 		 * queries,
 		 *  the most expensive step in ICP */
 		uint32_t corresponding_points_decimation{5};
+
+		/** Number of threads for the search of correspondences, passed to
+		 * mrpt::maps::TMatchingParams::parallelThreads. 1=single thread
+		 * (default), 0=as many as CPU cores.
+		 * \note (New in MRPT 2.7.1)
+		 */
+		uint32_t matchingThreads{1};
 	};
 
 	/** The options employed by the ICP align. */
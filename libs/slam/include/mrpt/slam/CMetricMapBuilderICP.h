@@ -72,6 +72,13 @@ class CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
 		 * position (default: 0.40) */
 		double minICPgoodnessToAccept;
 
+		/** (default:false) Enable incremental KD-tree updates in the points
+		 * maps, so the KD-tree is not rebuilt from scratch after inserting each
+		 * new observation (see mrpt::math::KDTreeCapable).
+		 * \note (New in MRPT 2.7.1)
+		 */
+		bool incrementalKDTree;
+
 		mrpt::system::VerbosityLevel& verbosity_level;
 
 		/** What maps to create (at least one points map and/or a grid map are
@@ -21,6 +21,8 @@
 #include <mrpt/slam/TKLDParams.h>
 
 #include <cmath>
+#include <future>
+#include <thread>
 
 /** \file PF_implementations.h
  *  This file contains the implementations of the template members declared in
@@ -130,6 +132,61 @@ bool PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 	return true;
 }  // end of PF_SLAM_implementation_gatherActionsCheckBothActObs
 
+template <
+	class PARTICLE_TYPE, class MYSELF,
+	mrpt::bayes::particle_storage_mode STORAGE>
+template <class FUNCTOR>
+void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
+	PF_SLAM_implementation_parallelFor(
+		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
+		const size_t N, FUNCTOR&& f)
+{
+	MRPT_START
+
+	if (!N) return;
+
+	const size_t chunkSize = std::max<size_t>(1, PF_options.parallelChunkSize);
+	const size_t nChunks = (N + chunkSize - 1) / chunkSize;
+
+	// One seed per chunk, taken from the global generator, so results only
+	// depend on its seed and not on the number of threads:
+	std::vector<uint32_t> seeds(nChunks);
+	for (auto& seed : seeds)
+		seed = mrpt::random::getRandomGenerator().drawUniform32bit();
+
+	auto lambdaRunChunk = [&](size_t chunk) {
+		mrpt::random::CRandomGenerator rng(seeds[chunk]);
+		f(rng, chunk * chunkSize, std::min(N, (chunk + 1) * chunkSize));
+	};
+
+	// First chunk in this thread, to build lazy caches without races:
+	lambdaRunChunk(0);
+	if (nChunks == 1) return;
+
+	size_t nThreads = PF_options.parallelThreads;
+	if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+	nThreads = std::max<size_t>(1, nThreads);
+
+	if (!m_parallelThreads || m_parallelThreads->size() != nThreads)
+		m_parallelThreads = std::make_shared<mrpt::WorkerThreadsPool>(
+			nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO, "PF_parallel");
+
+	std::vector<std::future<void>> futures;
+	futures.reserve(nChunks - 1);
+	for (size_t chunk = 1; chunk < nChunks; chunk++)
+		futures.emplace_back(
+			m_parallelThreads->enqueue(lambdaRunChunk, chunk));
+
+	// Wait for all chunks before propagating any exception, since they all
+	// reference local variables:
+	for (auto& fut : futures)
+		fut.wait();
+	for (auto& fut : futures)
+		fut.get();
+
+	MRPT_END
+}
+
 /** A generic implementation of the PF method
  * "prediction_and_update_pfAuxiliaryPFOptimal" (optimal sampling with rejection
  * sampling approximation),
@@ -237,31 +294,40 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 			// -------------------------------------------------------------
 			// FIXED SAMPLE SIZE
 			// -------------------------------------------------------------
-			mrpt::poses::CPose3D incrPose;
-			for (size_t i = 0; i < M; i++)
-			{
-				// Generate gaussian-distributed 2D-pose increments according to
-				// mean-cov:
-				m_movementDrawer.drawSample(incrPose);
-				bool pose_is_valid;
-				const mrpt::poses::CPose3D finalPose =
-					mrpt::poses::CPose3D(getLastPose(i, pose_is_valid)) +
-					incrPose;
-
-				// Update the particle with the new pose: this part is
-				// caller-dependant and must be implemented there:
-				if constexpr (
-					STORAGE == mrpt::bayes::particle_storage_mode::POINTER)
+			auto lambdaMoveParticles = [&](mrpt::random::CRandomGenerator& rng,
+										   size_t first, size_t last) {
+				mrpt::poses::CPose3D incrPose;
+				for (size_t i = first; i < last; i++)
 				{
-					PF_SLAM_implementation_custom_update_particle_with_new_pose(
-						me->m_particles[i].d.get(), finalPose.asTPose());
-				}
-				else
-				{
-					PF_SLAM_implementation_custom_update_particle_with_new_pose(
-						&me->m_particles[i].d, finalPose.asTPose());
+					// Generate gaussian-distributed 2D-pose increments
+					// according to mean-cov:
+					m_movementDrawer.drawSample(incrPose, rng);
+					bool pose_is_valid;
+					const mrpt::poses::CPose3D finalPose =
+						mrpt::poses::CPose3D(getLastPose(i, pose_is_valid)) +
+						incrPose;
+
+					// Update the particle with the new pose: this part is
+					// caller-dependant and must be implemented there:
+					if constexpr (
+						STORAGE == mrpt::bayes::particle_storage_mode::POINTER)
+					{
+						PF_SLAM_implementation_custom_update_particle_with_new_pose(
+							me->m_particles[i].d.get(), finalPose.asTPose());
+					}
+					else
+					{
+						PF_SLAM_implementation_custom_update_particle_with_new_pose(
+							&me->m_particles[i].d, finalPose.asTPose());
+					}
 				}
-			}
+			};
+
+			if (PF_options.parallelThreads != 1)
+				PF_SLAM_implementation_parallelFor(
+					PF_options, M, lambdaMoveParticles);
+			else
+				lambdaMoveParticles(mrpt::random::getRandomGenerator(), 0, M);
 		}
 		else
 		{
@@ -361,18 +427,28 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 		//	UPDATE STAGE
 		// ----------------------------------------------------------------------
 		// Compute all the likelihood values & update particles weight:
-		for (size_t i = 0; i < M; i++)
-		{
-			bool pose_is_valid;
-			const mrpt::math::TPose3D partPose =
-				getLastPose(i, pose_is_valid);	// Take the particle data:
-			auto partPose2 = mrpt::poses::CPose3D(partPose);
-			const double obs_log_lik =
-				PF_SLAM_computeObservationLikelihoodForParticle(
-					PF_options, i, *sf, partPose2);
-			ASSERT_(!std::isnan(obs_log_lik) && std::isfinite(obs_log_lik));
-			me->m_particles[i].log_w += obs_log_lik * PF_options.powFactor;
-		}  // for each particle "i"
+		auto lambdaUpdateWeights = [&](mrpt::random::CRandomGenerator&,
+									   size_t first, size_t last) {
+			for (size_t i = first; i < last; i++)
+			{
+				bool pose_is_valid;
+				const mrpt::math::TPose3D partPose =
+					getLastPose(i, pose_is_valid);	// Take the particle data:
+				auto partPose2 = mrpt::poses::CPose3D(partPose);
+				const double obs_log_lik =
+					PF_SLAM_computeObservationLikelihoodForParticle(
+						PF_options, i, *sf, partPose2);
+				ASSERT_(
+					!std::isnan(obs_log_lik) && std::isfinite(obs_log_lik));
+				me->m_particles[i].log_w += obs_log_lik * PF_options.powFactor;
+			}  // for each particle "i"
+		};
+
+		if (PF_options.parallelThreads != 1)
+			PF_SLAM_implementation_parallelFor(
+				PF_options, M, lambdaUpdateWeights);
+		else
+			lambdaUpdateWeights(mrpt::random::getRandomGenerator(), 0, M);
 
 		// Normalization of weights is done outside of this method
 		// automatically.
@@ -424,7 +500,8 @@ double PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 	PF_SLAM_particlesEvaluator_AuxPFOptimal(
 		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
 		const mrpt::bayes::CParticleFilterCapable* obj, size_t index,
-		[[maybe_unused]] const void* action, const void* observation)
+		[[maybe_unused]] const void* action, const void* observation,
+		mrpt::random::CRandomGenerator& rng)
 {
 	MRPT_START
 
@@ -449,7 +526,7 @@ double PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 	mrpt::poses::CPose3D drawnSample;
 	for (size_t q = 0; q < N; q++)
 	{
-		me->m_movementDrawer.drawSample(drawnSample);
+		me->m_movementDrawer.drawSample(drawnSample, rng);
 		mrpt::poses::CPose3D x_predict = oldPose + drawnSample;
 
 		// Estimate the mean...
@@ -503,7 +580,8 @@ double PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 	PF_SLAM_particlesEvaluator_AuxPFStandard(
 		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
 		const mrpt::bayes::CParticleFilterCapable* obj, size_t index,
-		const void* action, const void* observation)
+		const void* action, const void* observation,
+		mrpt::random::CRandomGenerator& rng)
 {
 	MRPT_START
 
@@ -555,7 +633,7 @@ double PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 		mrpt::poses::CPose3D drawnSample;
 		for (size_t q = 0; q < N; q++)
 		{
-			myObj->m_movementDrawer.drawSample(drawnSample);
+			myObj->m_movementDrawer.drawSample(drawnSample, rng);
 			mrpt::poses::CPose3D x_predict = oldPose + drawnSample;
 
 			// Estimate the mean...
@@ -647,14 +725,46 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 
 	// Prepare data for executing "fastDrawSample"
 	using TMyClass = PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>;
-	auto funcOpt =
-		&TMyClass::template PF_SLAM_particlesEvaluator_AuxPFOptimal<BINTYPE>;
-	auto funcStd =
-		&TMyClass::template PF_SLAM_particlesEvaluator_AuxPFStandard<BINTYPE>;
-
-	me->prepareFastDrawSample(
-		PF_options, USE_OPTIMAL_SAMPLING ? funcOpt : funcStd,
-		&meanRobotMovement, sf);
+
+	if (PF_options.parallelThreads != 1)
+	{
+		// Evaluate the first stage weights in parallel, then pass them
+		// to prepareFastDrawSample():
+		std::vector<double> firstStageWeights(M);
+		PF_SLAM_implementation_parallelFor(
+			PF_options, M,
+			[&](mrpt::random::CRandomGenerator& rng, size_t first,
+				size_t last) {
+				for (size_t i = first; i < last; i++)
+				{
+					if (USE_OPTIMAL_SAMPLING)
+						firstStageWeights[i] =
+							PF_SLAM_particlesEvaluator_AuxPFOptimal<BINTYPE>(
+								PF_options, me, i, &meanRobotMovement, sf, rng);
+					else
+						firstStageWeights[i] =
+							PF_SLAM_particlesEvaluator_AuxPFStandard<BINTYPE>(
+								PF_options, me, i, &meanRobotMovement, sf, rng);
+				}
+			});
+
+		me->prepareFastDrawSample(
+			PF_options, &TMyClass::PF_SLAM_particlesEvaluator_Precomputed,
+			&firstStageWeights, sf);
+	}
+	else
+	{
+		using evaluator_t = mrpt::bayes::CParticleFilterCapable::
+			TParticleProbabilityEvaluator;
+		evaluator_t funcOpt = &TMyClass::template
+			PF_SLAM_particlesEvaluator_AuxPFOptimal<BINTYPE>;
+		evaluator_t funcStd = &TMyClass::template
+			PF_SLAM_particlesEvaluator_AuxPFStandard<BINTYPE>;
+
+		me->prepareFastDrawSample(
+			PF_options, USE_OPTIMAL_SAMPLING ? funcOpt : funcStd,
+			&meanRobotMovement, sf);
+	}
 
 	// For USE_OPTIMAL_SAMPLING=1,  m_pfAuxiliaryPFOptimal_maxLikelihood is now
 	// computed.
@@ -10,14 +10,18 @@
 
 #include <mrpt/bayes/CParticleFilterCapable.h>
 #include <mrpt/bayes/CParticleFilterData.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/TPose3D.h>
 #include <mrpt/obs/CActionRobotMovement2D.h>
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/poses/CPose3DPDFGaussian.h>
 #include <mrpt/poses/CPoseRandomSampler.h>
+#include <mrpt/random/RandomGenerators.h>
 #include <mrpt/slam/TKLDParams.h>
 #include <mrpt/system/COutputLogger.h>
 
+#include <memory>
+
 namespace mrpt::slam
 {
 // Frwd decl:
@@ -62,6 +66,27 @@ class PF_implementation : public mrpt::system::COutputLogger
 		m_pfAuxiliaryPFOptimal_maxLikDrawnMovement;
 	std::vector<bool> m_pfAuxiliaryPFOptimal_maxLikMovementDrawHasBeenUsed;
 
+	/** Worker threads used when
+	 * TParticleFilterOptions::parallelThreads!=1. Created upon first use.
+	 * \sa PF_SLAM_implementation_parallelFor */
+	std::shared_ptr<mrpt::WorkerThreadsPool> m_parallelThreads;
+
+	/** Runs `f(rng, first, last)` for consecutive chunks [first,last) of
+	 * TParticleFilterOptions::parallelChunkSize particles covering [0,N),
+	 * distributing chunks among TParticleFilterOptions::parallelThreads
+	 * threads. Each chunk is given its own random generator, seeded from the
+	 * global mrpt::random::getRandomGenerator().
+	 *
+	 * The first chunk runs in the calling thread before the rest are
+	 * dispatched, so lazily-built caches (e.g. the points map of each laser
+	 * scan observation) are created before running concurrently.
+	 * Exceptions thrown from any chunk are rethrown here.
+	 */
+	template <class FUNCTOR>
+	void PF_SLAM_implementation_parallelFor(
+		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
+		const size_t N, FUNCTOR&& f);
+
 	/**  Compute w[i]*p(z_t | mu_t^i), with mu_t^i being
 	 *    the mean of the new robot pose
 	 *
@@ -73,14 +98,51 @@ class PF_implementation : public mrpt::system::COutputLogger
 	static double PF_SLAM_particlesEvaluator_AuxPFStandard(
 		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
 		const mrpt::bayes::CParticleFilterCapable* obj, size_t index,
-		const void* action, const void* observation);
+		const void* action, const void* observation)
+	{
+		return PF_SLAM_particlesEvaluator_AuxPFStandard<BINTYPE>(
+			PF_options, obj, index, action, observation,
+			mrpt::random::getRandomGenerator());
+	}
+	/** \overload Draws random samples from the given generator */
+	template <class BINTYPE>
+	static double PF_SLAM_particlesEvaluator_AuxPFStandard(
+		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
+		const mrpt::bayes::CParticleFilterCapable* obj, size_t index,
+		const void* action, const void* observation,
+		mrpt::random::CRandomGenerator& rng);
 
 	template <class BINTYPE>  // Template arg. actually not used, just to allow
 	// giving the definition in another file later on
 	static double PF_SLAM_particlesEvaluator_AuxPFOptimal(
 		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
 		const mrpt::bayes::CParticleFilterCapable* obj, size_t index,
-		const void* action, const void* observation);
+		const void* action, const void* observation)
+	{
+		return PF_SLAM_particlesEvaluator_AuxPFOptimal<BINTYPE>(
+			PF_options, obj, index, action, observation,
+			mrpt::random::getRandomGenerator());
+	}
+	/** \overload Draws random samples from the given generator */
+	template <class BINTYPE>
+	static double PF_SLAM_particlesEvaluator_AuxPFOptimal(
+		const mrpt::bayes::CParticleFilter::TParticleFilterOptions& PF_options,
+		const mrpt::bayes::CParticleFilterCapable* obj, size_t index,
+		const void* action, const void* observation,
+		mrpt::random::CRandomGenerator& rng);
+
+	/** Returns the index-th element of the `std::vector<double>` passed as
+	 * `action`. Used to feed prepareFastDrawSample() with values already
+	 * evaluated in parallel. */
+	static double PF_SLAM_particlesEvaluator_Precomputed(
+		[[maybe_unused]] const mrpt::bayes::CParticleFilter::
+			TParticleFilterOptions& PF_options,
+		[[maybe_unused]] const mrpt::bayes::CParticleFilterCapable* obj,
+		size_t index, const void* action,
+		[[maybe_unused]] const void* observation)
+	{
+		return (*static_cast<const std::vector<double>*>(action))[index];
+	}
 
 	/** @} */
 
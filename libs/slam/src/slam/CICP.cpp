@@ -122,6 +122,7 @@ void CICP::TConfigParams::loadFromConfigFile(
 
 	MRPT_LOAD_CONFIG_VAR(
 		corresponding_points_decimation, int, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(matchingThreads, int, iniFile, section);
 }
 
 void CICP::TConfigParams::saveToConfigFile(
@@ -170,6 +171,9 @@ void CICP::TConfigParams::saveToConfigFile(
 	MRPT_SAVE_CONFIG_VAR_COMMENT(skip_cov_calculation, "");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(skip_quality_calculation, "");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(corresponding_points_decimation, "");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		matchingThreads,
+		"Threads for correspondence search (0=all cores)");
 }
 
 float CICP::kernel(float x2, float rho2)
@@ -232,6 +236,7 @@ CPosePDF::Ptr CICP::ICP_Method_Classic(
 	matchParams.onlyUniqueRobust = options.onlyUniqueRobust;
 	matchParams.decimation_other_map_points =
 		options.corresponding_points_decimation;
+	matchParams.parallelThreads = options.matchingThreads;
 
 	// Ensure maps are not empty!
 	// ------------------------------------------------------
@@ -598,6 +603,7 @@ CPosePDF::Ptr CICP::ICP_Method_LM(
 	matchParams.onlyUniqueRobust = onlyUniqueRobust;
 	matchParams.decimation_other_map_points =
 		options.corresponding_points_decimation;
+	matchParams.parallelThreads = options.matchingThreads;
 
 	// The gaussian PDF to estimate:
 	// ------------------------------------------------------
@@ -995,6 +1001,7 @@ CPose3DPDF::Ptr CICP::ICP3D_Method_Classic(
 	matchParams.onlyUniqueRobust = options.onlyUniqueRobust;
 	matchParams.decimation_other_map_points =
 		options.corresponding_points_decimation;
+	matchParams.parallelThreads = options.matchingThreads;
 
 	// Ensure maps are not empty!
 	// ------------------------------------------------------
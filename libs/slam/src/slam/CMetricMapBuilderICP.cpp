@@ -61,6 +61,7 @@ CMetricMapBuilderICP::TConfigParams::TConfigParams(
 	  localizationLinDistance(0.20),
 	  localizationAngDistance(30.0_deg),
 	  minICPgoodnessToAccept(0.40),
+	  incrementalKDTree(false),
 	  verbosity_level(parent_verbosity_level),
 	  mapInitializers()
 {
@@ -76,6 +77,7 @@ CMetricMapBuilderICP::TConfigParams&
 	localizationLinDistance = other.localizationLinDistance;
 	localizationAngDistance = other.localizationAngDistance;
 	minICPgoodnessToAccept = other.minICPgoodnessToAccept;
+	incrementalKDTree = other.incrementalKDTree;
 	//	We can't copy a reference type
 	//	verbosity_level         = other.verbosity_level;
 	mapInitializers = other.mapInitializers;
@@ -94,6 +96,7 @@ void CMetricMapBuilderICP::TConfigParams::loadFromConfigFile(
 		section, "verbosity_level", verbosity_level);
 
 	MRPT_LOAD_CONFIG_VAR(minICPgoodnessToAccept, double, source, section)
+	MRPT_LOAD_CONFIG_VAR(incrementalKDTree, bool, source, section)
 
 	mapInitializers.loadFromConfigFile(source, section);
 }
@@ -116,6 +119,9 @@ void CMetricMapBuilderICP::TConfigParams::dumpToTextStream(
 	out << mrpt::format(
 		"localizationAngDistance                 = %f deg\n",
 		RAD2DEG(localizationAngDistance));
+	out << mrpt::format(
+		"incrementalKDTree                       = %s\n",
+		incrementalKDTree ? "YES" : "NO");
 	out << mrpt::format(
 		"verbosity_level                         = %s\n",
 		mrpt::typemeta::TEnumType<mrpt::system::VerbosityLevel>::value2name(
@@ -539,6 +545,13 @@ void CMetricMapBuilderICP::initialize(
 	// Create metric maps:
 	metricMap.setListOfMaps(ICP_options.mapInitializers);
 
+	for (auto& m : metricMap.maps)
+	{
+		if (auto pts = std::dynamic_pointer_cast<CPointsMap>(m); pts)
+			pts->kdtree_search_params.incremental =
+				ICP_options.incrementalKDTree;
+	}
+
 	// copy map:
 	SF_Poses_seq = initialMap;
 
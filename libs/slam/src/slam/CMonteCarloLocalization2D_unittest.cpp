@@ -34,7 +34,8 @@ using namespace mrpt::system;
 using namespace mrpt::obs;
 using namespace std;
 
-void run_test_pf_localization(CPose2D& meanPose, CMatrixDouble33& cov)
+void run_test_pf_localization(
+	CPose2D& meanPose, CMatrixDouble33& cov, unsigned int numThreads = 1)
 {
 	// ------------------------------------------------------
 	// The code below is a simplification of the program "pf-localization"
@@ -79,6 +80,7 @@ void run_test_pf_localization(CPose2D& meanPose, CMatrixDouble33& cov)
 	// ---------------------------
 	CParticleFilter::TParticleFilterOptions pfOptions;
 	pfOptions.loadFromConfigFile(iniFile, "PF_options");
+	pfOptions.parallelThreads = numThreads;
 
 	// PDF Options:
 	// ------------------
@@ -259,8 +261,7 @@ void run_test_pf_localization(CPose2D& meanPose, CMatrixDouble33& cov)
 	}  // end of loop for different # of particles
 }
 
-// TEST =================
-TEST(MonteCarlo2D, RunSampleDataset)
+static void run_test_and_check_convergence(unsigned int numThreads)
 {
 	try
 	{
@@ -276,7 +277,7 @@ TEST(MonteCarlo2D, RunSampleDataset)
 		// even twice in an extreme bad luck:
 		for (int op = 0; op < 3; op++)
 		{
-			run_test_pf_localization(meanPose, cov);
+			run_test_pf_localization(meanPose, cov, numThreads);
 
 			const double final_pf_cov_trace = cov.trace();
 			const CPose2D final_pf_pose = meanPose;
@@ -299,3 +300,11 @@ TEST(MonteCarlo2D, RunSampleDataset)
 		FAIL() << mrpt::exception_to_str(e);
 	}
 }
+
+// TEST =================
+TEST(MonteCarlo2D, RunSampleDataset) { run_test_and_check_convergence(1); }
+
+TEST(MonteCarlo2D, RunSampleDatasetParallel)
+{
+	run_test_and_check_convergence(4);
+}
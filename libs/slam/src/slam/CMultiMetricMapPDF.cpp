@@ -356,11 +356,6 @@ void CMultiMetricMapPDF::rebuildAverageMap()
 		for (auto& p : m_particles)
 		{
 			auto grid = p.d->mapTillNow.mapByClass<COccupancyGridMap2D>(0);
-			// Variables:
-			std::vector<COccupancyGridMap2D::cellType>::iterator srcCell;
-			auto firstSrcCell = grid->m_map.begin();
-			auto lastSrcCell = grid->m_map.end();
-			std::vector<float>::iterator destCell;
 
 			// The weight of particle:
 			float w = exp(p.log_w) / sumW;
@@ -368,20 +363,28 @@ void CMultiMetricMapPDF::rebuildAverageMap()
 			ASSERT_(grid->m_map.size() == floatMap.size());
 
 			// For each cell in individual maps:
-			for (srcCell = firstSrcCell, destCell = floatMap.begin();
-				 srcCell != lastSrcCell; srcCell++, destCell++)
-				(*destCell) += w * (*srcCell);
+			auto destCell = floatMap.begin();
+			for (unsigned int cy = 0; cy < grid->m_size_y; cy++)
+			{
+				const COccupancyGridMap2D::cellType* srcCell =
+					grid->m_map.row(cy);
+				for (unsigned int cx = 0; cx < grid->m_size_x; cx++)
+					(*destCell++) += w * (*srcCell++);
+			}
 		}
 
 		// Copy to fixed point map:
-		std::vector<float>::iterator srcCell;
-		auto destCell = avrg_grid->m_map.begin();
-
 		ASSERT_(avrg_grid->m_map.size() == floatMap.size());
 
-		for (srcCell = floatMap.begin(); srcCell != floatMap.end();
-			 srcCell++, destCell++)
-			*destCell = static_cast<COccupancyGridMap2D::cellType>(*srcCell);
+		auto srcCell = floatMap.begin();
+		for (unsigned int cy = 0; cy < avrg_grid->m_size_y; cy++)
+		{
+			COccupancyGridMap2D::cellType* destCell =
+				avrg_grid->m_map.mutableRow(cy);
+			for (unsigned int cx = 0; cx < avrg_grid->m_size_x; cx++)
+				*destCell++ =
+					static_cast<COccupancyGridMap2D::cellType>(*srcCell++);
+		}
 
 		MRPT_END
 	}  // End of SSE not supported
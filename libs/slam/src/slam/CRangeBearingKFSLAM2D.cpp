@@ -61,6 +61,7 @@ void CRangeBearingKFSLAM2D::reset()
 	// Initial cov:
 	m_pkk.setSize(3, 3);
 	m_pkk.setZero();
+	m_SEIF_active = false;
 }
 
 /*---------------------------------------------------------------
@@ -123,7 +124,7 @@ void CRangeBearingKFSLAM2D::getCurrentState(
 	std::copy(m_xkk.begin(), m_xkk.end(), out_fullState.begin());
 
 	// Full cov:
-	out_fullCovariance = m_pkk;
+	getFullCov(out_fullCovariance);
 
 	MRPT_END
 }
@@ -958,7 +959,7 @@ void CRangeBearingKFSLAM2D::getAs3DObject(
 	{
 		pointGauss.mean.x(m_xkk[3 + 2 * i + 0]);
 		pointGauss.mean.y(m_xkk[3 + 2 * i + 1]);
-		pointGauss.cov = m_pkk.blockCopy<2, 2>(3 + 2 * i, 3 + 2 * i);
+		getLandmarkCov(i, pointGauss.cov);
 
 		auto ellip = opengl::CEllipsoid2D::Create();
 
@@ -1018,9 +1019,11 @@ void CRangeBearingKFSLAM2D::saveMapAndPath2DRepresentationAsMATLABFile(
 	{
 		size_t idx = get_vehicle_size() + i * get_feature_size();
 
-		cov(0, 0) = m_pkk(idx + 0, idx + 0);
-		cov(1, 1) = m_pkk(idx + 1, idx + 1);
-		cov(0, 1) = cov(1, 0) = m_pkk(idx + 0, idx + 1);
+		KFMatrix_FxF lmCov;
+		getLandmarkCov(i, lmCov);
+		cov(0, 0) = lmCov(0, 0);
+		cov(1, 1) = lmCov(1, 1);
+		cov(0, 1) = cov(1, 0) = lmCov(0, 1);
 
 		mean[0] = m_xkk[idx + 0];
 		mean[1] = m_xkk[idx + 1];
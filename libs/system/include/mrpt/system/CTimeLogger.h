@@ -13,8 +13,11 @@
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/system/CTicTac.h>
 
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <map>
+#include <memory>
 #include <optional>
 #include <stack>
 #include <vector>
@@ -43,6 +46,22 @@ namespace mrpt::system
  * the latter case (and, actually, in general since it's safer against
  * exceptions), use the RAII helper class CTimeLoggerEntry.
  *
+ * For sub-microsecond sections, or to leave profiling enabled in production
+ * code, enable the lock-free mode with enableLockFreeMode() and use section
+ * IDs instead of names (see MRPT_TIMELOGGER_SCOPE()). Section names are then
+ * resolved only once per call site, and each thread records its calls into
+ * its own lock-free ring buffer, from which a background thread aggregates
+ * them into the regular stats. All stats-reporting methods (getStats(),
+ * dumpAllStats(), saveToCSVFile(),...) work as usual in this mode. If the
+ * aggregator cannot keep up with a thread, its extra calls are dropped and
+ * counted in getLockFreeDroppedCalls().
+ *
+ * Besides the aggregated stats, the start and end times and the thread of
+ * each call can be recorded with enableTraceRecording(), then exported with
+ * saveToChromeTraceFile() for visualization in Perfetto
+ * (https://ui.perfetto.dev) or `chrome://tracing`, to see how sections in
+ * different threads (and different CTimeLogger objects) overlap in time.
+ *
  * \sa CTimeLoggerEntry
  *
  * \note The default behavior is dumping all the information at destruction.
@@ -50,6 +69,10 @@ namespace mrpt::system
  */
 class CTimeLogger : public mrpt::system::COutputLogger
 {
+   public:
+	/** Identifier of a section name, see registerSection() */
+	using section_id_t = uint32_t;
+
    private:
 	CTicTac m_tictac;
 	bool m_enabled;
@@ -64,6 +87,8 @@ class CTimeLogger : public mrpt::system::COutputLogger
 		std::stack<double, std::vector<double>> open_calls;
 		bool has_time_units{true};
 		std::optional<std::deque<double>> whole_history{};
+		/** The ID of this section name, if already known */
+		std::optional<section_id_t> section{};
 
 		// Each instance holds its own mutex, even after = operations.
 		std::mutex mtx;
@@ -83,6 +108,7 @@ class CTimeLogger : public mrpt::system::COutputLogger
 			open_calls = d.open_calls;
 			has_time_units = d.has_time_units;
 			whole_history = d.whole_history;
+			section = d.section;
 			return *this;
 		}
 		TCallData& operator=(TCallData&& d)
@@ -95,6 +121,7 @@ class CTimeLogger : public mrpt::system::COutputLogger
 			open_calls = std::move(d.open_calls);
 			has_time_units = d.has_time_units;
 			whole_history = std::move(d.whole_history);
+			section = d.section;
 			return *this;
 		}
 	};
@@ -106,11 +133,70 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	using TDataMap = mrpt::containers::ts_hash_map<
 		std::string, TCallData, HASH_SIZE_IN_BYTES, HASH_ALLOWED_COLLISIONS>;
 
-	TDataMap m_data;
+	mutable TDataMap m_data;
 
 	void do_enter(const std::string_view& func_name) noexcept;
 	double do_leave(const std::string_view& func_name) noexcept;
 
+   private:
+	/** enter()/leave() by ID, in lock-free mode */
+	void do_enter_lockfree(section_id_t section) noexcept;
+	double do_leave_lockfree(section_id_t section) noexcept;
+	/** enter()/leave() by ID, when not in lock-free mode */
+	void do_enter(section_id_t section) noexcept;
+	double do_leave(section_id_t section) noexcept;
+
+	/** Returns the m_data entry of a section ID. Its name is only looked up
+	 * the first time, then the entry is cached. Must be called with
+	 * `TInternalState::flush_mtx` locked. */
+	TCallData* sectionData(section_id_t section) const noexcept;
+	/** Returns the m_data entry of a section ID if it is already cached, or
+	 * nullptr otherwise. It takes no lock. */
+	TCallData* cachedSectionData(section_id_t section) const noexcept;
+
+	/** Start and end of a call (with the mutex of `d` already locked) */
+	void openCall(TCallData& d) noexcept;
+	double closeCall(TCallData& d, double t_leave) noexcept;
+
+	/** Accumulates one measure (with the mutex of `d` already locked) */
+	void addMeasure(TCallData& d, double value) const;
+
+	/** Implements registerUserMeasure(). If `t_enter` is given, the measure
+	 * is a call which started then, and it is also added to the trace. */
+	void do_registerUserMeasure(
+		const std::string_view& event_name, const double value,
+		const bool is_time, const std::optional<double>& t_enter) noexcept;
+
+	struct TLockFreeThreadBuffer;
+	struct TInternalState;
+	/** Holder of the lock-free mode and trace data, which is never shared
+	 * between copies of a CTimeLogger. Copies start with both the lock-free
+	 * mode and trace recording disabled. */
+	struct TInternalStateHolder
+	{
+		TInternalStateHolder();
+		TInternalStateHolder(const TInternalStateHolder&);
+		TInternalStateHolder& operator=(const TInternalStateHolder&);
+		~TInternalStateHolder();
+
+		std::unique_ptr<TInternalState> state;
+		/** Read by all threads timing sections, hence atomic */
+		std::atomic<bool> lockfree_enabled{false};
+		std::atomic<bool> trace_enabled{false};
+	};
+
+	/** Appends one finished call to the trace, if enabled */
+	void addTraceEvent(
+		section_id_t section, uint32_t thread, double t_enter,
+		double t_leave) const;
+
+	/** Returns the lock-free ring buffer of the calling thread, creating it
+	 * upon the first call */
+	TLockFreeThreadBuffer* lockFreeThreadBuffer() noexcept;
+	/** Starts or stops the aggregator thread */
+	void startLockFreeAggregator();
+	void stopLockFreeAggregator();
+
    public:
 	/** Data of each call section: # of calls, minimum, maximum, average and
 	 * overall execution time (in seconds) \sa getStats */
@@ -164,6 +250,72 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	}
 	bool isEnabledKeepWholeHistory() const { return m_keep_whole_history; }
 
+	/** Enables the lock-free mode for the enter()/leave() methods taking
+	 * section IDs (see the class description). Disabling it stops the
+	 * aggregator thread, after merging all pending data into the stats.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void enableLockFreeMode(bool enable = true);
+	bool isEnabledLockFreeMode() const
+	{
+		return m_internal.lockfree_enabled.load(std::memory_order_relaxed);
+	}
+
+	/** Enables recording of a timeline of all calls: their section, thread,
+	 * and start and end times. Only the last `max_events` calls are kept.
+	 * \sa saveToChromeTraceFile
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void enableTraceRecording(bool enable = true, size_t max_events = 1000000);
+	bool isEnabledTraceRecording() const
+	{
+		return m_internal.trace_enabled.load(std::memory_order_relaxed);
+	}
+
+	/** Saves the calls recorded since enableTraceRecording() to a JSON file
+	 * in the Chrome Trace Event format, readable by Perfetto
+	 * (https://ui.perfetto.dev) and `chrome://tracing`.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void saveToChromeTraceFile(const std::string& json_file) const;
+
+	/** Like saveToChromeTraceFile(), but for several CTimeLogger objects in
+	 * one timeline, with one process row per logger named after it. Since
+	 * all loggers use the same (monotonic) clock, calls from different
+	 * loggers can be compared in time.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	static void saveToChromeTraceFile(
+		const std::string& json_file,
+		const std::vector<const CTimeLogger*>& loggers);
+
+	/** Merges into the stats all calls recorded in lock-free mode and not
+	 * aggregated yet. Normally, users do not need to call this, since it is
+	 * periodically done by a background thread, and before reporting stats.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	void flushLockFreeCalls() const;
+
+	/** Number of calls recorded in lock-free mode which had to be dropped
+	 * since their thread ring buffer was full.
+	 * \note (New in MRPT 2.7.1)
+	 */
+	uint64_t getLockFreeDroppedCalls() const;
+
+	/** Registers a section name, and returns its ID for use in the enter()
+	 * and leave() overloads taking IDs. Calling it again with the same name
+	 * returns the same ID. IDs are global, i.e. valid for all CTimeLogger
+	 * objects. This method is thread-safe but not lock-free, so call it once
+	 * per call site, e.g. via MRPT_TIMELOGGER_SECTION_ID().
+	 * \note (New in MRPT 2.7.1)
+	 */
+	static section_id_t registerSection(const std::string_view& name);
+
+	/** Returns the name of a section ID returned by registerSection()
+	 * \note (New in MRPT 2.7.1)
+	 */
+	static std::string getSectionName(section_id_t section);
+
 	/** Dump all stats to a Comma Separated Values (CSV) file. \sa dumpAllStats
 	 */
 	void saveToCSVFile(const std::string& csv_file) const;
@@ -187,6 +339,30 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	{
 		return m_enabled ? do_leave(func_name) : 0;
 	}
+	/** Start of a section given by its ID. In lock-free mode, this does not
+	 * lock any mutex nor allocate memory (except the first time it is called
+	 * from each thread) and, unlike enter(name), the same section can be
+	 * entered simultaneously from different threads. \sa registerSection
+	 * \note (New in MRPT 2.7.1)
+	 */
+	inline void enter(section_id_t section) noexcept
+	{
+		if (!m_enabled) return;
+		if (isEnabledLockFreeMode()) do_enter_lockfree(section);
+		else
+			do_enter(section);
+	}
+	/** End of a section given by its ID \return The ellapsed time, in
+	 * seconds or 0 if disabled. \sa enter
+	 * \note (New in MRPT 2.7.1)
+	 */
+	inline double leave(section_id_t section) noexcept
+	{
+		if (!m_enabled) return 0;
+		return isEnabledLockFreeMode() ? do_leave_lockfree(section)
+									   : do_leave(section);
+	}
+
 	/** Return the mean execution time of the given "section", or 0 if it hasn't
 	 * ever been called "enter" with that section name */
 	double getMeanTime(const std::string& name) const;
@@ -195,6 +371,9 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	double getLastTime(const std::string& name) const;
 
 	friend struct CTimeLoggerEntry;
+
+   private:
+	TInternalStateHolder m_internal;
 };	// End of class def.
 
 /** A safe way to call enter() and leave() of a mrpt::system::CTimeLogger upon
@@ -244,6 +423,41 @@ struct CTimeLoggerEntry
 	bool stopped_{false};
 };
 
+/** Like CTimeLoggerEntry, for a section given by its ID (see
+ * CTimeLogger::registerSection()), which is faster, and lock-free if the
+ * logger is in lock-free mode. Normally used via MRPT_TIMELOGGER_SCOPE().
+ *
+ * \ingroup mrpt_system_grp
+ * \note (New in MRPT 2.7.1)
+ */
+struct CTimeLoggerSectionEntry
+{
+	CTimeLoggerSectionEntry(
+		const CTimeLogger& logger, CTimeLogger::section_id_t section) noexcept
+		: m_logger(const_cast<CTimeLogger&>(logger)), m_section(section)
+	{
+		m_logger.enter(m_section);
+	}
+	~CTimeLoggerSectionEntry() { stop(); }
+
+	/** Optional: ends the section before the object destruction */
+	void stop() noexcept
+	{
+		if (m_stopped) return;
+		m_logger.leave(m_section);
+		m_stopped = true;
+	}
+
+	CTimeLoggerSectionEntry(const CTimeLoggerSectionEntry&) = delete;
+	CTimeLoggerSectionEntry& operator=(const CTimeLoggerSectionEntry&) =
+		delete;
+
+   private:
+	CTimeLogger& m_logger;
+	const CTimeLogger::section_id_t m_section;
+	bool m_stopped{false};
+};
+
 /** A helper class to save CSV stats upon self destruction, for example, at the
  * end of a program run. The target file will be named after timelogger's name.
  * \ingroup mrpt_system_grp
@@ -265,3 +479,37 @@ mrpt::system::CTimeLogger& global_profiler_getref() noexcept;
 /** @} */
 
 }  // namespace mrpt::system
+
+/** Returns the ID of a CTimeLogger section, registering its name only the
+ * first time this line is executed. NAME must be a string literal.
+ * \ingroup mrpt_system_grp
+ * \note (New in MRPT 2.7.1)
+ */
+#define MRPT_TIMELOGGER_SECTION_ID(NAME)                                       \
+	([]() {                                                                    \
+		static const mrpt::system::CTimeLogger::section_id_t id_ =             \
+			mrpt::system::CTimeLogger::registerSection(NAME);                  \
+		return id_;                                                            \
+	}())
+
+#define MRPT_TIMELOGGER_CONCAT_(A, B) A##B
+#define MRPT_TIMELOGGER_CONCAT(A, B) MRPT_TIMELOGGER_CONCAT_(A, B)
+
+/** Times the rest of the current scope as a section of the given
+ * CTimeLogger. The section name is only looked up once, which together with
+ * CTimeLogger::enableLockFreeMode() makes this suitable for very short or
+ * hot code sections. NAME must be a string literal. Example:
+ * \code
+ * void foo()
+ * {
+ *   MRPT_TIMELOGGER_SCOPE(myProfiler, "foo");
+ *   // ...
+ * }
+ * \endcode
+ * \ingroup mrpt_system_grp
+ * \note (New in MRPT 2.7.1)
+ */
+#define MRPT_TIMELOGGER_SCOPE(LOGGER, NAME)                                    \
+	mrpt::system::CTimeLoggerSectionEntry MRPT_TIMELOGGER_CONCAT(              \
+		mrpt_tle_, __LINE__)(LOGGER, MRPT_TIMELOGGER_SECTION_ID(NAME))
+
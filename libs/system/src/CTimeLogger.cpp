@@ -15,10 +15,18 @@
 #include <mrpt/system/datetime.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/string_utils.h>
+#include <mrpt/system/thread_name.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
+#include <set>
+#include <thread>
+#include <unordered_map>
 
 using namespace mrpt;
 using namespace mrpt::system;
@@ -63,12 +71,499 @@ void global_profiler_leave(const char* func_name) noexcept
 }
 }  // namespace mrpt::system
 
+// ---------------------------------------------------------------------------
+// Lock-free mode
+// ---------------------------------------------------------------------------
+namespace
+{
+// Global registry of section names <=> IDs:
+struct SectionsRegistry
+{
+	std::mutex mtx;
+	std::deque<std::string> names;	// indexed by ID
+	std::unordered_map<std::string, CTimeLogger::section_id_t> ids;
+
+	static SectionsRegistry& Instance()
+	{
+		// Never freed, so it can be used from the dtors of static loggers:
+		static auto* o = new SectionsRegistry();
+		return *o;
+	}
+};
+
+// Global registry of threads which recorded trace events:
+struct ThreadsRegistry
+{
+	std::mutex mtx;
+	std::vector<std::string> names;	 // indexed by thread index
+
+	static ThreadsRegistry& Instance()
+	{
+		static auto* o = new ThreadsRegistry();
+		return *o;
+	}
+};
+
+// A small, stable index for the calling thread, for trace events:
+uint32_t currentThreadIndex()
+{
+	thread_local const uint32_t idx = []() {
+		auto& r = ThreadsRegistry::Instance();
+		auto lck = mrpt::lockHelper(r.mtx);
+		r.names.push_back(mrpt::system::thread_name());
+		return static_cast<uint32_t>(r.names.size() - 1);
+	}();
+	return idx;
+}
+
+std::string threadNameForTrace(uint32_t idx)
+{
+	auto& r = ThreadsRegistry::Instance();
+	auto lck = mrpt::lockHelper(r.mtx);
+	if (idx < r.names.size() && !r.names[idx].empty()) return r.names[idx];
+	return mrpt::format("Thread #%u", static_cast<unsigned int>(idx));
+}
+
+double steadyClockNow()
+{
+	return std::chrono::duration<double>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+std::string jsonEscape(const std::string& str)
+{
+	std::string ret;
+	ret.reserve(str.size());
+	for (const char c : str)
+	{
+		switch (c)
+		{
+			case '"': ret += "\\\""; break;
+			case '\\': ret += "\\\\"; break;
+			case '\n': ret += "\\n"; break;
+			case '\t': ret += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+					ret += mrpt::format("\\u%04x", c);
+				else
+					ret += c;
+		}
+	}
+	return ret;
+}
+
+// Must be a power of 2:
+constexpr std::size_t LOCKFREE_RING_SIZE = 1U << 14;
+
+// Period of the aggregator thread:
+constexpr auto LOCKFREE_AGGREGATION_PERIOD = std::chrono::milliseconds(20);
+
+// Unique IDs of TInternalState objects, to tell them apart in the
+// thread-local cache even if one is allocated where another one was freed:
+std::atomic<uint64_t> lockFreeStateCounter{0};
+
+/** One finished call to a section, recorded in lock-free mode */
+struct TLockFreeCall
+{
+	CTimeLogger::section_id_t section = 0;
+	double t_enter = 0, t_leave = 0;
+};
+
+/** One finished call to a section, in the trace */
+struct TTraceEvent
+{
+	CTimeLogger::section_id_t section = 0;
+	uint32_t thread = 0;
+	double t_enter = 0, t_leave = 0;
+};
+}  // namespace
+
+/** A single-producer (the owner thread), single-consumer (the aggregator)
+ * ring buffer of finished calls */
+struct CTimeLogger::TLockFreeThreadBuffer
+{
+	TLockFreeThreadBuffer() : ring(LOCKFREE_RING_SIZE) {}
+
+	/** The owner thread, see currentThreadIndex() */
+	uint32_t thread = currentThreadIndex();
+
+	std::vector<TLockFreeCall> ring;
+	alignas(64) std::atomic<std::size_t> head{0};  //!< Written by producer
+	alignas(64) std::atomic<std::size_t> tail{0};  //!< Written by consumer
+	std::atomic<uint64_t> dropped{0};
+	/** Set by the owner thread when it exits, so the buffer can be freed
+	 * once drained */
+	std::atomic<bool> owner_exited{false};
+
+	/** Sections entered and not left yet, only used by the owner thread */
+	std::vector<std::pair<section_id_t, double>> open_calls;
+
+	void push(const TLockFreeCall& c) noexcept
+	{
+		const std::size_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= LOCKFREE_RING_SIZE)
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		ring[h & (LOCKFREE_RING_SIZE - 1)] = c;
+		head.store(h + 1, std::memory_order_release);
+	}
+
+	template <class F>
+	void pop_all(F&& f)
+	{
+		const std::size_t h = head.load(std::memory_order_acquire);
+		std::size_t t = tail.load(std::memory_order_relaxed);
+		for (; t != h; t++)
+			f(ring[t & (LOCKFREE_RING_SIZE - 1)]);
+		tail.store(t, std::memory_order_release);
+	}
+};
+
+struct CTimeLogger::TInternalState
+{
+	const uint64_t uid = ++lockFreeStateCounter;
+
+	/** Buffers of all threads alive, shared with each thread */
+	std::mutex buffers_mtx;
+	std::vector<std::shared_ptr<TLockFreeThreadBuffer>> buffers;
+	/** Dropped calls of the buffers already freed */
+	uint64_t dropped_by_exited_threads = 0;
+
+	/** Serializes aggregation, and protects the writes to `section_data`
+	 * and the structure of m_data */
+	std::mutex flush_mtx;
+	/** Cache of m_data entries, indexed by section ID. It is split into
+	 * chunks which are never freed nor moved while the logger is alive, so
+	 * cached entries can be read without any lock. */
+	static constexpr std::size_t SECTION_CHUNK_SIZE = 256;
+	static constexpr std::size_t SECTION_MAX_CHUNKS = 256;
+	using section_chunk_t =
+		std::array<std::atomic<TCallData*>, SECTION_CHUNK_SIZE>;
+	std::array<std::atomic<section_chunk_t*>, SECTION_MAX_CHUNKS>
+		section_data{};
+
+	~TInternalState()
+	{
+		for (auto& c : section_data)
+			delete c.load();
+	}
+
+	std::thread aggregator;
+	std::mutex aggregator_mtx;
+	std::condition_variable aggregator_cv;
+	bool aggregator_stop = false;
+
+	/** Time of m_tictac.Tic() in the steady clock [s], for traces */
+	double t0 = steadyClockNow();
+
+	std::mutex trace_mtx;
+	std::deque<TTraceEvent> trace;
+	std::size_t trace_max_events = 0;
+};
+
+CTimeLogger::TInternalStateHolder::TInternalStateHolder()
+	: state(std::make_unique<TInternalState>())
+{
+}
+CTimeLogger::TInternalStateHolder::TInternalStateHolder(
+	const TInternalStateHolder& o)
+	: TInternalStateHolder()
+{
+	// The copy of m_tictac has the same time origin:
+	state->t0 = o.state->t0;
+}
+CTimeLogger::TInternalStateHolder& CTimeLogger::TInternalStateHolder::
+	operator=(const TInternalStateHolder& o)
+{
+	// Keep our own state, except for the time origin of m_tictac:
+	state->t0 = o.state->t0;
+	return *this;
+}
+// Note: the aggregator thread is already stopped in ~CTimeLogger()
+CTimeLogger::TInternalStateHolder::~TInternalStateHolder() = default;
+
+CTimeLogger::section_id_t CTimeLogger::registerSection(
+	const std::string_view& name)
+{
+	auto& r = SectionsRegistry::Instance();
+	auto lck = mrpt::lockHelper(r.mtx);
+
+	std::string sName(name);
+	if (auto it = r.ids.find(sName); it != r.ids.end()) return it->second;
+
+	const auto id = static_cast<section_id_t>(r.names.size());
+	r.names.push_back(sName);
+	r.ids[sName] = id;
+	return id;
+}
+
+std::string CTimeLogger::getSectionName(section_id_t section)
+{
+	auto& r = SectionsRegistry::Instance();
+	auto lck = mrpt::lockHelper(r.mtx);
+	ASSERT_LT_(section, r.names.size());
+	return r.names[section];
+}
+
+CTimeLogger::TCallData* CTimeLogger::cachedSectionData(
+	section_id_t section) const noexcept
+{
+	const auto& st = *m_internal.state;
+	const std::size_t c = section / TInternalState::SECTION_CHUNK_SIZE;
+	if (c >= TInternalState::SECTION_MAX_CHUNKS) return nullptr;
+	const auto* chunk = st.section_data[c].load(std::memory_order_acquire);
+	if (!chunk) return nullptr;
+	return (*chunk)[section % TInternalState::SECTION_CHUNK_SIZE].load(
+		std::memory_order_acquire);
+}
+
+CTimeLogger::TCallData* CTimeLogger::sectionData(
+	section_id_t section) const noexcept
+{
+	if (auto* d_ptr = cachedSectionData(section); d_ptr) return d_ptr;
+
+	auto& st = *m_internal.state;
+	try
+	{
+		TCallData* d_ptr = m_data.find_or_alloc(getSectionName(section));
+		if (!d_ptr)
+		{
+			std::cerr << "[CTimeLogger] Warning: skipping due to hash "
+						 "collision.\n";
+			return nullptr;
+		}
+		{
+			auto lckData = mrpt::lockHelper(d_ptr->mtx);
+			d_ptr->section = section;
+		}
+
+		// Cache it, unless there are too many sections:
+		const std::size_t c = section / TInternalState::SECTION_CHUNK_SIZE;
+		if (c < TInternalState::SECTION_MAX_CHUNKS)
+		{
+			auto* chunk = st.section_data[c].load(std::memory_order_relaxed);
+			if (!chunk)
+			{
+				chunk = new TInternalState::section_chunk_t();
+				st.section_data[c].store(chunk, std::memory_order_release);
+			}
+			(*chunk)[section % TInternalState::SECTION_CHUNK_SIZE].store(
+				d_ptr, std::memory_order_release);
+		}
+		return d_ptr;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CTimeLogger] Error: " << mrpt::exception_to_str(e);
+		return nullptr;
+	}
+}
+
+CTimeLogger::TLockFreeThreadBuffer* CTimeLogger::lockFreeThreadBuffer() noexcept
+{
+	auto& st = *m_internal.state;
+
+	// Buffers of this thread, one per logger. They are marked upon thread
+	// exit, so the aggregator frees them once drained.
+	struct TThreadBuffers
+	{
+		struct Entry
+		{
+			uint64_t uid;  //!< TInternalState::uid
+			TLockFreeThreadBuffer* buf;
+			std::weak_ptr<TLockFreeThreadBuffer> owner;
+		};
+		std::vector<Entry> entries;
+
+		~TThreadBuffers()
+		{
+			for (const auto& e : entries)
+				if (auto b = e.owner.lock())
+					b->owner_exited.store(true, std::memory_order_release);
+		}
+	};
+	thread_local TThreadBuffers tlBuffers;
+
+	for (const auto& e : tlBuffers.entries)
+		if (e.uid == st.uid) return e.buf;
+
+	// First call from this thread:
+	try
+	{
+		// Forget about buffers of loggers already destroyed:
+		auto& ents = tlBuffers.entries;
+		ents.erase(
+			std::remove_if(
+				ents.begin(), ents.end(),
+				[](const auto& e) { return e.owner.expired(); }),
+			ents.end());
+
+		auto buf = std::make_shared<TLockFreeThreadBuffer>();
+		buf->open_calls.reserve(32);
+		{
+			std::lock_guard<std::mutex> lck(st.buffers_mtx);
+			st.buffers.push_back(buf);
+		}
+		auto* ret = buf.get();
+		ents.push_back({st.uid, ret, buf});
+		// In case this is a copy of the original logger:
+		startLockFreeAggregator();
+		return ret;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CTimeLogger] Error creating thread buffer:\n"
+				  << mrpt::exception_to_str(e);
+		return nullptr;
+	}
+}
+
+void CTimeLogger::do_enter_lockfree(section_id_t section) noexcept
+{
+	const double t = m_tictac.Tac();
+	auto* b = lockFreeThreadBuffer();
+	if (!b) return;
+	b->open_calls.emplace_back(section, t);
+}
+
+double CTimeLogger::do_leave_lockfree(section_id_t section) noexcept
+{
+	const double t = m_tictac.Tac();
+	auto* b = lockFreeThreadBuffer();
+	if (!b) return 0;
+
+	// Find the innermost open call to this section:
+	auto& oc = b->open_calls;
+	for (std::size_t i = oc.size(); i-- > 0;)
+	{
+		if (oc[i].first != section) continue;
+
+		const double t_enter = oc[i].second;
+		oc.erase(oc.begin() + i);
+		b->push({section, t_enter, t});
+		return t - t_enter;
+	}
+	return 0;  // This shouldn't happen!
+}
+
+void CTimeLogger::flushLockFreeCalls() const
+{
+	auto& st = *m_internal.state;
+	std::lock_guard<std::mutex> lck(st.flush_mtx);
+
+	std::vector<TLockFreeThreadBuffer*> bufs;
+	{
+		std::lock_guard<std::mutex> lckBufs(st.buffers_mtx);
+		for (auto& b : st.buffers)
+			bufs.push_back(b.get());
+	}
+
+	bool anyExited = false;
+	for (auto* b : bufs)
+	{
+		// Read before draining, so no call is pushed after the last pop:
+		const bool exited = b->owner_exited.load(std::memory_order_acquire);
+		anyExited = anyExited || exited;
+
+		b->pop_all([&](const TLockFreeCall& c) {
+			TCallData* d_ptr = sectionData(c.section);
+			if (!d_ptr) return;
+			{
+				auto lckData = mrpt::lockHelper(d_ptr->mtx);
+				addMeasure(*d_ptr, c.t_leave - c.t_enter);
+			}
+			addTraceEvent(c.section, b->thread, c.t_enter, c.t_leave);
+		});
+	}
+	if (!anyExited) return;
+
+	// Free the buffers of threads which already exited (only done here, so
+	// the pointers in `bufs` remain valid above):
+	std::lock_guard<std::mutex> lckBufs(st.buffers_mtx);
+	auto& buffers = st.buffers;
+	for (auto it = buffers.begin(); it != buffers.end();)
+	{
+		auto& b = **it;
+		if (b.owner_exited.load(std::memory_order_acquire) &&
+			b.head.load(std::memory_order_acquire) ==
+				b.tail.load(std::memory_order_relaxed))
+		{
+			st.dropped_by_exited_threads +=
+				b.dropped.load(std::memory_order_relaxed);
+			it = buffers.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+uint64_t CTimeLogger::getLockFreeDroppedCalls() const
+{
+	auto& st = *m_internal.state;
+	std::lock_guard<std::mutex> lck(st.buffers_mtx);
+	uint64_t n = st.dropped_by_exited_threads;
+	for (const auto& b : st.buffers)
+		n += b->dropped.load(std::memory_order_relaxed);
+	return n;
+}
+
+void CTimeLogger::enableLockFreeMode(bool enable)
+{
+	if (enable) startLockFreeAggregator();
+	m_internal.lockfree_enabled = enable;
+	if (!enable)
+	{
+		stopLockFreeAggregator();
+		flushLockFreeCalls();
+	}
+}
+
+void CTimeLogger::startLockFreeAggregator()
+{
+	auto& st = *m_internal.state;
+	std::lock_guard<std::mutex> lck(st.aggregator_mtx);
+	if (st.aggregator.joinable()) return;
+
+	st.aggregator_stop = false;
+	st.aggregator = std::thread([this, &st]() {
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lk(st.aggregator_mtx);
+				st.aggregator_cv.wait_for(
+					lk, LOCKFREE_AGGREGATION_PERIOD,
+					[&st]() { return st.aggregator_stop; });
+				if (st.aggregator_stop) break;
+			}
+			flushLockFreeCalls();
+		}
+	});
+	mrpt::system::thread_name("CTimeLogger", st.aggregator);
+}
+
+void CTimeLogger::stopLockFreeAggregator()
+{
+	auto& st = *m_internal.state;
+	{
+		std::lock_guard<std::mutex> lck(st.aggregator_mtx);
+		st.aggregator_stop = true;
+	}
+	st.aggregator_cv.notify_all();
+	if (st.aggregator.joinable()) st.aggregator.join();
+}
+
+// ---------------------------------------------------------------------------
+
 CTimeLogger::CTimeLogger(
 	bool enabled, const std::string& name, const bool keep_whole_history)
 	: m_enabled(enabled), m_keep_whole_history(keep_whole_history)
 {
 	setName(name);
 	m_tictac.Tic();
+	m_internal.state->t0 = steadyClockNow();
 }
 
 void CTimeLogger::setName(const std::string& name) noexcept
@@ -81,6 +576,9 @@ void CTimeLogger::setName(const std::string& name) noexcept
 
 CTimeLogger::~CTimeLogger()
 {
+	stopLockFreeAggregator();
+	flushLockFreeCalls();
+
 	// Dump all stats:
 	if (!m_data.empty())  // If logging is disabled, do nothing...
 		dumpAllStats();
@@ -88,16 +586,33 @@ CTimeLogger::~CTimeLogger()
 
 void CTimeLogger::clear(bool deep_clear)
 {
-	if (deep_clear) m_data.clear();
-	else
+	auto& st = *m_internal.state;
+
+	// Discard pending lock-free calls, and the cached pointers into m_data.
+	// The lock also keeps the aggregator thread away from m_data meanwhile:
+	flushLockFreeCalls();
 	{
-		for (auto& e : m_data)
+		std::lock_guard<std::mutex> lck(st.flush_mtx);
+		for (auto& c : st.section_data)
+			if (auto* chunk = c.load(std::memory_order_relaxed); chunk)
+				for (auto& d : *chunk)
+					d.store(nullptr, std::memory_order_relaxed);
+
+		if (deep_clear) m_data.clear();
+		else
 		{
-			e.second.mtx.lock();
-			e.second.mtx.unlock();
-			e.second = TCallData();
+			for (auto& e : m_data)
+			{
+				e.second.mtx.lock();
+				e.second.mtx.unlock();
+				e.second = TCallData();
+			}
 		}
 	}
+	{
+		std::lock_guard<std::mutex> lck(st.trace_mtx);
+		st.trace.clear();
+	}
 }
 
 std::string aux_format_string_multilines(const std::string& s, const size_t len)
@@ -114,6 +629,7 @@ std::string aux_format_string_multilines(const std::string& s, const size_t len)
 
 void CTimeLogger::getStats(std::map<std::string, TCallStats>& out_stats) const
 {
+	flushLockFreeCalls();
 	out_stats.clear();
 	for (const auto& e : m_data)
 	{
@@ -131,6 +647,7 @@ void CTimeLogger::getStats(std::map<std::string, TCallStats>& out_stats) const
 
 std::string CTimeLogger::getStatsAsText(const size_t column_width) const
 {
+	flushLockFreeCalls();
 	using std::string;
 	using namespace std::string_literals;
 
@@ -222,6 +739,7 @@ std::string CTimeLogger::getStatsAsText(const size_t column_width) const
 
 void CTimeLogger::saveToCSVFile(const std::string& csv_file) const
 {
+	flushLockFreeCalls();
 	std::string s;
 	s += "FUNCTION, #CALLS, LAST.T, MIN.T, MEAN.T, MAX.T, TOTAL.T [, "
 		 "WHOLE_HISTORY]\n";
@@ -252,6 +770,7 @@ void CTimeLogger::saveToCSVFile(const std::string& csv_file) const
 
 void CTimeLogger::saveToMFile(const std::string& file) const
 {
+	flushLockFreeCalls();
 	using std::string;
 	using namespace std::string_literals;
 
@@ -323,8 +842,29 @@ void CTimeLogger::do_enter(const std::string_view& func_name) noexcept
 					 "collision.\n";
 		return;
 	}
-	auto& d = *d_ptr;
-	auto lck = mrpt::lockHelper(d.mtx);
+	auto lck = mrpt::lockHelper(d_ptr->mtx);
+	// Only the first time, not on each leave():
+	if (m_internal.trace_enabled && !d_ptr->section)
+		d_ptr->section = registerSection(func_name);
+	openCall(*d_ptr);
+}
+
+void CTimeLogger::do_enter(section_id_t section) noexcept
+{
+	// The flush mutex is only needed the first time a section is used:
+	TCallData* d_ptr = cachedSectionData(section);
+	if (!d_ptr)
+	{
+		std::lock_guard<std::mutex> lck(m_internal.state->flush_mtx);
+		d_ptr = sectionData(section);
+	}
+	if (!d_ptr) return;
+	auto lck = mrpt::lockHelper(d_ptr->mtx);
+	openCall(*d_ptr);
+}
+
+void CTimeLogger::openCall(TCallData& d) noexcept
+{
 	d.n_calls++;
 	d.open_calls.push(0);  // Dummy value, it'll be written below
 	d.open_calls.top() = m_tictac.Tac();  // to avoid possible delays.
@@ -341,14 +881,36 @@ double CTimeLogger::do_leave(const std::string_view& func_name) noexcept
 					 "collision.\n";
 		return .0;
 	}
-	auto& d = *d_ptr;
-	auto lck = mrpt::lockHelper(d.mtx);
+	auto lck = mrpt::lockHelper(d_ptr->mtx);
+	return closeCall(*d_ptr, tim);
+}
+
+double CTimeLogger::do_leave(section_id_t section) noexcept
+{
+	const double tim = m_tictac.Tac();
+
+	TCallData* d_ptr = cachedSectionData(section);
+	if (!d_ptr)
+	{
+		std::lock_guard<std::mutex> lck(m_internal.state->flush_mtx);
+		d_ptr = sectionData(section);
+	}
+	if (!d_ptr) return .0;
+	auto lck = mrpt::lockHelper(d_ptr->mtx);
+	return closeCall(*d_ptr, tim);
+}
 
+double CTimeLogger::closeCall(TCallData& d, double tim) noexcept
+{
 	if (!d.open_calls.empty())
 	{
-		const double At = tim - d.open_calls.top();
+		const double t_enter = d.open_calls.top();
+		const double At = tim - t_enter;
 		d.open_calls.pop();
 
+		if (m_internal.trace_enabled && d.section)
+			addTraceEvent(*d.section, currentThreadIndex(), t_enter, tim);
+
 		d.last_t = At;
 		d.mean_t += At;
 		if (d.n_calls == 1)
@@ -378,6 +940,13 @@ double CTimeLogger::do_leave(const std::string_view& func_name) noexcept
 void CTimeLogger::registerUserMeasure(
 	const std::string_view& event_name, const double value,
 	const bool is_time) noexcept
+{
+	do_registerUserMeasure(event_name, value, is_time, std::nullopt);
+}
+
+void CTimeLogger::do_registerUserMeasure(
+	const std::string_view& event_name, const double value,
+	const bool is_time, const std::optional<double>& t_enter) noexcept
 {
 	if (!m_enabled) return;
 	TCallData* d_ptr = m_data.find_or_alloc(std::string(event_name));
@@ -391,6 +960,18 @@ void CTimeLogger::registerUserMeasure(
 	auto lck = mrpt::lockHelper(d.mtx);
 
 	d.has_time_units = is_time;
+	addMeasure(d, value);
+
+	if (t_enter && m_internal.trace_enabled)
+	{
+		if (!d.section) d.section = registerSection(event_name);
+		addTraceEvent(
+			*d.section, currentThreadIndex(), *t_enter, *t_enter + value);
+	}
+}
+
+void CTimeLogger::addMeasure(TCallData& d, double value) const
+{
 	d.last_t = value;
 	d.mean_t += value;
 	if (++d.n_calls == 1)
@@ -415,6 +996,7 @@ void CTimeLogger::registerUserMeasure(
 
 double CTimeLogger::getMeanTime(const std::string& name) const
 {
+	flushLockFreeCalls();
 	TDataMap::const_iterator it = m_data.find(name);
 	if (it == m_data.end()) return 0;
 	else
@@ -426,6 +1008,7 @@ double CTimeLogger::getMeanTime(const std::string& name) const
 }
 double CTimeLogger::getLastTime(const std::string& name) const
 {
+	flushLockFreeCalls();
 	TDataMap::const_iterator it = m_data.find(name);
 	if (it == m_data.end()) return 0;
 	else
@@ -435,6 +1018,96 @@ double CTimeLogger::getLastTime(const std::string& name) const
 	}
 }
 
+void CTimeLogger::enableTraceRecording(bool enable, size_t max_events)
+{
+	auto& st = *m_internal.state;
+	{
+		std::lock_guard<std::mutex> lck(st.trace_mtx);
+		st.trace_max_events = max_events;
+		while (st.trace.size() > st.trace_max_events)
+			st.trace.pop_front();
+	}
+	m_internal.trace_enabled = enable;
+}
+
+void CTimeLogger::addTraceEvent(
+	section_id_t section, uint32_t thread, double t_enter,
+	double t_leave) const
+{
+	if (!m_internal.trace_enabled) return;
+
+	auto& st = *m_internal.state;
+	std::lock_guard<std::mutex> lck(st.trace_mtx);
+	if (!st.trace_max_events) return;
+	if (st.trace.size() >= st.trace_max_events) st.trace.pop_front();
+	st.trace.push_back({section, thread, t_enter, t_leave});
+}
+
+void CTimeLogger::saveToChromeTraceFile(const std::string& json_file) const
+{
+	saveToChromeTraceFile(json_file, {this});
+}
+
+void CTimeLogger::saveToChromeTraceFile(
+	const std::string& json_file,
+	const std::vector<const CTimeLogger*>& loggers)
+{
+	std::ofstream f(json_file);
+	if (!f.is_open())
+		THROW_EXCEPTION_FMT("Error creating file: `%s`", json_file.c_str());
+
+	f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	const auto sep = [&]() -> const char* {
+		const bool wasFirst = first;
+		first = false;
+		return wasFirst ? "" : ",\n";
+	};
+
+	std::map<section_id_t, std::string> sectionNames;
+	for (size_t pid = 0; pid < loggers.size(); pid++)
+	{
+		const CTimeLogger& tl = *loggers[pid];
+		tl.flushLockFreeCalls();
+
+		auto& st = *tl.m_internal.state;
+		std::lock_guard<std::mutex> lck(st.trace_mtx);
+
+		const std::string loggerName = jsonEscape(
+			tl.m_name.empty() ? std::string("CTimeLogger") : tl.m_name);
+		f << sep() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":"
+		  << pid << ",\"tid\":0,\"args\":{\"name\":\"" << loggerName
+		  << "\"}}";
+
+		std::set<uint32_t> threads;
+		for (const auto& e : st.trace)
+		{
+			auto itName = sectionNames.find(e.section);
+			if (itName == sectionNames.end())
+			{
+				const auto name = jsonEscape(getSectionName(e.section));
+				itName = sectionNames.emplace(e.section, name).first;
+			}
+			threads.insert(e.thread);
+
+			// Timestamps in microseconds:
+			f << sep()
+			  << mrpt::format(
+					 "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+					 "\"dur\":%.3f,\"pid\":%u,\"tid\":%u}",
+					 itName->second.c_str(), loggerName.c_str(),
+					 (st.t0 + e.t_enter) * 1e6, (e.t_leave - e.t_enter) * 1e6,
+					 static_cast<unsigned int>(pid),
+					 static_cast<unsigned int>(e.thread));
+		}
+		for (const auto t : threads)
+			f << sep() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"
+			  << pid << ",\"tid\":" << t << ",\"args\":{\"name\":\""
+			  << jsonEscape(threadNameForTrace(t)) << "\"}}";
+	}
+	f << "\n]}\n";
+}
+
 CTimeLoggerEntry::CTimeLoggerEntry(
 	const CTimeLogger& logger, const std::string_view& section_name)
 	: m_logger(const_cast<CTimeLogger&>(logger)), m_section_name(section_name)
@@ -447,7 +1120,7 @@ void CTimeLoggerEntry::stop()
 	const double leave = m_logger.m_tictac.Tac();
 	const double dt = leave - m_entry;
 
-	m_logger.registerUserMeasure(m_section_name, dt, true);
+	m_logger.do_registerUserMeasure(m_section_name, dt, true, m_entry);
 	stopped_ = true;
 }
 
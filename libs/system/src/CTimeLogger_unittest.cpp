@@ -9,8 +9,12 @@
 
 #include <gtest/gtest.h>
 #include <mrpt/system/CTimeLogger.h>
+#include <mrpt/system/filesystem.h>
+#include <mrpt/system/thread_name.h>
 
 #include <chrono>
+#include <fstream>
+#include <iterator>
 #include <mutex>
 #include <thread>
 
@@ -123,3 +127,176 @@ TEST(CTimeLogger, multithread)
 	tl.clear(true);	 // to silent console output upon dtor
 	EXPECT_EQ(std::count(s.begin(), s.end(), '\n'), 9U);
 }
+
+TEST(CTimeLogger, sectionIds)
+{
+	mrpt::system::CTimeLogger tl;
+	const auto id = MRPT_TIMELOGGER_SECTION_ID("sectionIds.foo");
+	EXPECT_EQ(id, mrpt::system::CTimeLogger::registerSection("sectionIds.foo"));
+	EXPECT_EQ(mrpt::system::CTimeLogger::getSectionName(id), "sectionIds.foo");
+
+	// Regular (not lock-free) mode:
+	tl.enter(id);
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_GT(tl.leave(id), 5e-3);
+	EXPECT_GT(tl.getLastTime("sectionIds.foo"), 5e-3);
+
+	tl.clear(true);	 // to silent console output upon dtor
+}
+
+TEST(CTimeLogger, sectionIdsMultithread)
+{
+	mrpt::system::CTimeLogger tl;
+	std::vector<mrpt::system::CTimeLogger::section_id_t> ids;
+	for (int i = 0; i < 8; i++)
+		ids.push_back(mrpt::system::CTimeLogger::registerSection(
+			mrpt::format("sectionIdsMultithread.foo%i", i)));
+
+	// Regular (not lock-free) mode, one section per thread:
+	std::vector<std::thread> ths;
+	for (int i = 0; i < 8; i++)
+		ths.emplace_back([&tl, id = ids[i]]() {
+			for (int k = 0; k < 1000; k++)
+			{
+				tl.enter(id);
+				tl.leave(id);
+			}
+		});
+	for (auto& t : ths)
+		t.join();
+
+	std::map<std::string, mrpt::system::CTimeLogger::TCallStats> stats;
+	tl.getStats(stats);
+	for (const auto id : ids)
+		EXPECT_EQ(
+			stats.at(mrpt::system::CTimeLogger::getSectionName(id)).n_calls,
+			1000U);
+
+	tl.clear(true);	 // to silent console output upon dtor
+}
+
+TEST(CTimeLogger, lockFreeMode)
+{
+	mrpt::system::CTimeLogger tl;
+	tl.enableLockFreeMode();
+	EXPECT_TRUE(tl.isEnabledLockFreeMode());
+
+	const int nThreads = 8, nCalls = 5000;
+	std::vector<std::thread> ths;
+	for (int i = 0; i < nThreads; i++)
+	{
+		ths.emplace_back([&tl]() {
+			for (int j = 0; j < nCalls; j++)
+			{
+				MRPT_TIMELOGGER_SCOPE(tl, "lockFree.outer");
+				// All threads use the same sections at once:
+				MRPT_TIMELOGGER_SCOPE(tl, "lockFree.inner");
+			}
+		});
+	}
+	for (auto& t : ths)
+		t.join();
+
+	// Stats must include all calls, no matter the aggregator period:
+	std::map<std::string, mrpt::system::CTimeLogger::TCallStats> stats;
+	tl.getStats(stats);
+	ASSERT_EQ(stats.count("lockFree.outer"), 1U);
+	ASSERT_EQ(stats.count("lockFree.inner"), 1U);
+	EXPECT_EQ(tl.getLockFreeDroppedCalls(), 0U);
+	EXPECT_EQ(stats["lockFree.outer"].n_calls, size_t(nThreads * nCalls));
+	EXPECT_EQ(stats["lockFree.inner"].n_calls, size_t(nThreads * nCalls));
+	EXPECT_GE(stats["lockFree.outer"].total_t, stats["lockFree.inner"].total_t);
+
+	// Mixed with string-based sections:
+	doTimLogEntry(tl, "lockFree.str", 1);
+	{
+		MRPT_TIMELOGGER_SCOPE(tl, "lockFree.outer");
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	EXPECT_GT(tl.getLastTime("lockFree.outer"), 5e-3);
+	EXPECT_GT(tl.getLastTime("lockFree.str"), 0.5e-3);
+
+	tl.enableLockFreeMode(false);
+	tl.clear(true);	 // to silent console output upon dtor
+}
+
+TEST(CTimeLogger, lockFreeShortLivedThreads)
+{
+	mrpt::system::CTimeLogger tl;
+	tl.enableLockFreeMode();
+
+	// The buffers of threads which exit must be drained before being freed:
+	const int nThreads = 50, nCalls = 100;
+	for (int i = 0; i < nThreads; i++)
+	{
+		std::thread([&tl]() {
+			for (int j = 0; j < nCalls; j++)
+				MRPT_TIMELOGGER_SCOPE(tl, "shortLived.foo");
+		}).join();
+		if (i == nThreads / 2 - 1) tl.clear(true);
+	}
+
+	std::map<std::string, mrpt::system::CTimeLogger::TCallStats> stats;
+	tl.getStats(stats);
+	EXPECT_EQ(stats["shortLived.foo"].n_calls, size_t(nCalls * nThreads / 2));
+	EXPECT_EQ(tl.getLockFreeDroppedCalls(), 0U);
+
+	tl.enableLockFreeMode(false);
+	tl.clear(true);	 // to silent console output upon dtor
+}
+
+TEST(CTimeLogger, chromeTrace)
+{
+	mrpt::system::CTimeLogger tl1(true, "logger1"), tl2(true, "logger2");
+	tl1.enableTraceRecording();
+	tl2.enableTraceRecording();
+	tl2.enableLockFreeMode();
+
+	std::thread th([&]() {
+		mrpt::system::thread_name("worker");
+		doTimLogEntry(tl1, "th.foo", 1);
+		MRPT_TIMELOGGER_SCOPE(tl2, "th.\"quoted\"");
+	});
+	doTimLogEntry(tl1, "main.foo", 1);
+	{
+		mrpt::system::CTimeLoggerEntry tle(tl1, "main.bar");
+	}
+	th.join();
+
+	const std::string file =
+		mrpt::system::getTempFileName() + std::string("_trace.json");
+	mrpt::system::CTimeLogger::saveToChromeTraceFile(file, {&tl1, &tl2});
+
+	std::ifstream f(file);
+	const std::string s(
+		(std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+	const auto count = [&s](const std::string& sub) {
+		size_t n = 0;
+		for (auto p = s.find(sub); p != std::string::npos;
+			 p = s.find(sub, p + 1))
+			n++;
+		return n;
+	};
+	EXPECT_EQ(count("\"ph\":\"X\""), 4U);
+	EXPECT_EQ(count("\"name\":\"th.foo\""), 1U);
+	EXPECT_EQ(count("\"name\":\"main.bar\""), 1U);
+	EXPECT_EQ(count("th.\\\"quoted\\\""), 1U);
+	EXPECT_EQ(count("\"name\":\"logger1\""), 1U);
+	EXPECT_EQ(count("\"name\":\"logger2\""), 1U);
+	EXPECT_GE(count("\"name\":\"worker\""), 1U);
+
+	// Disabled:
+	tl1.clear(true);
+	tl1.enableTraceRecording(false);
+	doTimLogEntry(tl1, "main.foo", 1);
+	tl1.saveToChromeTraceFile(file);
+	std::ifstream f2(file);
+	const std::string s2(
+		(std::istreambuf_iterator<char>(f2)), std::istreambuf_iterator<char>());
+	EXPECT_EQ(s2.find("\"ph\":\"X\""), std::string::npos);
+	mrpt::system::deleteFile(file);
+
+	tl1.clear(true);  // to silent console output upon dtor
+	tl2.clear(true);
+}